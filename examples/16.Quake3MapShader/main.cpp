@@ -357,23 +357,21 @@ int IRRCALLCONV main(int argc, char* argv[])
 		int fps = driver->getFPS();
 		//if (lastFPS != fps)
 		{
-			io::IAttributes * const attr = smgr->getParameters();
+			const scene::SSceneStats& stats = smgr->getSceneStats();
 			core::stringw str = L"Q3 [";
 			str += driver->getName();
 			str += "] FPS:";
 			str += fps;
-#ifdef _IRR_SCENEMANAGER_DEBUG			
 			str += " Cull:";
-			str += attr->getAttributeAsInt("calls");
+			str += stats.NodesRegistered;
 			str += "/";
-			str += attr->getAttributeAsInt("culled");
+			str += stats.getCulledCount();
 			str += " Draw: ";
-			str += attr->getAttributeAsInt("drawn_solid");
+			str += stats.Solid.Nodes;
 			str += "/";
-			str += attr->getAttributeAsInt("drawn_transparent");
+			str += stats.Transparent.Nodes;
 			str += "/";
-			str += attr->getAttributeAsInt("drawn_transparent_effect");
-#endif
+			str += stats.TransparentEffect.Nodes;
 			device->setWindowCaption(str.c_str());
 			lastFPS = fps;
 		}
@@ -2028,29 +2028,19 @@ void CQuake3EventHandler::Animate()
 		wchar_t msg[128];
 		IVideoDriver * driver = Game->Device->getVideoDriver();
 
-#ifdef _IRR_SCENEMANAGER_DEBUG
-		IAttributes * attr = Game->Device->getSceneManager()->getParameters();
+		const SSceneStats& stats = Game->Device->getSceneManager()->getSceneStats();
 		swprintf_irr ( msg, 128,
 			L"Q3 %s [%ls], FPS:%03d Tri:%.03fm Cull %d/%d nodes (%d,%d,%d)",
 			Game->CurrentMapName.c_str(),
 			driver->getName(),
 			driver->getFPS (),
 			(f32) driver->getPrimitiveCountDrawn( 0 ) * ( 1.f / 1000000.f ),
-			attr->getAttributeAsInt ( "culled" ),
-			attr->getAttributeAsInt ( "calls" ),
-			attr->getAttributeAsInt ( "drawn_solid" ),
-			attr->getAttributeAsInt ( "drawn_transparent" ),
-			attr->getAttributeAsInt ( "drawn_transparent_effect" )
+			stats.getCulledCount(),
+			stats.NodesRegistered,
+			stats.Solid.Nodes,
+			stats.Transparent.Nodes,
+			stats.TransparentEffect.Nodes
 			);
-#else
-swprintf_irr ( msg, 128,
-			L"Q3 %s [%ls], FPS:%03d Tri:%.03fm",
-			Game->CurrentMapName.c_str(),
-			driver->getName(),
-			driver->getFPS (),
-			(f32) driver->getPrimitiveCountDrawn( 0 ) * ( 1.f / 1000000.f )
-			);
-#endif
 		Game->Device->setWindowCaption( msg );
 
 		swprintf_irr ( msg, 128,
@@ -19,7 +19,9 @@ namespace scene
 		EAC_BOX = 1,
 		EAC_FRUSTUM_BOX = 2,
 		EAC_FRUSTUM_SPHERE = 4,
-		EAC_OCC_QUERY = 8
+		EAC_OCC_QUERY = 8,
+		//! Hidden behind the occluders of the scene manager, see ISceneManager::setOccluder()
+		EAC_OCC_SOFTWARE = 16
 	};
 
 	//! Names for culling type
@@ -30,6 +32,7 @@ namespace scene
 		"frustum_box",		// camera frustum against node box
 		"frustum_sphere",	// camera frustum against node sphere
 		"occ_query",		// occlusion query
+		"occ_software",		// occluders rasterized on the CPU
 		0
 	};
 
@@ -54,6 +54,12 @@ namespace scene
 		//! Mesh Scene Node
 		ESNT_MESH           = MAKE_IRR_ID('m','e','s','h'),
 
+		//! Instanced Mesh Scene Node
+		ESNT_INSTANCED_MESH = MAKE_IRR_ID('i','m','s','h'),
+
+		//! Level of Detail Mesh Scene Node
+		ESNT_LOD_MESH       = MAKE_IRR_ID('l','o','d','m'),
+
 		//! Light Scene Node
 		ESNT_LIGHT          = MAKE_IRR_ID('l','g','h','t'),
 
@@ -78,6 +84,9 @@ namespace scene
 		//! Quake3 Shader Scene Node
 		ESNT_Q3SHADER_SCENE_NODE  = MAKE_IRR_ID('q','3','s','h'),
 
+		//! Quake3 Level Scene Node
+		ESNT_Q3LEVEL_SCENE_NODE  = MAKE_IRR_ID('q','3','l','v'),
+
 		//! Quake3 Model Scene Node ( has tag to link to )
 		ESNT_MD3_SCENE_NODE  = MAKE_IRR_ID('m','d','3','_'),
 
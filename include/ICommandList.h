@@ -0,0 +1,61 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_COMMAND_LIST_H_INCLUDED__
+#define __I_COMMAND_LIST_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+
+namespace irr
+{
+namespace video
+{
+	class IVideoDriver;
+
+//! Calls to a video driver, recorded to be replayed later.
+/** Create a command list with IVideoDriver::createCommandList(). Everything
+drawn with the driver returned by getRecorder() is stored in the list instead
+of being drawn, for example a whole scene with ISceneManager::drawAll(video::IVideoDriver*).
+replay() then sends the recorded calls to a driver, as often as needed and
+without visiting the scene graph again.
+
+Recorded are transformations, materials, dynamic lights, the ambient light,
+viewports, vertex primitive lists (so also mesh buffers and 3d triangles),
+2d images, rectangles and lines, 3d lines, pixels and stencil shadows. The
+vertices, indices and materials are copied into the list, the textures are
+grabbed until the list is cleared. All other calls, like loading textures or
+querying the material renderers, go directly to the driver which created the
+list. Render targets are not recorded, the commands are replayed into the
+render target which is set on the replaying driver. Note that scene nodes are
+animated while the scene is recorded, not while it is replayed.
+*/
+class ICommandList : public virtual IReferenceCounted
+{
+public:
+
+	//! Get the driver which records into this list.
+	/** The recorder belongs to the list, don't drop it.
+	\return Driver recording the calls. */
+	virtual IVideoDriver* getRecorder() = 0;
+
+	//! Removes all recorded calls and releases the referenced textures.
+	virtual void clear() = 0;
+
+	//! Sends the recorded calls to a driver.
+	/** This can only be invoked between IVideoDriver::beginScene() and
+	IVideoDriver::endScene() of the replaying driver. The list is not
+	changed, so it can be replayed any number of times.
+	\param driver Driver which draws the calls. */
+	virtual void replay(IVideoDriver* driver) const = 0;
+
+	//! Get the number of recorded calls.
+	virtual u32 getCommandCount() const = 0;
+
+	//! Get the memory used by the recorded calls and their vertices, indices and materials in bytes.
+	virtual u32 getSize() const = 0;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -14,9 +14,21 @@
 
 namespace irr
 {
+class IJobSystem;
+
 namespace video
 {
 
+//! Filters used to halve images into mip map levels
+enum E_MIP_MAP_FILTER
+{
+	//! Average of 2x2 pixels
+	EMMF_BOX = 0,
+
+	//! Kaiser windowed sinc over 6x6 pixels, keeps more detail than the box
+	EMMF_KAISER
+};
+
 //! Interface for software image data.
 /** Image loaders create these images from files. IVideoDrivers convert
 these images into their (hardware) textures.
@@ -279,6 +291,27 @@ public:
 	//! copies this surface into another, scaling it to fit, applying a box filter
 	virtual void copyToScalingBoxFilter(IImage* target, s32 bias = 0, bool blend = false) = 0;
 
+	//! Copies the image into a target of half its size, the next smaller mip map level
+	/** The target needs the color format of this image and a size of
+	max(1,width/2) x max(1,height/2). Odd sizes drop the last row or column.
+	Works with ECF_A8R8G8B8, ECF_R8G8B8, ECF_A1R5G5B5 and ECF_R5G6B5, the box
+	filter uses SSE2 when compiled with _IRR_COMPILE_WITH_SSE2_.
+	\param target Image receiving the smaller level.
+	\param filter Filter which combines the pixels.
+	\param jobSystem When set, the rows of large images are split over its threads.
+	\return True on success, false for other formats or target sizes. */
+	virtual bool copyToHalfSize(IImage* target, E_MIP_MAP_FILTER filter = EMMF_BOX, IJobSystem* jobSystem = 0) = 0;
+
+	//! Creates all mip map levels down to 1x1 and stores them as mip maps data
+	/** With the box filter and power of two sizes up to 4096x4096, each level
+	gets the same pixels as copyToScalingBoxFilter() from the full image, the
+	levels are summed up from each other. Otherwise each level is made from
+	the one before with copyToHalfSize. Mip maps data set before is replaced.
+	\param filter Filter which combines the pixels.
+	\param jobSystem When set, the rows of large levels are split over its threads.
+	\return True on success, false for formats copyToHalfSize does not support. */
+	virtual bool createMipMaps(E_MIP_MAP_FILTER filter = EMMF_BOX, IJobSystem* jobSystem = 0) = 0;
+
 	//! fills the surface with given color
 	virtual void fill(const SColor &color) =0;
 
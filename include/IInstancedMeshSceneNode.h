@@ -0,0 +1,84 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+#define __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "SInstanceData.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class IMesh;
+
+
+//! A scene node drawing one static mesh at many transformations.
+/** Each instance only stores a transformation relative to the node and a
+color, which is multiplied with the vertex colors. Instances are culled
+against the view frustum on their own, and all visible instances of a
+mesh buffer are drawn with a single IVideoDriver::drawMeshBufferInstanced()
+call. All instances share the materials of the node. */
+class IInstancedMeshSceneNode : public ISceneNode
+{
+public:
+
+	//! Constructor
+	IInstancedMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: ISceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Sets a new mesh to display
+	/** \param mesh Mesh to display. */
+	virtual void setMesh(IMesh* mesh) = 0;
+
+	//! Get the currently defined mesh for display.
+	virtual IMesh* getMesh(void) = 0;
+
+	//! Adds an instance
+	/** \param transformation Transformation of the instance, relative to this node.
+	\param color Color multiplied with the vertex colors of the mesh.
+	\return Index of the new instance. */
+	virtual u32 addInstance(const core::matrix4& transformation,
+			video::SColor color=video::SColor(255,255,255,255)) = 0;
+
+	//! Removes an instance
+	/** The last instance is moved to the index of the removed one.
+	\param index Index of the instance to remove. */
+	virtual void removeInstance(u32 index) = 0;
+
+	//! Removes all instances
+	virtual void clearInstances() = 0;
+
+	//! Get the number of instances
+	virtual u32 getInstanceCount() const = 0;
+
+	//! Get the data of all instances as one array
+	virtual const video::SInstanceData* getInstances() const = 0;
+
+	//! Sets the transformation of an instance, relative to this node
+	virtual void setInstanceTransformation(u32 index, const core::matrix4& transformation) = 0;
+
+	//! Get the transformation of an instance, relative to this node
+	virtual const core::matrix4& getInstanceTransformation(u32 index) const = 0;
+
+	//! Sets the color of an instance
+	virtual void setInstanceColor(u32 index, video::SColor color) = 0;
+
+	//! Get the color of an instance
+	virtual video::SColor getInstanceColor(u32 index) const = 0;
+
+	//! Get the number of instances which passed culling in the last frame
+	virtual u32 getVisibleInstanceCount() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+
+#endif
+
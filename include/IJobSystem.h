@@ -0,0 +1,53 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_JOB_SYSTEM_H_INCLUDED__
+#define __I_JOB_SYSTEM_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+
+namespace irr
+{
+
+//! Runs work on a pool of worker threads.
+/** The job system of a device is accessible with IrrlichtDevice::getJobSystem().
+The number of worker threads is set with SIrrlichtCreationParameters::JobThreads.
+Without worker threads all jobs are run serially on the calling thread in a fixed
+order, so results are deterministic.
+Note that the rest of the engine is not thread-safe. Jobs must only work on
+data which is not accessed by other jobs running at the same time.
+*/
+class IJobSystem : public virtual IReferenceCounted
+{
+public:
+
+	//! Function called for each index of a parallel loop.
+	/** \param userData Pointer passed to parallelFor.
+	\param index Index of the loop iteration. */
+	typedef void (*JobFunction)(void* userData, u32 index);
+
+	//! Get the number of worker threads.
+	/** The thread calling parallelFor is working as well, so up to
+	getWorkerCount()+1 jobs run at the same time.
+	\return Number of worker threads, 0 when all jobs run on the calling thread. */
+	virtual u32 getWorkerCount() const = 0;
+
+	//! Calls a function for each index in [0, count) and waits until all calls are done.
+	/** The indices are split into ranges which are distributed over the worker
+	threads and the calling thread. Threads which run out of work take over half
+	of the remaining range of another thread (work stealing), so jobs of different
+	length are balanced automatically.
+	Without worker threads, for less than two ranges of work, or when called while
+	another parallelFor is running (for example from inside a job), the indices
+	are processed in ascending order on the calling thread.
+	\param count Number of indices.
+	\param job Function called for each index.
+	\param userData Pointer passed to each call of job.
+	\param grainSize Minimal number of indices a thread takes at once. Use larger
+	values for very small jobs to reduce the synchronization overhead. */
+	virtual void parallelFor(u32 count, JobFunction job, void* userData, u32 grainSize=1) = 0;
+};
+
+} // end namespace irr
+
+#endif
@@ -0,0 +1,85 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_LOD_SCENE_NODE_H_INCLUDED__
+#define __I_LOD_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class IMesh;
+
+
+//! A scene node drawing one of several static meshes depending on its size on screen.
+/** Each level of detail has a mesh and the smallest screen size it is
+used for. The screen size is the diameter of the bounding sphere of the
+node projected by the active camera, relative to the height of the screen,
+so it takes the distance, the field of view and the size of the node into
+account. Each frame the most detailed level whose screen size is reached is
+drawn. With ISceneManager::drawAll for several views, each camera gets its
+own level. When the node is smaller than the screen size of the last level,
+nothing is drawn at all.
+To keep nodes close to a threshold from switching back and forth, the
+screen size has to be beyond the threshold by the hysteresis before the
+level changes. */
+class ILODSceneNode : public ISceneNode
+{
+public:
+
+	//! Constructor
+	ILODSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: ISceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Adds a level of detail
+	/** Levels are kept sorted from the largest to the smallest screen
+	size, so the most detailed mesh should get the largest one.
+	\param mesh Mesh drawn for this level.
+	\param minScreenSize Smallest screen size the level is used for, as
+	diameter of the node on screen relative to the screen height. Use 0
+	for the last level to never stop drawing the node.
+	\return Index of the new level. */
+	virtual u32 addLevel(IMesh* mesh, f32 minScreenSize) = 0;
+
+	//! Removes all levels
+	virtual void clearLevels() = 0;
+
+	//! Get the number of levels
+	virtual u32 getLevelCount() const = 0;
+
+	//! Get the mesh of a level
+	virtual IMesh* getLevelMesh(u32 level) const = 0;
+
+	//! Get the smallest screen size a level is used for
+	virtual f32 getLevelScreenSize(u32 level) const = 0;
+
+	//! Get the level drawn for the camera which drew the node last
+	/** \return Index of the level, or getLevelCount() if the node was
+	too small to be drawn. */
+	virtual u32 getCurrentLevel() const = 0;
+
+	//! Get the screen size of the node for the camera which drew the node last
+	virtual f32 getScreenSize() const = 0;
+
+	//! Sets how far the screen size has to pass a threshold before the level changes.
+	/** \param hysteresis Fraction of the screen size of a level. With the
+	default of 0.1 a node switches to a finer level at 110% of its screen
+	size and back to the coarser level at 90% of it. */
+	virtual void setHysteresis(f32 hysteresis) = 0;
+
+	//! Get the fraction of the screen sizes used to avoid switching levels back and forth
+	virtual f32 getHysteresis() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+
+#endif
+
@@ -12,6 +12,7 @@
 #include "SVertexIndex.h"
 #include "EHardwareBufferFlags.h"
 #include "EPrimitiveTypes.h"
+#include "irrObjectPool.h"
 
 namespace irr
 {
@@ -36,7 +37,7 @@ namespace scene
 	passed to a video driver and only drop the buffer once it's not used in
 	the current code block anymore.
 	*/
-	class IMeshBuffer : public virtual IReferenceCounted
+	class IMeshBuffer : public virtual IReferenceCounted, public core::SPooledObject
 	{
 	public:
 
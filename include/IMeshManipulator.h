@@ -264,6 +264,24 @@ namespace scene
 		IReferenceCounted::drop() for more information. */
 		virtual IMesh* createMeshWelded(IMesh* mesh, f32 tolerance=core::ROUNDING_ERROR_f32) const = 0;
 
+		//! Creates a copy of a mesh with less triangles
+		/** Edges are collapsed in the order of their quadric error, the
+		squared distance to the planes of the original surface. Vertices
+		keep their normals, texture coordinates and colors, so seams
+		of these stay intact. Open borders and positions shared by
+		several mesh buffers, like material boundaries, are kept as well.
+		Works with all vertex types, only triangle lists are simplified.
+		\param mesh Input mesh
+		\param ratio Amount of triangles to keep for each mesh buffer,
+		between 0 and 1.
+		\param maxError No edge is collapsed which moves the surface
+		further than this distance, even if there are more triangles left
+		than the ratio allows.
+		\return Simplified mesh. If you no longer need the mesh, you
+		should call IMesh::drop(). See IReferenceCounted::drop() for more
+		information. */
+		virtual IMesh* createMeshSimplified(IMesh* mesh, f32 ratio, f32 maxError=FLT_MAX) const = 0;
+
 		//! Get amount of polygons in mesh.
 		/** \param mesh Input mesh
 		\return Number of polygons in mesh. */
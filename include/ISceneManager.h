@@ -19,11 +19,14 @@
 #include "SceneParameters.h"
 #include "IGeometryCreator.h"
 #include "ISkinnedMesh.h"
+#include "SSceneView.h"
+#include "SSceneStats.h"
 
 namespace irr
 {
 	struct SKeyMap;
 	struct SEvent;
+	class IJobSystem;
 
 namespace io
 {
@@ -108,10 +111,13 @@ namespace scene
 	class IMeshLoader;
 	class IMeshManipulator;
 	class IMeshSceneNode;
+	class IInstancedMeshSceneNode;
+	class ILODSceneNode;
 	class IMeshWriter;
 	class IMetaTriangleSelector;
 	class IOctreeSceneNode;
 	class IParticleSystemSceneNode;
+	class IQ3LevelMesh;
 	class ISceneCollisionManager;
 	class ISceneLoader;
 	class ISceneNode;
@@ -509,6 +515,39 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false) = 0;
 
+		//! Adds a scene node for drawing a static mesh at many transformations.
+		/** The node starts without instances, add them with
+		IInstancedMeshSceneNode::addInstance().
+		\param mesh: Pointer to the static mesh drawn for each instance.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initial rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\return Pointer to the created scene node, 0 if mesh is 0.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) = 0;
+
+		//! Adds a scene node switching between meshes of different detail by its size on screen.
+		/** The node starts without levels, add them with
+		ILODSceneNode::addLevel().
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initial rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual ILODSceneNode* addLODSceneNode(ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) = 0;
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		/** Looks really good when the Material type EMT_TRANSPARENT_REFLECTION
 		is used.
@@ -893,6 +932,25 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												) = 0;
 
+		//! Adds a scene node drawing the geometry of a quake3 level with its potentially visible sets.
+		/** The node draws the buffers of
+		mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY). Each frame it finds the
+		leaf of the BSP tree the camera is in. Only the faces of leafs in
+		clusters visible from that leaf's cluster and inside the view
+		frustum are drawn, so most of the level behind walls is skipped.
+		When the camera is outside the level or the file has no
+		visibility data, the faces of all leafs in the view frustum are
+		drawn. The node copies the vertices and materials of the level and
+		only rebuilds the indices each frame.
+		\param mesh: A level loaded from a .bsp file.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\return Pointer to the created scene node, 0 if mesh is 0 or the
+		engine was compiled without the bsp loader.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual ISceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1) = 0;
+
 
 		//! Adds an empty scene node to the scene graph.
 		/** Can be used for doing advanced transformations
@@ -1115,7 +1173,9 @@ namespace scene
 		\param pass: Specifies when the node wants to be drawn in relation to the other nodes.
 		For example, if the node is a shadow, it usually wants to be drawn after all other nodes
 		and will use ESNRP_SHADOW for this. See scene::E_SCENE_NODE_RENDER_PASS for details.
-		\return scene will be rendered ( passed culling ) */
+		Nodes of the passes which are culled are tested together before drawing,
+		so they can still be culled after they were registered.
+		\return 1 if the node was registered, 0 if it was ignored. */
 		virtual u32 registerNodeForRendering(ISceneNode* node,
 			E_SCENE_NODE_RENDER_PASS pass = ESNRP_AUTOMATIC) = 0;
 
@@ -1132,6 +1192,28 @@ namespace scene
 		by existing scene node animators, culling of scene nodes is done, etc. */
 		virtual void drawAll() = 0;
 
+		//! Draws all the scene nodes from several cameras.
+		/** Each view is drawn from its camera into its viewport, for
+		example for split screen. Unlike calling drawAll() for each camera
+		the scene is animated and its nodes register for rendering only
+		once. Only the culling, sorting and drawing are done for each view.
+		Nodes which depend on the active camera while they register, like
+		terrain LOD, see the camera of the first view.
+		The active camera and the viewport of the driver are restored
+		afterwards. This can only be invoked between
+		IVideoDriver::beginScene() and IVideoDriver::endScene().
+		\param views Cameras and viewports to draw. */
+		virtual void drawAll(const core::array<SSceneView>& views) = 0;
+
+		//! Draws all the scene nodes with another driver.
+		/** Like drawAll(), but the nodes draw with the given driver
+		instead of getVideoDriver(). This is mainly used to record the
+		scene into a command list, with the driver returned by
+		video::ICommandList::getRecorder(). The scene is animated while it
+		is drawn, the recorded list can then be replayed in each frame.
+		\param driver Driver the nodes draw with during this call. */
+		virtual void drawAll(video::IVideoDriver* driver) = 0;
+
 		//! Creates a rotation animator, which rotates the attached scene node around itself.
 		/** \param rotationSpeed Specifies the speed of the animation in degree per 10 milliseconds.
 		\return The animator. Attach it to a scene node with ISceneNode::addAnimator()
@@ -1541,6 +1623,8 @@ namespace scene
 		an xml based format. .irr files can Be edited with the Irrlicht
 		Engine Editor, irrEdit (http://www.ambiera.com/irredit/). To
 		load .irr files again, see ISceneManager::loadScene().
+		Files with the extension .irrb are written in a binary format
+		with the same content, which loads a lot faster.
 		\param filename Name of the file.
 		\param userDataSerializer If you want to save some user data
 		for every scene node into the file, implement the
@@ -1559,6 +1643,8 @@ namespace scene
 		an xml based format. .irr files can Be edited with the Irrlicht
 		Engine Editor, irrEdit (http://www.ambiera.com/irredit/). To
 		load .irr files again, see ISceneManager::loadScene().
+		When the name of the file has the extension .irrb the scene
+		is written in a binary format with the same content.
 		\param file File where the scene is saved into.
 		\param userDataSerializer If you want to save some user data
 		for every scene node into the file, implement the
@@ -1597,7 +1683,8 @@ namespace scene
 		ISceneManager::addExternalSceneLoader. .irr files can Be edited
 		with the Irrlicht Engine Editor, irrEdit
 		(http://www.ambiera.com/irredit/) or saved directly by the engine
-		using ISceneManager::saveScene().
+		using ISceneManager::saveScene(). Binary .irrb files are mapped
+		into memory and read without parsing any text.
 		\param filename Name of the file to load from.
 		\param userDataSerializer If you want to load user data
 		possibily saved in that file for some scene nodes in the file,
@@ -1671,6 +1758,205 @@ namespace scene
 		\return True if node is not visible in the current scene, else
 		false. */
 		virtual bool isCulled(const ISceneNode* node) const =0;
+
+		//! Enable or disable culling of static scene node groups with a bounding volume hierarchy.
+		/** When enabled, each direct child of the root scene node is
+		checked for being static, i.e. neither it nor any of its children
+		has animators, disabled automatic culling or is of a type which
+		changes its bounding box on its own (cameras, lights, animated
+		meshes, particle systems, terrains and similar). A hierarchy of
+		bounding boxes is built over all static subtrees, and during
+		drawAll() whole groups of them are culled against the view frustum
+		of the active camera with a single test. Nodes completely inside
+		the frustum skip their own frustum test. Other subtrees are handled
+		as before.
+		The hierarchy is only rebuilt when children are added to or removed
+		from the scene manager. If static nodes are moved, resized or get
+		new children, setCullingHierarchyDirty() has to be called.
+		Disabled by default.
+		\param enable True to use the culling hierarchy. */
+		virtual void setUseCullingHierarchy(bool enable) = 0;
+
+		//! Check if the culling hierarchy is used.
+		virtual bool getUseCullingHierarchy() const = 0;
+
+		//! Force a rebuild of the culling hierarchy in the next drawAll() call.
+		/** Has to be called after static scene nodes have been changed. */
+		virtual void setCullingHierarchyDirty() = 0;
+
+		//! Set the job system used for parallel work of the scene manager.
+		/** The scene manager of a device uses IrrlichtDevice::getJobSystem()
+		by default.
+		\param jobSystem The new job system, 0 to do all work on the calling thread. */
+		virtual void setJobSystem(IJobSystem* jobSystem) = 0;
+
+		//! Get the job system used for parallel work of the scene manager.
+		virtual IJobSystem* getJobSystem() const = 0;
+
+		//! Enable or disable animating scene nodes on several threads.
+		/** When enabled, drawAll() animates the subtrees below the root
+		scene node on the threads of the job system instead of calling
+		OnAnimate() for the whole scene on the calling thread.
+		A subtree is only animated in parallel when all its nodes are
+		thread-safe: the node types must be known not to access any
+		shared data in OnAnimate() and updateAbsolutePosition() (mesh,
+		octree, cube, sphere, billboard, light, camera, empty, dummy
+		transformation, sky box/dome, text, volume light and shadow
+		volume nodes) and all animators must return true for
+		ISceneNodeAnimator::isThreadSafe(). Of the built-in animators
+		this is the case for rotation, fly circle, fly straight and
+		follow spline.
+		All other subtrees are animated afterwards on the calling thread
+		in the order of the children of the root, so results don't depend
+		on the number of threads. Without worker threads in the job system
+		everything is animated serially as before.
+		Disabled by default.
+		\param enable True to animate in parallel. */
+		virtual void setUseParallelAnimation(bool enable) = 0;
+
+		//! Check if scene nodes are animated on several threads.
+		virtual bool getUseParallelAnimation() const = 0;
+
+		//! Set a fixed time step for animating the scene independent of drawing.
+		/** With a time step, drawAll() no longer animates the scene, this
+		is done by updateAnimation() in steps of a fixed length. So the cost
+		and the results of the animation don't depend on the frame rate,
+		the scene can for example be animated at 30 Hz and drawn at 144 Hz.
+		drawAll() draws the absolute transformations of the nodes which
+		moved in the last step interpolated between the two last steps,
+		depending on how far the time passed to updateAnimation() is past
+		the last step. So the scene moves smoothly but is drawn up to one
+		step late. Translation and scale are interpolated linearly,
+		rotations spherically, also the targets of cameras are interpolated.
+		Other animation like the frames of animated meshes is not.
+		Nodes changed outside of animators are drawn at their new place by
+		the next drawAll() call.
+		0 by default, which animates the scene in each drawAll() call.
+		\param stepMs Time between two animation steps in milliseconds, 0
+		to animate in drawAll(). */
+		virtual void setAnimationTimeStep(u32 stepMs) = 0;
+
+		//! Get the fixed time step for animating the scene.
+		virtual u32 getAnimationTimeStep() const = 0;
+
+		//! Animate the scene in fixed time steps up to a time.
+		/** Calls OnAnimate() for the whole scene once for each time step
+		since the last step up to timeMs, see setAnimationTimeStep(). The
+		first call animates the scene once at timeMs. When the time runs
+		backwards, for example after ITimer::setTime(), it starts again
+		like the first call. Without a time step nothing is done.
+		\param timeMs Current time in milliseconds, usually ITimer::getTime().
+		\param maxSteps Maximal number of steps done in this call. If more
+		steps are due, e.g. after loading, the older ones are skipped, so a
+		slow animation can't slow down the following frames even more.
+		\return Number of steps done. */
+		virtual u32 updateAnimation(u32 timeMs, u32 maxSteps=5) = 0;
+
+		//! Mark a mesh scene node as static, so it is drawn together with other static nodes.
+		/** The mesh buffers of all static nodes are transformed to world
+		space and merged into one buffer per material and cell of a
+		regular grid, see setStaticBatchCellSize(). drawAll() then draws
+		each such batch with a single call instead of setting material
+		and transformation for each node. The cells are culled against
+		the view frustum as a whole.
+		The nodes stay in the scene, so picking, collision and changing
+		their visibility work as before. Buffers with transparent materials
+		or nodes with visible debug data are drawn normally.
+		The batches are rebuilt in the next drawAll() call. After a static
+		node was moved or its mesh or materials were changed,
+		setStaticBatchesDirty() has to be called.
+		The scene manager grabs the node until it is unmarked or the scene
+		is cleared.
+		\param node Node to mark.
+		\param isStatic True to draw the node as part of a static batch,
+		false to draw it on its own again. */
+		virtual void setStaticBatching(IMeshSceneNode* node, bool isStatic) = 0;
+
+		//! Check if a mesh scene node was marked as static.
+		virtual bool getStaticBatching(const IMeshSceneNode* node) const = 0;
+
+		//! Set the edge length of the grid cells used to split the static batches.
+		/** Larger cells mean less draw calls, but coarser culling.
+		Default is 256.
+		\param size New cell size, must be greater than 0. */
+		virtual void setStaticBatchCellSize(f32 size) = 0;
+
+		//! Get the edge length of the grid cells used to split the static batches.
+		virtual f32 getStaticBatchCellSize() const = 0;
+
+		//! Force a rebuild of the static batches in the next drawAll() call.
+		/** Has to be called after static scene nodes have been changed. */
+		virtual void setStaticBatchesDirty() = 0;
+
+		//! Enable or disable culling and per node selection of lights.
+		/** Only used when no light manager was set with setLightManager().
+		Without light culling, all lights are added to the driver and the
+		ones closest to the camera are turned on for the whole scene, up to
+		IVideoDriver::getMaximalDynamicLightAmount().
+		With light culling, point and spot lights which can't reach into
+		the view frustum of the active camera are skipped. All other lights
+		are added to the driver and sorted into a regular grid. Before each
+		scene node is rendered, only the lights which influence its bounding
+		box most are turned on, see setMaxLightsPerNode(). Point and spot
+		lights influence a node when it is inside their radius, the
+		influence falls off with their attenuation. Directional lights are
+		always selected first. So scenes can have hundreds of local lights
+		without each node testing all of them.
+		Disabled by default.
+		\param enable True to cull and select lights. */
+		virtual void setUseLightCulling(bool enable) = 0;
+
+		//! Check if lights are culled and selected per scene node.
+		virtual bool getUseLightCulling() const = 0;
+
+		//! Set the maximal number of lights turned on for a scene node with light culling.
+		/** Never more than IVideoDriver::getMaximalDynamicLightAmount()
+		lights are used, if the driver reports a limit. Default is 8.
+		\param count Maximal number of lights for a node. */
+		virtual void setMaxLightsPerNode(u32 count) = 0;
+
+		//! Get the maximal number of lights turned on for a scene node with light culling.
+		virtual u32 getMaxLightsPerNode() const = 0;
+
+		//! Set or remove the mesh a scene node hides other nodes with.
+		/** Scene nodes with EAC_OCC_SOFTWARE in their automatic culling
+		are culled when they are completely hidden behind occluder meshes.
+		This works without occlusion queries of the driver, so also for the
+		null and software drivers, and without a frame of latency.
+		Before the nodes register for rendering, drawAll() rasterizes the
+		triangles of the meshes of all visible occluders in the scene with
+		the transformation of their nodes into a small depth buffer on the
+		CPU, see setOcclusionBufferSize(). The boxes of the culled nodes are
+		then tested against it. Occluders should be few and simple meshes
+		inside of large solid objects like walls, floors and buildings,
+		for example made with IMeshManipulator::createMeshSimplified().
+		The scene manager grabs the node and the mesh until the occluder is
+		removed or the scene is cleared.
+		\param node Node which hides other nodes.
+		\param mesh Mesh in the space of the node which is rasterized,
+		0 to remove the occluder. */
+		virtual void setOccluder(ISceneNode* node, IMesh* mesh) = 0;
+
+		//! Get the occluder mesh of a scene node.
+		/** \return The mesh set with setOccluder() or 0. */
+		virtual IMesh* getOccluder(const ISceneNode* node) const = 0;
+
+		//! Set the resolution of the depth buffer for EAC_OCC_SOFTWARE.
+		/** The depth buffer is stretched over the whole view. Higher
+		resolutions cull more exactly but need more time to rasterize the
+		occluders. Default is 256x128. */
+		virtual void setOcclusionBufferSize(const core::dimension2du& size) = 0;
+
+		//! Get the resolution of the depth buffer for EAC_OCC_SOFTWARE.
+		virtual const core::dimension2du& getOcclusionBufferSize() const = 0;
+
+		//! Get statistics of the last drawAll() call.
+		/** The counters are reset at the start of each drawAll() call and
+		filled while it registers and draws the nodes. They are always
+		collected, reading them costs nothing.
+		\return Numbers of registered, culled and drawn nodes, mesh
+		buffers, material changes and lights. */
+		virtual const SSceneStats& getSceneStats() const = 0;
 	};
 
 
@@ -17,6 +17,7 @@
 #include "matrix4.h"
 #include "irrList.h"
 #include "IAttributes.h"
+#include "irrObjectPool.h"
 
 namespace irr
 {
@@ -29,6 +30,17 @@ namespace scene
 	//! Typedef for list of scene node animators
 	typedef core::list<ISceneNodeAnimator*> ISceneNodeAnimatorList;
 
+	//! Changes of the scene graph passed up to the root scene node
+	enum E_SCENE_GRAPH_CHANGE
+	{
+		//! A node and its children were added to a parent
+		ESGC_ADDED = 0,
+		//! A node and its children are about to be removed from their parent
+		ESGC_REMOVED,
+		//! The name or id of a node changed
+		ESGC_RENAMED
+	};
+
 	//! Scene node interface.
 	/** A scene node is a node in the hierarchical scene graph. Every scene
 	node may have children, which are also scene nodes. Children move
@@ -37,7 +49,7 @@ namespace scene
 	example easily possible to attach a light to a moving car, or to place
 	a walking character on a moving platform on a moving ship.
 	*/
-	class ISceneNode : virtual public io::IAttributeExchangingObject
+	class ISceneNode : virtual public io::IAttributeExchangingObject, public core::SPooledObject
 	{
 	public:
 
@@ -49,7 +61,7 @@ namespace scene
 			: RelativeTranslation(position), RelativeRotation(rotation), RelativeScale(scale),
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
-				IsVisible(true), IsDebugObject(false)
+				IsVisible(true), IsDebugObject(false), TransformationDirty(true)
 		{
 			if (parent)
 				parent->addChild(this);
@@ -154,6 +166,8 @@ namespace scene
 		virtual void setName(const c8* name)
 		{
 			Name = name;
+			if (Parent)
+				Parent->onSceneGraphChange(this, ESGC_RENAMED);
 		}
 
 
@@ -162,6 +176,8 @@ namespace scene
 		virtual void setName(const core::stringc& name)
 		{
 			Name = name;
+			if (Parent)
+				Parent->onSceneGraphChange(this, ESGC_RENAMED);
 		}
 
 
@@ -285,6 +301,8 @@ namespace scene
 		virtual void setID(s32 id)
 		{
 			ID = id;
+			if (Parent)
+				Parent->onSceneGraphChange(this, ESGC_RENAMED);
 		}
 
 
@@ -304,6 +322,8 @@ namespace scene
 				child->remove(); // remove from old parent
 				Children.push_back(child);
 				child->Parent = this;
+				child->TransformationDirty = true;
+				onSceneGraphChange(child, ESGC_ADDED);
 			}
 		}
 
@@ -320,7 +340,9 @@ namespace scene
 			for (; it != Children.end(); ++it)
 				if ((*it) == child)
 				{
+					onSceneGraphChange(child, ESGC_REMOVED);
 					(*it)->Parent = 0;
+					(*it)->TransformationDirty = true;
 					(*it)->drop();
 					Children.erase(it);
 					return true;
@@ -339,7 +361,9 @@ namespace scene
 			ISceneNodeList::Iterator it = Children.begin();
 			for (; it != Children.end(); ++it)
 			{
+				onSceneGraphChange(*it, ESGC_REMOVED);
 				(*it)->Parent = 0;
+				(*it)->TransformationDirty = true;
 				(*it)->drop();
 			}
 
@@ -482,6 +506,7 @@ namespace scene
 		virtual void setScale(const core::vector3df& scale)
 		{
 			RelativeScale = scale;
+			TransformationDirty = true;
 		}
 
 
@@ -502,6 +527,7 @@ namespace scene
 		virtual void setRotation(const core::vector3df& rotation)
 		{
 			RelativeRotation = rotation;
+			TransformationDirty = true;
 		}
 
 
@@ -521,6 +547,7 @@ namespace scene
 		virtual void setPosition(const core::vector3df& newpos)
 		{
 			RelativeTranslation = newpos;
+			TransformationDirty = true;
 		}
 
 
@@ -661,16 +688,48 @@ namespace scene
 
 		//! Updates the absolute position based on the relative and the parents position
 		/** Note: This does not recursively update the parents absolute positions, so if you have a deeper
-			hierarchy you might want to update the parents first.*/
+			hierarchy you might want to update the parents first.
+			The absolute transformation is only recalculated when it was marked as changed
+			(see setTransformationDirty()). Each recalculation marks the children as changed.*/
 		virtual void updateAbsolutePosition()
 		{
+			if (!TransformationDirty)
+				return;
+
 			if (Parent)
-			{
-				AbsoluteTransformation =
-					Parent->getAbsoluteTransformation() * getRelativeTransformation();
-			}
+				AbsoluteTransformation = Parent->getAbsoluteTransformation() * getRelativeTransformation();
 			else
 				AbsoluteTransformation = getRelativeTransformation();
+
+			TransformationDirty = false;
+			setChildrenTransformationDirty();
+		}
+
+
+		//! Marks the relative transformation as changed.
+		/** updateAbsolutePosition() skips the calculation of the absolute
+		transformation for nodes which didn't change. setPosition(),
+		setRotation(), setScale(), changing the parent and a new absolute
+		transformation of the parent call this automatically. Scene nodes
+		which calculate their relative transformation in another way, for
+		example by overriding getRelativeTransformation(), have to call it
+		when that changes. */
+		void setTransformationDirty()
+		{
+			TransformationDirty = true;
+		}
+
+
+		//! Sets the absolute transformation directly.
+		/** It is kept until updateAbsolutePosition() recalculates it
+		because the relative transformation or the parent changed. The
+		scene manager uses this to draw interpolated transformations, see
+		ISceneManager::setAnimationTimeStep().
+		\param transformation New absolute transformation. */
+		void setAbsoluteTransformation(const core::matrix4& transformation)
+		{
+			AbsoluteTransformation = transformation;
+			setChildrenTransformationDirty();
 		}
 
 
@@ -728,6 +787,8 @@ namespace scene
 				return;
 			Name = in->getAttributeAsString("Name", Name);
 			ID = in->getAttributeAsInt("Id", ID);
+			if (Parent)
+				Parent->onSceneGraphChange(this, ESGC_RENAMED);
 
 			setPosition(in->getAttributeAsVector3d("Position", RelativeTranslation));
 			setRotation(in->getAttributeAsVector3d("Rotation", RelativeRotation));
@@ -765,6 +826,18 @@ namespace scene
 
 	protected:
 
+		//! Called when a node below this node was added, removed or renamed.
+		/** The call is passed on to the parent up to the root scene node,
+		which keeps the index used by ISceneManager::getSceneNodeFromId(),
+		getSceneNodeFromName() and getSceneNodeFromType() up to date.
+		\param node The changed node.
+		\param change What happened to the node. */
+		virtual void onSceneGraphChange(ISceneNode* node, E_SCENE_GRAPH_CHANGE change)
+		{
+			if (Parent)
+				Parent->onSceneGraphChange(node, change);
+		}
+
 		//! A clone function for the ISceneNode members.
 		/** This method can be used by clone() implementations of
 		derived classes
@@ -774,6 +847,7 @@ namespace scene
 		{
 			Name = toCopyFrom->Name;
 			AbsoluteTransformation = toCopyFrom->AbsoluteTransformation;
+			TransformationDirty = true;
 			RelativeTranslation = toCopyFrom->RelativeTranslation;
 			RelativeRotation = toCopyFrom->RelativeRotation;
 			RelativeScale = toCopyFrom->RelativeScale;
@@ -783,6 +857,8 @@ namespace scene
 			DebugDataVisible = toCopyFrom->DebugDataVisible;
 			IsVisible = toCopyFrom->IsVisible;
 			IsDebugObject = toCopyFrom->IsDebugObject;
+			if (Parent)
+				Parent->onSceneGraphChange(this, ESGC_RENAMED);
 
 			if (newManager)
 				SceneManager = newManager;
@@ -820,6 +896,14 @@ namespace scene
 				(*it)->setSceneManager(newManager);
 		}
 
+		//! Marks the children as changed after the absolute transformation changed
+		void setChildrenTransformationDirty()
+		{
+			ISceneNodeList::Iterator it = Children.begin();
+			for (; it != Children.end(); ++it)
+				(*it)->TransformationDirty = true;
+		}
+
 		//! Name of the scene node.
 		core::stringc Name;
 
@@ -864,6 +948,11 @@ namespace scene
 
 		//! Is debug object?
 		bool IsDebugObject;
+
+		//! Absolute transformation has to be recalculated
+		/** Set when the relative transformation, the parent or the absolute
+		transformation of the parent changed since the last update. */
+		bool TransformationDirty;
 	};
 
 
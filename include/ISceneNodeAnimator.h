@@ -11,6 +11,7 @@
 #include "IAttributeExchangingObject.h"
 #include "IAttributes.h"
 #include "IEventReceiver.h"
+#include "irrObjectPool.h"
 
 namespace irr
 {
@@ -28,7 +29,7 @@ namespace scene
 	change its position, rotation, scale and/or material. There are lots of animators
 	to choose from. You can create scene node animators with the ISceneManager interface.
 	*/
-	class ISceneNodeAnimator : public io::IAttributeExchangingObject, public IEventReceiver
+	class ISceneNodeAnimator : public io::IAttributeExchangingObject, public IEventReceiver, public core::SPooledObject
 	{
 	public:
 		ISceneNodeAnimator() : IsEnabled(true), PauseTimeSum(0), PauseTimeStart(0), StartTime(0)
@@ -66,6 +67,19 @@ namespace scene
 			return ESNAT_UNKNOWN;
 		}
 
+		//! Returns true if this animator can run at the same time as animators of other scene nodes.
+		/** Used by ISceneManager::setUseParallelAnimation(). Return true only
+		when animateNode only changes the animated node itself and this
+		animator, doesn't read other scene nodes, doesn't add or remove
+		scene nodes or animators and doesn't access the scene manager,
+		driver, cursor or other shared objects. Such an animator must not be
+		attached to more than one scene node.
+		\return False by default. */
+		virtual bool isThreadSafe() const
+		{
+			return false;
+		}
+
 		//! Returns if the animator has finished.
 		/** This is only valid for non-looping animators with a discrete end state.
 		\return true if the animator has finished, false if it is still running. */
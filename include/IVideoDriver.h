@@ -19,9 +19,12 @@
 #include "EDriverFeatures.h"
 #include "SExposedVideoData.h"
 #include "SOverrideMaterial.h"
+#include "SInstanceData.h"
 
 namespace irr
 {
+	class IJobSystem;
+
 namespace io
 {
 	class IAttributes;
@@ -48,6 +51,7 @@ namespace video
 	class IMaterialRenderer;
 	class IGPUProgrammingServices;
 	class IRenderTarget;
+	class ICommandList;
 
 	//! enumeration for geometry transformation states
 	enum E_TRANSFORMATION_STATE
@@ -993,6 +997,17 @@ namespace video
 		/** \param mb Buffer to draw */
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) =0;
 
+		//! Draws a mesh buffer several times with different transformations and colors
+		/** Each instance is drawn with the current world transformation
+		multiplied by the transformation of the instance, and with the
+		vertex colors multiplied by the color of the instance. Drivers
+		without hardware support loop over the instances internally.
+		\param mb Buffer to draw
+		\param instances Array with the data of each instance
+		\param instanceCount Number of elements in instances */
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const SInstanceData* instances, u32 instanceCount) =0;
+
 		//! Draws normals of a mesh buffer
 		/** \param mb Buffer to draw the normals of
 		\param length length scale factor of the normals
@@ -1057,6 +1072,13 @@ namespace video
 		\return Amount of primitives drawn in the last frame. */
 		virtual u32 getPrimitiveCountDrawn( u32 mode =0 ) const =0;
 
+		//! Returns the number of 3d primitive lists drawn since beginScene().
+		/** Each mesh buffer is drawn as one list, so this is about the
+		number of draw calls of the frame so far. Unlike
+		getPrimitiveCountDrawn() it can be read while drawing.
+		\return Number of drawVertexPrimitiveList() calls and mesh buffers drawn. */
+		virtual u32 getDrawCallCount() const =0;
+
 		//! Deletes all dynamic lights which were previously added with addDynamicLight().
 		virtual void deleteAllDynamicLights() =0;
 
@@ -1501,6 +1523,28 @@ namespace video
 		//! Check if the driver supports creating textures with the given color format
 		/**	\return True if the format is available, false if not. */
 		virtual bool queryTextureFormat(ECOLOR_FORMAT format) const = 0;
+
+		//! Set the job system used to split the work of the driver over threads.
+		/** The driver of a device uses IrrlichtDevice::getJobSystem() by
+		default. Burning's Video rasterizes bands of rows of the render
+		target on the worker threads when the job system has any, the
+		rendered images are the same as without worker threads. The
+		other drivers ignore the job system.
+		\param jobSystem The new job system, 0 to do all work on the calling thread. */
+		virtual void setJobSystem(IJobSystem* jobSystem) = 0;
+
+		//! Get the job system used by the driver.
+		virtual IJobSystem* getJobSystem() const = 0;
+
+		//! Creates a list which records calls to this driver to replay them later.
+		/** Draw with ICommandList::getRecorder() instead of this driver, for
+		example with ISceneManager::drawAll(video::IVideoDriver*), and replay
+		the list with ICommandList::replay() in each frame. Static scenes and
+		user interfaces are recorded once and drawn without visiting the scene
+		graph again. See ICommandList for the calls which are recorded.
+		\return The new command list. This pointer should be dropped when the
+		list is no longer needed. See IReferenceCounted::drop() for more information. */
+		virtual ICommandList* createCommandList() = 0;
 	};
 
 } // end namespace video
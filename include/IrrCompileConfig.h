@@ -133,6 +133,31 @@ while it runs and enabling it will slow down the engine. */
 #ifdef NO_IRR_COMPILE_WITH_PROFILING_
 #undef _IRR_COMPILE_WITH_PROFILING_
 #endif
+
+//! Use SSE2 intrinsics for batched calculations like culling
+/** Enabled when the compiler targets SSE2, which is always the case for x86-64.
+When the compiler also targets AVX (for example with -mavx) 8 values are
+processed at once where possible, integer calculations like the scanlines of
+Burning's Video need AVX2 (-mavx2) for that. Results are the same as the
+scalar code. */
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _IRR_COMPILE_WITH_SSE2_
+#endif
+#ifdef NO_IRR_COMPILE_WITH_SSE2_
+#undef _IRR_COMPILE_WITH_SSE2_
+#endif
+#if defined(_IRR_COMPILE_WITH_SSE2_) && defined(__AVX__)
+#define _IRR_COMPILE_WITH_AVX_
+#endif
+#ifdef NO_IRR_COMPILE_WITH_AVX_
+#undef _IRR_COMPILE_WITH_AVX_
+#endif
+#if defined(_IRR_COMPILE_WITH_AVX_) && defined(__AVX2__)
+#define _IRR_COMPILE_WITH_AVX2_
+#endif
+#ifdef NO_IRR_COMPILE_WITH_AVX2_
+#undef _IRR_COMPILE_WITH_AVX2_
+#endif
 
 //! Define _IRR_COMPILE_WITH_DIRECT3D_9_ to compile the Irrlicht engine with DIRECT3D9.
 /** If you only want to use the software device or opengl you can disable those defines.
@@ -355,6 +380,13 @@ tool <http://developer.nvidia.com/object/nvperfhud_home.html>. */
 #undef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 #endif
 
+//! Define _IRR_COMPILE_WITH_IRRB_SCENE_LOADER_ if you want to be able to load
+/** binary .irrb scenes using ISceneManager::loadScene */
+#define _IRR_COMPILE_WITH_IRRB_SCENE_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_IRRB_SCENE_LOADER_
+#undef _IRR_COMPILE_WITH_IRRB_SCENE_LOADER_
+#endif
+
 //! Define _IRR_COMPILE_WITH_SKINNED_MESH_SUPPORT_ if you want to use bone based
 /** animated meshes. If you compile without this, you will be unable to load
 B3D, MS3D or X meshes */
@@ -785,19 +817,5 @@ precision will be lower but speed higher. currently X86 only
   #define __has_feature(x) 0  // Compatibility with non-clang compilers.
 #endif
 
-#ifdef _DEBUG
-	//! A few attributes are written in CSceneManager when _IRR_SCENEMANAGER_DEBUG is enabled
-	// NOTE: Those attributes were used always until 1.8.0 and became a global define for 1.8.1
-	// which is only enabled in debug because it had a large (sometimes >5%) impact on speed.
-	// A better solution in the long run is to break the interface and remove _all_ attribute
-	// access in functions like CSceneManager::drawAll and instead put that information in some
-	// own struct/class or in CSceneManager.
-	// See http://irrlicht.sourceforge.net/forum/viewtopic.php?f=2&t=48211 for the discussion.
-	#define _IRR_SCENEMANAGER_DEBUG
-	#ifdef NO_IRR_SCENEMANAGER_DEBUG
-		#undef _IRR_SCENEMANAGER_DEBUG
-	#endif
-#endif
-
 #endif // __IRR_COMPILE_CONFIG_H_INCLUDED__
 
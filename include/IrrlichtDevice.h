@@ -21,6 +21,7 @@ namespace irr
 	class ILogger;
 	class IEventReceiver;
 	class IRandomizer;
+	class IJobSystem;
 
 	namespace io {
 		class IFileSystem;
@@ -136,6 +137,12 @@ namespace irr
 		\return Pointer to the ITimer object. */
 		virtual ITimer* getTimer() = 0;
 
+		//! Provides access to the engine's job system.
+		/** The job system runs work on a pool of worker threads. The
+		number of threads is set with SIrrlichtCreationParameters::JobThreads.
+		\return Pointer to the IJobSystem object. */
+		virtual IJobSystem* getJobSystem() = 0;
+
 		//! Provides access to the engine's currently set randomizer.
 		/** \return Pointer to the IRandomizer object. */
 		virtual IRandomizer* getRandomizer() const =0;
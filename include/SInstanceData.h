@@ -0,0 +1,34 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_INSTANCE_DATA_H_INCLUDED__
+#define __S_INSTANCE_DATA_H_INCLUDED__
+
+#include "matrix4.h"
+#include "SColor.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Data of one instance for IVideoDriver::drawMeshBufferInstanced
+struct SInstanceData
+{
+	SInstanceData() : Color(0xffffffff) {}
+
+	SInstanceData(const core::matrix4& transformation, SColor color)
+		: Transformation(transformation), Color(color) {}
+
+	//! Transformation of the instance, relative to the current world transformation
+	core::matrix4 Transformation;
+
+	//! Color which is multiplied with the vertex colors
+	SColor Color;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
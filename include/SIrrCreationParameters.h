@@ -47,6 +47,7 @@ namespace irr
 			DisplayAdapter(0),
 			DriverMultithreaded(false),
 			UsePerformanceTimer(true),
+			JobThreads(0),
 			SDK_version_do_not_use(IRRLICHT_SDK_VERSION)
 		{
 		}
@@ -79,6 +80,7 @@ namespace irr
 			DriverMultithreaded = other.DriverMultithreaded;
 			DisplayAdapter = other.DisplayAdapter;
 			UsePerformanceTimer = other.UsePerformanceTimer;
+			JobThreads = other.JobThreads;
 			return *this;
 		}
 
@@ -288,6 +290,14 @@ namespace irr
 		*/
 		bool UsePerformanceTimer;
 
+		//! Number of worker threads started for the job system.
+		/** The job system is used for optional parallel work like
+		ISceneManager::setUseParallelAnimation and the rasterizer of
+		Burning's Video, see IVideoDriver::setJobSystem. Default is 0, which runs
+		all jobs serially on the calling thread. A good value is the
+		number of cores minus one. */
+		u32 JobThreads;
+
 		//! Don't use or change this parameter.
 		/** Always set it to IRRLICHT_SDK_VERSION, which is done by default.
 		This is needed for sdk version checks. */
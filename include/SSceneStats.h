@@ -0,0 +1,85 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_SCENE_STATS_H_INCLUDED__
+#define __S_SCENE_STATS_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Counters of one render pass in SSceneStats
+	struct SRenderPassStats
+	{
+		SRenderPassStats() : Nodes(0), MeshBuffers(0), MaterialChanges(0) {}
+
+		//! Scene nodes drawn in the pass
+		u32 Nodes;
+
+		//! Mesh buffers and other primitive lists drawn by the nodes, see video::IVideoDriver::getDrawCallCount()
+		u32 MeshBuffers;
+
+		//! How often the material changed from one node to the next.
+		/** Nodes are compared by the parts of the material they are sorted
+		by: material type, textures and for solid nodes the main render
+		states. The first node of the pass counts as a change. Not counted
+		in the sky box and shadow passes, where nodes are not sorted. */
+		u32 MaterialChanges;
+	};
+
+	//! Statistics of a frame drawn by ISceneManager::drawAll().
+	/** Filled by each drawAll() call, with several views the counters of
+	all views are added up. Counting costs only a few increments, so it is
+	always done. See ISceneManager::getSceneStats(). */
+	struct SSceneStats
+	{
+		SSceneStats() : NodesRegistered(0), CulledBox(0), CulledFrustumBox(0),
+			CulledFrustumSphere(0), CulledOcclusionQuery(0), CulledOcclusionSoftware(0),
+			LightsUsed(0) {}
+
+		//! Scene nodes registered for rendering, including the culled ones.
+		/** Nodes in groups culled as a whole by the culling hierarchy, see
+		ISceneManager::setUseCullingHierarchy(), don't register. */
+		u32 NodesRegistered;
+
+		//! Nodes culled by EAC_BOX
+		u32 CulledBox;
+
+		//! Nodes culled by EAC_FRUSTUM_BOX
+		u32 CulledFrustumBox;
+
+		//! Nodes culled by EAC_FRUSTUM_SPHERE
+		u32 CulledFrustumSphere;
+
+		//! Nodes culled by EAC_OCC_QUERY
+		u32 CulledOcclusionQuery;
+
+		//! Nodes culled by EAC_OCC_SOFTWARE
+		u32 CulledOcclusionSoftware;
+
+		//! Lights added to the driver
+		u32 LightsUsed;
+
+		//! Counters of the render passes
+		SRenderPassStats SkyBox;
+		SRenderPassStats Solid;
+		SRenderPassStats Shadow;
+		SRenderPassStats Transparent;
+		SRenderPassStats TransparentEffect;
+
+		//! Get the number of culled nodes
+		u32 getCulledCount() const
+		{
+			return CulledBox + CulledFrustumBox + CulledFrustumSphere +
+				CulledOcclusionQuery + CulledOcclusionSoftware;
+		}
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,36 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_SCENE_VIEW_H_INCLUDED__
+#define __S_SCENE_VIEW_H_INCLUDED__
+
+#include "rect.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ICameraSceneNode;
+
+	//! A camera and the area of the render target it draws into.
+	/** Used for drawing the scene from several cameras with
+	ISceneManager::drawAll(const core::array<SSceneView>&). */
+	struct SSceneView
+	{
+		SSceneView() : Camera(0) {}
+
+		SSceneView(ICameraSceneNode* camera, const core::rect<s32>& viewport)
+			: Camera(camera), Viewport(viewport) {}
+
+		//! Camera of the view
+		ICameraSceneNode* Camera;
+
+		//! Viewport of the view, see video::IVideoDriver::setViewPort()
+		core::rect<s32> Viewport;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,89 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_OBJECT_POOL_H_INCLUDED__
+#define __IRR_OBJECT_POOL_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "irrTypes.h"
+#include <stddef.h>
+
+namespace irr
+{
+namespace core
+{
+	//! Enable or disable allocating scene nodes, animators and mesh buffers from pools.
+	/** The objects are allocated with their own operator new, which by
+	default uses the global operator new like all other objects. With pools,
+	objects of about the same size are put next to each other into large
+	slabs, each size class in its own slabs. This avoids fragmenting the
+	heap when many objects are created, like when loading a large scene,
+	and keeps nodes of the same type close together in memory for scene
+	traversal. Freed blocks are used again for new objects of their size
+	class, the slabs are kept until the program ends. Objects larger than
+	2 KB are always allocated with the global operator new.
+	The setting can be changed at any time and affects only objects created
+	afterwards. Objects are always freed the way they were allocated.
+	Disabled by default.
+	\param enable True to allocate from pools. */
+	IRRLICHT_API void IRRCALLCONV setUseObjectPools(bool enable);
+
+	//! Check if scene nodes, animators and mesh buffers are allocated from pools.
+	IRRLICHT_API bool IRRCALLCONV getUseObjectPools();
+
+	//! Allocates memory for an object from the pools.
+	/** Used by operator new of SPooledObject when the pools are enabled.
+	\param size Size of the object in bytes.
+	\return Pointer to memory for the object. */
+	IRRLICHT_API void* IRRCALLCONV allocatePooledObject(size_t size);
+
+	//! Frees memory of an object from the pools or from the global operator new.
+	/** Used by operator delete of SPooledObject once the pools were used.
+	\param ptr Pointer to the object, may be 0. */
+	IRRLICHT_API void IRRCALLCONV deallocatePooledObject(void* ptr);
+
+	//! State of the pools, checked by SPooledObject before calling into the library
+	struct SObjectPoolState
+	{
+		//! New objects are allocated from the pools
+		bool Enabled;
+
+		//! Some objects were allocated from the pools
+		bool Used;
+	};
+
+	//! Don't change it directly, use setUseObjectPools()
+	IRRLICHT_API extern SObjectPoolState ObjectPoolState;
+
+	//! Base of the classes whose objects can be allocated from pools
+	/** ISceneNode, ISceneNodeAnimator and IMeshBuffer derive from it, so all
+	their subclasses use it. As long as the pools were never enabled, the
+	objects are plain allocations of the global operators new and delete.
+	A class deriving from several of these bases finds the same static
+	operators in each, which is not ambiguous. */
+	struct SPooledObject
+	{
+		static void* operator new(size_t size)
+		{
+			if (!ObjectPoolState.Enabled)
+				return ::operator new(size);
+			return allocatePooledObject(size);
+		}
+
+		static void operator delete(void* ptr)
+		{
+			if (!ObjectPoolState.Used)
+				::operator delete(ptr);
+			else
+				deallocatePooledObject(ptr);
+		}
+
+		static void* operator new(size_t, void* place) { return place; }
+		static void operator delete(void*, void*) {}
+	};
+
+} // end namespace core
+} // end namespace irr
+
+#endif
+
@@ -49,6 +49,7 @@
 #include "EMaterialTypes.h"
 #include "EMeshWriterEnums.h"
 #include "EMessageBoxFlags.h"
+#include "EReadFileType.h"
 #include "ESceneNodeAnimatorTypes.h"
 #include "ESceneNodeTypes.h"
 #include "ETerrainElements.h"
@@ -64,6 +65,7 @@
 #include "IBillboardTextSceneNode.h"
 #include "IBoneSceneNode.h"
 #include "ICameraSceneNode.h"
+#include "ICommandList.h"
 #include "IContextManager.h"
 #include "ICursorControl.h"
 #include "IDummyTransformationSceneNode.h"
@@ -104,6 +106,9 @@
 #include "IImageLoader.h"
 #include "IImageWriter.h"
 #include "IIndexBuffer.h"
+#include "IInstancedMeshSceneNode.h"
+#include "IJobSystem.h"
+#include "ILODSceneNode.h"
 #include "ILightSceneNode.h"
 #include "ILogger.h"
 #include "IMaterialRenderer.h"
@@ -130,6 +135,7 @@
 #include "IrrlichtDevice.h"
 #include "irrList.h"
 #include "irrMap.h"
+#include "irrObjectPool.h"
 #include "irrMath.h"
 #include "irrString.h"
 #include "irrTypes.h"
@@ -175,6 +181,7 @@
 #include "SceneParameters.h"
 #include "SColor.h"
 #include "SExposedVideoData.h"
+#include "SInstanceData.h"
 #include "SIrrCreationParameters.h"
 #include "SKeyMap.h"
 #include "SLight.h"
@@ -184,6 +191,8 @@
 #include "SMeshBufferLightMap.h"
 #include "SMeshBufferTangents.h"
 #include "SParticle.h"
+#include "SSceneView.h"
+#include "SSceneStats.h"
 #include "SSharedMeshBuffer.h"
 #include "SSkinMeshBuffer.h"
 #include "SVertexIndex.h"
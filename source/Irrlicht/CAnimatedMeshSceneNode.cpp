@@ -1034,6 +1034,8 @@ void CAnimatedMeshSceneNode::checkJoints()
 
 		//Create joints for SkinnedMesh
 		((CSkinnedMesh*)Mesh)->addJoints(JointChildSceneNodes, this, SceneManager);
+		// the mesh may be shared and still animated to the frame of another node
+		((CSkinnedMesh*)Mesh)->animateMesh(getFrameNr(), 1.0f);
 		((CSkinnedMesh*)Mesh)->recoverJointsFromMesh(JointChildSceneNodes);
 
 		JointsUsed=true;
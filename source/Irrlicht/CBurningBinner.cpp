@@ -0,0 +1,312 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+#include "CBurningBinner.h"
+#include "CSoftwareDriver2.h"
+#include "CSoftwareTexture2.h"
+#include "IJobSystem.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Triangles recorded before they are drawn even without other flushes
+static const u32 MaxBinnedTriangles = 65536;
+
+CBurningBinner::CBurningBinner(CBurningVideoDriver* driver, IJobSystem* jobSystem)
+	: IBurningShader(driver), JobSystem(jobSystem), Shader(0),
+	BandCount(0), BandHeight(1), TargetHeight(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CBurningBinner");
+	#endif
+
+	JobSystem->grab();
+
+	for (u32 i=0; i!=ETR2_COUNT; ++i)
+		ShaderUsed[i] = false;
+}
+
+
+CBurningBinner::~CBurningBinner()
+{
+	for (u32 i=0; i<Textures.size(); ++i)
+		Textures[i]->drop();
+
+	// the shaders of the bands don't own their render target and textures
+	sInternalTexture none;
+	memset(&none, 0, sizeof(none));
+	for (u32 i=0; i<BandShaders.size(); ++i)
+	{
+		if (!BandShaders[i])
+			continue;
+
+		BandShaders[i]->setRasterTarget(0);
+		for (u32 m=0; m!=BURNING_MATERIAL_MAX_TEXTURES; ++m)
+			BandShaders[i]->setRasterTexture(m, none);
+		BandShaders[i]->drop();
+	}
+
+	JobSystem->drop();
+}
+
+
+//! Select the shader the following calls are recorded for
+void CBurningBinner::setShader(EBurningFFShader type, IBurningShader* shader)
+{
+	Shader = shader;
+	if (!ShaderUsed[type])
+	{
+		ShaderUsed[type] = true;
+		createBandShaders();
+	}
+
+	ShaderState.set_used(0);
+	addCommand(ECMD_SHADER, type);
+}
+
+
+void CBurningBinner::setRenderTarget(video::IImage* surface, const core::rect<s32>& viewPort)
+{
+	// keeps the surface alive until the next flush
+	IBurningShader::setRenderTarget(surface, viewPort);
+	Shader->setRenderTarget(surface, viewPort);
+	addCommand(ECMD_RENDER_TARGET, 0, 0.f, surface);
+}
+
+
+void CBurningBinner::setTextureParam(u32 stage, video::CSoftwareTexture2* texture, s32 lodLevel)
+{
+	if (texture && texture != IT[stage].Texture)
+	{
+		texture->grab();
+		Textures.push_back(texture);
+	}
+
+	// the mip map level is selected here, the bands only copy the result
+	IBurningShader::setTextureParam(stage, texture, lodLevel);
+}
+
+
+void CBurningBinner::setParam(u32 index, f32 value)
+{
+	Shader->setParam(index, value);
+	addCommand(ECMD_PARAM, index, value);
+}
+
+
+void CBurningBinner::setZCompareFunc(u32 func)
+{
+	Shader->setZCompareFunc(func);
+	addCommand(ECMD_Z_COMPARE, func);
+}
+
+
+void CBurningBinner::setMaterial(const SBurningShaderMaterial &material)
+{
+	Shader->setMaterial(material);
+	ShaderMaterial = material;
+	addCommand(ECMD_MATERIAL, Materials.size());
+	Materials.push_back(material);
+}
+
+
+void CBurningBinner::addCommand(E_COMMAND type, u32 value, f32 param, video::IImage* target)
+{
+	SCommand command;
+	command.Type = type;
+	command.Value = value;
+	command.Param = param;
+	command.Target = target;
+	Commands.push_back(command);
+
+	// only the last value of each state is needed after a flush
+	for (u32 i=0; i<ShaderState.size(); ++i)
+	{
+		if (ShaderState[i].Type == type && (type != ECMD_PARAM || ShaderState[i].Value == value))
+		{
+			ShaderState[i] = command;
+			return;
+		}
+	}
+	ShaderState.push_back(command);
+}
+
+
+void CBurningBinner::drawTriangle(const s4DVertex *a, const s4DVertex *b, const s4DVertex *c)
+{
+	if (!RenderTarget)
+		return;
+
+	if (Triangles.empty())
+		setBands(RenderTarget->getDimension().Height);
+
+	// rows covered with the top-left fill convention of the shaders
+	const s32 yStart = core::s32_max(core::ceil32(core::min_(a->Pos.y, b->Pos.y, c->Pos.y)), 0);
+	const s32 yEnd = core::s32_min(core::ceil32(core::max_(a->Pos.y, b->Pos.y, c->Pos.y)) - 1, (s32)TargetHeight - 1);
+	if (yEnd < yStart)
+		return;
+
+	const u32 index = Triangles.size();
+	if (Triangles.allocated_size() == index)
+		Triangles.reallocate(index ? index * 2 : 1024);
+	Triangles.set_used(index + 1);
+
+	STriangle& triangle = Triangles[index];
+	triangle.Command = Commands.size();
+	for (u32 m=0; m!=BURNING_MATERIAL_MAX_TEXTURES; ++m)
+		triangle.Texture[m] = IT[m];
+	triangle.Vertex[0] = *a;
+	triangle.Vertex[1] = *b;
+	triangle.Vertex[2] = *c;
+
+	const u32 last = (u32)yEnd / BandHeight;
+	for (u32 band = (u32)yStart / BandHeight; band <= last; ++band)
+		Bins[band].push_back(index);
+
+	if (Triangles.size() >= MaxBinnedTriangles)
+		flush();
+}
+
+
+//! Draw all recorded triangles.
+void CBurningBinner::flush()
+{
+	if (!Triangles.empty())
+	{
+		JobSystem->parallelFor(BandCount, drawBandJob, this);
+
+		// the depth tiles were tested before the triangles were drawn
+		if (DepthBuffer)
+			DepthBuffer->invalidate();
+	}
+
+	Commands.set_used(0);
+	Materials.set_used(0);
+	Triangles.set_used(0);
+	for (u32 i=0; i<Bins.size(); ++i)
+		Bins[i].set_used(0);
+
+	for (u32 i=0; i<Textures.size(); ++i)
+		Textures[i]->drop();
+	Textures.set_used(0);
+
+	// the current textures might be replaced after the next triangles
+	for (u32 m=0; m!=BURNING_MATERIAL_MAX_TEXTURES; ++m)
+	{
+		if (IT[m].Texture)
+		{
+			IT[m].Texture->grab();
+			Textures.push_back(IT[m].Texture);
+		}
+	}
+
+	// restore the state of the current shader for the next triangles
+	for (u32 i=0; i<ShaderState.size(); ++i)
+	{
+		SCommand& command = ShaderState[i];
+		if (command.Type == ECMD_MATERIAL)
+		{
+			command.Value = Materials.size();
+			Materials.push_back(ShaderMaterial);
+		}
+		Commands.push_back(command);
+	}
+}
+
+
+//! Splits the render target into bands for the triangles of the next flush
+void CBurningBinner::setBands(u32 height)
+{
+	// a few bands per thread balance the work, but with at least 8 rows
+	const u32 threads = JobSystem->getWorkerCount() + 1;
+	TargetHeight = height;
+	BandHeight = core::max_((height + threads * 4 - 1) / (threads * 4), 8u);
+	BandCount = core::max_((height + BandHeight - 1) / BandHeight, 1u);
+
+	while (Bins.size() < BandCount)
+		Bins.push_back(core::array<u32>());
+
+	while (BandShaders.size() < BandCount * ETR2_COUNT)
+		BandShaders.push_back(0);
+
+	createBandShaders();
+}
+
+
+//! Creates the shaders of the bands for all shader types in use
+void CBurningBinner::createBandShaders()
+{
+	for (u32 band=0; band<BandCount; ++band)
+	{
+		for (u32 type=0; type!=ETR2_COUNT; ++type)
+		{
+			IBurningShader*& shader = BandShaders[band * ETR2_COUNT + type];
+			if (ShaderUsed[type] && !shader)
+				shader = Driver->createShader((EBurningFFShader) type);
+		}
+	}
+}
+
+
+void CBurningBinner::drawBandJob(void* userData, u32 index)
+{
+	((CBurningBinner*) userData)->drawBand(index);
+}
+
+
+//! Replays the commands and draws the triangles of a band
+void CBurningBinner::drawBand(u32 band)
+{
+	const core::array<u32>& bin = Bins[band];
+	IBurningShader** shaders = BandShaders.pointer() + band * ETR2_COUNT;
+	IBurningShader* shader = 0;
+
+	// the outer bands take the rows clipping might leave outside of the target
+	const s32 start = band ? band * BandHeight : -0x7fffffff;
+	const s32 end = band + 1 == BandCount ? 0x7fffffff : (band + 1) * BandHeight;
+
+	u32 command = 0;
+	for (u32 i=0; i<bin.size(); ++i)
+	{
+		const STriangle& triangle = Triangles[bin[i]];
+
+		for (; command < triangle.Command; ++command)
+		{
+			const SCommand& c = Commands[command];
+			switch (c.Type)
+			{
+			case ECMD_SHADER:
+				shader = shaders[c.Value];
+				shader->setBand(start, end);
+				break;
+			case ECMD_RENDER_TARGET:
+				shader->setRasterTarget(c.Target);
+				break;
+			case ECMD_Z_COMPARE:
+				shader->setZCompareFunc(c.Value);
+				break;
+			case ECMD_MATERIAL:
+				shader->setMaterial(Materials[c.Value]);
+				break;
+			case ECMD_PARAM:
+				shader->setParam(c.Value, c.Param);
+				break;
+			}
+		}
+
+		for (u32 m=0; m!=BURNING_MATERIAL_MAX_TEXTURES; ++m)
+			shader->setRasterTexture(m, triangle.Texture[m]);
+		shader->drawTriangle(triangle.Vertex, triangle.Vertex + 1, triangle.Vertex + 2);
+	}
+}
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
@@ -0,0 +1,125 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BURNING_BINNER_H_INCLUDED__
+#define __C_BURNING_BINNER_H_INCLUDED__
+
+#include "IBurningShader.h"
+
+namespace irr
+{
+class IJobSystem;
+
+namespace video
+{
+
+	//! Collects the triangles of Burning's Video and rasterizes them on several threads.
+	/** Used as current shader of the driver while its job system has worker
+	threads. The state changes of the shaders are recorded in order, the
+	triangles are copied with their textures and sorted into bands of rows of
+	the render target which they cover. flush() draws the bands in parallel.
+	Each band has its own copies of the shaders, which get the recorded state
+	changes and draw the triangles of the band restricted to its rows. Every
+	pixel is drawn by the same scanline code from the same triangles in the
+	same order, so the image is the same as when drawing directly.
+	Bands are whole rows because the scanlines interpolate from their left
+	end, tiles of columns would change the rounding. */
+	class CBurningBinner : public IBurningShader
+	{
+	public:
+
+		CBurningBinner(CBurningVideoDriver* driver, IJobSystem* jobSystem);
+
+		virtual ~CBurningBinner();
+
+		//! Select the shader the following calls are recorded for
+		/** \param type Type of the shader.
+		\param shader Shader of the driver, gets the state changes as well. */
+		void setShader(EBurningFFShader type, IBurningShader* shader);
+
+		//! Draw all recorded triangles.
+		/** Has to be called before anything else draws into the render target
+		or the depth and stencil buffers, and before the render target changes. */
+		void flush();
+
+		virtual void setRenderTarget(video::IImage* surface, const core::rect<s32>& viewPort) _IRR_OVERRIDE_;
+		virtual void setTextureParam(u32 stage, video::CSoftwareTexture2* texture, s32 lodLevel) _IRR_OVERRIDE_;
+		virtual void drawTriangle(const s4DVertex *a, const s4DVertex *b, const s4DVertex *c) _IRR_OVERRIDE_;
+		virtual void setParam(u32 index, f32 value) _IRR_OVERRIDE_;
+		virtual void setZCompareFunc(u32 func) _IRR_OVERRIDE_;
+		virtual void setMaterial(const SBurningShaderMaterial &material) _IRR_OVERRIDE_;
+
+	private:
+
+		enum E_COMMAND
+		{
+			ECMD_SHADER = 0,
+			ECMD_RENDER_TARGET,
+			ECMD_Z_COMPARE,
+			ECMD_MATERIAL,
+			ECMD_PARAM
+		};
+
+		struct SCommand
+		{
+			E_COMMAND Type;
+			//! shader type, z compare function, material or param index
+			u32 Value;
+			f32 Param;
+			video::IImage* Target;
+		};
+
+		struct STriangle
+		{
+			//! Number of commands recorded before the triangle
+			u32 Command;
+			sInternalTexture Texture[BURNING_MATERIAL_MAX_TEXTURES];
+			s4DVertex Vertex[3];
+		};
+
+		//! Records a state change of the current shader
+		void addCommand(E_COMMAND type, u32 value, f32 param=0.f, video::IImage* target=0);
+
+		//! Splits the render target into bands for the triangles of the next flush
+		void setBands(u32 height);
+
+		//! Creates the shaders of the bands for all shader types in use
+		void createBandShaders();
+
+		static void drawBandJob(void* userData, u32 index);
+
+		//! Replays the commands and draws the triangles of a band
+		void drawBand(u32 band);
+
+		IJobSystem* JobSystem;
+
+		//! The shader of the driver which is recorded
+		IBurningShader* Shader;
+
+		core::array<SCommand> Commands;
+		core::array<SBurningShaderMaterial> Materials;
+		core::array<STriangle> Triangles;
+
+		//! Indices of the triangles drawn by each band
+		core::array<core::array<u32> > Bins;
+
+		//! Commands since the shader was selected, recorded again after a flush
+		core::array<SCommand> ShaderState;
+		SBurningShaderMaterial ShaderMaterial;
+
+		//! Textures of the recorded triangles, grabbed until they are drawn
+		core::array<video::CSoftwareTexture2*> Textures;
+
+		//! Shaders of the bands, ETR2_COUNT for each band
+		core::array<IBurningShader*> BandShaders;
+		bool ShaderUsed[ETR2_COUNT];
+
+		u32 BandCount;
+		u32 BandHeight;
+		u32 TargetHeight;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -976,7 +976,8 @@ void CBurningShader_Raster_Reference::drawTriangle ( const s4DVertex *a,const s4
 			}
 
 			// render a scanline
-			scanline ();
+			if ( inBand ( line.y ) )
+				scanline ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -1091,7 +1092,8 @@ void CBurningShader_Raster_Reference::drawTriangle ( const s4DVertex *a,const s4
 			}
 
 			// render a scanline
-			scanline ();
+			if ( inBand ( line.y ) )
+				scanline ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
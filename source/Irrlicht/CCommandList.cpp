@@ -0,0 +1,680 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CCommandList.h"
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+	//! Number of indices read by a primitive list
+	u32 getIndexCount(scene::E_PRIMITIVE_TYPE pType, u32 primitiveCount)
+	{
+		switch (pType)
+		{
+		case scene::EPT_LINE_STRIP:
+			return primitiveCount + 1;
+		case scene::EPT_LINES:
+			return primitiveCount * 2;
+		case scene::EPT_TRIANGLE_STRIP:
+		case scene::EPT_TRIANGLE_FAN:
+			return primitiveCount + 2;
+		case scene::EPT_TRIANGLES:
+			return primitiveCount * 3;
+		case scene::EPT_QUAD_STRIP:
+			return primitiveCount * 2 + 2;
+		case scene::EPT_QUADS:
+			return primitiveCount * 4;
+		default:
+			// points, point sprites, line loops and polygons
+			return primitiveCount;
+		}
+	}
+
+	//! Makes room for size more bytes at the end of an array, returns the first new byte
+	/** Grows the array like push_back does, set_used alone would
+	reallocate for each command. */
+	u8* appendBytes(core::array<u8>& bytes, u32 size)
+	{
+		const u32 used = bytes.size();
+		if (used + size > bytes.allocated_size())
+			bytes.reallocate(core::max_(used + size, bytes.allocated_size() * 2, 256u));
+		bytes.set_used(used + size);
+		return bytes.pointer() + used;
+	}
+
+	//! Copies the arguments of a command out of the stream
+	template <class T>
+	inline void readArguments(const u8*& stream, T& arguments)
+	{
+		memcpy(static_cast<void*>(&arguments), stream, sizeof(T));
+		stream += sizeof(T);
+	}
+}
+
+
+//! constructor
+CCommandList::CCommandList(IVideoDriver* driver, io::IFileSystem* io)
+	: CNullDriver(io, driver->getScreenSize()), Driver(driver), CommandCount(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CCommandList");
+	#endif
+
+	Driver->grab();
+
+	ViewPort = Driver->getViewPort();
+	for (u32 i=0; i<ETS_COUNT; ++i)
+		Transforms[i] = Driver->getTransform((E_TRANSFORMATION_STATE)i);
+}
+
+
+//! destructor
+CCommandList::~CCommandList()
+{
+	clear();
+	Driver->drop();
+}
+
+
+//! Removes all recorded calls and releases the referenced textures.
+void CCommandList::clear()
+{
+	for (u32 i=0; i<Textures.size(); ++i)
+		Textures[i]->drop();
+	Textures.clear();
+
+	Commands.clear();
+	Data.clear();
+	DataBlocks.clear();
+	Materials.clear();
+	ShadowVolumes.clear();
+	Lights.set_used(0);
+	CommandCount = 0;
+}
+
+
+//! Get the memory used by the recorded calls.
+u32 CCommandList::getSize() const
+{
+	u32 size = Commands.size() + Data.size() + Materials.size() * sizeof(SMaterial);
+	for (u32 i=0; i<ShadowVolumes.size(); ++i)
+		size += ShadowVolumes[i].size() * sizeof(core::vector3df);
+	return size;
+}
+
+
+//! Sends the recorded calls to a driver.
+void CCommandList::replay(IVideoDriver* driver) const
+{
+	if (!driver)
+		return;
+
+	const u8* stream = Commands.const_pointer();
+	const u8* const end = stream + Commands.size();
+	const u8* const data = Data.const_pointer();
+
+	while (stream < end)
+	{
+		const E_COMMAND command = (E_COMMAND)*stream++;
+		switch (command)
+		{
+		case ECMD_SET_TRANSFORM:
+			{
+				SSetTransform c;
+				readArguments(stream, c);
+				driver->setTransform((E_TRANSFORMATION_STATE)c.State, c.Matrix);
+			}
+			break;
+		case ECMD_SET_MATERIAL:
+			{
+				u32 material;
+				readArguments(stream, material);
+				driver->setMaterial(Materials[material]);
+			}
+			break;
+		case ECMD_SET_VIEWPORT:
+			{
+				core::rect<s32> area;
+				readArguments(stream, area);
+				driver->setViewPort(area);
+			}
+			break;
+		case ECMD_DRAW_PRIMITIVES:
+		case ECMD_DRAW_2D_PRIMITIVES:
+			{
+				SDrawPrimitives c;
+				readArguments(stream, c);
+				const void* indices = (c.IndexOffset != 0xffffffff) ? data + c.IndexOffset : 0;
+				if (command == ECMD_DRAW_PRIMITIVES)
+					driver->drawVertexPrimitiveList(data + c.VertexOffset, c.VertexCount, indices, c.PrimitiveCount,
+						(E_VERTEX_TYPE)c.VertexType, (scene::E_PRIMITIVE_TYPE)c.PrimitiveType, (E_INDEX_TYPE)c.IndexType);
+				else
+					driver->draw2DVertexPrimitiveList(data + c.VertexOffset, c.VertexCount, indices, c.PrimitiveCount,
+						(E_VERTEX_TYPE)c.VertexType, (scene::E_PRIMITIVE_TYPE)c.PrimitiveType, (E_INDEX_TYPE)c.IndexType);
+			}
+			break;
+		case ECMD_DRAW_3D_LINE:
+			{
+				SDraw3DLine c;
+				readArguments(stream, c);
+				driver->draw3DLine(c.Start, c.End, c.Color);
+			}
+			break;
+		case ECMD_DRAW_2D_IMAGE:
+			{
+				SDraw2DImage c;
+				readArguments(stream, c);
+				driver->draw2DImage(c.Texture, c.Pos, c.SourceRect, c.Clip ? &c.ClipRect : 0, c.Color, c.UseAlpha);
+			}
+			break;
+		case ECMD_DRAW_2D_IMAGE_RECT:
+			{
+				SDraw2DImageRect c;
+				readArguments(stream, c);
+				driver->draw2DImage(c.Texture, c.DestRect, c.SourceRect, c.Clip ? &c.ClipRect : 0,
+					c.UseColors ? c.Colors : 0, c.UseAlpha);
+			}
+			break;
+		case ECMD_DRAW_2D_RECTANGLE:
+			{
+				SDraw2DRectangle c;
+				readArguments(stream, c);
+				driver->draw2DRectangle(c.Pos, c.Colors[0], c.Colors[1], c.Colors[2], c.Colors[3],
+					c.Clip ? &c.ClipRect : 0);
+			}
+			break;
+		case ECMD_DRAW_2D_LINE:
+			{
+				SDraw2DLine c;
+				readArguments(stream, c);
+				driver->draw2DLine(c.Start, c.End, c.Color);
+			}
+			break;
+		case ECMD_DRAW_PIXEL:
+			{
+				SDrawPixel c;
+				readArguments(stream, c);
+				driver->drawPixel(c.X, c.Y, c.Color);
+			}
+			break;
+		case ECMD_DELETE_LIGHTS:
+			driver->deleteAllDynamicLights();
+			break;
+		case ECMD_ADD_LIGHT:
+			{
+				SLight light;
+				readArguments(stream, light);
+				driver->addDynamicLight(light);
+			}
+			break;
+		case ECMD_TURN_LIGHT_ON:
+			{
+				STurnLightOn c;
+				readArguments(stream, c);
+				driver->turnLightOn(c.Index, c.TurnOn);
+			}
+			break;
+		case ECMD_SET_AMBIENT_LIGHT:
+			{
+				SColorf color;
+				readArguments(stream, color);
+				driver->setAmbientLight(color);
+			}
+			break;
+		case ECMD_DRAW_SHADOW_VOLUME:
+			{
+				SDrawShadowVolume c;
+				readArguments(stream, c);
+				driver->drawStencilShadowVolume(ShadowVolumes[c.Volume], c.ZFail, c.DebugDataVisible);
+			}
+			break;
+		case ECMD_DRAW_SHADOW:
+			{
+				SDrawShadow c;
+				readArguments(stream, c);
+				driver->drawStencilShadow(c.ClearStencilBuffer, c.Colors[0], c.Colors[1], c.Colors[2], c.Colors[3]);
+			}
+			break;
+		}
+	}
+}
+
+
+//! appends a command and its arguments to the stream
+template <class T>
+void CCommandList::addCommand(E_COMMAND command, const T& arguments)
+{
+	u8* stream = appendBytes(Commands, 1 + sizeof(T));
+	*stream = (u8)command;
+	memcpy(stream + 1, &arguments, sizeof(T));
+	++CommandCount;
+}
+
+
+//! appends a command without arguments to the stream
+void CCommandList::addCommand(E_COMMAND command)
+{
+	*appendBytes(Commands, 1) = (u8)command;
+	++CommandCount;
+}
+
+
+//! copies vertices or indices into Data, returns their offset
+u32 CCommandList::addData(const void* data, u32 size)
+{
+	core::map<const void*, SDataBlock>::Node* node = DataBlocks.find(data);
+	if (node)
+	{
+		const SDataBlock& block = node->getValue();
+		if (block.Size == size && !memcmp(Data.const_pointer() + block.Offset, data, size))
+			return block.Offset;
+	}
+
+	// keep the blocks aligned for the vertex transformations
+	const u32 padding = (16 - (Data.size() & 15)) & 15;
+	u8* target = appendBytes(Data, padding + size) + padding;
+	memcpy(target, data, size);
+
+	SDataBlock block;
+	block.Offset = (u32)(target - Data.const_pointer());
+	block.Size = size;
+	DataBlocks.set(data, block);
+	return block.Offset;
+}
+
+
+//! grabs a texture until the list is cleared
+void CCommandList::grabTexture(const ITexture* texture)
+{
+	if (!texture)
+		return;
+
+	ITexture* t = const_cast<ITexture*>(texture);
+	t->grab();
+	Textures.push_back(t);
+}
+
+
+void CCommandList::setTransform(E_TRANSFORMATION_STATE state, const core::matrix4& mat)
+{
+	Transforms[state] = mat;
+
+	SSetTransform c;
+	c.State = state;
+	c.Matrix = mat;
+	addCommand(ECMD_SET_TRANSFORM, c);
+}
+
+
+const core::matrix4& CCommandList::getTransform(E_TRANSFORMATION_STATE state) const
+{
+	return Transforms[state];
+}
+
+
+void CCommandList::setMaterial(const SMaterial& material)
+{
+	// nodes often set the same material for each of their mesh buffers
+	if (Materials.empty() || Materials.getLast() != material)
+	{
+		Materials.push_back(material);
+		for (u32 i=0; i<MATERIAL_MAX_TEXTURES; ++i)
+			grabTexture(material.getTexture(i));
+	}
+
+	addCommand(ECMD_SET_MATERIAL, Materials.size() - 1);
+}
+
+
+void CCommandList::setViewPort(const core::rect<s32>& area)
+{
+	ViewPort = area;
+	addCommand(ECMD_SET_VIEWPORT, area);
+}
+
+
+void CCommandList::addPrimitives(E_COMMAND command, const void* vertices, u32 vertexCount,
+		const void* indexList, u32 primitiveCount,
+		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	if (!vertices || !vertexCount || !primitiveCount)
+		return;
+
+	SDrawPrimitives c;
+	c.VertexOffset = addData(vertices, vertexCount * getVertexPitchFromType(vType));
+	c.VertexCount = vertexCount;
+	c.IndexOffset = indexList ? addData(indexList,
+		getIndexCount(pType, primitiveCount) * (iType == EIT_16BIT ? sizeof(u16) : sizeof(u32))) : 0xffffffff;
+	c.PrimitiveCount = primitiveCount;
+	c.VertexType = (u8)vType;
+	c.PrimitiveType = (u8)pType;
+	c.IndexType = (u8)iType;
+	addCommand(command, c);
+}
+
+
+void CCommandList::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
+		const void* indexList, u32 primitiveCount,
+		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	CNullDriver::drawVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
+	addPrimitives(ECMD_DRAW_PRIMITIVES, vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
+}
+
+
+void CCommandList::draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
+		const void* indexList, u32 primitiveCount,
+		E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+{
+	CNullDriver::draw2DVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
+	addPrimitives(ECMD_DRAW_2D_PRIMITIVES, vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
+}
+
+
+void CCommandList::draw3DLine(const core::vector3df& start,
+		const core::vector3df& end, SColor color)
+{
+	SDraw3DLine c;
+	c.Start = start;
+	c.End = end;
+	c.Color = color;
+	addCommand(ECMD_DRAW_3D_LINE, c);
+}
+
+
+void CCommandList::draw2DImage(const video::ITexture* texture, const core::position2d<s32>& destPos,
+		const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect,
+		SColor color, bool useAlphaChannelOfTexture)
+{
+	if (!texture)
+		return;
+
+	grabTexture(texture);
+
+	SDraw2DImage c;
+	c.Texture = texture;
+	c.Pos = destPos;
+	c.SourceRect = sourceRect;
+	c.Clip = clipRect != 0;
+	if (clipRect)
+		c.ClipRect = *clipRect;
+	c.Color = color;
+	c.UseAlpha = useAlphaChannelOfTexture;
+	addCommand(ECMD_DRAW_2D_IMAGE, c);
+}
+
+
+void CCommandList::draw2DImage(const video::ITexture* texture, const core::rect<s32>& destRect,
+		const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect,
+		const video::SColor* const colors, bool useAlphaChannelOfTexture)
+{
+	if (!texture)
+		return;
+
+	grabTexture(texture);
+
+	SDraw2DImageRect c;
+	c.Texture = texture;
+	c.DestRect = destRect;
+	c.SourceRect = sourceRect;
+	c.Clip = clipRect != 0;
+	if (clipRect)
+		c.ClipRect = *clipRect;
+	c.UseColors = colors != 0;
+	if (colors)
+	{
+		for (u32 i=0; i<4; ++i)
+			c.Colors[i] = colors[i];
+	}
+	c.UseAlpha = useAlphaChannelOfTexture;
+	addCommand(ECMD_DRAW_2D_IMAGE_RECT, c);
+}
+
+
+void CCommandList::draw2DRectangle(const core::rect<s32>& pos,
+		SColor colorLeftUp, SColor colorRightUp, SColor colorLeftDown, SColor colorRightDown,
+		const core::rect<s32>* clip)
+{
+	SDraw2DRectangle c;
+	c.Pos = pos;
+	c.Clip = clip != 0;
+	if (clip)
+		c.ClipRect = *clip;
+	c.Colors[0] = colorLeftUp;
+	c.Colors[1] = colorRightUp;
+	c.Colors[2] = colorLeftDown;
+	c.Colors[3] = colorRightDown;
+	addCommand(ECMD_DRAW_2D_RECTANGLE, c);
+}
+
+
+void CCommandList::draw2DLine(const core::position2d<s32>& start,
+		const core::position2d<s32>& end, SColor color)
+{
+	SDraw2DLine c;
+	c.Start = start;
+	c.End = end;
+	c.Color = color;
+	addCommand(ECMD_DRAW_2D_LINE, c);
+}
+
+
+void CCommandList::drawPixel(u32 x, u32 y, const SColor & color)
+{
+	SDrawPixel c;
+	c.X = x;
+	c.Y = y;
+	c.Color = color;
+	addCommand(ECMD_DRAW_PIXEL, c);
+}
+
+
+void CCommandList::deleteAllDynamicLights()
+{
+	CNullDriver::deleteAllDynamicLights();
+	addCommand(ECMD_DELETE_LIGHTS);
+}
+
+
+s32 CCommandList::addDynamicLight(const SLight& light)
+{
+	addCommand(ECMD_ADD_LIGHT, light);
+	return CNullDriver::addDynamicLight(light);
+}
+
+
+void CCommandList::turnLightOn(s32 lightIndex, bool turnOn)
+{
+	STurnLightOn c;
+	c.Index = lightIndex;
+	c.TurnOn = turnOn;
+	addCommand(ECMD_TURN_LIGHT_ON, c);
+}
+
+
+void CCommandList::setAmbientLight(const SColorf& color)
+{
+	addCommand(ECMD_SET_AMBIENT_LIGHT, color);
+}
+
+
+void CCommandList::drawStencilShadowVolume(const core::array<core::vector3df>& triangles,
+		bool zfail, u32 debugDataVisible)
+{
+	if (triangles.empty())
+		return;
+
+	SDrawShadowVolume c;
+	c.Volume = ShadowVolumes.size();
+	c.DebugDataVisible = debugDataVisible;
+	c.ZFail = zfail;
+	ShadowVolumes.push_back(triangles);
+	addCommand(ECMD_DRAW_SHADOW_VOLUME, c);
+}
+
+
+void CCommandList::drawStencilShadow(bool clearStencilBuffer,
+		video::SColor leftUpEdge, video::SColor rightUpEdge,
+		video::SColor leftDownEdge, video::SColor rightDownEdge)
+{
+	SDrawShadow c;
+	c.Colors[0] = leftUpEdge;
+	c.Colors[1] = rightUpEdge;
+	c.Colors[2] = leftDownEdge;
+	c.Colors[3] = rightDownEdge;
+	c.ClearStencilBuffer = clearStencilBuffer;
+	addCommand(ECMD_DRAW_SHADOW, c);
+}
+
+
+bool CCommandList::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
+{
+	return Driver->queryFeature(feature);
+}
+
+
+const io::IAttributes& CCommandList::getDriverAttributes() const
+{
+	return Driver->getDriverAttributes();
+}
+
+
+E_DRIVER_TYPE CCommandList::getDriverType() const
+{
+	return Driver->getDriverType();
+}
+
+
+ECOLOR_FORMAT CCommandList::getColorFormat() const
+{
+	return Driver->getColorFormat();
+}
+
+
+const core::dimension2d<u32>& CCommandList::getScreenSize() const
+{
+	return Driver->getScreenSize();
+}
+
+
+const core::dimension2d<u32>& CCommandList::getCurrentRenderTargetSize() const
+{
+	return Driver->getCurrentRenderTargetSize();
+}
+
+
+u32 CCommandList::getMaximalDynamicLightAmount() const
+{
+	return Driver->getMaximalDynamicLightAmount();
+}
+
+
+u32 CCommandList::getMaximalPrimitiveCount() const
+{
+	return Driver->getMaximalPrimitiveCount();
+}
+
+
+ITexture* CCommandList::getTexture(const io::path& filename)
+{
+	return Driver->getTexture(filename);
+}
+
+
+ITexture* CCommandList::getTexture(io::IReadFile* file)
+{
+	return Driver->getTexture(file);
+}
+
+
+ITexture* CCommandList::getTextureByIndex(u32 index)
+{
+	return Driver->getTextureByIndex(index);
+}
+
+
+u32 CCommandList::getTextureCount() const
+{
+	return Driver->getTextureCount();
+}
+
+
+ITexture* CCommandList::findTexture(const io::path& filename)
+{
+	return Driver->findTexture(filename);
+}
+
+
+ITexture* CCommandList::addTexture(const core::dimension2d<u32>& size, const io::path& name, ECOLOR_FORMAT format)
+{
+	return Driver->addTexture(size, name, format);
+}
+
+
+ITexture* CCommandList::addTexture(const io::path& name, IImage* image)
+{
+	return Driver->addTexture(name, image);
+}
+
+
+ITexture* CCommandList::addRenderTargetTexture(const core::dimension2d<u32>& size,
+		const io::path& name, const ECOLOR_FORMAT format)
+{
+	return Driver->addRenderTargetTexture(size, name, format);
+}
+
+
+IMaterialRenderer* CCommandList::getMaterialRenderer(u32 idx)
+{
+	return Driver->getMaterialRenderer(idx);
+}
+
+
+u32 CCommandList::getMaterialRendererCount() const
+{
+	return Driver->getMaterialRendererCount();
+}
+
+
+const char* CCommandList::getMaterialRendererName(u32 idx) const
+{
+	return Driver->getMaterialRendererName(idx);
+}
+
+
+IGPUProgrammingServices* CCommandList::getGPUProgrammingServices()
+{
+	return Driver->getGPUProgrammingServices();
+}
+
+
+SOverrideMaterial& CCommandList::getOverrideMaterial()
+{
+	return Driver->getOverrideMaterial();
+}
+
+
+bool CCommandList::getTextureCreationFlag(E_TEXTURE_CREATION_FLAG flag) const
+{
+	return Driver->getTextureCreationFlag(flag);
+}
+
+
+core::dimension2du CCommandList::getMaxTextureSize() const
+{
+	return Driver->getMaxTextureSize();
+}
+
+
+bool CCommandList::queryTextureFormat(ECOLOR_FORMAT format) const
+{
+	return Driver->queryTextureFormat(format);
+}
+
+
+} // end namespace video
+} // end namespace irr
@@ -0,0 +1,312 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_COMMAND_LIST_H_INCLUDED__
+#define __C_COMMAND_LIST_H_INCLUDED__
+
+#include "ICommandList.h"
+#include "CNullDriver.h"
+
+namespace irr
+{
+namespace video
+{
+
+	//! Records the calls of a driver into a byte stream and replays them
+	/** The list is its own recorder: a null driver which stores the draw
+	calls and forwards all queries and resources to the driver which created it. */
+	class CCommandList : public ICommandList, public CNullDriver
+	{
+	public:
+
+		//! constructor
+		CCommandList(IVideoDriver* driver, io::IFileSystem* io);
+
+		//! destructor
+		virtual ~CCommandList();
+
+		//! Get the driver which records into this list.
+		virtual IVideoDriver* getRecorder() _IRR_OVERRIDE_ { return this; }
+
+		//! Removes all recorded calls and releases the referenced textures.
+		virtual void clear() _IRR_OVERRIDE_;
+
+		//! Sends the recorded calls to a driver.
+		virtual void replay(IVideoDriver* driver) const _IRR_OVERRIDE_;
+
+		//! Get the number of recorded calls.
+		virtual u32 getCommandCount() const _IRR_OVERRIDE_ { return CommandCount; }
+
+		//! Get the memory used by the recorded calls.
+		virtual u32 getSize() const _IRR_OVERRIDE_;
+
+		// recorded calls
+
+		virtual void setTransform(E_TRANSFORMATION_STATE state, const core::matrix4& mat) _IRR_OVERRIDE_;
+
+		virtual const core::matrix4& getTransform(E_TRANSFORMATION_STATE state) const _IRR_OVERRIDE_;
+
+		virtual void setMaterial(const SMaterial& material) _IRR_OVERRIDE_;
+
+		virtual void setViewPort(const core::rect<s32>& area) _IRR_OVERRIDE_;
+
+		virtual void drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
+				const void* indexList, u32 primitiveCount,
+				E_VERTEX_TYPE vType=EVT_STANDARD, scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
+				E_INDEX_TYPE iType=EIT_16BIT) _IRR_OVERRIDE_;
+
+		virtual void draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
+				const void* indexList, u32 primitiveCount,
+				E_VERTEX_TYPE vType=EVT_STANDARD, scene::E_PRIMITIVE_TYPE pType=scene::EPT_TRIANGLES,
+				E_INDEX_TYPE iType=EIT_16BIT) _IRR_OVERRIDE_;
+
+		virtual void draw3DLine(const core::vector3df& start,
+			const core::vector3df& end, SColor color = SColor(255,255,255,255)) _IRR_OVERRIDE_;
+
+		virtual void draw2DImage(const video::ITexture* texture, const core::position2d<s32>& destPos,
+			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
+			SColor color=SColor(255,255,255,255), bool useAlphaChannelOfTexture=false) _IRR_OVERRIDE_;
+
+		virtual void draw2DImage(const video::ITexture* texture, const core::rect<s32>& destRect,
+			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
+			const video::SColor* const colors=0, bool useAlphaChannelOfTexture=false) _IRR_OVERRIDE_;
+
+		virtual void draw2DRectangle(const core::rect<s32>& pos,
+			SColor colorLeftUp, SColor colorRightUp, SColor colorLeftDown, SColor colorRightDown,
+			const core::rect<s32>* clip = 0) _IRR_OVERRIDE_;
+
+		virtual void draw2DLine(const core::position2d<s32>& start,
+					const core::position2d<s32>& end,
+					SColor color=SColor(255,255,255,255)) _IRR_OVERRIDE_;
+
+		virtual void drawPixel(u32 x, u32 y, const SColor & color) _IRR_OVERRIDE_;
+
+		virtual void deleteAllDynamicLights() _IRR_OVERRIDE_;
+
+		virtual s32 addDynamicLight(const SLight& light) _IRR_OVERRIDE_;
+
+		virtual void turnLightOn(s32 lightIndex, bool turnOn) _IRR_OVERRIDE_;
+
+		virtual void setAmbientLight(const SColorf& color) _IRR_OVERRIDE_;
+
+		virtual void drawStencilShadowVolume(const core::array<core::vector3df>& triangles,
+			bool zfail=true, u32 debugDataVisible=0) _IRR_OVERRIDE_;
+
+		virtual void drawStencilShadow(bool clearStencilBuffer=false,
+			video::SColor leftUpEdge = video::SColor(0,0,0,0),
+			video::SColor rightUpEdge = video::SColor(0,0,0,0),
+			video::SColor leftDownEdge = video::SColor(0,0,0,0),
+			video::SColor rightDownEdge = video::SColor(0,0,0,0)) _IRR_OVERRIDE_;
+
+		// calls forwarded to the driver which created the list
+
+		virtual bool queryFeature(E_VIDEO_DRIVER_FEATURE feature) const _IRR_OVERRIDE_;
+
+		virtual const io::IAttributes& getDriverAttributes() const _IRR_OVERRIDE_;
+
+		virtual E_DRIVER_TYPE getDriverType() const _IRR_OVERRIDE_;
+
+		virtual ECOLOR_FORMAT getColorFormat() const _IRR_OVERRIDE_;
+
+		virtual const core::dimension2d<u32>& getScreenSize() const _IRR_OVERRIDE_;
+
+		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const _IRR_OVERRIDE_;
+
+		virtual u32 getMaximalDynamicLightAmount() const _IRR_OVERRIDE_;
+
+		virtual u32 getMaximalPrimitiveCount() const _IRR_OVERRIDE_;
+
+		virtual ITexture* getTexture(const io::path& filename) _IRR_OVERRIDE_;
+
+		virtual ITexture* getTexture(io::IReadFile* file) _IRR_OVERRIDE_;
+
+		virtual ITexture* getTextureByIndex(u32 index) _IRR_OVERRIDE_;
+
+		virtual u32 getTextureCount() const _IRR_OVERRIDE_;
+
+		virtual ITexture* findTexture(const io::path& filename) _IRR_OVERRIDE_;
+
+		virtual ITexture* addTexture(const core::dimension2d<u32>& size, const io::path& name, ECOLOR_FORMAT format = ECF_A8R8G8B8) _IRR_OVERRIDE_;
+
+		virtual ITexture* addTexture(const io::path& name, IImage* image) _IRR_OVERRIDE_;
+
+		virtual ITexture* addRenderTargetTexture(const core::dimension2d<u32>& size,
+			const io::path& name, const ECOLOR_FORMAT format = ECF_UNKNOWN) _IRR_OVERRIDE_;
+
+		virtual IMaterialRenderer* getMaterialRenderer(u32 idx) _IRR_OVERRIDE_;
+
+		virtual u32 getMaterialRendererCount() const _IRR_OVERRIDE_;
+
+		virtual const char* getMaterialRendererName(u32 idx) const _IRR_OVERRIDE_;
+
+		virtual IGPUProgrammingServices* getGPUProgrammingServices() _IRR_OVERRIDE_;
+
+		virtual SOverrideMaterial& getOverrideMaterial() _IRR_OVERRIDE_;
+
+		virtual bool getTextureCreationFlag(E_TEXTURE_CREATION_FLAG flag) const _IRR_OVERRIDE_;
+
+		virtual core::dimension2du getMaxTextureSize() const _IRR_OVERRIDE_;
+
+		virtual bool queryTextureFormat(ECOLOR_FORMAT format) const _IRR_OVERRIDE_;
+
+	private:
+
+		enum E_COMMAND
+		{
+			ECMD_SET_TRANSFORM = 0,
+			ECMD_SET_MATERIAL,
+			ECMD_SET_VIEWPORT,
+			ECMD_DRAW_PRIMITIVES,
+			ECMD_DRAW_2D_PRIMITIVES,
+			ECMD_DRAW_3D_LINE,
+			ECMD_DRAW_2D_IMAGE,
+			ECMD_DRAW_2D_IMAGE_RECT,
+			ECMD_DRAW_2D_RECTANGLE,
+			ECMD_DRAW_2D_LINE,
+			ECMD_DRAW_PIXEL,
+			ECMD_DELETE_LIGHTS,
+			ECMD_ADD_LIGHT,
+			ECMD_TURN_LIGHT_ON,
+			ECMD_SET_AMBIENT_LIGHT,
+			ECMD_DRAW_SHADOW_VOLUME,
+			ECMD_DRAW_SHADOW
+		};
+
+		// arguments of the commands, copied into the stream behind the command byte
+
+		struct SSetTransform
+		{
+			u32 State;
+			core::matrix4 Matrix;
+		};
+
+		struct SDrawPrimitives
+		{
+			u32 VertexOffset;
+			u32 VertexCount;
+			u32 IndexOffset;
+			u32 PrimitiveCount;
+			u8 VertexType;
+			u8 PrimitiveType;
+			u8 IndexType;
+		};
+
+		struct SDraw3DLine
+		{
+			core::vector3df Start;
+			core::vector3df End;
+			SColor Color;
+		};
+
+		struct SDraw2DImage
+		{
+			const ITexture* Texture;
+			core::position2d<s32> Pos;
+			core::rect<s32> SourceRect;
+			core::rect<s32> ClipRect;
+			SColor Color;
+			bool Clip;
+			bool UseAlpha;
+		};
+
+		struct SDraw2DImageRect
+		{
+			const ITexture* Texture;
+			core::rect<s32> DestRect;
+			core::rect<s32> SourceRect;
+			core::rect<s32> ClipRect;
+			SColor Colors[4];
+			bool Clip;
+			bool UseColors;
+			bool UseAlpha;
+		};
+
+		struct SDraw2DRectangle
+		{
+			core::rect<s32> Pos;
+			core::rect<s32> ClipRect;
+			SColor Colors[4];
+			bool Clip;
+		};
+
+		struct SDraw2DLine
+		{
+			core::position2d<s32> Start;
+			core::position2d<s32> End;
+			SColor Color;
+		};
+
+		struct SDrawPixel
+		{
+			u32 X;
+			u32 Y;
+			SColor Color;
+		};
+
+		struct STurnLightOn
+		{
+			s32 Index;
+			bool TurnOn;
+		};
+
+		struct SDrawShadowVolume
+		{
+			u32 Volume;
+			u32 DebugDataVisible;
+			bool ZFail;
+		};
+
+		struct SDrawShadow
+		{
+			SColor Colors[4];
+			bool ClearStencilBuffer;
+		};
+
+		//! block of vertices or indices in Data
+		struct SDataBlock
+		{
+			u32 Offset;
+			u32 Size;
+		};
+
+		//! appends a command and its arguments to the stream
+		template <class T>
+		void addCommand(E_COMMAND command, const T& arguments);
+
+		//! appends a command without arguments to the stream
+		void addCommand(E_COMMAND command);
+
+		//! copies vertices or indices into Data, returns their offset
+		/** Data drawn several times from the same address is only stored once,
+		as long as it was not changed in between. */
+		u32 addData(const void* data, u32 size);
+
+		//! stores the shared arguments of both primitive list calls
+		void addPrimitives(E_COMMAND command, const void* vertices, u32 vertexCount,
+				const void* indexList, u32 primitiveCount,
+				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType);
+
+		//! grabs a texture until the list is cleared
+		void grabTexture(const ITexture* texture);
+
+		//! the driver which created the list
+		IVideoDriver* Driver;
+
+		//! command bytes, each followed by its arguments
+		core::array<u8> Commands;
+		//! copied vertices and indices
+		core::array<u8> Data;
+		//! address of the last data copied from each source
+		core::map<const void*, SDataBlock> DataBlocks;
+		core::array<SMaterial> Materials;
+		core::array<core::array<core::vector3df> > ShadowVolumes;
+		core::array<ITexture*> Textures;
+
+		core::matrix4 Transforms[ETS_COUNT];
+		u32 CommandCount;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -0,0 +1,285 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CCullingHierarchy.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Maximal number of entries in a leaf of the tree, tested as one batch
+static const u32 LEAF_SIZE = 8;
+
+//! Maximal depth of the tree. Median splits keep it at log2(entries).
+static const u32 MAX_DEPTH = 64;
+
+static inline f32 axisValue(const core::vector3df& v, u32 axis)
+{
+	return axis == 0 ? v.X : (axis == 1 ? v.Y : v.Z);
+}
+
+//! Returns ISREL3D_FRONT when the box is outside the frustum, ISREL3D_BACK when
+//! it is completely inside and ISREL3D_CLIPPED otherwise.
+static inline core::EIntersectionRelation3D classifyFrustumRelation(const core::aabbox3df& box,
+		const SViewFrustum& frustum)
+{
+	core::EIntersectionRelation3D result = core::ISREL3D_BACK;
+	for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+	{
+		const core::EIntersectionRelation3D r = box.classifyPlaneRelation(frustum.planes[i]);
+		if (r == core::ISREL3D_FRONT)
+			return core::ISREL3D_FRONT;
+		if (r == core::ISREL3D_CLIPPED)
+			result = core::ISREL3D_CLIPPED;
+	}
+	return result;
+}
+
+
+CCullingHierarchy::CCullingHierarchy()
+	: Dirty(true)
+{
+}
+
+
+void CCullingHierarchy::clear()
+{
+	Entries.clear();
+	EntryBoxes.clear();
+	Nodes.clear();
+	DynamicNodes.clear();
+	Dirty = true;
+}
+
+
+void CCullingHierarchy::build(const ISceneNode* root)
+{
+	Entries.set_used(0);
+	EntryBoxes.clear();
+	Nodes.set_used(0);
+	DynamicNodes.set_used(0);
+	Dirty = false;
+
+	if (!root)
+		return;
+
+	const ISceneNodeList& children = root->getChildren();
+	ISceneNodeList::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+	{
+		SEntry entry;
+		entry.Node = *it;
+		bool boxInitialized = false;
+
+		if (addStaticSubtree(entry.Node, entry.Box, boxInitialized) && boxInitialized)
+		{
+			entry.Center = entry.Box.getCenter();
+			Entries.push_back(entry);
+		}
+		else
+			DynamicNodes.push_back(entry.Node);
+	}
+
+	if (!Entries.empty())
+	{
+		Nodes.reallocate(Entries.size() * 2);
+		buildNode(0, Entries.size());
+
+		// in tree order, leaves are continuous ranges
+		EntryBoxes.reallocate(Entries.size());
+		for (u32 i=0; i<Entries.size(); ++i)
+			EntryBoxes.push_back(Entries[i].Box);
+	}
+}
+
+
+bool CCullingHierarchy::addStaticSubtree(const ISceneNode* node, core::aabbox3df& box, bool& boxInitialized) const
+{
+	if (!node->getAnimators().empty())
+		return false;
+
+	if (node->getAutomaticCulling() == EAC_OFF)
+		return false;
+
+	switch (node->getType())
+	{
+	// never culled or registered in passes which aren't culled
+	case ESNT_CAMERA:
+	case ESNT_CAMERA_MAYA:
+	case ESNT_CAMERA_FPS:
+	case ESNT_LIGHT:
+	case ESNT_SKY_BOX:
+	case ESNT_SKY_DOME:
+	case ESNT_SHADOW_VOLUME:
+	// bounding boxes change without any transformation change
+	case ESNT_ANIMATED_MESH:
+	case ESNT_MD3_SCENE_NODE:
+	case ESNT_PARTICLE_SYSTEM:
+	case ESNT_Q3SHADER_SCENE_NODE:
+	case ESNT_WATER_SURFACE:
+	case ESNT_TERRAIN:
+		return false;
+	default:
+		break;
+	}
+
+	// same box as used in CSceneManager::isCulled
+	core::aabbox3df tbox = node->getBoundingBox();
+	node->getAbsoluteTransformation().transformBoxEx(tbox);
+	if (boxInitialized)
+		box.addInternalBox(tbox);
+	else
+	{
+		box = tbox;
+		boxInitialized = true;
+	}
+
+	const ISceneNodeList& children = node->getChildren();
+	ISceneNodeList::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+	{
+		if (!addStaticSubtree(*it, box, boxInitialized))
+			return false;
+	}
+
+	return true;
+}
+
+
+u32 CCullingHierarchy::buildNode(u32 begin, u32 end)
+{
+	// Nodes might get reallocated by the recursion, so work on a copy
+	const u32 index = Nodes.size();
+	Nodes.push_back(STreeNode());
+
+	STreeNode node;
+	node.Begin = begin;
+	node.End = end;
+	node.Right = 0;
+	node.Box = Entries[begin].Box;
+	core::aabbox3df centers(Entries[begin].Center);
+	for (u32 i=begin+1; i<end; ++i)
+	{
+		node.Box.addInternalBox(Entries[i].Box);
+		centers.addInternalPoint(Entries[i].Center);
+	}
+
+	if (end - begin > LEAF_SIZE)
+	{
+		// split at the median of the longest axis of the entry centers
+		const core::vector3df extent = centers.getExtent();
+		u32 axis = 2;
+		if (extent.X >= extent.Y && extent.X >= extent.Z)
+			axis = 0;
+		else if (extent.Y >= extent.Z)
+			axis = 1;
+
+		const u32 mid = begin + (end - begin) / 2;
+		selectMedian(begin, end, mid, axis);
+
+		buildNode(begin, mid);
+		node.Right = buildNode(mid, end);
+	}
+
+	Nodes[index] = node;
+	return index;
+}
+
+
+void CCullingHierarchy::selectMedian(u32 begin, u32 end, u32 mid, u32 axis)
+{
+	// quickselect, afterwards all entries before mid are <= and all after are >= mid
+	s32 lo = (s32)begin;
+	s32 hi = (s32)end - 1;
+	const s32 k = (s32)mid;
+
+	while (lo < hi)
+	{
+		const f32 pivot = axisValue(Entries[(lo + hi) / 2].Center, axis);
+		s32 i = lo;
+		s32 j = hi;
+		while (i <= j)
+		{
+			while (axisValue(Entries[i].Center, axis) < pivot)
+				++i;
+			while (axisValue(Entries[j].Center, axis) > pivot)
+				--j;
+			if (i <= j)
+			{
+				core::swap(Entries[i], Entries[j]);
+				++i;
+				--j;
+			}
+		}
+
+		if (k <= j)
+			hi = j;
+		else if (k >= i)
+			lo = i;
+		else
+			break;
+	}
+}
+
+
+void CCullingHierarchy::addEntries(const STreeNode& node, core::array<ISceneNode*>& out) const
+{
+	for (u32 i=node.Begin; i<node.End; ++i)
+		out.push_back(Entries[i].Node);
+}
+
+
+void CCullingHierarchy::cull(const SViewFrustum& frustum, core::array<ISceneNode*>& outClipped,
+		core::array<ISceneNode*>& outInside) const
+{
+	outClipped.set_used(0);
+	outInside.set_used(0);
+
+	if (Nodes.empty())
+		return;
+
+	u32 stack[MAX_DEPTH];
+	u32 stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize)
+	{
+		const u32 index = stack[--stackSize];
+		const STreeNode& node = Nodes[index];
+
+		const core::EIntersectionRelation3D r = classifyFrustumRelation(node.Box, frustum);
+		if (r == core::ISREL3D_FRONT)
+			continue;
+
+		// fully inside, no further checks for the entries needed
+		if (r == core::ISREL3D_BACK)
+		{
+			addEntries(node, outInside);
+			continue;
+		}
+
+		if (node.Right)
+		{
+			stack[stackSize++] = node.Right;
+			stack[stackSize++] = index + 1;
+		}
+		else
+		{
+			core::EIntersectionRelation3D relations[LEAF_SIZE];
+			EntryBoxes.classify(frustum, node.Begin, node.End, relations);
+			for (u32 i=node.Begin; i<node.End; ++i)
+			{
+				const core::EIntersectionRelation3D er = relations[i - node.Begin];
+				if (er == core::ISREL3D_BACK)
+					outInside.push_back(Entries[i].Node);
+				else if (er == core::ISREL3D_CLIPPED)
+					outClipped.push_back(Entries[i].Node);
+			}
+		}
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,101 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_CULLING_HIERARCHY_H_INCLUDED__
+#define __C_CULLING_HIERARCHY_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "SViewFrustum.h"
+#include "CFrustumBoxBatch.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Bounding volume hierarchy over the static subtrees below a scene node.
+	/** Used by the scene manager to cull whole groups of scene nodes with
+	a single frustum test instead of checking every node on its own.
+	Each entry is a direct child of the root node together with all its
+	children, represented by one world-space box around all of them.
+	Subtrees which can move or which must never be culled (cameras, lights,
+	animated nodes, nodes with animators or with culling disabled) are not
+	put into the tree but returned as dynamic nodes. */
+	class CCullingHierarchy
+	{
+	public:
+
+		//! Constructor
+		CCullingHierarchy();
+
+		//! Rebuilds the tree from the children of the given node.
+		/** The absolute transformations of all nodes must be up to date. */
+		void build(const ISceneNode* root);
+
+		//! Removes all entries and marks the tree as dirty.
+		void clear();
+
+		//! Request a rebuild before the next use.
+		void setDirty() { Dirty = true; }
+
+		//! Check if the tree has to be rebuilt before it can be used.
+		bool isDirty() const { return Dirty; }
+
+		//! Children of the root which can't be handled by the tree.
+		const core::array<ISceneNode*>& getDynamicNodes() const { return DynamicNodes; }
+
+		//! Get the number of subtrees stored in the tree.
+		u32 getEntryCount() const { return Entries.size(); }
+
+		//! Collects all entries which might be visible in the frustum.
+		/** \param frustum View frustum in world space.
+		\param outClipped Receives entries intersecting the frustum border.
+		\param outInside Receives entries which are completely inside the frustum.
+		Both arrays are cleared first. */
+		void cull(const SViewFrustum& frustum, core::array<ISceneNode*>& outClipped,
+				core::array<ISceneNode*>& outInside) const;
+
+	private:
+
+		struct SEntry
+		{
+			ISceneNode* Node;
+			core::aabbox3df Box;
+			core::vector3df Center;
+		};
+
+		struct STreeNode
+		{
+			core::aabbox3df Box;
+			//! Range of entries below this node
+			u32 Begin;
+			u32 End;
+			//! Index of the second child, the first one always follows directly. 0 for leaves.
+			u32 Right;
+		};
+
+		//! Add the subtree box of node to box, returns false if the subtree can't be cached
+		bool addStaticSubtree(const ISceneNode* node, core::aabbox3df& box, bool& boxInitialized) const;
+
+		//! Recursively creates the tree nodes for the entries [begin, end)
+		u32 buildNode(u32 begin, u32 end);
+
+		//! Reorders entries so that the median along axis is at position mid
+		void selectMedian(u32 begin, u32 end, u32 mid, u32 axis);
+
+		//! Adds all entries of a tree node to the output list
+		void addEntries(const STreeNode& node, core::array<ISceneNode*>& out) const;
+
+		core::array<SEntry> Entries;
+		//! Boxes of the entries, so whole leaves are tested at once
+		CFrustumBoxBatch EntryBoxes;
+		core::array<STreeNode> Nodes;
+		core::array<ISceneNode*> DynamicNodes;
+		bool Dirty;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
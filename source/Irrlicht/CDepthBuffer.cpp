@@ -13,10 +13,14 @@ namespace irr
 namespace video
 {
 
+//! size of the depth tiles
+#define DEPTH_TILE_LOG2 3
+#define DEPTH_TILE_SIZE ( 1 << DEPTH_TILE_LOG2 )
+
 
 //! constructor
 CDepthBuffer::CDepthBuffer(const core::dimension2d<u32>& size)
-: Buffer(0), Size(0,0)
+: Buffer(0), Size(0,0), TileMin(0), TileDirty(0), TilesX(0), TilesY(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CDepthBuffer");
@@ -31,6 +35,8 @@ CDepthBuffer::CDepthBuffer(const core::dimension2d<u32>& size)
 CDepthBuffer::~CDepthBuffer()
 {
 	delete [] Buffer;
+	delete [] TileMin;
+	delete [] TileDirty;
 }
 
 
@@ -49,6 +55,8 @@ void CDepthBuffer::clear()
 	zMaxValue = IR(zMax);
 
 	memset32 ( Buffer, zMaxValue, TotalSize );
+	memset32 ( TileMin, zMaxValue, TilesX * TilesY * sizeof ( f32 ) );
+	memset ( TileDirty, 0, TilesX * TilesY );
 }
 
 
@@ -66,6 +74,14 @@ void CDepthBuffer::setSize(const core::dimension2d<u32>& size)
 	Pitch = size.Width * sizeof ( fp24 );
 	TotalSize = Pitch * size.Height;
 	Buffer = new u8[TotalSize];
+
+	delete [] TileMin;
+	delete [] TileDirty;
+
+	TilesX = ( size.Width + DEPTH_TILE_SIZE - 1 ) >> DEPTH_TILE_LOG2;
+	TilesY = ( size.Height + DEPTH_TILE_SIZE - 1 ) >> DEPTH_TILE_LOG2;
+	TileMin = new f32[TilesX * TilesY];
+	TileDirty = new u8[TilesX * TilesY];
 	clear ();
 }
 
@@ -77,6 +93,108 @@ const core::dimension2d<u32>& CDepthBuffer::getSize() const
 	return Size;
 }
 
+
+/*!
+	Only for the w buffer, where the depth test passes for a larger or equal w.
+	The shaders never make the depth of a pixel smaller, so the minimum of a
+	dirty tile stays conservative and is only recalculated when it can't
+	reject the triangle.
+*/
+bool CDepthBuffer::clipToDepth(core::rect<s32>& area, f32 w)
+{
+	area.clipAgainst ( core::rect<s32> ( 0, 0, Size.Width, Size.Height ) );
+	if ( area.UpperLeftCorner.X >= area.LowerRightCorner.X ||
+		area.UpperLeftCorner.Y >= area.LowerRightCorner.Y )
+		return false;
+
+	const u32 tx0 = area.UpperLeftCorner.X >> DEPTH_TILE_LOG2;
+	const u32 tx1 = ( area.LowerRightCorner.X - 1 ) >> DEPTH_TILE_LOG2;
+	u32 ty0 = area.UpperLeftCorner.Y >> DEPTH_TILE_LOG2;
+	u32 ty1 = ( area.LowerRightCorner.Y - 1 ) >> DEPTH_TILE_LOG2;
+
+	while ( ty0 <= ty1 && !isRowVisible ( ty0, tx0, tx1, w ) )
+		ty0 += 1;
+
+	if ( ty0 > ty1 )
+		return false;
+
+	while ( ty1 > ty0 && !isRowVisible ( ty1, tx0, tx1, w ) )
+		ty1 -= 1;
+
+	area.UpperLeftCorner.Y = core::max_ ( area.UpperLeftCorner.Y, (s32) ( ty0 << DEPTH_TILE_LOG2 ) );
+	area.LowerRightCorner.Y = core::min_ ( area.LowerRightCorner.Y, (s32) ( ( ty1 + 1 ) << DEPTH_TILE_LOG2 ) );
+	return true;
+}
+
+
+//! the tiles of area have to be updated before the next test
+void CDepthBuffer::invalidate(const core::rect<s32>& area)
+{
+	if ( area.UpperLeftCorner.X >= area.LowerRightCorner.X ||
+		area.UpperLeftCorner.Y >= area.LowerRightCorner.Y )
+		return;
+
+	const u32 tx0 = area.UpperLeftCorner.X >> DEPTH_TILE_LOG2;
+	const u32 tx1 = ( area.LowerRightCorner.X - 1 ) >> DEPTH_TILE_LOG2;
+	const u32 ty0 = area.UpperLeftCorner.Y >> DEPTH_TILE_LOG2;
+	const u32 ty1 = ( area.LowerRightCorner.Y - 1 ) >> DEPTH_TILE_LOG2;
+
+	for ( u32 ty = ty0; ty <= ty1; ++ty )
+		memset ( TileDirty + ty * TilesX + tx0, 1, tx1 - tx0 + 1 );
+}
+
+
+//! all tiles have to be updated before the next test
+void CDepthBuffer::invalidate()
+{
+	memset ( TileDirty, 1, TilesX * TilesY );
+}
+
+
+//! true if a tile of the row could have a depth of w or smaller
+bool CDepthBuffer::isRowVisible(u32 ty, u32 tx0, u32 tx1, f32 w)
+{
+	const u32 row = ty * TilesX;
+	for ( u32 tx = tx0; tx <= tx1; ++tx )
+	{
+		if ( TileMin[row + tx] > w )
+			continue;
+
+		if ( TileDirty[row + tx] )
+		{
+			updateTile ( tx, ty );
+			if ( TileMin[row + tx] > w )
+				continue;
+		}
+		return true;
+	}
+	return false;
+}
+
+
+//! recalculates the smallest depth of a tile
+void CDepthBuffer::updateTile(u32 tx, u32 ty)
+{
+	const u32 x0 = tx << DEPTH_TILE_LOG2;
+	const u32 y0 = ty << DEPTH_TILE_LOG2;
+	const u32 x1 = core::min_ ( x0 + DEPTH_TILE_SIZE, Size.Width );
+	const u32 y1 = core::min_ ( y0 + DEPTH_TILE_SIZE, Size.Height );
+
+	f32 tileMin = FLT_MAX;
+	for ( u32 y = y0; y < y1; ++y )
+	{
+		const fp24* z = (fp24*) ( Buffer + y * Pitch );
+		for ( u32 x = x0; x < x1; ++x )
+		{
+			if ( z[x] < tileMin )
+				tileMin = z[x];
+		}
+	}
+
+	TileMin[ty * TilesX + tx] = tileMin;
+	TileDirty[ty * TilesX + tx] = 0;
+}
+
 // -----------------------------------------------------------------
 
 //! constructor
@@ -40,13 +40,35 @@ namespace video
 		//! returns pitch of depthbuffer (in bytes)
 		virtual u32 getPitch() const _IRR_OVERRIDE_ { return Pitch; }
 
+		//! shrinks the rows of area to the tiles a triangle with largest w could pass the depth test
+		virtual bool clipToDepth(core::rect<s32>& area, f32 w) _IRR_OVERRIDE_;
+
+		//! the tiles of area have to be updated before the next test
+		virtual void invalidate(const core::rect<s32>& area) _IRR_OVERRIDE_;
+
+		//! all tiles have to be updated before the next test
+		virtual void invalidate() _IRR_OVERRIDE_;
+
 
 	private:
 
+		//! true if a tile of the row could have a depth of w or smaller
+		bool isRowVisible(u32 ty, u32 tx0, u32 tx1, f32 w);
+
+		//! recalculates the smallest depth of a tile
+		void updateTile(u32 tx, u32 ty);
+
 		u8* Buffer;
 		core::dimension2d<u32> Size;
 		u32 TotalSize;
 		u32 Pitch;
+
+		//! smallest depth of the 8x8 tiles, never larger than the real one
+		f32* TileMin;
+		//! tiles which were drawn since their TileMin was calculated
+		u8* TileDirty;
+		u32 TilesX;
+		u32 TilesY;
 	};
 
 
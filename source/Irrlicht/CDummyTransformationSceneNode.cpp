@@ -35,6 +35,8 @@ const core::aabbox3d<f32>& CDummyTransformationSceneNode::getBoundingBox() const
 //! and rotation.
 core::matrix4& CDummyTransformationSceneNode::getRelativeTransformationMatrix()
 {
+	// might get changed by the caller
+	setTransformationDirty();
 	return RelativeTransformationMatrix;
 }
 
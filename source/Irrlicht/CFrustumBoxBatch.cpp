@@ -0,0 +1,206 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CFrustumBoxBatch.h"
+
+#if defined(_IRR_COMPILE_WITH_AVX_)
+#include <immintrin.h>
+#elif defined(_IRR_COMPILE_WITH_SSE2_)
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+#if defined(_IRR_COMPILE_WITH_AVX_)
+//! Number of boxes tested together
+static const u32 BATCH_SIZE = 8;
+#elif defined(_IRR_COMPILE_WITH_SSE2_)
+static const u32 BATCH_SIZE = 4;
+#else
+static const u32 BATCH_SIZE = 1;
+#endif
+
+//! Coordinates behind the last box, so a batch starting at the last box can still be loaded
+static const u32 BATCH_PADDING = BATCH_SIZE - 1;
+
+//! Bits collected per box while testing the planes
+enum E_BOX_PLANE_FLAGS
+{
+	EBPF_CLIPPED = 1,
+	EBPF_FRONT = 2
+};
+
+static inline core::EIntersectionRelation3D relationFromFlags(u32 flags)
+{
+	if (flags & EBPF_FRONT)
+		return core::ISREL3D_FRONT;
+	if (flags & EBPF_CLIPPED)
+		return core::ISREL3D_CLIPPED;
+	return core::ISREL3D_BACK;
+}
+
+
+CFrustumBoxBatch::CFrustumBoxBatch() : Count(0)
+{
+	clear();
+}
+
+
+void CFrustumBoxBatch::clear()
+{
+	for (u32 i=0; i<3; ++i)
+	{
+		MinEdge[i].set_used(BATCH_PADDING);
+		MaxEdge[i].set_used(BATCH_PADDING);
+		for (u32 j=0; j<BATCH_PADDING; ++j)
+		{
+			MinEdge[i][j] = 0.f;
+			MaxEdge[i][j] = 0.f;
+		}
+	}
+	Count = 0;
+}
+
+
+void CFrustumBoxBatch::reallocate(u32 count)
+{
+	for (u32 i=0; i<3; ++i)
+	{
+		MinEdge[i].reallocate(count + BATCH_PADDING);
+		MaxEdge[i].reallocate(count + BATCH_PADDING);
+	}
+}
+
+
+void CFrustumBoxBatch::push_back(const core::aabbox3df& box)
+{
+	// the padding moves one box further
+	for (u32 i=0; i<3; ++i)
+	{
+		MinEdge[i].push_back(0.f);
+		MaxEdge[i].push_back(0.f);
+	}
+
+	MinEdge[0][Count] = box.MinEdge.X;
+	MinEdge[1][Count] = box.MinEdge.Y;
+	MinEdge[2][Count] = box.MinEdge.Z;
+	MaxEdge[0][Count] = box.MaxEdge.X;
+	MaxEdge[1][Count] = box.MaxEdge.Y;
+	MaxEdge[2][Count] = box.MaxEdge.Z;
+	++Count;
+}
+
+
+void CFrustumBoxBatch::classifyScalar(const SViewFrustum& frustum, u32 begin, u32 end,
+		core::EIntersectionRelation3D* out) const
+{
+	for (u32 i=begin; i<end; ++i)
+	{
+		core::aabbox3df box(MinEdge[0][i], MinEdge[1][i], MinEdge[2][i],
+			MaxEdge[0][i], MaxEdge[1][i], MaxEdge[2][i]);
+
+		u32 flags = 0;
+		for (u32 p=0; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+		{
+			const core::EIntersectionRelation3D r = box.classifyPlaneRelation(frustum.planes[p]);
+			if (r == core::ISREL3D_FRONT)
+			{
+				flags |= EBPF_FRONT;
+				break;
+			}
+			if (r == core::ISREL3D_CLIPPED)
+				flags |= EBPF_CLIPPED;
+		}
+		*out++ = relationFromFlags(flags);
+	}
+}
+
+
+void CFrustumBoxBatch::classify(const SViewFrustum& frustum, u32 begin, u32 end,
+		core::EIntersectionRelation3D* out) const
+{
+	_IRR_DEBUG_BREAK_IF(end > size() || begin > end)
+
+#if defined(_IRR_COMPILE_WITH_SSE2_)
+	// the edge closest to the plane depends only on the sign of the normal,
+	// so pick the arrays once per plane
+	const f32* nearEdge[SViewFrustum::VF_PLANE_COUNT][3];
+	const f32* farEdge[SViewFrustum::VF_PLANE_COUNT][3];
+	for (u32 p=0; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+	{
+		const core::plane3df& plane = frustum.planes[p];
+		const f32 normal[3] = { plane.Normal.X, plane.Normal.Y, plane.Normal.Z };
+		for (u32 a=0; a<3; ++a)
+		{
+			const bool positive = normal[a] > 0.f;
+			nearEdge[p][a] = positive ? MinEdge[a].const_pointer() : MaxEdge[a].const_pointer();
+			farEdge[p][a] = positive ? MaxEdge[a].const_pointer() : MinEdge[a].const_pointer();
+		}
+	}
+
+	// the last batch reads into the padding and stores only the boxes before end
+	for (u32 i=begin; i<end; i+=BATCH_SIZE)
+	{
+		u32 front = 0;
+		u32 clipped = 0;
+		for (u32 p=0; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+		{
+			const core::plane3df& plane = frustum.planes[p];
+#if defined(_IRR_COMPILE_WITH_AVX_)
+			const __m256 nx = _mm256_set1_ps(plane.Normal.X);
+			const __m256 ny = _mm256_set1_ps(plane.Normal.Y);
+			const __m256 nz = _mm256_set1_ps(plane.Normal.Z);
+			const __m256 d = _mm256_set1_ps(plane.D);
+			const __m256 zero = _mm256_setzero_ps();
+
+			// same order of operations as vector3d::dotProduct + D
+			__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(nx, _mm256_loadu_ps(nearEdge[p][0] + i)),
+				_mm256_mul_ps(ny, _mm256_loadu_ps(nearEdge[p][1] + i))),
+				_mm256_mul_ps(nz, _mm256_loadu_ps(nearEdge[p][2] + i))), d);
+			front |= (u32)_mm256_movemask_ps(_mm256_cmp_ps(dist, zero, _CMP_GT_OQ));
+
+			dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(nx, _mm256_loadu_ps(farEdge[p][0] + i)),
+				_mm256_mul_ps(ny, _mm256_loadu_ps(farEdge[p][1] + i))),
+				_mm256_mul_ps(nz, _mm256_loadu_ps(farEdge[p][2] + i))), d);
+			clipped |= (u32)_mm256_movemask_ps(_mm256_cmp_ps(dist, zero, _CMP_GT_OQ));
+#else
+			const __m128 nx = _mm_set1_ps(plane.Normal.X);
+			const __m128 ny = _mm_set1_ps(plane.Normal.Y);
+			const __m128 nz = _mm_set1_ps(plane.Normal.Z);
+			const __m128 d = _mm_set1_ps(plane.D);
+			const __m128 zero = _mm_setzero_ps();
+
+			// same order of operations as vector3d::dotProduct + D
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(nx, _mm_loadu_ps(nearEdge[p][0] + i)),
+				_mm_mul_ps(ny, _mm_loadu_ps(nearEdge[p][1] + i))),
+				_mm_mul_ps(nz, _mm_loadu_ps(nearEdge[p][2] + i))), d);
+			front |= (u32)_mm_movemask_ps(_mm_cmpgt_ps(dist, zero));
+
+			dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(nx, _mm_loadu_ps(farEdge[p][0] + i)),
+				_mm_mul_ps(ny, _mm_loadu_ps(farEdge[p][1] + i))),
+				_mm_mul_ps(nz, _mm_loadu_ps(farEdge[p][2] + i))), d);
+			clipped |= (u32)_mm_movemask_ps(_mm_cmpgt_ps(dist, zero));
+#endif
+		}
+
+		const u32 count = core::min_(BATCH_SIZE, end - i);
+		for (u32 j=0; j<count; ++j)
+		{
+			const u32 flags = ((front >> j) & 1 ? EBPF_FRONT : 0) | ((clipped >> j) & 1 ? EBPF_CLIPPED : 0);
+			*out++ = relationFromFlags(flags);
+		}
+	}
+#else
+	classifyScalar(frustum, begin, end, out);
+#endif
+}
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,68 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_FRUSTUM_BOX_BATCH_H_INCLUDED__
+#define __C_FRUSTUM_BOX_BATCH_H_INCLUDED__
+
+#include "SViewFrustum.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! World space bounding boxes stored as structure of arrays for batched frustum tests.
+	/** With _IRR_COMPILE_WITH_SSE2_ 4 boxes are tested per iteration, with
+	_IRR_COMPILE_WITH_AVX_ 8. The calculations are done in the same order as
+	in aabbox3d::classifyPlaneRelation, so the results are exactly the same
+	as testing each box on its own. The coordinate arrays are padded behind
+	the last box, so a batch can start at any box and the results of the
+	lanes behind the end are just not stored. */
+	class CFrustumBoxBatch
+	{
+	public:
+
+		//! Constructor
+		CFrustumBoxBatch();
+
+		//! Removes all boxes
+		void clear();
+
+		//! Reserve memory for the given number of boxes
+		void reallocate(u32 count);
+
+		//! Adds a box to the end of the batch
+		void push_back(const core::aabbox3df& box);
+
+		//! Get the number of boxes
+		u32 size() const { return Count; }
+
+		//! Classifies the boxes [begin, end) against all planes of the frustum.
+		/** For each box out receives ISREL3D_FRONT if it is outside of any plane,
+		ISREL3D_CLIPPED if it intersects any plane and ISREL3D_BACK if it is
+		completely inside. This is the same as combining
+		aabbox3d::classifyPlaneRelation for all frustum planes.
+		\param frustum View frustum in the same space as the boxes.
+		\param begin First box to test.
+		\param end One behind the last box to test.
+		\param out Array with at least end-begin elements for the results. */
+		void classify(const SViewFrustum& frustum, u32 begin, u32 end,
+				core::EIntersectionRelation3D* out) const;
+
+	private:
+
+		//! Path without SSE2
+		void classifyScalar(const SViewFrustum& frustum, u32 begin, u32 end,
+				core::EIntersectionRelation3D* out) const;
+
+		//! X, Y and Z coordinates of the edges, followed by the padding
+		core::array<f32> MinEdge[3];
+		core::array<f32> MaxEdge[3];
+		u32 Count;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -6,8 +6,13 @@
 #include "irrString.h"
 #include "CColorConverter.h"
 #include "CBlit.h"
+#include "IJobSystem.h"
 #include "os.h"
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace video
@@ -293,6 +298,664 @@ void CImage::copyToScalingBoxFilter(IImage* target, s32 bias, bool blend)
 }
 
 
+//! Halved images with at least this many pixels are split over the threads of a job system
+static const u32 HALF_SIZE_PARALLEL_PIXELS = 256 * 256;
+
+//! Target rows halved at once, by one job
+static const u32 HALF_SIZE_JOB_ROWS = 16;
+
+//! Kaiser windowed sinc (beta 4, radius of 3 source pixels), the weights sum up to 256
+static const s32 KaiserWeights[6] = { -5, 24, 109, 109, 24, -5 };
+
+//! Shift and mask of a channel in a 16 bit color, and the rounding of its average
+struct SChannel16
+{
+	u32 Shift;
+	u32 Mask;
+	u32 Round;
+};
+
+// a zero mask ends the list, the single alpha bit is set when 3 of 4 pixels have it
+static const SChannel16 ChannelsA1R5G5B5[4] = { { 15, 1, 1 }, { 10, 31, 0 }, { 5, 31, 0 }, { 0, 31, 0 } };
+static const SChannel16 ChannelsR5G6B5[4] = { { 11, 31, 0 }, { 5, 63, 0 }, { 0, 31, 0 }, { 0, 0, 0 } };
+
+//! Source and target of copyToHalfSize, shared by all jobs
+struct SHalfSize
+{
+	const u8* Source;
+	u8* Target;
+	core::dimension2d<u32> SourceSize;
+	core::dimension2d<u32> TargetSize;
+	u32 SourcePitch;
+	u32 TargetPitch;
+	ECOLOR_FORMAT Format;
+	E_MIP_MAP_FILTER Filter;
+};
+
+
+//! averages 2x2 pixels of the rows a and b, step is 0 for sources one pixel wide
+static void boxRowA8R8G8B8(const u32* a, const u32* b, u32* dst, u32 width, u32 step)
+{
+	u32 x = 0;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	if (step)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		for (; x + 4 <= width; x += 4)
+		{
+			const __m128i a0 = _mm_loadu_si128((const __m128i*)(a + x * 2));
+			const __m128i a1 = _mm_loadu_si128((const __m128i*)(a + x * 2 + 4));
+			const __m128i b0 = _mm_loadu_si128((const __m128i*)(b + x * 2));
+			const __m128i b1 = _mm_loadu_si128((const __m128i*)(b + x * 2 + 4));
+
+			// vertical sums with 16 bit per channel, two pixels per register
+			const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+			const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+			const __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+			const __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+			// add the neighboring pixels
+			const __m128i h0 = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+			const __m128i h1 = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+
+			_mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(_mm_srli_epi16(h0, 2), _mm_srli_epi16(h1, 2)));
+		}
+	}
+#endif
+
+	for (; x < width; ++x)
+	{
+		const u32 p0 = a[x * 2];
+		const u32 p1 = a[x * 2 + step];
+		const u32 p2 = b[x * 2];
+		const u32 p3 = b[x * 2 + step];
+
+		// two channels at once, their sums don't overlap
+		const u32 rb = ((p0 & 0x00FF00FF) + (p1 & 0x00FF00FF) + (p2 & 0x00FF00FF) + (p3 & 0x00FF00FF)) >> 2;
+		const u32 ag = (((p0 >> 8) & 0x00FF00FF) + ((p1 >> 8) & 0x00FF00FF) +
+			((p2 >> 8) & 0x00FF00FF) + ((p3 >> 8) & 0x00FF00FF)) >> 2;
+
+		dst[x] = (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+	}
+}
+
+
+//! averages 2x2 pixels of the rows a and b
+static void boxRowR8G8B8(const u8* a, const u8* b, u8* dst, u32 width, u32 step)
+{
+	const u32 next = step * 3;
+
+	for (u32 x = 0; x != width * 3; x += 3)
+	{
+		const u8* pa = a + x * 2;
+		const u8* pb = b + x * 2;
+
+		dst[x] = (u8)((pa[0] + pa[next] + pb[0] + pb[next]) >> 2);
+		dst[x + 1] = (u8)((pa[1] + pa[next + 1] + pb[1] + pb[next + 1]) >> 2);
+		dst[x + 2] = (u8)((pa[2] + pa[next + 2] + pb[2] + pb[next + 2]) >> 2);
+	}
+}
+
+
+//! averages 2x2 pixels of the rows a and b, channel by channel
+static void boxRow16(const u16* a, const u16* b, u16* dst, u32 width, u32 step, const SChannel16* channels)
+{
+	u32 x = 0;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	if (step)
+	{
+		const __m128i one = _mm_set1_epi16(1);
+		for (; x + 8 <= width; x += 8)
+		{
+			const __m128i a0 = _mm_loadu_si128((const __m128i*)(a + x * 2));
+			const __m128i a1 = _mm_loadu_si128((const __m128i*)(a + x * 2 + 8));
+			const __m128i b0 = _mm_loadu_si128((const __m128i*)(b + x * 2));
+			const __m128i b1 = _mm_loadu_si128((const __m128i*)(b + x * 2 + 8));
+
+			__m128i result = _mm_setzero_si128();
+			for (u32 c = 0; c != 4 && channels[c].Mask; ++c)
+			{
+				const __m128i shift = _mm_cvtsi32_si128(channels[c].Shift);
+				const __m128i mask = _mm_set1_epi16((s16)channels[c].Mask);
+
+				// vertical sums, then the neighboring pixels added to 32 bit
+				const __m128i v0 = _mm_add_epi16(_mm_and_si128(_mm_srl_epi16(a0, shift), mask),
+					_mm_and_si128(_mm_srl_epi16(b0, shift), mask));
+				const __m128i v1 = _mm_add_epi16(_mm_and_si128(_mm_srl_epi16(a1, shift), mask),
+					_mm_and_si128(_mm_srl_epi16(b1, shift), mask));
+				const __m128i sum = _mm_packs_epi32(_mm_madd_epi16(v0, one), _mm_madd_epi16(v1, one));
+
+				const __m128i average = _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16((s16)channels[c].Round)), 2);
+				result = _mm_or_si128(result, _mm_sll_epi16(average, shift));
+			}
+
+			_mm_storeu_si128((__m128i*)(dst + x), result);
+		}
+	}
+#endif
+
+	for (; x < width; ++x)
+	{
+		const u32 p0 = a[x * 2];
+		const u32 p1 = a[x * 2 + step];
+		const u32 p2 = b[x * 2];
+		const u32 p3 = b[x * 2 + step];
+
+		u32 result = 0;
+		for (u32 c = 0; c != 4 && channels[c].Mask; ++c)
+		{
+			const u32 shift = channels[c].Shift;
+			const u32 mask = channels[c].Mask;
+			const u32 sum = ((p0 >> shift) & mask) + ((p1 >> shift) & mask) +
+				((p2 >> shift) & mask) + ((p3 >> shift) & mask);
+
+			result |= ((sum + channels[c].Round) >> 2) << shift;
+		}
+		dst[x] = (u16)result;
+	}
+}
+
+
+//! filters the target rows [y0,y1) with the Kaiser weights, first along the source rows, then the columns
+static void kaiserRows(const SHalfSize& job, u32 y0, u32 y1)
+{
+	const s32 sourceWidth = (s32)job.SourceSize.Width;
+	const s32 sourceHeight = (s32)job.SourceSize.Height;
+	const u32 width = job.TargetSize.Width;
+
+	// source rows 2*y0-2 to 2*y1+1, filtered along the row with 4 channels each
+	const s32 firstRow = (s32)y0 * 2 - 2;
+	const u32 rows = (y1 - y0) * 2 + 4;
+
+	SColor* line = new SColor[core::max_((u32)sourceWidth, width)];
+	s32* filtered = new s32[rows * width * 4];
+
+	for (u32 row = 0; row != rows; ++row)
+	{
+		const s32 sy = core::s32_clamp(firstRow + (s32)row, 0, sourceHeight - 1);
+		CColorConverter::convert_viaFormat(job.Source + sy * job.SourcePitch, job.Format, sourceWidth, line, ECF_A8R8G8B8);
+
+		s32* dst = filtered + row * width * 4;
+		for (u32 x = 0; x != width; ++x)
+		{
+			s32 a = 0, r = 0, g = 0, b = 0;
+			for (s32 k = 0; k != 6; ++k)
+			{
+				const SColor& c = line[core::s32_clamp((s32)x * 2 - 2 + k, 0, sourceWidth - 1)];
+				a += KaiserWeights[k] * (s32)c.getAlpha();
+				r += KaiserWeights[k] * (s32)c.getRed();
+				g += KaiserWeights[k] * (s32)c.getGreen();
+				b += KaiserWeights[k] * (s32)c.getBlue();
+			}
+			dst[0] = a;
+			dst[1] = r;
+			dst[2] = g;
+			dst[3] = b;
+			dst += 4;
+		}
+	}
+
+	const u32 rowSize = width * 4;
+	for (u32 y = y0; y != y1; ++y)
+	{
+		const s32* src = filtered + (y - y0) * 2 * rowSize;
+		for (u32 x = 0; x != width; ++x)
+		{
+			s32 sum[4] = { 0, 0, 0, 0 };
+			for (u32 k = 0; k != 6; ++k)
+			{
+				const s32* c = src + k * rowSize + x * 4;
+				sum[0] += KaiserWeights[k] * c[0];
+				sum[1] += KaiserWeights[k] * c[1];
+				sum[2] += KaiserWeights[k] * c[2];
+				sum[3] += KaiserWeights[k] * c[3];
+			}
+
+			line[x].set(core::s32_clamp((sum[0] + 32768) >> 16, 0, 255),
+				core::s32_clamp((sum[1] + 32768) >> 16, 0, 255),
+				core::s32_clamp((sum[2] + 32768) >> 16, 0, 255),
+				core::s32_clamp((sum[3] + 32768) >> 16, 0, 255));
+		}
+		CColorConverter::convert_viaFormat(line, ECF_A8R8G8B8, width, job.Target + y * job.TargetPitch, job.Format);
+	}
+
+	delete [] filtered;
+	delete [] line;
+}
+
+
+//! halves the target rows [y0,y1)
+static void halfSizeRows(const SHalfSize& job, u32 y0, u32 y1)
+{
+	if (job.Filter == EMMF_KAISER)
+	{
+		kaiserRows(job, y0, y1);
+		return;
+	}
+
+	const u32 step = job.SourceSize.Width > 1 ? 1 : 0;
+	const u32 width = job.TargetSize.Width;
+
+	for (u32 y = y0; y != y1; ++y)
+	{
+		const u8* a = job.Source + core::min_(y * 2, job.SourceSize.Height - 1) * job.SourcePitch;
+		const u8* b = job.Source + core::min_(y * 2 + 1, job.SourceSize.Height - 1) * job.SourcePitch;
+		u8* dst = job.Target + y * job.TargetPitch;
+
+		switch (job.Format)
+		{
+		case ECF_A8R8G8B8:
+			boxRowA8R8G8B8((const u32*)a, (const u32*)b, (u32*)dst, width, step);
+			break;
+		case ECF_R8G8B8:
+			boxRowR8G8B8(a, b, dst, width, step);
+			break;
+		case ECF_A1R5G5B5:
+			boxRow16((const u16*)a, (const u16*)b, (u16*)dst, width, step, ChannelsA1R5G5B5);
+			break;
+		case ECF_R5G6B5:
+			boxRow16((const u16*)a, (const u16*)b, (u16*)dst, width, step, ChannelsR5G6B5);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+
+//! job of copyToHalfSize, halves a band of rows
+static void halfSizeJob(void* userData, u32 index)
+{
+	const SHalfSize& job = *(const SHalfSize*)userData;
+	const u32 y0 = index * HALF_SIZE_JOB_ROWS;
+
+	halfSizeRows(job, y0, core::min_(y0 + HALF_SIZE_JOB_ROWS, job.TargetSize.Height));
+}
+
+
+//! true for the formats copyToHalfSize works with
+static bool canCopyToHalfSize(ECOLOR_FORMAT format)
+{
+	switch (format)
+	{
+	case ECF_A8R8G8B8:
+	case ECF_R8G8B8:
+	case ECF_A1R5G5B5:
+	case ECF_R5G6B5:
+		return true;
+	default:
+		os::Printer::log("IImage::copyToHalfSize method doesn't work with this color format.", ELL_WARNING);
+		return false;
+	}
+}
+
+
+//! Largest image whose channel sums still fit into 32 bit
+static const u32 BOX_SUMS_MAX_PIXELS = 4096 * 4096;
+
+//! One mip map level made from the channel sums of the level before, shared by all jobs
+/** Each pixel keeps the sums of blue, green, red and alpha of all pixels of
+the full image it covers, so every level is the truncated average of the full
+image, not of the truncated level before. */
+struct SBoxLevel
+{
+	//! full image, only read for the first level
+	const u8* Source;
+	//! sums of the level before, 0 for the first level
+	const u32* Sums;
+	u32* NextSums;
+	u8* Target;
+	core::dimension2d<u32> SourceSize;
+	core::dimension2d<u32> TargetSize;
+	u32 SourcePitch;
+	u32 TargetPitch;
+	//! log2 of the number of full image pixels in one target pixel
+	u32 Shift;
+	ECOLOR_FORMAT Format;
+};
+
+
+//! adds the channels of a pixel as getPixel() returns them
+static inline void addPixel(u32* sum, const u8* pixel, ECOLOR_FORMAT format)
+{
+	u32 c;
+	switch (format)
+	{
+	case ECF_A1R5G5B5:
+		c = A1R5G5B5toA8R8G8B8(*(const u16*)pixel);
+		break;
+	case ECF_R5G6B5:
+		c = R5G6B5toA8R8G8B8(*(const u16*)pixel);
+		break;
+	case ECF_R8G8B8:
+		c = SColor(255, pixel[0], pixel[1], pixel[2]).color;
+		break;
+	default:
+		c = *(const u32*)pixel;
+		break;
+	}
+
+	sum[0] += c & 0xFF;
+	sum[1] += (c >> 8) & 0xFF;
+	sum[2] += (c >> 16) & 0xFF;
+	sum[3] += c >> 24;
+}
+
+
+//! sums 2x2 pixels of the rows a and b of the full image, b is 0 and step is 0 for sources one pixel high or wide
+static void sumPixelRow(const u8* a, const u8* b, u32* sums, u32 width, u32 step, ECOLOR_FORMAT format)
+{
+	u32 x = 0;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	if (format == ECF_A8R8G8B8 && b && step)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		for (; x + 2 <= width; x += 2)
+		{
+			const __m128i pa = _mm_loadu_si128((const __m128i*)(a + x * 8));
+			const __m128i pb = _mm_loadu_si128((const __m128i*)(b + x * 8));
+
+			// vertical sums with 16 bit per channel, then the neighboring pixels
+			const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(pa, zero), _mm_unpacklo_epi8(pb, zero));
+			const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(pa, zero), _mm_unpackhi_epi8(pb, zero));
+			const __m128i h = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+
+			_mm_storeu_si128((__m128i*)(sums + x * 4), _mm_unpacklo_epi16(h, zero));
+			_mm_storeu_si128((__m128i*)(sums + x * 4 + 4), _mm_unpackhi_epi16(h, zero));
+		}
+	}
+#endif
+
+	const u32 bpp = IImage::getBitsPerPixelFromFormat(format) / 8;
+	for (; x < width; ++x)
+	{
+		u32* sum = sums + x * 4;
+		sum[0] = sum[1] = sum[2] = sum[3] = 0;
+
+		const u32 offset = (step ? x * 2 : x) * bpp;
+		addPixel(sum, a + offset, format);
+		if (step)
+			addPixel(sum, a + offset + bpp, format);
+		if (b)
+		{
+			addPixel(sum, b + offset, format);
+			if (step)
+				addPixel(sum, b + offset + bpp, format);
+		}
+	}
+}
+
+
+//! adds the sums of 2x2 pixels of the rows a and b of the level before
+static void sumRow(const u32* a, const u32* b, u32* sums, u32 width, u32 step)
+{
+	for (u32 x = 0; x < width; ++x)
+	{
+		const u32 i = (step ? x * 2 : x) * 4;
+		const u32 next = i + step * 4;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+		__m128i s = _mm_loadu_si128((const __m128i*)(a + i));
+		if (step)
+			s = _mm_add_epi32(s, _mm_loadu_si128((const __m128i*)(a + next)));
+		if (b)
+		{
+			s = _mm_add_epi32(s, _mm_loadu_si128((const __m128i*)(b + i)));
+			if (step)
+				s = _mm_add_epi32(s, _mm_loadu_si128((const __m128i*)(b + next)));
+		}
+		_mm_storeu_si128((__m128i*)(sums + x * 4), s);
+#else
+		for (u32 c = 0; c != 4; ++c)
+		{
+			u32 s = a[i + c];
+			if (step)
+				s += a[next + c];
+			if (b)
+			{
+				s += b[i + c];
+				if (step)
+					s += b[next + c];
+			}
+			sums[x * 4 + c] = s;
+		}
+#endif
+	}
+}
+
+
+//! writes the averages of a row of sums in the format of the target
+static void storeSumsRow(const u32* sums, u8* dst, u32 width, u32 shift, ECOLOR_FORMAT format)
+{
+	u32 x = 0;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	if (format == ECF_A8R8G8B8)
+	{
+		const __m128i count = _mm_cvtsi32_si128(shift);
+		for (; x + 4 <= width; x += 4)
+		{
+			const __m128i p0 = _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(sums + x * 4)), count);
+			const __m128i p1 = _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(sums + x * 4 + 4)), count);
+			const __m128i p2 = _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(sums + x * 4 + 8)), count);
+			const __m128i p3 = _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(sums + x * 4 + 12)), count);
+
+			_mm_storeu_si128((__m128i*)(dst + x * 4),
+				_mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+		}
+	}
+#endif
+
+	for (; x < width; ++x)
+	{
+		const u32* sum = sums + x * 4;
+		const u32 c = (sum[0] >> shift) | ((sum[1] >> shift) << 8) | ((sum[2] >> shift) << 16) | ((sum[3] >> shift) << 24);
+
+		// the same conversions as setPixel()
+		switch (format)
+		{
+		case ECF_A1R5G5B5:
+			((u16*)dst)[x] = A8R8G8B8toA1R5G5B5(c);
+			break;
+		case ECF_R5G6B5:
+			((u16*)dst)[x] = A8R8G8B8toR5G6B5(c);
+			break;
+		case ECF_R8G8B8:
+			dst[x * 3] = (u8)(c >> 16);
+			dst[x * 3 + 1] = (u8)(c >> 8);
+			dst[x * 3 + 2] = (u8)c;
+			break;
+		default:
+			((u32*)dst)[x] = c;
+			break;
+		}
+	}
+}
+
+
+//! job of copyToBoxMipMaps, sums and averages a band of rows of one level
+static void boxLevelJob(void* userData, u32 index)
+{
+	const SBoxLevel& job = *(const SBoxLevel*)userData;
+	const u32 y0 = index * HALF_SIZE_JOB_ROWS;
+	const u32 y1 = core::min_(y0 + HALF_SIZE_JOB_ROWS, job.TargetSize.Height);
+
+	const u32 width = job.TargetSize.Width;
+	const u32 step = job.SourceSize.Width > 1 ? 1 : 0;
+	const bool pairs = job.SourceSize.Height > 1;
+
+	for (u32 y = y0; y != y1; ++y)
+	{
+		u32* sums = job.NextSums + y * width * 4;
+		const u32 row = pairs ? y * 2 : y;
+
+		if (job.Sums)
+		{
+			const u32* a = job.Sums + row * job.SourceSize.Width * 4;
+			sumRow(a, pairs ? a + job.SourceSize.Width * 4 : 0, sums, width, step);
+		}
+		else
+		{
+			const u8* a = job.Source + row * job.SourcePitch;
+			sumPixelRow(a, pairs ? a + job.SourcePitch : 0, sums, width, step, job.Format);
+		}
+
+		storeSumsRow(sums, job.Target + y * job.TargetPitch, width, job.Shift, job.Format);
+	}
+}
+
+
+//! copies this surface into a target of half its size
+bool CImage::copyToHalfSize(IImage* target, E_MIP_MAP_FILTER filter, IJobSystem* jobSystem)
+{
+	if (!target || !canCopyToHalfSize(Format))
+		return false;
+
+	const core::dimension2d<u32> halfSize(core::max_(1u, Size.Width >> 1), core::max_(1u, Size.Height >> 1));
+	if (target->getColorFormat() != Format || target->getDimension() != halfSize)
+	{
+		os::Printer::log("IImage::copyToHalfSize needs a target of the same format and half the size.", ELL_WARNING);
+		return false;
+	}
+
+	SHalfSize job;
+	job.Source = Data;
+	job.Target = (u8*)target->getData();
+	job.SourceSize = Size;
+	job.TargetSize = halfSize;
+	job.SourcePitch = Pitch;
+	job.TargetPitch = target->getPitch();
+	job.Format = Format;
+	job.Filter = filter;
+
+	// bands of rows keep the buffers of the Kaiser filter small
+	const u32 bands = (halfSize.Height + HALF_SIZE_JOB_ROWS - 1) / HALF_SIZE_JOB_ROWS;
+	if (jobSystem && halfSize.getArea() >= HALF_SIZE_PARALLEL_PIXELS)
+		jobSystem->parallelFor(bands, halfSizeJob, &job);
+	else
+	{
+		for (u32 i = 0; i != bands; ++i)
+			halfSizeJob(&job, i);
+	}
+
+	return true;
+}
+
+
+//! fills mip map levels with the box filtered pixels of this image
+bool CImage::copyToBoxMipMaps(CImage* const* levels, u32 count, IJobSystem* jobSystem)
+{
+	if (!count || !canCopyToHalfSize(Format))
+		return false;
+
+	// other sizes don't split into whole boxes, larger ones overflow the sums
+	if ((Size.Width & (Size.Width - 1)) || (Size.Height & (Size.Height - 1)) || Size.getArea() > BOX_SUMS_MAX_PIXELS)
+		return false;
+
+	core::dimension2d<u32> size = Size;
+	for (u32 i = 0; i != count; ++i)
+	{
+		size.set(core::max_(1u, size.Width >> 1), core::max_(1u, size.Height >> 1));
+		if (!levels[i] || levels[i]->getColorFormat() != Format || levels[i]->getDimension() != size)
+		{
+			os::Printer::log("IImage::copyToBoxMipMaps needs levels of the same format, each half the size of the one before.", ELL_WARNING);
+			return false;
+		}
+	}
+
+	// levels take turns in two buffers, each level has a quarter of the pixels of the one two before
+	const core::dimension2d<u32>& first = levels[0]->getDimension();
+	const u32 secondArea = count > 1 ? levels[1]->getDimension().getArea() : 1;
+	u32* buffers[2] = { new u32[first.getArea() * 4], new u32[secondArea * 4] };
+
+	SBoxLevel job;
+	job.Source = Data;
+	job.Sums = 0;
+	job.SourceSize = Size;
+	job.SourcePitch = Pitch;
+	job.Shift = 0;
+	job.Format = Format;
+
+	for (u32 i = 0; i != count; ++i)
+	{
+		job.NextSums = buffers[i & 1];
+		job.Target = (u8*)levels[i]->getData();
+		job.TargetSize = levels[i]->getDimension();
+		job.TargetPitch = levels[i]->getPitch();
+		job.Shift += (job.SourceSize.Width > 1 ? 1 : 0) + (job.SourceSize.Height > 1 ? 1 : 0);
+
+		const u32 bands = (job.TargetSize.Height + HALF_SIZE_JOB_ROWS - 1) / HALF_SIZE_JOB_ROWS;
+		if (jobSystem && job.TargetSize.getArea() >= HALF_SIZE_PARALLEL_PIXELS)
+			jobSystem->parallelFor(bands, boxLevelJob, &job);
+		else
+		{
+			for (u32 b = 0; b != bands; ++b)
+				boxLevelJob(&job, b);
+		}
+
+		job.Sums = job.NextSums;
+		job.SourceSize = job.TargetSize;
+	}
+
+	delete [] buffers[1];
+	delete [] buffers[0];
+
+	return true;
+}
+
+
+//! creates all mip map levels and stores them as mip maps data
+bool CImage::createMipMaps(E_MIP_MAP_FILTER filter, IJobSystem* jobSystem)
+{
+	if (!canCopyToHalfSize(Format))
+		return false;
+
+	// the same levels setMipMapsData expects
+	u32 dataSize = 0;
+	core::array<core::dimension2d<u32> > sizes;
+	core::dimension2d<u32> size = Size;
+
+	do
+	{
+		if (size.Width > 1)
+			size.Width >>= 1;
+
+		if (size.Height > 1)
+			size.Height >>= 1;
+
+		sizes.push_back(size);
+		dataSize += getDataSizeFromFormat(Format, size.Width, size.Height);
+	} while (size.Width != 1 || size.Height != 1);
+
+	u8* data = Allocator.allocate(dataSize);
+	core::array<CImage*> levels(sizes.size());
+	u8* level = data;
+
+	for (u32 i = 0; i != sizes.size(); ++i)
+	{
+		levels.push_back(new CImage(Format, sizes[i], level, true, false));
+		level += getDataSizeFromFormat(Format, sizes[i].Width, sizes[i].Height);
+	}
+
+	if (filter != EMMF_BOX || !copyToBoxMipMaps(levels.const_pointer(), levels.size(), jobSystem))
+	{
+		copyToHalfSize(levels[0], filter, jobSystem);
+		for (u32 i = 1; i != levels.size(); ++i)
+			levels[i - 1]->copyToHalfSize(levels[i], filter, jobSystem);
+	}
+
+	for (u32 i = 0; i != levels.size(); ++i)
+		levels[i]->drop();
+
+	setMipMapsData(data, true, true);
+
+	return true;
+}
+
+
 //! fills the surface with given color
 void CImage::fill(const SColor &color)
 {
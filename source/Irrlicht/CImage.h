@@ -55,6 +55,23 @@ public:
 	//! copies this surface into another, scaling it to fit, applying a box filter
 	virtual void copyToScalingBoxFilter(IImage* target, s32 bias = 0, bool blend = false) _IRR_OVERRIDE_;
 
+	//! copies this surface into a target of half its size
+	virtual bool copyToHalfSize(IImage* target, E_MIP_MAP_FILTER filter = EMMF_BOX, IJobSystem* jobSystem = 0) _IRR_OVERRIDE_;
+
+	//! creates all mip map levels and stores them as mip maps data
+	virtual bool createMipMaps(E_MIP_MAP_FILTER filter = EMMF_BOX, IJobSystem* jobSystem = 0) _IRR_OVERRIDE_;
+
+	//! Fills mip map levels with the box filtered pixels of this image
+	/** Each level gets the same pixels copyToScalingBoxFilter() gives from
+	this image, but the levels are summed up from each other. Only works for
+	power of two sizes up to 4096x4096, and the formats of copyToHalfSize().
+	\param levels Images of the same format, each max(1,width/2) x max(1,height/2)
+	of the one before, starting at half the size of this image.
+	\param count Number of levels.
+	\param jobSystem When set, the rows of large levels are split over its threads.
+	\return True on success. */
+	bool copyToBoxMipMaps(CImage* const* levels, u32 count, IJobSystem* jobSystem = 0);
+
 	//! fills the surface with given color
 	virtual void fill(const SColor &color) _IRR_OVERRIDE_;
 
@@ -0,0 +1,274 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CInstancedMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IMaterialRenderer.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! constructor
+CInstancedMeshSceneNode::CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+: IInstancedMeshSceneNode(parent, mgr, id, position, rotation, scale),
+	CulledCamera(0), BoxesDirty(true), Mesh(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CInstancedMeshSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CInstancedMeshSceneNode::~CInstancedMeshSceneNode()
+{
+	if (Mesh)
+		Mesh->drop();
+}
+
+
+//! frame
+void CInstancedMeshSceneNode::OnRegisterSceneNode()
+{
+	if (!IsVisible)
+		return;
+
+	// the instances are culled in render(), each view of drawAll has its own camera
+	CulledCamera = 0;
+	VisibleInstances.set_used(0);
+
+	if (Mesh && !Instances.empty())
+	{
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		u32 transparentCount = 0;
+		u32 solidCount = 0;
+		for (u32 i=0; i<Materials.size(); ++i)
+		{
+			video::IMaterialRenderer* rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
+			if ((rnd && rnd->isTransparent()) || Materials[i].isTransparent())
+				++transparentCount;
+			else
+				++solidCount;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+void CInstancedMeshSceneNode::cullInstances()
+{
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (CulledCamera && camera == CulledCamera)
+		return;
+
+	CulledCamera = camera;
+	VisibleInstances.set_used(0);
+
+	if (!camera || AutomaticCullingState == EAC_OFF)
+	{
+		VisibleInstances = Instances;
+		return;
+	}
+
+	updateBoxes();
+
+	// test the boxes of the instances in the space of this node
+	SViewFrustum frustum(*camera->getViewFrustum());
+	core::matrix4 inverse;
+	if (AbsoluteTransformation.getInverse(inverse))
+		frustum.transform(inverse);
+
+	Relations.set_used(Instances.size());
+	InstanceBoxes.classify(frustum, 0, Instances.size(), Relations.pointer());
+
+	for (u32 i=0; i<Instances.size(); ++i)
+	{
+		if (Relations[i] != core::ISREL3D_FRONT)
+			VisibleInstances.push_back(Instances[i]);
+	}
+}
+
+
+//! renders the node.
+void CInstancedMeshSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	if (!Mesh || !driver)
+		return;
+
+	cullInstances();
+	if (VisibleInstances.empty())
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == ESNRP_TRANSPARENT;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		if (!mb)
+			continue;
+
+		const video::SMaterial& material = Materials[i];
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent()) || material.isTransparent();
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(material);
+			driver->drawMeshBufferInstanced(mb, VisibleInstances.const_pointer(), VisibleInstances.size());
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible & EDS_BBOX)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		driver->draw3DBox(getBoundingBox(), video::SColor(255,255,255,255));
+	}
+}
+
+
+//! returns the axis aligned bounding box around all instances
+const core::aabbox3d<f32>& CInstancedMeshSceneNode::getBoundingBox() const
+{
+	updateBoxes();
+	return Box;
+}
+
+
+void CInstancedMeshSceneNode::updateBoxes() const
+{
+	if (!BoxesDirty)
+		return;
+	BoxesDirty = false;
+
+	InstanceBoxes.clear();
+	Box.reset(0,0,0);
+
+	if (!Mesh)
+		return;
+
+	InstanceBoxes.reallocate(Instances.size());
+	const core::aabbox3df& meshBox = Mesh->getBoundingBox();
+	for (u32 i=0; i<Instances.size(); ++i)
+	{
+		core::aabbox3df box(meshBox);
+		Instances[i].Transformation.transformBoxEx(box);
+		InstanceBoxes.push_back(box);
+
+		if (i)
+			Box.addInternalBox(box);
+		else
+			Box = box;
+	}
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CInstancedMeshSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CInstancedMeshSceneNode::getMaterialCount() const
+{
+	return Materials.size();
+}
+
+
+//! Sets a new mesh
+void CInstancedMeshSceneNode::setMesh(IMesh* mesh)
+{
+	if (mesh)
+	{
+		mesh->grab();
+		if (Mesh)
+			Mesh->drop();
+
+		Mesh = mesh;
+
+		Materials.clear();
+		Materials.reallocate(Mesh->getMeshBufferCount());
+		for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+			Materials.push_back(mb ? mb->getMaterial() : video::SMaterial());
+		}
+
+		BoxesDirty = true;
+	}
+}
+
+
+//! Adds an instance
+u32 CInstancedMeshSceneNode::addInstance(const core::matrix4& transformation, video::SColor color)
+{
+	Instances.push_back(video::SInstanceData(transformation, color));
+	BoxesDirty = true;
+	return Instances.size() - 1;
+}
+
+
+//! Removes an instance
+void CInstancedMeshSceneNode::removeInstance(u32 index)
+{
+	if (index >= Instances.size())
+		return;
+
+	Instances[index] = Instances.getLast();
+	Instances.erase(Instances.size() - 1);
+	BoxesDirty = true;
+}
+
+
+//! Removes all instances
+void CInstancedMeshSceneNode::clearInstances()
+{
+	Instances.clear();
+	VisibleInstances.clear();
+	CulledCamera = 0;
+	BoxesDirty = true;
+}
+
+
+//! Sets the transformation of an instance
+void CInstancedMeshSceneNode::setInstanceTransformation(u32 index, const core::matrix4& transformation)
+{
+	Instances[index].Transformation = transformation;
+	BoxesDirty = true;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
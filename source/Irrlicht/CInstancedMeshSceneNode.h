@@ -0,0 +1,113 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+#define __C_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "IInstancedMeshSceneNode.h"
+#include "IMesh.h"
+#include "CFrustumBoxBatch.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	class ICameraSceneNode;
+
+	class CInstancedMeshSceneNode : public IInstancedMeshSceneNode
+	{
+	public:
+
+		//! constructor
+		CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		//! destructor
+		virtual ~CInstancedMeshSceneNode();
+
+		//! frame
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box around all instances
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_INSTANCED_MESH; }
+
+		//! Sets a new mesh
+		virtual void setMesh(IMesh* mesh) _IRR_OVERRIDE_;
+
+		//! Returns the current mesh
+		virtual IMesh* getMesh(void) _IRR_OVERRIDE_ { return Mesh; }
+
+		//! Adds an instance
+		virtual u32 addInstance(const core::matrix4& transformation, video::SColor color) _IRR_OVERRIDE_;
+
+		//! Removes an instance
+		virtual void removeInstance(u32 index) _IRR_OVERRIDE_;
+
+		//! Removes all instances
+		virtual void clearInstances() _IRR_OVERRIDE_;
+
+		//! Get the number of instances
+		virtual u32 getInstanceCount() const _IRR_OVERRIDE_ { return Instances.size(); }
+
+		//! Get the data of all instances as one array
+		virtual const video::SInstanceData* getInstances() const _IRR_OVERRIDE_ { return Instances.const_pointer(); }
+
+		//! Sets the transformation of an instance
+		virtual void setInstanceTransformation(u32 index, const core::matrix4& transformation) _IRR_OVERRIDE_;
+
+		//! Get the transformation of an instance
+		virtual const core::matrix4& getInstanceTransformation(u32 index) const _IRR_OVERRIDE_ { return Instances[index].Transformation; }
+
+		//! Sets the color of an instance
+		virtual void setInstanceColor(u32 index, video::SColor color) _IRR_OVERRIDE_ { Instances[index].Color = color; }
+
+		//! Get the color of an instance
+		virtual video::SColor getInstanceColor(u32 index) const _IRR_OVERRIDE_ { return Instances[index].Color; }
+
+		//! Get the number of instances which passed culling in the last frame
+		virtual u32 getVisibleInstanceCount() const _IRR_OVERRIDE_ { return VisibleInstances.size(); }
+
+	private:
+
+		//! Recalculates the boxes of all instances when needed
+		void updateBoxes() const;
+
+		//! Collects the instances inside the view frustum of the active camera
+		/** Only done once for each camera after the node was registered. */
+		void cullInstances();
+
+		core::array<video::SMaterial> Materials;
+		core::array<video::SInstanceData> Instances;
+		core::array<video::SInstanceData> VisibleInstances;
+		core::array<core::EIntersectionRelation3D> Relations;
+		//! camera of VisibleInstances, 0 if they have to be culled again
+		const ICameraSceneNode* CulledCamera;
+
+		//! Boxes of the instances in the space of this node
+		mutable CFrustumBoxBatch InstanceBoxes;
+		mutable core::aabbox3d<f32> Box;
+		mutable bool BoxesDirty;
+
+		IMesh* Mesh;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
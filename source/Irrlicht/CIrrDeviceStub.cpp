@@ -13,6 +13,7 @@
 #include "CLogger.h"
 #include "irrString.h"
 #include "IRandomizer.h"
+#include "CJobSystem.h"
 
 namespace irr
 {
@@ -20,7 +21,7 @@ namespace irr
 CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 : IrrlichtDevice(), VideoDriver(0), GUIEnvironment(0), SceneManager(0),
 	Timer(0), CursorControl(0), UserReceiver(params.EventReceiver),
-	Logger(0), Operator(0), Randomizer(0), FileSystem(0),
+	Logger(0), Operator(0), Randomizer(0), JobSystem(0), FileSystem(0),
 	InputReceivingSceneManager(0), VideoModeList(0), ContextManager(0),
 	CreationParams(params), Close(false)
 {
@@ -40,6 +41,7 @@ CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 
 	os::Printer::Logger = Logger;
 	Randomizer = createDefaultRandomizer();
+	JobSystem = new CJobSystem(params.JobThreads);
 
 	FileSystem = io::createFileSystem();
 	VideoModeList = new video::CVideoModeList();
@@ -83,6 +85,9 @@ CIrrDeviceStub::~CIrrDeviceStub()
 	if (Randomizer)
 		Randomizer->drop();
 
+	if (JobSystem)
+		JobSystem->drop();
+
 	CursorControl = 0;
 
 	if (Timer)
@@ -100,8 +105,13 @@ void CIrrDeviceStub::createGUIAndScene()
 	GUIEnvironment = gui::createGUIEnvironment(FileSystem, VideoDriver, Operator);
 	#endif
 
+	if (VideoDriver)
+		VideoDriver->setJobSystem(JobSystem);
+
 	// create Scene manager
 	SceneManager = scene::createSceneManager(VideoDriver, FileSystem, CursorControl, GUIEnvironment);
+	if (SceneManager)
+		SceneManager->setJobSystem(JobSystem);
 
 	setEventReceiver(UserReceiver);
 }
@@ -146,6 +156,13 @@ ITimer* CIrrDeviceStub::getTimer()
 }
 
 
+//! Returns the job system
+IJobSystem* CIrrDeviceStub::getJobSystem()
+{
+	return JobSystem;
+}
+
+
 //! Returns the version of the engine.
 const char* CIrrDeviceStub::getVersion() const
 {
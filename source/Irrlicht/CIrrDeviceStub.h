@@ -83,6 +83,9 @@ namespace irr
 		//! Returns a pointer to the ITimer object. With it the current Time can be received.
 		virtual ITimer* getTimer() _IRR_OVERRIDE_;
 
+		//! Returns the job system
+		virtual IJobSystem* getJobSystem() _IRR_OVERRIDE_;
+
 		//! Returns the version of the engine.
 		virtual const char* getVersion() const _IRR_OVERRIDE_;
 
@@ -167,6 +170,7 @@ namespace irr
 		CLogger* Logger;
 		IOSOperator* Operator;
 		IRandomizer* Randomizer;
+		IJobSystem* JobSystem;
 		io::IFileSystem* FileSystem;
 		scene::ISceneManager* InputReceivingSceneManager;
 
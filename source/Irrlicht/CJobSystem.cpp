@@ -0,0 +1,290 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CJobSystem.h"
+#include "os.h"
+
+namespace irr
+{
+
+#if defined(_IRR_WINDOWS_API_)
+
+CJobMutex::CJobMutex()
+{
+	InitializeCriticalSection(&Section);
+	InitializeConditionVariable(&Condition);
+}
+
+CJobMutex::~CJobMutex()
+{
+	DeleteCriticalSection(&Section);
+}
+
+void CJobMutex::lock()
+{
+	EnterCriticalSection(&Section);
+}
+
+void CJobMutex::unlock()
+{
+	LeaveCriticalSection(&Section);
+}
+
+void CJobMutex::wait()
+{
+	SleepConditionVariableCS(&Condition, &Section, INFINITE);
+}
+
+void CJobMutex::broadcast()
+{
+	WakeAllConditionVariable(&Condition);
+}
+
+#else
+
+CJobMutex::CJobMutex()
+{
+	pthread_mutex_init(&Mutex, 0);
+	pthread_cond_init(&Condition, 0);
+}
+
+CJobMutex::~CJobMutex()
+{
+	pthread_cond_destroy(&Condition);
+	pthread_mutex_destroy(&Mutex);
+}
+
+void CJobMutex::lock()
+{
+	pthread_mutex_lock(&Mutex);
+}
+
+void CJobMutex::unlock()
+{
+	pthread_mutex_unlock(&Mutex);
+}
+
+void CJobMutex::wait()
+{
+	pthread_cond_wait(&Condition, &Mutex);
+}
+
+void CJobMutex::broadcast()
+{
+	pthread_cond_broadcast(&Condition);
+}
+
+#endif
+
+
+CJobSystem::CJobSystem(u32 workerCount)
+	: Ranges(0), Generation(0), ActiveWorkers(0), Busy(false), Quit(false),
+	Job(0), UserData(0), GrainSize(1)
+{
+	#ifdef _DEBUG
+	setDebugName("CJobSystem");
+	#endif
+
+	Ranges = new SRange[workerCount + 1];
+
+	Workers.reallocate(workerCount);
+	for (u32 i=0; i<workerCount; ++i)
+	{
+		Workers.push_back(SWorker());
+		SWorker& worker = Workers.getLast();
+		worker.Owner = this;
+		worker.Slot = i + 1;
+#if defined(_IRR_WINDOWS_API_)
+		worker.Thread = CreateThread(0, 0, threadMain, &worker, 0, 0);
+		const bool started = (worker.Thread != 0);
+#else
+		const bool started = (pthread_create(&worker.Thread, 0, threadMain, &worker) == 0);
+#endif
+		if (!started)
+		{
+			os::Printer::log("Could not start all worker threads for the job system.", ELL_WARNING);
+			Workers.erase(Workers.size()-1);
+			break;
+		}
+	}
+}
+
+
+CJobSystem::~CJobSystem()
+{
+	State.lock();
+	Quit = true;
+	State.broadcast();
+	State.unlock();
+
+	for (u32 i=0; i<Workers.size(); ++i)
+	{
+#if defined(_IRR_WINDOWS_API_)
+		WaitForSingleObject(Workers[i].Thread, INFINITE);
+		CloseHandle(Workers[i].Thread);
+#else
+		pthread_join(Workers[i].Thread, 0);
+#endif
+	}
+
+	delete [] Ranges;
+}
+
+
+#if defined(_IRR_WINDOWS_API_)
+DWORD WINAPI CJobSystem::threadMain(LPVOID data)
+{
+	SWorker* worker = (SWorker*)data;
+	worker->Owner->workerLoop(worker->Slot);
+	return 0;
+}
+#else
+void* CJobSystem::threadMain(void* data)
+{
+	SWorker* worker = (SWorker*)data;
+	worker->Owner->workerLoop(worker->Slot);
+	return 0;
+}
+#endif
+
+
+void CJobSystem::workerLoop(u32 slot)
+{
+	u32 seenGeneration = 0;
+
+	State.lock();
+	while (true)
+	{
+		while (!Quit && Generation == seenGeneration)
+			State.wait();
+		if (Quit)
+			break;
+		seenGeneration = Generation;
+		State.unlock();
+
+		runSlot(slot);
+
+		State.lock();
+		if (--ActiveWorkers == 0)
+			State.broadcast();
+	}
+	State.unlock();
+}
+
+
+void CJobSystem::parallelFor(u32 count, JobFunction job, void* userData, u32 grainSize)
+{
+	if (!count || !job)
+		return;
+	if (!grainSize)
+		grainSize = 1;
+
+	bool serial = Workers.empty() || count <= grainSize;
+	if (!serial)
+	{
+		State.lock();
+		serial = Busy;
+		Busy = true;
+		State.unlock();
+	}
+
+	if (serial)
+	{
+		for (u32 i=0; i<count; ++i)
+			job(userData, i);
+		return;
+	}
+
+	// give each thread an equal part, stealing balances the rest
+	const u32 slots = Workers.size() + 1;
+	for (u32 i=0; i<slots; ++i)
+	{
+		Ranges[i].Begin = (u32)((u64)count * i / slots);
+		Ranges[i].End = (u32)((u64)count * (i + 1) / slots);
+	}
+
+	State.lock();
+	Job = job;
+	UserData = userData;
+	GrainSize = grainSize;
+	ActiveWorkers = Workers.size();
+	++Generation;
+	State.broadcast();
+	State.unlock();
+
+	runSlot(0);
+
+	State.lock();
+	while (ActiveWorkers)
+		State.wait();
+	Busy = false;
+	State.unlock();
+}
+
+
+void CJobSystem::runSlot(u32 slot)
+{
+	u32 begin, end;
+	while (true)
+	{
+		if (!popFront(slot, begin, end))
+		{
+			if (!steal(slot))
+				return;
+			continue;
+		}
+
+		for (u32 i=begin; i<end; ++i)
+			Job(UserData, i);
+	}
+}
+
+
+bool CJobSystem::popFront(u32 slot, u32& begin, u32& end)
+{
+	SRange& range = Ranges[slot];
+	range.Lock.lock();
+	const bool found = range.Begin < range.End;
+	if (found)
+	{
+		begin = range.Begin;
+		end = core::min_(range.Begin + GrainSize, range.End);
+		range.Begin = end;
+	}
+	range.Lock.unlock();
+	return found;
+}
+
+
+bool CJobSystem::steal(u32 slot)
+{
+	const u32 slots = Workers.size() + 1;
+	for (u32 i=1; i<slots; ++i)
+	{
+		SRange& victim = Ranges[(slot + i) % slots];
+
+		victim.Lock.lock();
+		const u32 remaining = victim.End - victim.Begin;
+		if (victim.Begin >= victim.End)
+		{
+			victim.Lock.unlock();
+			continue;
+		}
+
+		// take the back half, the owner keeps working on the front
+		const u32 end = victim.End;
+		const u32 begin = end - (remaining + 1) / 2;
+		victim.End = begin;
+		victim.Lock.unlock();
+
+		SRange& own = Ranges[slot];
+		own.Lock.lock();
+		own.Begin = begin;
+		own.End = end;
+		own.Lock.unlock();
+		return true;
+	}
+	return false;
+}
+
+} // end namespace irr
@@ -0,0 +1,121 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_JOB_SYSTEM_H_INCLUDED__
+#define __C_JOB_SYSTEM_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "IJobSystem.h"
+#include "irrArray.h"
+
+#if defined(_IRR_WINDOWS_API_)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace irr
+{
+
+//! Mutex and condition variable used by the job system
+class CJobMutex
+{
+public:
+	CJobMutex();
+	~CJobMutex();
+
+	void lock();
+	void unlock();
+
+	//! Unlocks the mutex, waits until signaled and locks again
+	void wait();
+
+	//! Wake up all threads waiting on this mutex
+	void broadcast();
+
+private:
+#if defined(_IRR_WINDOWS_API_)
+	CRITICAL_SECTION Section;
+	CONDITION_VARIABLE Condition;
+#else
+	pthread_mutex_t Mutex;
+	pthread_cond_t Condition;
+#endif
+};
+
+//! Work-stealing thread pool
+class CJobSystem : public IJobSystem
+{
+public:
+
+	//! Starts the given number of worker threads
+	CJobSystem(u32 workerCount);
+
+	//! Stops all worker threads
+	virtual ~CJobSystem();
+
+	//! Get the number of worker threads.
+	virtual u32 getWorkerCount() const _IRR_OVERRIDE_ { return Workers.size(); }
+
+	//! Calls a function for each index in [0, count) and waits until all calls are done.
+	virtual void parallelFor(u32 count, JobFunction job, void* userData, u32 grainSize=1) _IRR_OVERRIDE_;
+
+private:
+
+	struct SWorker
+	{
+		CJobSystem* Owner;
+		u32 Slot;
+#if defined(_IRR_WINDOWS_API_)
+		HANDLE Thread;
+#else
+		pthread_t Thread;
+#endif
+	};
+
+	//! Range of indices owned by one thread. The owner takes work from
+	//! the front, other threads steal from the back.
+	struct SRange
+	{
+		CJobMutex Lock;
+		u32 Begin;
+		u32 End;
+	};
+
+#if defined(_IRR_WINDOWS_API_)
+	static DWORD WINAPI threadMain(LPVOID data);
+#else
+	static void* threadMain(void* data);
+#endif
+
+	//! Main loop of a worker thread
+	void workerLoop(u32 slot);
+
+	//! Processes indices until no range has work left
+	void runSlot(u32 slot);
+
+	//! Take the next indices of a slot, false when it's empty
+	bool popFront(u32 slot, u32& begin, u32& end);
+
+	//! Move half of the work of another slot into the given slot
+	bool steal(u32 slot);
+
+	core::array<SWorker> Workers;
+	//! One range per worker and one for the calling thread (slot 0)
+	SRange* Ranges;
+
+	//! Protects the members below
+	CJobMutex State;
+	u32 Generation;
+	u32 ActiveWorkers;
+	bool Busy;
+	bool Quit;
+
+	JobFunction Job;
+	void* UserData;
+	u32 GrainSize;
+};
+
+} // end namespace irr
+
+#endif
@@ -0,0 +1,352 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CLODSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IMeshCache.h"
+#include "IAnimatedMesh.h"
+#include "IMaterialRenderer.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! constructor
+CLODSceneNode::CLODSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+: ILODSceneNode(parent, mgr, id, position, rotation, scale),
+	CurrentLevel(0), ScreenSize(0.f), Hysteresis(0.1f), SelectedCamera(0), Frame(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CLODSceneNode");
+	#endif
+}
+
+
+//! destructor
+CLODSceneNode::~CLODSceneNode()
+{
+	clearLevels();
+}
+
+
+//! frame
+void CLODSceneNode::OnRegisterSceneNode()
+{
+	if (!IsVisible)
+		return;
+
+	// the level is selected in render(), each view of drawAll has its own camera
+	SelectedCamera = 0;
+
+	// forget the cameras which didn't draw the node in the last frame
+	++Frame;
+	for (u32 i=0; i<CameraLevels.size();)
+	{
+		if (Frame - CameraLevels[i].Frame > 1)
+			CameraLevels.erase(i);
+		else
+			++i;
+	}
+
+	// the passes needed by any level
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	u32 transparentCount = 0;
+	u32 solidCount = 0;
+	for (u32 l=0; l<Levels.size(); ++l)
+	{
+		const core::array<video::SMaterial>& materials = Levels[l].Materials;
+		for (u32 i=0; i<materials.size(); ++i)
+		{
+			video::IMaterialRenderer* rnd = driver->getMaterialRenderer(materials[i].MaterialType);
+			if ((rnd && rnd->isTransparent()) || materials[i].isTransparent())
+				++transparentCount;
+			else
+				++solidCount;
+		}
+	}
+
+	if (solidCount)
+		SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+
+	if (transparentCount)
+		SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+void CLODSceneNode::selectLevel()
+{
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (SelectedCamera && camera == SelectedCamera)
+		return;
+
+	SelectedCamera = camera;
+
+	if (!camera || Levels.empty())
+	{
+		CurrentLevel = 0;
+		return;
+	}
+
+	// diameter of the bounding sphere relative to the screen height,
+	// the projection maps half the screen height to 1
+	core::aabbox3df box(Box);
+	AbsoluteTransformation.transformBoxEx(box);
+	const f32 radius = box.getExtent().getLength() * 0.5f;
+	const f32 projection = camera->getProjectionMatrix()[5];
+
+	if (camera->isOrthogonal())
+		ScreenSize = radius * projection;
+	else
+	{
+		const f32 distance = camera->getAbsolutePosition().getDistanceFrom(box.getCenter());
+		ScreenSize = (distance > radius) ? radius * projection / distance : FLT_MAX;
+	}
+
+	u32 i;
+	for (i=0; i<CameraLevels.size(); ++i)
+	{
+		if (CameraLevels[i].Camera == camera)
+			break;
+	}
+
+	if (i == CameraLevels.size())
+	{
+		SCameraLevel entry;
+		entry.Camera = camera;
+		entry.Level = getLevelForScreenSize(ScreenSize);
+		CameraLevels.push_back(entry);
+	}
+	else
+	{
+		// change only when the size is clearly beyond the threshold
+		const u32 finer = getLevelForScreenSize(ScreenSize / (1.f + Hysteresis));
+		const u32 coarser = getLevelForScreenSize(ScreenSize / (1.f - Hysteresis));
+
+		if (CameraLevels[i].Level > finer)
+			CameraLevels[i].Level = finer;
+		else if (CameraLevels[i].Level < coarser)
+			CameraLevels[i].Level = coarser;
+	}
+
+	CameraLevels[i].Frame = Frame;
+	CurrentLevel = CameraLevels[i].Level;
+}
+
+
+u32 CLODSceneNode::getLevelForScreenSize(f32 screenSize) const
+{
+	for (u32 i=0; i<Levels.size(); ++i)
+	{
+		if (screenSize >= Levels[i].ScreenSize)
+			return i;
+	}
+	return Levels.size();
+}
+
+
+//! renders the node.
+void CLODSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (!driver)
+		return;
+
+	selectLevel();
+	if (CurrentLevel >= Levels.size())
+		return;
+
+	const SLevel& level = Levels[CurrentLevel];
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == ESNRP_TRANSPARENT;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	for (u32 i=0; i<level.Mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* mb = level.Mesh->getMeshBuffer(i);
+		if (!mb)
+			continue;
+
+		const video::SMaterial& material = level.Materials[i];
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent()) || material.isTransparent();
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(material);
+			driver->drawMeshBuffer(mb);
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible & EDS_BBOX)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		driver->draw3DBox(Box, video::SColor(255,255,255,255));
+	}
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CLODSceneNode::getMaterial(u32 i)
+{
+	for (u32 l=0; l<Levels.size(); ++l)
+	{
+		if (i < Levels[l].Materials.size())
+			return Levels[l].Materials[i];
+		i -= Levels[l].Materials.size();
+	}
+
+	return ISceneNode::getMaterial(i);
+}
+
+
+//! returns amount of materials of all levels.
+u32 CLODSceneNode::getMaterialCount() const
+{
+	u32 count = 0;
+	for (u32 l=0; l<Levels.size(); ++l)
+		count += Levels[l].Materials.size();
+	return count;
+}
+
+
+//! Adds a level of detail
+u32 CLODSceneNode::addLevel(IMesh* mesh, f32 minScreenSize)
+{
+	if (!mesh)
+		return Levels.size();
+
+	mesh->grab();
+
+	SLevel level;
+	level.Mesh = mesh;
+	level.ScreenSize = minScreenSize;
+	level.Materials.reallocate(mesh->getMeshBufferCount());
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		level.Materials.push_back(mb ? mb->getMaterial() : video::SMaterial());
+	}
+
+	// keep the levels sorted by screen size
+	u32 index = 0;
+	while (index < Levels.size() && Levels[index].ScreenSize >= minScreenSize)
+		++index;
+	Levels.insert(level, index);
+
+	if (Levels.size() == 1)
+		Box = mesh->getBoundingBox();
+	else
+		Box.addInternalBox(mesh->getBoundingBox());
+
+	CameraLevels.clear();
+	SelectedCamera = 0;
+	return index;
+}
+
+
+//! Removes all levels
+void CLODSceneNode::clearLevels()
+{
+	for (u32 i=0; i<Levels.size(); ++i)
+		Levels[i].Mesh->drop();
+
+	Levels.clear();
+	Box.reset(0,0,0);
+	CurrentLevel = 0;
+	CameraLevels.clear();
+	SelectedCamera = 0;
+}
+
+
+//! Sets how far the screen size has to pass a threshold before the level changes.
+void CLODSceneNode::setHysteresis(f32 hysteresis)
+{
+	Hysteresis = core::clamp(hysteresis, 0.f, 0.9f);
+}
+
+
+//! Writes attributes of the scene node.
+void CLODSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	ILODSceneNode::serializeAttributes(out, options);
+
+	out->addFloat("Hysteresis", Hysteresis);
+
+	for (u32 i=0; i<Levels.size(); ++i)
+	{
+		const core::stringc index(i);
+		out->addString((core::stringc("Mesh") + index).c_str(),
+			SceneManager->getMeshCache()->getMeshName(Levels[i].Mesh).getPath().c_str());
+		out->addFloat((core::stringc("ScreenSize") + index).c_str(), Levels[i].ScreenSize);
+	}
+}
+
+
+//! Reads attributes of the scene node.
+void CLODSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	setHysteresis(in->getAttributeAsFloat("Hysteresis", Hysteresis));
+
+	if (in->existsAttribute("Mesh0"))
+	{
+		clearLevels();
+
+		for (u32 i=0; ; ++i)
+		{
+			const core::stringc index(i);
+			const core::stringc meshName = core::stringc("Mesh") + index;
+			if (!in->existsAttribute(meshName.c_str()))
+				break;
+
+			IAnimatedMesh* mesh = SceneManager->getMesh(in->getAttributeAsString(meshName.c_str()));
+			if (mesh)
+				addLevel(mesh->getMesh(0), in->getAttributeAsFloat((core::stringc("ScreenSize") + index).c_str()));
+		}
+	}
+
+	ILODSceneNode::deserializeAttributes(in, options);
+}
+
+
+//! Creates a clone of this scene node and its children.
+ISceneNode* CLODSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
+{
+	if (!newParent)
+		newParent = Parent;
+	if (!newManager)
+		newManager = SceneManager;
+
+	CLODSceneNode* nb = new CLODSceneNode(newParent,
+		newManager, ID, RelativeTranslation, RelativeRotation, RelativeScale);
+
+	nb->cloneMembers(this, newManager);
+	for (u32 i=0; i<Levels.size(); ++i)
+	{
+		nb->addLevel(Levels[i].Mesh, Levels[i].ScreenSize);
+		nb->Levels[i].Materials = Levels[i].Materials;
+	}
+	nb->Hysteresis = Hysteresis;
+
+	if ( newParent )
+		nb->drop();
+	return nb;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
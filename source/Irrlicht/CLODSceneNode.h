@@ -0,0 +1,123 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_LOD_SCENE_NODE_H_INCLUDED__
+#define __C_LOD_SCENE_NODE_H_INCLUDED__
+
+#include "ILODSceneNode.h"
+#include "IMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ICameraSceneNode;
+
+	class CLODSceneNode : public ILODSceneNode
+	{
+	public:
+
+		//! constructor
+		CLODSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		//! destructor
+		virtual ~CLODSceneNode();
+
+		//! frame
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box around all levels
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_ { return Box; }
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of materials of all levels.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_LOD_MESH; }
+
+		//! Writes attributes of the scene node.
+		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const _IRR_OVERRIDE_;
+
+		//! Reads attributes of the scene node.
+		virtual void deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options=0) _IRR_OVERRIDE_;
+
+		//! Creates a clone of this scene node and its children.
+		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0) _IRR_OVERRIDE_;
+
+		//! Adds a level of detail
+		virtual u32 addLevel(IMesh* mesh, f32 minScreenSize) _IRR_OVERRIDE_;
+
+		//! Removes all levels
+		virtual void clearLevels() _IRR_OVERRIDE_;
+
+		//! Get the number of levels
+		virtual u32 getLevelCount() const _IRR_OVERRIDE_ { return Levels.size(); }
+
+		//! Get the mesh of a level
+		virtual IMesh* getLevelMesh(u32 level) const _IRR_OVERRIDE_ { return Levels[level].Mesh; }
+
+		//! Get the smallest screen size a level is used for
+		virtual f32 getLevelScreenSize(u32 level) const _IRR_OVERRIDE_ { return Levels[level].ScreenSize; }
+
+		//! Get the level drawn in the last frame
+		virtual u32 getCurrentLevel() const _IRR_OVERRIDE_ { return CurrentLevel; }
+
+		//! Get the screen size of the node in the last frame
+		virtual f32 getScreenSize() const _IRR_OVERRIDE_ { return ScreenSize; }
+
+		//! Sets how far the screen size has to pass a threshold before the level changes.
+		virtual void setHysteresis(f32 hysteresis) _IRR_OVERRIDE_;
+
+		//! Get the fraction of the screen sizes used to avoid switching levels back and forth
+		virtual f32 getHysteresis() const _IRR_OVERRIDE_ { return Hysteresis; }
+
+	private:
+
+		struct SLevel
+		{
+			IMesh* Mesh;
+			f32 ScreenSize;
+			core::array<video::SMaterial> Materials;
+		};
+
+		//! Level selected for a camera, kept for the hysteresis
+		struct SCameraLevel
+		{
+			const ICameraSceneNode* Camera;
+			u32 Level;
+			//! Last frame in which the camera drew the node
+			u32 Frame;
+		};
+
+		//! Picks the level for the active camera
+		void selectLevel();
+
+		//! Returns the first level used at the screen size
+		u32 getLevelForScreenSize(f32 screenSize) const;
+
+		core::array<SLevel> Levels;
+		core::aabbox3d<f32> Box;
+		u32 CurrentLevel;
+		f32 ScreenSize;
+		f32 Hysteresis;
+		core::array<SCameraLevel> CameraLevels;
+		//! Camera CurrentLevel was selected for since the node was registered
+		const ICameraSceneNode* SelectedCamera;
+		//! Counts the frames in which the node was registered
+		u32 Frame;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,334 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CLightCullingManager.h"
+#include "ILightSceneNode.h"
+#include "ICameraSceneNode.h"
+#include "SViewFrustum.h"
+#include "IVideoDriver.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Lights and nodes touching more cells are handled without the grid
+static const s32 MAX_GRID_CELLS = 64;
+
+
+//! constructor
+CLightCullingManager::CLightCullingManager(ISceneManager* smgr)
+: SceneManager(smgr), MaxLightsPerNode(8), CellSize(1.f), Stamp(0), Managed(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CLightCullingManager");
+	#endif
+}
+
+
+//! Culls the lights and builds the grid
+void CLightCullingManager::OnPreRender(core::array<ISceneNode*>& lightList)
+{
+	Lights.set_used(0);
+	LightsOn.set_used(0);
+	Managed = false;
+
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	const SViewFrustum* frustum = camera ? camera->getViewFrustum() : 0;
+
+	u32 kept = 0;
+	for (u32 i=0; i<lightList.size(); ++i)
+	{
+		ISceneNode* node = lightList[i];
+
+		SCulledLight light;
+		light.Radius = 0.f;
+		light.Intensity = 0.f;
+		light.Type = ECLT_UNMANAGED;
+
+		if (node->getType() == ESNT_LIGHT)
+		{
+			const video::SLight& data = static_cast<ILightSceneNode*>(node)->getLightData();
+			light.Position = data.Position;
+			light.Attenuation = data.Attenuation;
+			light.Radius = data.Radius;
+			light.Intensity = data.DiffuseColor.r + data.DiffuseColor.g + data.DiffuseColor.b;
+			light.Type = (data.Type == video::ELT_DIRECTIONAL || data.Radius <= 0.f) ? ECLT_GLOBAL : ECLT_LOCAL;
+
+			// nothing inside the view frustum is lit by a light outside
+			// of the frustum by more than its radius
+			if (light.Type == ECLT_LOCAL && frustum)
+			{
+				u32 p;
+				for (p=0; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+				{
+					if (frustum->planes[p].getDistanceTo(light.Position) > light.Radius)
+						break;
+				}
+				if (p != SViewFrustum::VF_PLANE_COUNT)
+					continue;
+			}
+		}
+
+		lightList[kept++] = node;
+		Lights.push_back(light);
+	}
+	lightList.set_used(kept);
+
+	buildGrid();
+}
+
+
+void CLightCullingManager::OnPostRender(void)
+{
+	LightsOn.set_used(0);
+	Managed = false;
+}
+
+
+//! Turns off all lights after they were added to the driver
+void CLightCullingManager::OnRenderPassPostRender(E_SCENE_NODE_RENDER_PASS renderPass)
+{
+	if (renderPass != ESNRP_LIGHT)
+		return;
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	u32 maxLights = MaxLightsPerNode;
+	if (driver->getMaximalDynamicLightAmount())
+		maxLights = core::min_(maxLights, driver->getMaximalDynamicLightAmount());
+
+	// the driver light indices are only known when each light added one
+	// light. With few lights all of them stay on.
+	Managed = Lights.size() > maxLights && driver->getDynamicLightCount() == Lights.size();
+	if (!Managed)
+		return;
+
+	for (u32 i=0; i<Lights.size(); ++i)
+	{
+		if (Lights[i].Type != ECLT_UNMANAGED)
+			driver->turnLightOn((s32)i, false);
+	}
+	LightsOn.set_used(0);
+}
+
+
+//! Turns on the lights of the node
+void CLightCullingManager::OnNodePreRender(ISceneNode* node)
+{
+	if (!Managed)
+		return;
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	u32 maxLights = MaxLightsPerNode;
+	if (driver->getMaximalDynamicLightAmount())
+		maxLights = core::min_(maxLights, driver->getMaximalDynamicLightAmount());
+
+	selectLights(node->getTransformedBoundingBox(), maxLights);
+
+	++Stamp;
+	for (u32 i=0; i<Selected.size(); ++i)
+		SelectStamp[Selected[i].Light] = Stamp;
+
+	// turn off first, so the freed hardware lights can be used again
+	for (u32 i=0; i<LightsOn.size(); ++i)
+	{
+		if (SelectStamp[LightsOn[i]] != Stamp)
+			driver->turnLightOn((s32)LightsOn[i], false);
+		else
+			SelectStamp[LightsOn[i]] = 0;
+	}
+
+	LightsOn.set_used(0);
+	for (u32 i=0; i<Selected.size(); ++i)
+	{
+		const u32 light = Selected[i].Light;
+		if (SelectStamp[light] == Stamp)
+			driver->turnLightOn((s32)light, true);
+		LightsOn.push_back(light);
+	}
+}
+
+
+void CLightCullingManager::getCell(const core::vector3df& p, s32& x, s32& y, s32& z) const
+{
+	const f32 inv = 1.f / CellSize;
+	x = core::floor32(p.X * inv);
+	y = core::floor32(p.Y * inv);
+	z = core::floor32(p.Z * inv);
+}
+
+
+u64 CLightCullingManager::getCellKey(s32 x, s32 y, s32 z)
+{
+	return ((u64)(x & 0x1fffff) << 42) | ((u64)(y & 0x1fffff) << 21) | (u64)(z & 0x1fffff);
+}
+
+
+//! Builds the grid over all local lights
+void CLightCullingManager::buildGrid()
+{
+	GlobalLights.set_used(0);
+	Grid.set_used(0);
+	VisitStamp.set_used(Lights.size());
+	SelectStamp.set_used(Lights.size());
+	for (u32 i=0; i<Lights.size(); ++i)
+	{
+		VisitStamp[i] = 0;
+		SelectStamp[i] = 0;
+	}
+	Stamp = 0;
+
+	// cells of about the size of an average light
+	f32 radiusSum = 0.f;
+	u32 localCount = 0;
+	for (u32 i=0; i<Lights.size(); ++i)
+	{
+		if (Lights[i].Type == ECLT_LOCAL)
+		{
+			radiusSum += Lights[i].Radius;
+			++localCount;
+		}
+	}
+	CellSize = localCount ? core::max_(2.f * radiusSum / localCount, 1.f) : 1.f;
+
+	for (u32 i=0; i<Lights.size(); ++i)
+	{
+		const SCulledLight& light = Lights[i];
+		if (light.Type == ECLT_UNMANAGED)
+			continue;
+
+		s32 x0=0, y0=0, z0=0, x1=0, y1=0, z1=0;
+		if (light.Type == ECLT_LOCAL)
+		{
+			const core::vector3df r(light.Radius, light.Radius, light.Radius);
+			getCell(light.Position - r, x0, y0, z0);
+			getCell(light.Position + r, x1, y1, z1);
+		}
+
+		if (light.Type == ECLT_GLOBAL ||
+			(s64)(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1) > MAX_GRID_CELLS)
+		{
+			GlobalLights.push_back(i);
+			continue;
+		}
+
+		SGridEntry entry;
+		entry.Light = i;
+		for (s32 x=x0; x<=x1; ++x)
+			for (s32 y=y0; y<=y1; ++y)
+				for (s32 z=z0; z<=z1; ++z)
+				{
+					entry.Cell = getCellKey(x, y, z);
+					Grid.push_back(entry);
+				}
+	}
+
+	Grid.sort();
+}
+
+
+//! Collects the most influential lights for a box into Selected
+void CLightCullingManager::selectLights(const core::aabbox3df& box, u32 maxLights)
+{
+	Selected.set_used(0);
+	if (!maxLights)
+		return;
+	++Stamp;
+
+	for (u32 i=0; i<GlobalLights.size(); ++i)
+		testLight(GlobalLights[i], box, maxLights);
+
+	s32 x0, y0, z0, x1, y1, z1;
+	getCell(box.MinEdge, x0, y0, z0);
+	getCell(box.MaxEdge, x1, y1, z1);
+
+	// large nodes test all lights
+	if ((s64)(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1) > MAX_GRID_CELLS)
+	{
+		for (u32 i=0; i<Lights.size(); ++i)
+		{
+			if (Lights[i].Type == ECLT_LOCAL)
+				testLight(i, box, maxLights);
+		}
+		return;
+	}
+
+	for (s32 x=x0; x<=x1; ++x)
+		for (s32 y=y0; y<=y1; ++y)
+			for (s32 z=z0; z<=z1; ++z)
+			{
+				const u64 cell = getCellKey(x, y, z);
+
+				// first entry of the cell
+				s32 lo = 0;
+				s32 hi = (s32)Grid.size();
+				while (lo < hi)
+				{
+					const s32 mid = (lo + hi) / 2;
+					if (Grid[mid].Cell < cell)
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
+
+				for (u32 i=(u32)lo; i<Grid.size() && Grid[i].Cell == cell; ++i)
+					testLight(Grid[i].Light, box, maxLights);
+			}
+}
+
+
+//! Adds a light to Selected if it is one of the maxLights most influential ones
+void CLightCullingManager::testLight(u32 index, const core::aabbox3df& box, u32 maxLights)
+{
+	if (VisitStamp[index] == Stamp)
+		return;
+	VisitStamp[index] = Stamp;
+
+	const SCulledLight& light = Lights[index];
+	f32 influence = light.Intensity;
+
+	if (light.Type == ECLT_LOCAL)
+	{
+		// distance from the light to the closest point of the box
+		const core::vector3df closest(
+			core::clamp(light.Position.X, box.MinEdge.X, box.MaxEdge.X),
+			core::clamp(light.Position.Y, box.MinEdge.Y, box.MaxEdge.Y),
+			core::clamp(light.Position.Z, box.MinEdge.Z, box.MaxEdge.Z));
+		const f32 distance = closest.getDistanceFrom(light.Position);
+		if (distance > light.Radius)
+			return;
+
+		const f32 attenuation = light.Attenuation.X + light.Attenuation.Y * distance +
+			light.Attenuation.Z * distance * distance;
+		influence /= core::max_(attenuation, 0.001f);
+	}
+	else
+	{
+		// directional lights are always the first
+		influence += FLT_MAX * 0.5f;
+	}
+
+	if (Selected.size() == maxLights && influence <= Selected.getLast().Influence)
+		return;
+
+	// keep sorted by influence, most influential first
+	SSelectedLight selected;
+	selected.Influence = influence;
+	selected.Light = index;
+
+	if (Selected.size() < maxLights)
+		Selected.push_back(selected);
+	else
+		Selected.getLast() = selected;
+
+	for (u32 i=Selected.size()-1; i>0 && Selected[i-1].Influence < selected.Influence; --i)
+	{
+		Selected[i] = Selected[i-1];
+		Selected[i-1] = selected;
+	}
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,133 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_LIGHT_CULLING_MANAGER_H_INCLUDED__
+#define __C_LIGHT_CULLING_MANAGER_H_INCLUDED__
+
+#include "ISceneManager.h"
+#include "ILightManager.h"
+#include "SLight.h"
+#include "aabbox3d.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Light manager used by the scene manager when light culling is enabled.
+	/** Point and spot lights outside of the view frustum are removed from
+	the light list before the lights are added to the driver. The remaining
+	point and spot lights are put into a regular grid of cells about twice
+	their average radius, so each node only has to look at the lights in the
+	cells its bounding box touches. Before a node is rendered the lights
+	which influence its box most are turned on and all others are turned
+	off. Directional lights and lights of other node types are always
+	candidates. As long as there are not more lights than allowed for a
+	node, all lights stay turned on. */
+	class CLightCullingManager : public ILightManager
+	{
+	public:
+
+		//! Constructor
+		CLightCullingManager(ISceneManager* smgr);
+
+		//! Set the maximal number of lights turned on for a node
+		void setMaxLightsPerNode(u32 count) { MaxLightsPerNode = count; }
+
+		u32 getMaxLightsPerNode() const { return MaxLightsPerNode; }
+
+		//! Culls the lights and builds the grid
+		virtual void OnPreRender(core::array<ISceneNode*>& lightList) _IRR_OVERRIDE_;
+
+		virtual void OnPostRender(void) _IRR_OVERRIDE_;
+
+		virtual void OnRenderPassPreRender(E_SCENE_NODE_RENDER_PASS renderPass) _IRR_OVERRIDE_ {}
+
+		//! Turns off all lights after they were added to the driver
+		virtual void OnRenderPassPostRender(E_SCENE_NODE_RENDER_PASS renderPass) _IRR_OVERRIDE_;
+
+		//! Turns on the lights of the node
+		virtual void OnNodePreRender(ISceneNode* node) _IRR_OVERRIDE_;
+
+		virtual void OnNodePostRender(ISceneNode* node) _IRR_OVERRIDE_ {}
+
+	private:
+
+		enum E_CULLED_LIGHT_TYPE
+		{
+			//! point and spot lights, in the grid
+			ECLT_LOCAL = 0,
+			//! directional lights and lights too large for the grid
+			ECLT_GLOBAL,
+			//! other node types, never turned off
+			ECLT_UNMANAGED
+		};
+
+		struct SCulledLight
+		{
+			core::vector3df Position;
+			core::vector3df Attenuation;
+			f32 Radius;
+			f32 Intensity;
+			E_CULLED_LIGHT_TYPE Type;
+		};
+
+		struct SGridEntry
+		{
+			u64 Cell;
+			u32 Light;
+
+			bool operator < (const SGridEntry& other) const
+			{
+				return Cell < other.Cell || (Cell == other.Cell && Light < other.Light);
+			}
+		};
+
+		struct SSelectedLight
+		{
+			f32 Influence;
+			u32 Light;
+		};
+
+		//! Grid cell of a position
+		void getCell(const core::vector3df& p, s32& x, s32& y, s32& z) const;
+
+		static u64 getCellKey(s32 x, s32 y, s32 z);
+
+		//! Builds the grid over all local lights
+		void buildGrid();
+
+		//! Collects the most influential lights for a box into Selected
+		void selectLights(const core::aabbox3df& box, u32 maxLights);
+
+		//! Adds a light to Selected if it is one of the maxLights most influential ones
+		void testLight(u32 light, const core::aabbox3df& box, u32 maxLights);
+
+		ISceneManager* SceneManager;
+		u32 MaxLightsPerNode;
+
+		//! lights which passed culling, in the order of the light list
+		core::array<SCulledLight> Lights;
+		//! lights which are always tested
+		core::array<u32> GlobalLights;
+		//! grid entries of the local lights, sorted by cell
+		core::array<SGridEntry> Grid;
+		f32 CellSize;
+
+		core::array<SSelectedLight> Selected;
+		//! lights turned on for the last node
+		core::array<u32> LightsOn;
+		//! stamps to visit each light only once per query and to find lights to turn off
+		core::array<u32> VisitStamp;
+		core::array<u32> SelectStamp;
+		u32 Stamp;
+
+		//! true if the lights are turned on and off for each node
+		bool Managed;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -43,6 +43,18 @@ namespace io
 		//! returns name of file
 		virtual const io::path& getFileName() const _IRR_OVERRIDE_;
 
+		//! Get the type of the class implementing this interface
+		virtual EREAD_FILE_TYPE getType() const _IRR_OVERRIDE_
+		{
+			return EFIT_MEMORY;
+		}
+
+		//! Get direct access to the memory of the file
+		const void* getBuffer() const
+		{
+			return Buffer;
+		}
+
 	private:
 
 		const void *Buffer;
@@ -9,6 +9,7 @@
 #include "os.h"
 #include "irrMap.h"
 #include "triangle3d.h"
+#include "CMeshSimplifier.h"
 
 namespace irr
 {
@@ -947,6 +948,13 @@ IMesh* CMeshManipulator::createMeshWelded(IMesh *mesh, f32 tolerance) const
 }
 
 
+//! Creates a copy of the mesh with edges collapsed by their quadric error.
+IMesh* CMeshManipulator::createMeshSimplified(IMesh* mesh, f32 ratio, f32 maxError) const
+{
+	return scene::createMeshSimplified(mesh, ratio, maxError);
+}
+
+
 //! Creates a copy of the mesh, which will only consist of S3DVertexTangents vertices.
 // not yet 32bit
 IMesh* CMeshManipulator::createMeshWithTangents(IMesh* mesh, bool recalculateNormals, bool smooth, bool angleWeighted, bool calculateTangents) const
@@ -75,6 +75,9 @@ public:
 	//! Creates a copy of the mesh, which will have all duplicated vertices removed, i.e. maximal amount of vertices are shared via indexing.
 	virtual IMesh* createMeshWelded(IMesh *mesh, f32 tolerance=core::ROUNDING_ERROR_f32) const _IRR_OVERRIDE_;
 
+	//! Creates a copy of the mesh with edges collapsed by their quadric error.
+	virtual IMesh* createMeshSimplified(IMesh* mesh, f32 ratio, f32 maxError=FLT_MAX) const _IRR_OVERRIDE_;
+
 	//! Returns amount of polygons in mesh.
 	virtual s32 getPolyCount(scene::IMesh* mesh) const _IRR_OVERRIDE_;
 
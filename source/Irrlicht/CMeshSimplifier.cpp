@@ -0,0 +1,888 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMeshSimplifier.h"
+#include "SMesh.h"
+#include "CMeshBuffer.h"
+#include "CDynamicMeshBuffer.h"
+#include "irrArray.h"
+#include <string.h>
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+const u32 INVALID_INDEX = 0xffffffff;
+
+//! Weight of the planes through open borders, relative to the faces
+const f64 BORDER_WEIGHT = 10.0;
+
+enum E_POSITION_KIND
+{
+	//! Inside of a surface, can move to any neighbor
+	EPK_MANIFOLD = 0,
+	//! On an open border, only moves along the border
+	EPK_BORDER,
+	//! Has two vertices with different attributes, only moves along the seam
+	EPK_SEAM,
+	//! Never moves
+	EPK_LOCKED
+};
+
+//! Sum of squared distances to planes, weighted by the area of the planes
+struct SQuadric
+{
+	SQuadric() : A2(0), AB(0), AC(0), AD(0), B2(0), BC(0), BD(0), C2(0), CD(0), D2(0), Weight(0) {}
+
+	void addPlane(const core::vector3d<f64>& n, f64 d, f64 weight)
+	{
+		A2 += weight * n.X * n.X;
+		AB += weight * n.X * n.Y;
+		AC += weight * n.X * n.Z;
+		AD += weight * n.X * d;
+		B2 += weight * n.Y * n.Y;
+		BC += weight * n.Y * n.Z;
+		BD += weight * n.Y * d;
+		C2 += weight * n.Z * n.Z;
+		CD += weight * n.Z * d;
+		D2 += weight * d * d;
+	}
+
+	void add(const SQuadric& other)
+	{
+		A2 += other.A2; AB += other.AB; AC += other.AC; AD += other.AD;
+		B2 += other.B2; BC += other.BC; BD += other.BD;
+		C2 += other.C2; CD += other.CD; D2 += other.D2;
+		Weight += other.Weight;
+	}
+
+	//! Sum of the weighted squared distances of the point to the planes
+	f64 evaluate(const core::vector3df& p) const
+	{
+		const f64 x = p.X, y = p.Y, z = p.Z;
+		return A2*x*x + 2*AB*x*y + 2*AC*x*z + 2*AD*x
+			+ B2*y*y + 2*BC*y*z + 2*BD*y
+			+ C2*z*z + 2*CD*z + D2;
+	}
+
+	f64 A2, AB, AC, AD, B2, BC, BD, C2, CD, D2;
+	//! Area of the faces added
+	f64 Weight;
+};
+
+//! Sort key to find equal positions
+struct SPositionKey
+{
+	u32 X, Y, Z;
+	//! Vertex or position index
+	u32 Index;
+	//! Mesh buffer, for keys of several buffers
+	u32 Buffer;
+
+	bool operator<(const SPositionKey& other) const
+	{
+		if (X != other.X)
+			return X < other.X;
+		if (Y != other.Y)
+			return Y < other.Y;
+		return Z < other.Z;
+	}
+
+	bool samePosition(const SPositionKey& other) const
+	{
+		return X == other.X && Y == other.Y && Z == other.Z;
+	}
+};
+
+//! Entry of the collapse heap
+struct SCollapse
+{
+	f32 Cost;
+	u32 Position;
+	u32 Target;
+	//! Stamp of the position at the time the collapse was found
+	u32 Stamp;
+};
+
+//! Triangle in the list of a position
+struct STriangleRef
+{
+	u32 Triangle;
+	s32 Next;
+};
+
+struct SNeighbor
+{
+	u32 Position;
+	u32 Count;
+	u32 Triangle;
+};
+
+
+//! Simplifies the triangles of one mesh buffer
+class CBufferSimplifier
+{
+public:
+
+	CBufferSimplifier(const IMeshBuffer* mb);
+
+	u32 getPositionCount() const { return CopyStart.size() - 1; }
+
+	const core::vector3df& getPosition(u32 p) const { return vertexPosition(Copies[CopyStart[p]]); }
+
+	u32 getTriangleCount() const { return LiveTriangles; }
+
+	//! Keeps a position where it is, must be called before simplify()
+	void lockPosition(u32 p) { Kind[p] = EPK_LOCKED; }
+
+	//! Collapses edges until the number of triangles or the error is reached
+	void simplify(u32 targetTriangles, f32 maxError);
+
+	//! Creates a mesh buffer with the remaining triangles
+	IMeshBuffer* createMeshBuffer() const;
+
+private:
+
+	const core::vector3df& vertexPosition(u32 v) const
+	{
+		return *(const core::vector3df*)(Vertices + v * Pitch);
+	}
+
+	const core::vector3df& cornerPosition(u32 corner) const
+	{
+		return vertexPosition(Indices[corner]);
+	}
+
+	bool isRemoved(u32 triangle) const { return Indices[triangle * 3] == INVALID_INDEX; }
+
+	void computeQuadricsAndKinds();
+	void gatherTriangles(u32 p, core::array<u32>& triangles);
+	void gatherNeighbors(u32 p, const core::array<u32>& triangles, core::array<SNeighbor>& neighbors) const;
+	void evaluate(u32 p, f32 maxCost, bool validate);
+	bool isValidCollapse(u32 p, u32 q);
+	void collapse(u32 p, u32 q);
+	void pushHeap(const SCollapse& collapse);
+	SCollapse popHeap();
+
+	const IMeshBuffer* Buffer;
+	const u8* Vertices;
+	u32 Pitch;
+
+	//! Corners of the triangles, first index INVALID_INDEX for removed triangles
+	core::array<u32> Indices;
+	u32 LiveTriangles;
+
+	//! Position of each vertex
+	core::array<u32> VertexPositions;
+	//! Different vertices of each position, the ones of p from CopyStart[p] to CopyStart[p+1]
+	core::array<u32> CopyStart;
+	core::array<u32> Copies;
+
+	// for each position
+	core::array<SQuadric> Quadrics;
+	core::array<u8> Kind;
+	core::array<u8> Removed;
+	core::array<u32> Stamps;
+	core::array<s32> TriangleHead;
+
+	core::array<STriangleRef> TriangleRefs;
+	core::array<SCollapse> Heap;
+
+	//! Copies of q the copies of p move to, set by isValidCollapse
+	u32 CollapseMap[2];
+
+	// temporary lists
+	core::array<u32> EvaluateTriangles;
+	core::array<SNeighbor> Candidates;
+	core::array<u32> PTriangles;
+	core::array<u32> QTriangles;
+	core::array<SNeighbor> PNeighbors;
+	core::array<SNeighbor> QNeighbors;
+	core::array<SNeighbor> Ring;
+};
+
+
+CBufferSimplifier::CBufferSimplifier(const IMeshBuffer* mb)
+	: Buffer(mb), LiveTriangles(0)
+{
+	Vertices = (const u8*)mb->getVertices();
+	Pitch = video::getVertexPitchFromType(mb->getVertexType());
+	const u32 vertexCount = mb->getVertexCount();
+
+	// equal positions are next to each other after sorting
+	core::array<SPositionKey> keys;
+	keys.set_used(vertexCount);
+	for (u32 v=0; v<vertexCount; ++v)
+	{
+		const core::vector3df& pos = vertexPosition(v);
+		keys[v].X = core::IR(pos.X);
+		keys[v].Y = core::IR(pos.Y);
+		keys[v].Z = core::IR(pos.Z);
+		keys[v].Index = v;
+		keys[v].Buffer = 0;
+	}
+	keys.sort();
+
+	// weld equal vertices, keep the different vertices of each position
+	core::array<u32> vertexRemap;
+	vertexRemap.set_used(vertexCount);
+	VertexPositions.set_used(vertexCount);
+	Copies.reallocate(vertexCount);
+	for (u32 i=0; i<vertexCount; )
+	{
+		u32 end = i + 1;
+		while (end < vertexCount && keys[end].samePosition(keys[i]))
+			++end;
+
+		const u32 p = CopyStart.size();
+		CopyStart.push_back(Copies.size());
+		for (u32 j=i; j<end; ++j)
+		{
+			const u32 v = keys[j].Index;
+			u32 k = CopyStart[p];
+			while (k < Copies.size() && memcmp(Vertices + Copies[k] * Pitch, Vertices + v * Pitch, Pitch))
+				++k;
+			if (k == Copies.size())
+				Copies.push_back(v);
+			vertexRemap[v] = Copies[k];
+			VertexPositions[v] = p;
+		}
+		i = end;
+	}
+	CopyStart.push_back(Copies.size());
+
+	// triangles between the welded vertices, without degenerated ones
+	const u32 indexCount = mb->getIndexCount() / 3 * 3;
+	const u16* indices16 = mb->getIndices();
+	const u32* indices32 = (const u32*)mb->getIndices();
+	const bool is32Bit = (mb->getIndexType() == video::EIT_32BIT);
+
+	Indices.reallocate(indexCount);
+	for (u32 i=0; i<indexCount; i+=3)
+	{
+		u32 t[3];
+		for (u32 k=0; k<3; ++k)
+			t[k] = vertexRemap[is32Bit ? indices32[i + k] : indices16[i + k]];
+
+		const u32 p0 = VertexPositions[t[0]];
+		const u32 p1 = VertexPositions[t[1]];
+		const u32 p2 = VertexPositions[t[2]];
+		if (p0 == p1 || p1 == p2 || p0 == p2)
+			continue;
+
+		Indices.push_back(t[0]);
+		Indices.push_back(t[1]);
+		Indices.push_back(t[2]);
+	}
+	LiveTriangles = Indices.size() / 3;
+
+	const u32 positionCount = getPositionCount();
+	TriangleHead.set_used(positionCount);
+	for (u32 p=0; p<positionCount; ++p)
+		TriangleHead[p] = -1;
+
+	TriangleRefs.set_used(Indices.size());
+	for (u32 i=0; i<Indices.size(); ++i)
+	{
+		const u32 p = VertexPositions[Indices[i]];
+		TriangleRefs[i].Triangle = i / 3;
+		TriangleRefs[i].Next = TriangleHead[p];
+		TriangleHead[p] = (s32)i;
+	}
+
+	computeQuadricsAndKinds();
+}
+
+
+void CBufferSimplifier::computeQuadricsAndKinds()
+{
+	const u32 positionCount = getPositionCount();
+	Quadrics.set_used(0);
+	Quadrics.reallocate(positionCount);
+	for (u32 p=0; p<positionCount; ++p)
+		Quadrics.push_back(SQuadric());
+
+	// planes of the faces, weighted by their area
+	for (u32 i=0; i<Indices.size(); i+=3)
+	{
+		const core::vector3d<f64> p0(cornerPosition(i).X, cornerPosition(i).Y, cornerPosition(i).Z);
+		const core::vector3d<f64> p1(cornerPosition(i+1).X, cornerPosition(i+1).Y, cornerPosition(i+1).Z);
+		const core::vector3d<f64> p2(cornerPosition(i+2).X, cornerPosition(i+2).Y, cornerPosition(i+2).Z);
+
+		core::vector3d<f64> n = (p1 - p0).crossProduct(p2 - p0);
+		const f64 length = n.getLength();
+		if (length <= 0)
+			continue;
+		n /= length;
+		const f64 area = length * 0.5;
+		const f64 d = -n.dotProduct(p0);
+
+		for (u32 k=0; k<3; ++k)
+		{
+			SQuadric& q = Quadrics[VertexPositions[Indices[i + k]]];
+			q.addPlane(n, d, area);
+			q.Weight += area;
+		}
+	}
+
+	Kind.set_used(positionCount);
+	core::array<u32> triangles;
+	core::array<SNeighbor> neighbors;
+	for (u32 p=0; p<positionCount; ++p)
+	{
+		const u32 copyCount = CopyStart[p + 1] - CopyStart[p];
+		Kind[p] = (copyCount > 2) ? EPK_LOCKED : (copyCount == 2) ? EPK_SEAM : EPK_MANIFOLD;
+
+		gatherTriangles(p, triangles);
+		gatherNeighbors(p, triangles, neighbors);
+
+		for (u32 i=0; i<neighbors.size(); ++i)
+		{
+			// edges of more than two triangles are too complex to move
+			if (neighbors[i].Count > 2)
+				Kind[p] = EPK_LOCKED;
+
+			if (neighbors[i].Count != 1)
+				continue;
+
+			// open border
+			if (Kind[p] == EPK_MANIFOLD)
+				Kind[p] = EPK_BORDER;
+			else if (Kind[p] == EPK_SEAM)
+				Kind[p] = EPK_LOCKED;
+
+			// plane through the border edge, perpendicular to its triangle
+			const u32 q = neighbors[i].Position;
+			if (q < p)
+				continue;
+
+			const u32 t = neighbors[i].Triangle * 3;
+			const core::vector3df& a = getPosition(p);
+			const core::vector3df& b = getPosition(q);
+			const core::vector3d<f64> pa(a.X, a.Y, a.Z);
+			const core::vector3d<f64> edge(b.X - a.X, b.Y - a.Y, b.Z - a.Z);
+			const core::vector3df fn = (cornerPosition(t+1) - cornerPosition(t)).crossProduct(cornerPosition(t+2) - cornerPosition(t));
+			core::vector3d<f64> n = edge.crossProduct(core::vector3d<f64>(fn.X, fn.Y, fn.Z));
+			const f64 length = n.getLength();
+			if (length <= 0)
+				continue;
+			n /= length;
+
+			const f64 weight = edge.getLengthSQ() * BORDER_WEIGHT;
+			Quadrics[p].addPlane(n, -n.dotProduct(pa), weight);
+			Quadrics[q].addPlane(n, -n.dotProduct(pa), weight);
+		}
+	}
+}
+
+
+//! Collects the remaining triangles of a position and drops the removed ones from its list
+void CBufferSimplifier::gatherTriangles(u32 p, core::array<u32>& triangles)
+{
+	triangles.set_used(0);
+
+	s32* link = &TriangleHead[p];
+	while (*link >= 0)
+	{
+		const STriangleRef& ref = TriangleRefs[*link];
+		if (isRemoved(ref.Triangle))
+		{
+			*link = ref.Next;
+			continue;
+		}
+		triangles.push_back(ref.Triangle);
+		link = &TriangleRefs[*link].Next;
+	}
+}
+
+
+//! Collects the positions sharing an edge with p and the number of triangles on each edge
+void CBufferSimplifier::gatherNeighbors(u32 p, const core::array<u32>& triangles, core::array<SNeighbor>& neighbors) const
+{
+	neighbors.set_used(0);
+
+	for (u32 i=0; i<triangles.size(); ++i)
+	{
+		for (u32 k=0; k<3; ++k)
+		{
+			const u32 q = VertexPositions[Indices[triangles[i] * 3 + k]];
+			if (q == p)
+				continue;
+
+			u32 n = 0;
+			while (n < neighbors.size() && neighbors[n].Position != q)
+				++n;
+			if (n == neighbors.size())
+			{
+				SNeighbor neighbor;
+				neighbor.Position = q;
+				neighbor.Count = 0;
+				neighbor.Triangle = triangles[i];
+				neighbors.push_back(neighbor);
+			}
+			++neighbors[n].Count;
+		}
+	}
+}
+
+
+//! Finds the cheapest collapse of a position and puts it on the heap
+/** Without validation the collapse is only checked when it is taken from the heap,
+most collapses found are replaced before that anyway. */
+void CBufferSimplifier::evaluate(u32 p, f32 maxCost, bool validate)
+{
+	if (Kind[p] == EPK_LOCKED || Removed[p])
+		return;
+
+	gatherTriangles(p, EvaluateTriangles);
+	gatherNeighbors(p, EvaluateTriangles, Candidates);
+
+	// cost of each allowed collapse, stored in place of the triangle
+	u32 count = 0;
+	for (u32 i=0; i<Candidates.size(); ++i)
+	{
+		const u32 q = Candidates[i].Position;
+		const u8 kind = Kind[q];
+
+		if (Kind[p] == EPK_BORDER && (Candidates[i].Count != 1 || (kind != EPK_BORDER && kind != EPK_LOCKED)))
+			continue;
+		if (Kind[p] == EPK_SEAM && kind != EPK_SEAM && kind != EPK_LOCKED)
+			continue;
+
+		SQuadric quadric(Quadrics[p]);
+		quadric.add(Quadrics[q]);
+		const f64 cost = quadric.evaluate(getPosition(q)) / core::max_(quadric.Weight, 1e-20);
+		if (cost > maxCost)
+			continue;
+
+		SNeighbor candidate;
+		candidate.Position = q;
+		candidate.Count = 0;
+		candidate.Triangle = core::IR((f32)core::max_(cost, 0.0));
+		Candidates[count++] = candidate;
+	}
+	Candidates.set_used(count);
+
+	// the cheapest one, which keeps the mesh intact when validated.
+	// Costs are positive so their bits sort like the floats
+	while (Candidates.size())
+	{
+		u32 best = 0;
+		for (u32 i=1; i<Candidates.size(); ++i)
+			if (Candidates[i].Triangle < Candidates[best].Triangle)
+				best = i;
+
+		if (!validate || isValidCollapse(p, Candidates[best].Position))
+		{
+			SCollapse collapse;
+			collapse.Cost = core::FR(Candidates[best].Triangle);
+			collapse.Position = p;
+			collapse.Target = Candidates[best].Position;
+			collapse.Stamp = Stamps[p];
+			pushHeap(collapse);
+			return;
+		}
+		Candidates.erase(best);
+	}
+}
+
+
+//! Checks if moving p onto q keeps seams, orientation and topology, fills CollapseMap
+bool CBufferSimplifier::isValidCollapse(u32 p, u32 q)
+{
+	gatherTriangles(p, PTriangles);
+
+	// each copy of p has to share its triangles with exactly one copy of q
+	const u32 firstCopy = Copies[CopyStart[p]];
+	CollapseMap[0] = CollapseMap[1] = INVALID_INDEX;
+	u32 shared = 0;
+
+	for (u32 i=0; i<PTriangles.size(); ++i)
+	{
+		const u32* corners = &Indices[PTriangles[i] * 3];
+		u32 vp = INVALID_INDEX;
+		u32 vq = INVALID_INDEX;
+		for (u32 k=0; k<3; ++k)
+		{
+			const u32 position = VertexPositions[corners[k]];
+			if (position == p)
+				vp = corners[k];
+			else if (position == q)
+				vq = corners[k];
+		}
+		if (vq == INVALID_INDEX)
+			continue;
+
+		++shared;
+		u32& mapped = CollapseMap[vp == firstCopy ? 0 : 1];
+		if (mapped == INVALID_INDEX)
+			mapped = vq;
+		else if (mapped != vq)
+			return false;
+	}
+
+	const u32 copyCount = CopyStart[p + 1] - CopyStart[p];
+	if (!shared || CollapseMap[0] == INVALID_INDEX)
+		return false;
+	if (copyCount == 2 && (CollapseMap[1] == INVALID_INDEX || CollapseMap[0] == CollapseMap[1]))
+		return false;
+
+	// the triangles moving with p must not flip or become degenerated
+	const core::vector3df& target = getPosition(q);
+	for (u32 i=0; i<PTriangles.size(); ++i)
+	{
+		const u32 t = PTriangles[i] * 3;
+		core::vector3df before[3];
+		core::vector3df after[3];
+		bool hasQ = false;
+		for (u32 k=0; k<3; ++k)
+		{
+			const u32 position = VertexPositions[Indices[t + k]];
+			hasQ |= (position == q);
+			before[k] = cornerPosition(t + k);
+			after[k] = (position == p) ? target : before[k];
+		}
+		if (hasQ)
+			continue;
+
+		const core::vector3df n0 = (before[1] - before[0]).crossProduct(before[2] - before[0]);
+		const core::vector3df n1 = (after[1] - after[0]).crossProduct(after[2] - after[0]);
+		if (n0.dotProduct(n1) <= 0.25f * n0.getLength() * n1.getLength())
+			return false;
+	}
+
+	// the only common neighbors are the ones of the triangles on the edge
+	gatherNeighbors(p, PTriangles, PNeighbors);
+	gatherTriangles(q, QTriangles);
+	gatherNeighbors(q, QTriangles, QNeighbors);
+
+	u32 common = 0;
+	for (u32 i=0; i<PNeighbors.size(); ++i)
+		for (u32 j=0; j<QNeighbors.size(); ++j)
+			if (PNeighbors[i].Position == QNeighbors[j].Position)
+				++common;
+
+	return common == shared;
+}
+
+
+//! Moves p onto q, isValidCollapse(p, q) has to be called right before
+void CBufferSimplifier::collapse(u32 p, u32 q)
+{
+	Quadrics[q].add(Quadrics[p]);
+
+	const u32 firstCopy = Copies[CopyStart[p]];
+	for (u32 i=0; i<PTriangles.size(); ++i)
+	{
+		u32* corners = &Indices[PTriangles[i] * 3];
+		bool hasQ = false;
+		for (u32 k=0; k<3; ++k)
+			hasQ |= (VertexPositions[corners[k]] == q);
+
+		if (hasQ)
+		{
+			corners[0] = INVALID_INDEX;
+			--LiveTriangles;
+			continue;
+		}
+
+		for (u32 k=0; k<3; ++k)
+			if (VertexPositions[corners[k]] == p)
+				corners[k] = CollapseMap[corners[k] == firstCopy ? 0 : 1];
+	}
+
+	// the triangles of p belong to q now
+	if (TriangleHead[p] >= 0)
+	{
+		s32 last = TriangleHead[p];
+		while (TriangleRefs[last].Next >= 0)
+			last = TriangleRefs[last].Next;
+		TriangleRefs[last].Next = TriangleHead[q];
+		TriangleHead[q] = TriangleHead[p];
+		TriangleHead[p] = -1;
+	}
+	Removed[p] = 1;
+}
+
+
+void CBufferSimplifier::simplify(u32 targetTriangles, f32 maxError)
+{
+	const f32 maxCost = (maxError < sqrtf(FLT_MAX)) ? maxError * maxError : FLT_MAX;
+	const u32 positionCount = getPositionCount();
+
+	Removed.set_used(positionCount);
+	Stamps.set_used(positionCount);
+	for (u32 p=0; p<positionCount; ++p)
+	{
+		Removed[p] = 0;
+		Stamps[p] = 0;
+	}
+
+	Heap.set_used(0);
+	for (u32 p=0; p<positionCount && LiveTriangles > targetTriangles; ++p)
+		evaluate(p, maxCost, false);
+
+	while (LiveTriangles > targetTriangles && Heap.size())
+	{
+		const SCollapse entry = popHeap();
+		const u32 p = entry.Position;
+
+		// the neighborhood changed since the collapse was found
+		if (Removed[p] || entry.Stamp != Stamps[p])
+			continue;
+
+		if (!isValidCollapse(p, entry.Target))
+		{
+			++Stamps[p];
+			evaluate(p, maxCost, true);
+			continue;
+		}
+
+		collapse(p, entry.Target);
+
+		// find new collapses for the target and its neighbors
+		gatherTriangles(entry.Target, QTriangles);
+		gatherNeighbors(entry.Target, QTriangles, Ring);
+		SNeighbor self;
+		self.Position = entry.Target;
+		Ring.push_back(self);
+
+		for (u32 i=0; i<Ring.size(); ++i)
+		{
+			++Stamps[Ring[i].Position];
+			evaluate(Ring[i].Position, maxCost, false);
+		}
+	}
+}
+
+
+void CBufferSimplifier::pushHeap(const SCollapse& collapse)
+{
+	Heap.push_back(collapse);
+
+	u32 i = Heap.size() - 1;
+	while (i)
+	{
+		const u32 parent = (i - 1) / 2;
+		if (Heap[parent].Cost <= collapse.Cost)
+			break;
+		Heap[i] = Heap[parent];
+		i = parent;
+	}
+	Heap[i] = collapse;
+}
+
+
+SCollapse CBufferSimplifier::popHeap()
+{
+	const SCollapse top = Heap[0];
+	const SCollapse last = Heap.getLast();
+	Heap.set_used(Heap.size() - 1);
+
+	const u32 size = Heap.size();
+	if (size)
+	{
+		u32 i = 0;
+		for (;;)
+		{
+			u32 child = i * 2 + 1;
+			if (child >= size)
+				break;
+			if (child + 1 < size && Heap[child + 1].Cost < Heap[child].Cost)
+				++child;
+			if (last.Cost <= Heap[child].Cost)
+				break;
+			Heap[i] = Heap[child];
+			i = child;
+		}
+		Heap[i] = last;
+	}
+	return top;
+}
+
+
+IMeshBuffer* CBufferSimplifier::createMeshBuffer() const
+{
+	// the vertices still used, numbered in the order of their first use
+	core::array<u32> newIndex;
+	newIndex.set_used(Buffer->getVertexCount());
+	for (u32 v=0; v<newIndex.size(); ++v)
+		newIndex[v] = INVALID_INDEX;
+
+	core::array<u32> usedVertices;
+	u32 indexCount = 0;
+	for (u32 i=0; i<Indices.size(); i+=3)
+	{
+		if (Indices[i] == INVALID_INDEX)
+			continue;
+		for (u32 k=0; k<3; ++k)
+		{
+			if (newIndex[Indices[i + k]] == INVALID_INDEX)
+			{
+				newIndex[Indices[i + k]] = usedVertices.size();
+				usedVertices.push_back(Indices[i + k]);
+			}
+		}
+		indexCount += 3;
+	}
+
+	const u32 vertexCount = usedVertices.size();
+	IMeshBuffer* buffer = 0;
+	u8* vertices = 0;
+	u16* indices16 = 0;
+	u32* indices32 = 0;
+
+	if (vertexCount <= 65536)
+	{
+		switch (Buffer->getVertexType())
+		{
+		case video::EVT_STANDARD:
+			{
+				SMeshBuffer* mb = new SMeshBuffer();
+				mb->Vertices.set_used(vertexCount);
+				mb->Indices.set_used(indexCount);
+				vertices = (u8*)mb->Vertices.pointer();
+				indices16 = mb->Indices.pointer();
+				buffer = mb;
+			}
+			break;
+		case video::EVT_2TCOORDS:
+			{
+				SMeshBufferLightMap* mb = new SMeshBufferLightMap();
+				mb->Vertices.set_used(vertexCount);
+				mb->Indices.set_used(indexCount);
+				vertices = (u8*)mb->Vertices.pointer();
+				indices16 = mb->Indices.pointer();
+				buffer = mb;
+			}
+			break;
+		case video::EVT_TANGENTS:
+			{
+				SMeshBufferTangents* mb = new SMeshBufferTangents();
+				mb->Vertices.set_used(vertexCount);
+				mb->Indices.set_used(indexCount);
+				vertices = (u8*)mb->Vertices.pointer();
+				indices16 = mb->Indices.pointer();
+				buffer = mb;
+			}
+			break;
+		}
+	}
+	else
+	{
+		CDynamicMeshBuffer* mb = new CDynamicMeshBuffer(Buffer->getVertexType(), video::EIT_32BIT);
+		mb->getVertexBuffer().set_used(vertexCount);
+		mb->getIndexBuffer().set_used(indexCount);
+		vertices = (u8*)mb->getVertexBuffer().getData();
+		indices32 = (u32*)mb->getIndexBuffer().getData();
+		buffer = mb;
+	}
+
+	for (u32 v=0; v<vertexCount; ++v)
+		memcpy(vertices + v * Pitch, Vertices + usedVertices[v] * Pitch, Pitch);
+
+	u32 n = 0;
+	for (u32 i=0; i<Indices.size(); ++i)
+	{
+		if (Indices[i - i % 3] == INVALID_INDEX)
+			continue;
+		if (indices16)
+			indices16[n++] = (u16)newIndex[Indices[i]];
+		else
+			indices32[n++] = newIndex[Indices[i]];
+	}
+
+	buffer->getMaterial() = Buffer->getMaterial();
+	buffer->setHardwareMappingHint(Buffer->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+	buffer->setHardwareMappingHint(Buffer->getHardwareMappingHint_Index(), EBT_INDEX);
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+} // end anonymous namespace
+
+
+IMesh* createMeshSimplified(IMesh* mesh, f32 ratio, f32 maxError)
+{
+	if (!mesh)
+		return 0;
+
+	ratio = core::clamp(ratio, 0.f, 1.f);
+	const u32 bufferCount = mesh->getMeshBufferCount();
+
+	core::array<CBufferSimplifier*> simplifiers;
+	simplifiers.set_used(bufferCount);
+	for (u32 b=0; b<bufferCount; ++b)
+	{
+		IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		simplifiers[b] = (mb && mb->getPrimitiveType() == EPT_TRIANGLES) ? new CBufferSimplifier(mb) : 0;
+	}
+
+	// positions used by several mesh buffers are on a material boundary
+	// and stay where they are
+	core::array<SPositionKey> keys;
+	for (u32 b=0; b<bufferCount; ++b)
+	{
+		if (!simplifiers[b])
+			continue;
+		for (u32 p=0; p<simplifiers[b]->getPositionCount(); ++p)
+		{
+			const core::vector3df& pos = simplifiers[b]->getPosition(p);
+			SPositionKey key;
+			key.X = core::IR(pos.X);
+			key.Y = core::IR(pos.Y);
+			key.Z = core::IR(pos.Z);
+			key.Index = p;
+			key.Buffer = b;
+			keys.push_back(key);
+		}
+	}
+	keys.sort();
+
+	for (u32 i=0; i<keys.size(); )
+	{
+		u32 end = i + 1;
+		while (end < keys.size() && keys[end].samePosition(keys[i]))
+			++end;
+		if (end - i > 1)
+		{
+			for (u32 j=i; j<end; ++j)
+				simplifiers[keys[j].Buffer]->lockPosition(keys[j].Index);
+		}
+		i = end;
+	}
+
+	SMesh* result = new SMesh();
+	for (u32 b=0; b<bufferCount; ++b)
+	{
+		IMeshBuffer* buffer;
+		if (simplifiers[b])
+		{
+			const u32 target = (u32)(simplifiers[b]->getTriangleCount() * ratio + 0.5f);
+			simplifiers[b]->simplify(target, maxError);
+			buffer = simplifiers[b]->createMeshBuffer();
+			delete simplifiers[b];
+		}
+		else
+		{
+			// other primitives are shared with the original mesh
+			buffer = mesh->getMeshBuffer(b);
+			if (!buffer)
+				continue;
+			buffer->grab();
+		}
+		result->addMeshBuffer(buffer);
+		buffer->drop();
+	}
+	result->recalculateBoundingBox();
+
+	return result;
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,30 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MESH_SIMPLIFIER_H_INCLUDED__
+#define __C_MESH_SIMPLIFIER_H_INCLUDED__
+
+#include "IMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Creates a copy of a mesh with edges collapsed by their quadric error.
+	/** Implements IMeshManipulator::createMeshSimplified().
+	Each position is moved onto a neighbor position (half edge collapse),
+	so vertices keep their attributes and no new vertices are created.
+	Positions with several different vertices are on a seam and only move
+	along the seam, positions on open borders only along the border.
+	Positions used by more than one mesh buffer, seam junctions and
+	non-manifold positions never move. The collapses are taken from a heap
+	ordered by the error of the collapse, and are checked against flipping
+	triangles and changing the topology. */
+	IMesh* createMeshSimplified(IMesh* mesh, f32 ratio, f32 maxError);
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -16,6 +16,8 @@
 #include "CColorConverter.h"
 #include "IAttributeExchangingObject.h"
 #include "IRenderTarget.h"
+#include "IJobSystem.h"
+#include "CCommandList.h"
 
 
 namespace irr
@@ -87,8 +89,8 @@ IImageWriter* createImageWriterPPM();
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
 	: SharedRenderTarget(0), CurrentRenderTarget(0), CurrentRenderTargetSize(0, 0), FileSystem(io), MeshManipulator(0),
-	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), MinVertexCountForVBO(500),
-	TextureCreationFlags(0), OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false)
+	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), DrawCalls(0), MinVertexCountForVBO(500),
+	TextureCreationFlags(0), OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false), JobSystem(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CNullDriver");
@@ -236,6 +238,9 @@ CNullDriver::~CNullDriver()
 
 	// delete hardware mesh buffers
 	removeAllHardwareBuffers();
+
+	if (JobSystem)
+		JobSystem->drop();
 }
 
 
@@ -319,6 +324,7 @@ bool CNullDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clearDepth, u
 {
 	core::clearFPUException();
 	PrimitivesDrawn = 0;
+	DrawCalls = 0;
 	return true;
 }
 
@@ -767,6 +773,7 @@ void CNullDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 	if ((iType==EIT_16BIT) && (vertexCount>65536))
 		os::Printer::log("Too many vertices for 16bit index type, render artifacts may occur.");
 	PrimitivesDrawn += primitiveCount;
+	++DrawCalls;
 }
 
 
@@ -1757,6 +1764,57 @@ void CNullDriver::drawMeshBuffer(const scene::IMeshBuffer* mb)
 }
 
 
+//! Draws a mesh buffer several times with different transformations and colors
+void CNullDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+		const SInstanceData* instances, u32 instanceCount)
+{
+	if (!mb || !instances || !instanceCount)
+		return;
+
+	// generic fallback for drivers without an own implementation
+	const core::matrix4 world = getTransform(ETS_WORLD);
+	for (u32 i=0; i<instanceCount; ++i)
+	{
+		setTransform(ETS_WORLD, world * instances[i].Transformation);
+		if (instances[i].Color.color == 0xffffffff)
+			drawMeshBuffer(mb);
+		else
+			drawVertexPrimitiveList(getInstanceVertices(mb, instances[i].Color), mb->getVertexCount(),
+				mb->getIndices(), mb->getPrimitiveCount(), mb->getVertexType(),
+				mb->getPrimitiveType(), mb->getIndexType());
+	}
+	setTransform(ETS_WORLD, world);
+}
+
+
+//! Returns the vertices of the buffer with the colors multiplied by color
+const void* CNullDriver::getInstanceVertices(const scene::IMeshBuffer* mb, SColor color)
+{
+	if (color.color == 0xffffffff)
+		return mb->getVertices();
+
+	const u32 pitch = getVertexPitchFromType(mb->getVertexType());
+	const u32 count = mb->getVertexCount();
+	InstanceVertices.set_used(pitch * count);
+	memcpy(InstanceVertices.pointer(), mb->getVertices(), pitch * count);
+
+	// all vertex types start with the members of S3DVertex
+	u8* v = InstanceVertices.pointer();
+	const u32 r = color.getRed();
+	const u32 g = color.getGreen();
+	const u32 b = color.getBlue();
+	const u32 a = color.getAlpha();
+	for (u32 i=0; i<count; ++i, v+=pitch)
+	{
+		SColor& c = reinterpret_cast<S3DVertex*>(v)->Color;
+		c.set(c.getAlpha() * a / 255, c.getRed() * r / 255,
+			c.getGreen() * g / 255, c.getBlue() * b / 255);
+	}
+
+	return InstanceVertices.const_pointer();
+}
+
+
 //! Draws the normals of a mesh buffer
 void CNullDriver::drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length, SColor color)
 {
@@ -2628,10 +2686,38 @@ void CNullDriver::printVersion()
 }
 
 
+namespace
+{
+
+//! Driver of EDT_NULL, which only counts what would be drawn
+/** The other drivers derive from CNullDriver and use its functions as
+fallbacks, so shortcuts for drawing nothing at all belong here. */
+class CNullDriverCounting : public CNullDriver
+{
+public:
+
+	CNullDriverCounting(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
+		: CNullDriver(io, screenSize) {}
+
+	//! Counts the primitives of all instances without visiting each one
+	virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+		const SInstanceData* instances, u32 instanceCount) _IRR_OVERRIDE_
+	{
+		if (!mb || !instances || !instanceCount)
+			return;
+
+		PrimitivesDrawn += mb->getPrimitiveCount() * instanceCount;
+		++DrawCalls;
+	}
+};
+
+} // end anonymous namespace
+
+
 //! creates a video driver
 IVideoDriver* createNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
 {
-	CNullDriver* nullDriver = new CNullDriver(io, screenSize);
+	CNullDriver* nullDriver = new CNullDriverCounting(io, screenSize);
 
 	// create empty material renderers
 	for(u32 i=0; sBuiltInMaterialTypeNames[i]; ++i)
@@ -2722,5 +2808,28 @@ void CNullDriver::convertColor(const void* sP, ECOLOR_FORMAT sF, s32 sN,
 }
 
 
+//! Set the job system used to split the work of the driver over threads.
+void CNullDriver::setJobSystem(IJobSystem* jobSystem)
+{
+	if (jobSystem == JobSystem)
+		return;
+
+	if (JobSystem)
+		JobSystem->drop();
+
+	JobSystem = jobSystem;
+
+	if (JobSystem)
+		JobSystem->grab();
+}
+
+
+//! Creates a list which records calls to this driver to replay them later.
+ICommandList* CNullDriver::createCommandList()
+{
+	return new CCommandList(this, FileSystem);
+}
+
+
 } // end namespace
 } // end namespace
@@ -251,6 +251,9 @@ namespace video
 		//! very useful method for statistics.
 		virtual u32 getPrimitiveCountDrawn( u32 param = 0 ) const _IRR_OVERRIDE_;
 
+		//! Returns the number of 3d primitive lists drawn since beginScene().
+		virtual u32 getDrawCallCount() const _IRR_OVERRIDE_ { return DrawCalls; }
+
 		//! deletes all dynamic lights there are
 		virtual void deleteAllDynamicLights() _IRR_OVERRIDE_;
 
@@ -372,6 +375,10 @@ namespace video
 		//! Draws a mesh buffer
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) _IRR_OVERRIDE_;
 
+		//! Draws a mesh buffer several times with different transformations and colors
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const SInstanceData* instances, u32 instanceCount) _IRR_OVERRIDE_;
+
 		//! Draws the normals of a mesh buffer
 		virtual void drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length=10.f,
 			SColor color=0xffffffff) _IRR_OVERRIDE_;
@@ -382,6 +389,15 @@ namespace video
 			return false;
 		}
 
+		//! Set the job system used to split the work of the driver over threads.
+		virtual void setJobSystem(IJobSystem* jobSystem) _IRR_OVERRIDE_;
+
+		//! Get the job system used by the driver.
+		virtual IJobSystem* getJobSystem() const _IRR_OVERRIDE_ { return JobSystem; }
+
+		//! Creates a list which records calls to this driver to replay them later.
+		virtual ICommandList* createCommandList() _IRR_OVERRIDE_;
+
 	protected:
 		struct SHWBufferLink
 		{
@@ -694,6 +710,11 @@ namespace video
 		//! checks triangle count and print warning if wrong
 		bool checkPrimitiveCount(u32 prmcnt) const;
 
+		//! Returns the vertices of the buffer with the colors multiplied by color
+		/** The vertices are only copied if color isn't white. The returned
+		pointer is valid until the next call. */
+		const void* getInstanceVertices(const scene::IMeshBuffer* mb, SColor color);
+
 		bool checkImage(const core::array<IImage*>& image) const;
 
 		// adds a material renderer and drops it afterwards. To be used for internal creation
@@ -866,8 +887,12 @@ namespace video
 		CFPSCounter FPSCounter;
 
 		u32 PrimitivesDrawn;
+		u32 DrawCalls;
 		u32 MinVertexCountForVBO;
 
+		//! Vertices with instance colors for drawMeshBufferInstanced
+		core::array<u8> InstanceVertices;
+
 		u32 TextureCreationFlags;
 
 		f32 FogStart;
@@ -888,6 +913,8 @@ namespace video
 		bool RangeFog;
 		bool AllowZWriteOnTransparent;
 
+		IJobSystem* JobSystem;
+
 		bool FeatureEnabled[video::EVDF_COUNT];
 	};
 
@@ -0,0 +1,171 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "irrObjectPool.h"
+#include "irrArray.h"
+#include "CJobSystem.h"
+#include <stdlib.h>
+
+namespace irr
+{
+namespace core
+{
+
+SObjectPoolState ObjectPoolState = { false, false };
+
+namespace
+{
+
+struct SFreeBlock
+{
+	SFreeBlock* Next;
+};
+
+//! Block sizes are multiples of this, which keeps the alignment of malloc
+const u32 POOL_GRANULARITY = 16;
+//! Largest block
+const u32 POOL_MAX_BLOCK = 2048;
+const u32 POOL_CLASS_COUNT = POOL_MAX_BLOCK / POOL_GRANULARITY;
+//! Size of one slab
+const u32 POOL_SLAB_SIZE = 64 * 1024;
+
+//! Memory of a slab and the size class of its blocks
+struct SSlab
+{
+	u8* Begin;
+	u8* End;
+	u32 SizeClass;
+};
+
+//! Slabs and free lists of each size class
+struct SObjectPools
+{
+	SObjectPools()
+	{
+		for (u32 i=0; i<POOL_CLASS_COUNT; ++i)
+			FreeList[i] = 0;
+	}
+
+	CJobMutex Lock;
+	SFreeBlock* FreeList[POOL_CLASS_COUNT];
+	//! All slabs, sorted by address
+	array<SSlab> Slabs;
+};
+
+// Created before main and never destroyed, so objects can still be deleted
+// during the destruction of global objects.
+SObjectPools& Pools = *new SObjectPools();
+
+
+//! Puts a new slab for a size class into its free list
+bool addSlab(u32 sizeClass)
+{
+	const u32 blockSize = (sizeClass + 1) * POOL_GRANULARITY;
+	const u32 blockCount = POOL_SLAB_SIZE / blockSize;
+
+	SSlab slab;
+	slab.Begin = (u8*)malloc(blockCount * blockSize);
+	if (!slab.Begin)
+		return false;
+	slab.End = slab.Begin + blockCount * blockSize;
+	slab.SizeClass = sizeClass;
+
+	u32 index = 0;
+	while (index < Pools.Slabs.size() && Pools.Slabs[index].Begin < slab.Begin)
+		++index;
+	Pools.Slabs.insert(slab, index);
+
+	// in reverse, so blocks are handed out in address order
+	u8* block = slab.End - blockSize;
+	for (u32 i=0; i<blockCount; ++i, block -= blockSize)
+	{
+		SFreeBlock* freeBlock = (SFreeBlock*)block;
+		freeBlock->Next = Pools.FreeList[sizeClass];
+		Pools.FreeList[sizeClass] = freeBlock;
+	}
+
+	ObjectPoolState.Used = true;
+	return true;
+}
+
+
+//! Get the slab which contains the memory, 0 if it is not from the pools
+const SSlab* findSlab(const void* ptr)
+{
+	// last slab which begins before ptr
+	s32 low = 0;
+	s32 high = (s32)Pools.Slabs.size() - 1;
+	while (low <= high)
+	{
+		const s32 middle = (low + high) / 2;
+		if (Pools.Slabs[middle].Begin <= (const u8*)ptr)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+
+	if (high < 0 || (const u8*)ptr >= Pools.Slabs[high].End)
+		return 0;
+	return &Pools.Slabs[high];
+}
+
+} // end anonymous namespace
+
+
+IRRLICHT_API void IRRCALLCONV setUseObjectPools(bool enable)
+{
+	ObjectPoolState.Enabled = enable;
+}
+
+
+IRRLICHT_API bool IRRCALLCONV getUseObjectPools()
+{
+	return ObjectPoolState.Enabled;
+}
+
+
+IRRLICHT_API void* IRRCALLCONV allocatePooledObject(size_t size)
+{
+	if (size && size <= POOL_MAX_BLOCK)
+	{
+		const u32 sizeClass = (u32)((size + POOL_GRANULARITY - 1) / POOL_GRANULARITY) - 1;
+		SFreeBlock* block = 0;
+
+		Pools.Lock.lock();
+		if (Pools.FreeList[sizeClass] || addSlab(sizeClass))
+		{
+			block = Pools.FreeList[sizeClass];
+			Pools.FreeList[sizeClass] = block->Next;
+		}
+		Pools.Lock.unlock();
+
+		if (block)
+			return block;
+	}
+
+	return ::operator new(size);
+}
+
+
+IRRLICHT_API void IRRCALLCONV deallocatePooledObject(void* ptr)
+{
+	if (!ptr)
+		return;
+
+	Pools.Lock.lock();
+	const SSlab* slab = findSlab(ptr);
+	if (slab)
+	{
+		SFreeBlock* block = (SFreeBlock*)ptr;
+		block->Next = Pools.FreeList[slab->SizeClass];
+		Pools.FreeList[slab->SizeClass] = block;
+	}
+	Pools.Lock.unlock();
+
+	if (!slab)
+		::operator delete(ptr);
+}
+
+} // end namespace core
+} // end namespace irr
+
@@ -0,0 +1,431 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "COcclusionCuller.h"
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+COcclusionCuller::COcclusionCuller()
+	: Pitch(0), Valid(false)
+{
+	setSize(core::dimension2du(256, 128));
+}
+
+
+COcclusionCuller::~COcclusionCuller()
+{
+	clear();
+}
+
+
+void COcclusionCuller::setOccluder(ISceneNode* node, IMesh* mesh)
+{
+	if (!node)
+		return;
+
+	SOccluder key;
+	key.Node = node;
+	key.Mesh = mesh;
+	const s32 index = Occluders.binary_search(key);
+
+	if (index >= 0)
+	{
+		if (Occluders[index].Mesh == mesh)
+			return;
+		Occluders[index].Node->drop();
+		Occluders[index].Mesh->drop();
+		Occluders.erase(index);
+	}
+
+	if (mesh)
+	{
+		node->grab();
+		mesh->grab();
+		Occluders.push_back(key);
+		Occluders.sort();
+	}
+}
+
+
+IMesh* COcclusionCuller::getOccluder(const ISceneNode* node) const
+{
+	SOccluder key;
+	key.Node = const_cast<ISceneNode*>(node);
+	key.Mesh = 0;
+	const s32 index = Occluders.binary_search(key, 0, (s32)Occluders.size() - 1);
+	return (index >= 0) ? Occluders[index].Mesh : 0;
+}
+
+
+void COcclusionCuller::clear()
+{
+	for (u32 i=0; i<Occluders.size(); ++i)
+	{
+		Occluders[i].Node->drop();
+		Occluders[i].Mesh->drop();
+	}
+	Occluders.clear();
+	Valid = false;
+}
+
+
+void COcclusionCuller::setSize(const core::dimension2du& size)
+{
+	Size.Width = core::max_(size.Width, 1u);
+	Size.Height = core::max_(size.Height, 1u);
+	Pitch = (Size.Width + 3) & ~3u;
+	// the last row is written 4 pixels at a time
+	Depth.set_used(Pitch * Size.Height + 4);
+
+	LevelSize.set_used(0);
+	LevelStart.set_used(0);
+	core::dimension2du levelSize(Size);
+	u32 levelStart = 0;
+	while (levelSize.Width > 1 || levelSize.Height > 1)
+	{
+		levelSize.Width = (levelSize.Width + 1) / 2;
+		levelSize.Height = (levelSize.Height + 1) / 2;
+		LevelSize.push_back(levelSize);
+		LevelStart.push_back(levelStart);
+		levelStart += levelSize.getArea();
+	}
+	Levels.set_used(levelStart);
+	Valid = false;
+}
+
+
+bool COcclusionCuller::isInScene(const ISceneNode* node, const ISceneNode* root)
+{
+	while (node)
+	{
+		if (!node->isVisible())
+			return false;
+		if (node == root)
+			return true;
+		node = node->getParent();
+	}
+	return false;
+}
+
+
+void COcclusionCuller::render(const ICameraSceneNode* camera, const ISceneNode* root)
+{
+	Valid = false;
+	if (!camera || Occluders.empty())
+		return;
+
+	ViewProjection = camera->getProjectionMatrix() * camera->getViewMatrix();
+
+	for (u32 i=0; i<Depth.size(); ++i)
+		Depth[i] = FLT_MAX;
+
+	for (u32 i=0; i<Occluders.size(); ++i)
+	{
+		if (!isInScene(Occluders[i].Node, root))
+			continue;
+		rasterizeMesh(Occluders[i].Mesh, ViewProjection * Occluders[i].Node->getAbsoluteTransformation());
+		Valid = true;
+	}
+
+	if (Valid)
+		buildLevels();
+}
+
+
+void COcclusionCuller::rasterizeMesh(const IMesh* mesh, const core::matrix4& transformation)
+{
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		if (mb->getPrimitiveType() != EPT_TRIANGLES)
+			continue;
+
+		const u32 vertexCount = mb->getVertexCount();
+		const u32 vertexPitch = video::getVertexPitchFromType(mb->getVertexType());
+		const u8* vertices = (const u8*)mb->getVertices();
+
+		ClipVertices.set_used(vertexCount * 4);
+		for (u32 i=0; i<vertexCount; ++i)
+			transformation.transformVect(&ClipVertices[i * 4], *(const core::vector3df*)(vertices + i * vertexPitch));
+
+		const u32 indexCount = mb->getIndexCount() / 3 * 3;
+		const f32* clip = ClipVertices.const_pointer();
+		if (mb->getIndexType() == video::EIT_32BIT)
+		{
+			const u32* indices = (const u32*)mb->getIndices();
+			for (u32 i=0; i<indexCount; i+=3)
+				clipTriangle(clip + indices[i] * 4, clip + indices[i+1] * 4, clip + indices[i+2] * 4);
+		}
+		else
+		{
+			const u16* indices = mb->getIndices();
+			for (u32 i=0; i<indexCount; i+=3)
+				clipTriangle(clip + indices[i] * 4, clip + indices[i+1] * 4, clip + indices[i+2] * 4);
+		}
+	}
+}
+
+
+void COcclusionCuller::clipTriangle(const f32* a, const f32* b, const f32* c)
+{
+	// completely outside of a side plane
+	if ((a[0] > a[3] && b[0] > b[3] && c[0] > c[3]) || (a[0] < -a[3] && b[0] < -b[3] && c[0] < -c[3]) ||
+		(a[1] > a[3] && b[1] > b[3] && c[1] > c[3]) || (a[1] < -a[3] && b[1] < -b[3] && c[1] < -c[3]))
+		return;
+
+	// the near plane is z=0 in clip space
+	const f32* in[3] = { a, b, c };
+	u32 inside = 0;
+	for (u32 i=0; i<3; ++i)
+		inside += (in[i][2] >= 0.f);
+
+	if (inside == 3)
+	{
+		rasterizeTriangle(a, b, c);
+		return;
+	}
+	if (inside == 0)
+		return;
+
+	f32 out[4][4];
+	u32 count = 0;
+	for (u32 i=0; i<3; ++i)
+	{
+		const f32* p = in[i];
+		const f32* q = in[(i + 1) % 3];
+		if (p[2] >= 0.f)
+		{
+			for (u32 k=0; k<4; ++k)
+				out[count][k] = p[k];
+			++count;
+		}
+		if ((p[2] >= 0.f) != (q[2] >= 0.f))
+		{
+			const f32 t = p[2] / (p[2] - q[2]);
+			for (u32 k=0; k<4; ++k)
+				out[count][k] = p[k] + (q[k] - p[k]) * t;
+			out[count][2] = 0.f;
+			++count;
+		}
+	}
+
+	for (u32 i=2; i<count; ++i)
+		rasterizeTriangle(out[0], out[i - 1], out[i]);
+}
+
+
+void COcclusionCuller::rasterizeTriangle(const f32* a, const f32* b, const f32* c)
+{
+	// to pixels, y goes down
+	const f32 width = (f32)Size.Width;
+	const f32 height = (f32)Size.Height;
+	f32 x[3], y[3], z[3];
+	const f32* in[3] = { a, b, c };
+	for (u32 i=0; i<3; ++i)
+	{
+		const f32 w = core::reciprocal(in[i][3]);
+		x[i] = (in[i][0] * w * 0.5f + 0.5f) * width;
+		y[i] = (0.5f - in[i][1] * w * 0.5f) * height;
+		z[i] = in[i][2] * w;
+	}
+
+	f32 area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+	if (area == 0.f)
+		return;
+
+	// both sides are drawn, make the edge functions positive inside
+	if (area < 0.f)
+	{
+		core::swap(x[1], x[2]);
+		core::swap(y[1], y[2]);
+		core::swap(z[1], z[2]);
+		area = -area;
+	}
+
+	const s32 minX = core::max_(0, (s32)floorf(core::min_(x[0], x[1], x[2])));
+	const s32 maxX = core::min_((s32)Size.Width - 1, (s32)floorf(core::max_(x[0], x[1], x[2])));
+	const s32 minY = core::max_(0, (s32)floorf(core::min_(y[0], y[1], y[2])));
+	const s32 maxY = core::min_((s32)Size.Height - 1, (s32)floorf(core::max_(y[0], y[1], y[2])));
+	if (minX > maxX || minY > maxY)
+		return;
+
+	// edge functions A*x + B*y + C, from vertex i to vertex i+1
+	f32 edgeA[3], edgeB[3], edgeC[3];
+	for (u32 i=0; i<3; ++i)
+	{
+		const u32 j = (i + 1) % 3;
+		edgeA[i] = y[i] - y[j];
+		edgeB[i] = x[j] - x[i];
+		edgeC[i] = -(edgeA[i] * x[i] + edgeB[i] * y[i]);
+	}
+
+	const f32 invArea = core::reciprocal(area);
+	const f32 dzdx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * invArea;
+	const f32 dzdy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) * invArea;
+
+	const f32 startX = minX + 0.5f;
+	const f32 lastOffset = (f32)(maxX - minX);
+
+	for (s32 py=minY; py<=maxY; ++py)
+	{
+		const f32 centerY = py + 0.5f;
+		const f32 e0 = edgeA[0] * startX + edgeB[0] * centerY + edgeC[0];
+		const f32 e1 = edgeA[1] * startX + edgeB[1] * centerY + edgeC[1];
+		const f32 e2 = edgeA[2] * startX + edgeB[2] * centerY + edgeC[2];
+		const f32 depth = z[0] + dzdx * (startX - x[0]) + dzdy * (centerY - y[0]);
+		f32* row = &Depth[py * Pitch + minX];
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+		const __m128 step = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 last = _mm_set1_ps(lastOffset);
+		for (s32 px=0; px<=maxX-minX; px+=4)
+		{
+			const __m128 offset = _mm_add_ps(_mm_set1_ps((f32)px), step);
+			const __m128 w0 = _mm_add_ps(_mm_set1_ps(e0), _mm_mul_ps(_mm_set1_ps(edgeA[0]), offset));
+			const __m128 w1 = _mm_add_ps(_mm_set1_ps(e1), _mm_mul_ps(_mm_set1_ps(edgeA[1]), offset));
+			const __m128 w2 = _mm_add_ps(_mm_set1_ps(e2), _mm_mul_ps(_mm_set1_ps(edgeA[2]), offset));
+			const __m128 d = _mm_add_ps(_mm_set1_ps(depth), _mm_mul_ps(_mm_set1_ps(dzdx), offset));
+
+			const __m128 mask = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)),
+				_mm_and_ps(_mm_cmpge_ps(w2, zero), _mm_cmple_ps(offset, last)));
+			if (!_mm_movemask_ps(mask))
+				continue;
+
+			const __m128 old = _mm_loadu_ps(row + px);
+			const __m128 closer = _mm_min_ps(old, d);
+			_mm_storeu_ps(row + px, _mm_or_ps(_mm_and_ps(mask, closer), _mm_andnot_ps(mask, old)));
+		}
+#else
+		for (s32 px=0; px<=maxX-minX; ++px)
+		{
+			const f32 offset = (f32)px;
+			if (e0 + edgeA[0] * offset >= 0.f && e1 + edgeA[1] * offset >= 0.f && e2 + edgeA[2] * offset >= 0.f)
+			{
+				const f32 d = depth + dzdx * offset;
+				if (d < row[px])
+					row[px] = d;
+			}
+		}
+#endif
+	}
+}
+
+
+void COcclusionCuller::buildLevels()
+{
+	const f32* source = Depth.const_pointer();
+	u32 sourcePitch = Pitch;
+	core::dimension2du sourceSize(Size);
+
+	for (u32 l=0; l<LevelSize.size(); ++l)
+	{
+		f32* target = &Levels[LevelStart[l]];
+		const core::dimension2du& size = LevelSize[l];
+
+		for (u32 y=0; y<size.Height; ++y)
+		{
+			const f32* row0 = source + y * 2 * sourcePitch;
+			const f32* row1 = (y * 2 + 1 < sourceSize.Height) ? row0 + sourcePitch : row0;
+
+			for (u32 x=0; x<size.Width; ++x)
+			{
+				const u32 x1 = (x * 2 + 1 < sourceSize.Width) ? x * 2 + 1 : x * 2;
+				target[y * size.Width + x] = core::max_(
+					core::max_(row0[x * 2], row0[x1]),
+					core::max_(row1[x * 2], row1[x1]));
+			}
+		}
+
+		source = target;
+		sourcePitch = size.Width;
+		sourceSize = size;
+	}
+}
+
+
+bool COcclusionCuller::isOccluded(const core::aabbox3df& box) const
+{
+	if (!Valid)
+		return false;
+
+	core::vector3df edges[8];
+	box.getEdges(edges);
+
+	f32 minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+	f32 maxX = -FLT_MAX, maxY = -FLT_MAX;
+	for (u32 i=0; i<8; ++i)
+	{
+		f32 clip[4];
+		ViewProjection.transformVect(clip, edges[i]);
+
+		// boxes reaching through the near plane are visible
+		if (clip[2] < 0.f || clip[3] <= 0.f)
+			return false;
+
+		const f32 w = core::reciprocal(clip[3]);
+		const f32 x = (clip[0] * w * 0.5f + 0.5f) * Size.Width;
+		const f32 y = (0.5f - clip[1] * w * 0.5f) * Size.Height;
+		minX = core::min_(minX, x);
+		maxX = core::max_(maxX, x);
+		minY = core::min_(minY, y);
+		maxY = core::max_(maxY, y);
+		minZ = core::min_(minZ, clip[2] * w);
+	}
+
+	// outside of the screen is left to the frustum culling
+	if (maxX < 0.f || maxY < 0.f || minX >= Size.Width || minY >= Size.Height)
+		return false;
+
+	const s32 x0 = core::max_(0, (s32)floorf(minX));
+	const s32 y0 = core::max_(0, (s32)floorf(minY));
+	const s32 x1 = core::min_((s32)Size.Width - 1, (s32)floorf(maxX));
+	const s32 y1 = core::min_((s32)Size.Height - 1, (s32)floorf(maxY));
+
+	// start where the rectangle touches at most 2x2 texels
+	u32 level = 0;
+	while ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)
+		++level;
+
+	return isRegionOccluded(level, x0 >> level, y0 >> level, x1 >> level, y1 >> level,
+		x0, y0, x1, y1, minZ);
+}
+
+
+bool COcclusionCuller::isRegionOccluded(u32 level, s32 x0, s32 y0, s32 x1, s32 y1,
+		s32 pixelX0, s32 pixelY0, s32 pixelX1, s32 pixelY1, f32 depth) const
+{
+	for (s32 y=y0; y<=y1; ++y)
+	{
+		for (s32 x=x0; x<=x1; ++x)
+		{
+			const f32 texel = level ?
+				Levels[LevelStart[level - 1] + y * LevelSize[level - 1].Width + x] :
+				Depth[y * Pitch + x];
+			if (texel < depth)
+				continue;
+			if (!level)
+				return false;
+
+			// look at the part of the rectangle in the finer texels
+			const u32 child = level - 1;
+			if (!isRegionOccluded(child,
+					core::max_(x * 2, pixelX0 >> child), core::max_(y * 2, pixelY0 >> child),
+					core::min_(x * 2 + 1, pixelX1 >> child), core::min_(y * 2 + 1, pixelY1 >> child),
+					pixelX0, pixelY0, pixelX1, pixelY1, depth))
+				return false;
+		}
+	}
+	return true;
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,118 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_OCCLUSION_CULLER_H_INCLUDED__
+#define __C_OCCLUSION_CULLER_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "IMesh.h"
+#include "IMeshBuffer.h"
+#include "ICameraSceneNode.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Culls scene nodes hidden behind occluder meshes with a depth buffer on the CPU.
+	/** Used by the scene manager for EAC_OCC_SOFTWARE. Once per frame the
+	occluder meshes are rasterized into a small depth buffer, with
+	_IRR_COMPILE_WITH_SSE2_ 4 pixels at a time. Depth is z/w of the camera
+	projection and only written, never tested. From the depth buffer a chain
+	of levels is built, each texel holding the largest depth of 2x2 texels
+	of the level below. A box is hidden when all texels its screen rectangle
+	touches are closer than the closest point of the box. The test starts on
+	the level where the rectangle touches at most 2x2 texels and only goes
+	down to the finer levels where this isn't enough. */
+	class COcclusionCuller
+	{
+	public:
+
+		//! Constructor
+		COcclusionCuller();
+
+		//! Destructor
+		~COcclusionCuller();
+
+		//! Set or remove the occluder mesh of a node. Grabs node and mesh.
+		void setOccluder(ISceneNode* node, IMesh* mesh);
+
+		//! Get the occluder mesh of a node, 0 if the node is no occluder.
+		IMesh* getOccluder(const ISceneNode* node) const;
+
+		//! Drops all occluders
+		void clear();
+
+		//! Set the resolution of the depth buffer.
+		void setSize(const core::dimension2du& size);
+
+		const core::dimension2du& getSize() const { return Size; }
+
+		//! Rasterizes the visible occluders below root for the camera and builds the depth levels.
+		/** The absolute transformations of all nodes must be up to date.
+		Without camera or visible occluders nothing is culled until the next call. */
+		void render(const ICameraSceneNode* camera, const ISceneNode* root);
+
+		//! Check if a world space box is hidden behind the occluders of the last render() call.
+		bool isOccluded(const core::aabbox3df& box) const;
+
+		//! Get the depth of a pixel of the last render() call.
+		f32 getDepth(u32 x, u32 y) const { return Depth[y * Pitch + x]; }
+
+	private:
+
+		struct SOccluder
+		{
+			ISceneNode* Node;
+			IMesh* Mesh;
+
+			bool operator < (const SOccluder& other) const
+			{
+				return Node < other.Node;
+			}
+		};
+
+		//! Check if the node and all its parents are visible and it is in the scene below root
+		static bool isInScene(const ISceneNode* node, const ISceneNode* root);
+
+		//! Rasterizes all triangles of the mesh with the transformation to clip space
+		void rasterizeMesh(const IMesh* mesh, const core::matrix4& transformation);
+
+		//! Clips a triangle in clip space at the near plane and rasterizes it
+		void clipTriangle(const f32* a, const f32* b, const f32* c);
+
+		//! Rasterizes a triangle in clip space which is in front of the near plane
+		void rasterizeTriangle(const f32* a, const f32* b, const f32* c);
+
+		//! Builds the levels with the largest depth of the level below
+		void buildLevels();
+
+		//! Check if the texels of a level are all closer than depth
+		bool isRegionOccluded(u32 level, s32 x0, s32 y0, s32 x1, s32 y1,
+				s32 pixelX0, s32 pixelY0, s32 pixelX1, s32 pixelY1, f32 depth) const;
+
+		//! Occluders, sorted by node
+		core::array<SOccluder> Occluders;
+
+		core::dimension2du Size;
+		//! Width of a row of Depth, multiple of 4
+		u32 Pitch;
+		core::array<f32> Depth;
+
+		//! Size and start in Levels of each level above the depth buffer
+		core::array<core::dimension2du> LevelSize;
+		core::array<u32> LevelStart;
+		core::array<f32> Levels;
+
+		core::matrix4 ViewProjection;
+		//! Transformed vertices of the current mesh buffer
+		core::array<f32> ClipVertices;
+		//! Set when occluders were rendered for the current camera
+		bool Valid;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -13,6 +13,7 @@
 #include "ILightSceneNode.h"
 #include "IQ3Shader.h"
 #include "IFileList.h"
+#include "irrMap.h"
 
 //#define TJUNCTION_SOLVER_ROUND
 //#define TJUNCTION_SOLVER_0125
@@ -43,6 +44,10 @@ CQ3LevelMesh::CQ3LevelMesh(io::IFileSystem* fs, scene::ISceneManager* smgr,
 		Mesh[i] = 0;
 	}
 
+	VisData.numOfClusters = 0;
+	VisData.bytesPerCluster = 0;
+	VisData.pBitsets = 0;
+
 	Driver = smgr ? smgr->getVideoDriver() : 0;
 	if (Driver)
 		Driver->grab();
@@ -162,6 +167,7 @@ bool CQ3LevelMesh::loadFile(io::IReadFile* file)
 
 	cleanMeshes();
 	calcBoundingBoxes();
+	buildVisibility();
 	cleanLoader();
 
 	return true;
@@ -182,7 +188,9 @@ void CQ3LevelMesh::cleanLoader ()
 	delete [] LeafFaces; LeafFaces = 0;
 	delete [] MeshVerts; MeshVerts = 0;
 	delete [] Brushes; Brushes = 0;
+	delete [] VisData.pBitsets; VisData.pBitsets = 0;
 
+	FaceBuffers.clear();
 	Lightmap.clear();
 	Tex.clear();
 }
@@ -314,7 +322,24 @@ void CQ3LevelMesh::loadFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumPlanes = l->length / sizeof(tBSPPlane);
+	if ( !NumPlanes )
+		return;
+	Planes = new tBSPPlane[NumPlanes];
+
+	file->seek( l->offset );
+	file->read( Planes, l->length );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumPlanes; i++)
+		{
+			Planes[i].vNormal[0] = os::Byteswap::byteswap(Planes[i].vNormal[0]);
+			Planes[i].vNormal[1] = os::Byteswap::byteswap(Planes[i].vNormal[1]);
+			Planes[i].vNormal[2] = os::Byteswap::byteswap(Planes[i].vNormal[2]);
+			Planes[i].d = os::Byteswap::byteswap(Planes[i].d);
+		}
+	}
 }
 
 
@@ -322,7 +347,29 @@ void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumNodes = l->length / sizeof(tBSPNode);
+	if ( !NumNodes )
+		return;
+	Nodes = new tBSPNode[NumNodes];
+
+	file->seek( l->offset );
+	file->read( Nodes, l->length );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumNodes; i++)
+		{
+			Nodes[i].plane = os::Byteswap::byteswap(Nodes[i].plane);
+			Nodes[i].front = os::Byteswap::byteswap(Nodes[i].front);
+			Nodes[i].back = os::Byteswap::byteswap(Nodes[i].back);
+			Nodes[i].mins[0] = os::Byteswap::byteswap(Nodes[i].mins[0]);
+			Nodes[i].mins[1] = os::Byteswap::byteswap(Nodes[i].mins[1]);
+			Nodes[i].mins[2] = os::Byteswap::byteswap(Nodes[i].mins[2]);
+			Nodes[i].maxs[0] = os::Byteswap::byteswap(Nodes[i].maxs[0]);
+			Nodes[i].maxs[1] = os::Byteswap::byteswap(Nodes[i].maxs[1]);
+			Nodes[i].maxs[2] = os::Byteswap::byteswap(Nodes[i].maxs[2]);
+		}
+	}
 }
 
 
@@ -330,7 +377,32 @@ void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafs = l->length / sizeof(tBSPLeaf);
+	if ( !NumLeafs )
+		return;
+	Leafs = new tBSPLeaf[NumLeafs];
+
+	file->seek( l->offset );
+	file->read( Leafs, l->length );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumLeafs; i++)
+		{
+			Leafs[i].cluster = os::Byteswap::byteswap(Leafs[i].cluster);
+			Leafs[i].area = os::Byteswap::byteswap(Leafs[i].area);
+			Leafs[i].mins[0] = os::Byteswap::byteswap(Leafs[i].mins[0]);
+			Leafs[i].mins[1] = os::Byteswap::byteswap(Leafs[i].mins[1]);
+			Leafs[i].mins[2] = os::Byteswap::byteswap(Leafs[i].mins[2]);
+			Leafs[i].maxs[0] = os::Byteswap::byteswap(Leafs[i].maxs[0]);
+			Leafs[i].maxs[1] = os::Byteswap::byteswap(Leafs[i].maxs[1]);
+			Leafs[i].maxs[2] = os::Byteswap::byteswap(Leafs[i].maxs[2]);
+			Leafs[i].leafface = os::Byteswap::byteswap(Leafs[i].leafface);
+			Leafs[i].numOfLeafFaces = os::Byteswap::byteswap(Leafs[i].numOfLeafFaces);
+			Leafs[i].leafBrush = os::Byteswap::byteswap(Leafs[i].leafBrush);
+			Leafs[i].numOfLeafBrushes = os::Byteswap::byteswap(Leafs[i].numOfLeafBrushes);
+		}
+	}
 }
 
 
@@ -338,15 +410,54 @@ void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafFaces = l->length / sizeof(s32);
+	if ( !NumLeafFaces )
+		return;
+	LeafFaces = new s32[NumLeafFaces];
+
+	file->seek( l->offset );
+	file->read( LeafFaces, l->length );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumLeafFaces; i++)
+		{
+			LeafFaces[i] = os::Byteswap::byteswap(LeafFaces[i]);
+		}
+	}
 }
 
 
 /*!
+	load the bitsets of the clusters visible from each cluster
 */
 void CQ3LevelMesh::loadVisData(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	VisData.numOfClusters = 0;
+	VisData.bytesPerCluster = 0;
+	if ( l->length < 8 )
+		return;
+
+	file->seek( l->offset );
+	file->read( &VisData.numOfClusters, sizeof(s32) );
+	file->read( &VisData.bytesPerCluster, sizeof(s32) );
+
+	if ( LoadParam.swapHeader )
+	{
+		VisData.numOfClusters = os::Byteswap::byteswap(VisData.numOfClusters);
+		VisData.bytesPerCluster = os::Byteswap::byteswap(VisData.bytesPerCluster);
+	}
+
+	const s32 size = VisData.numOfClusters * VisData.bytesPerCluster;
+	if ( size <= 0 || size > l->length - 8 )
+	{
+		VisData.numOfClusters = 0;
+		VisData.bytesPerCluster = 0;
+		return;
+	}
+
+	VisData.pBitsets = new c8[size];
+	file->read( VisData.pBitsets, size );
 }
 
 
@@ -863,6 +974,19 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 	SToBuffer item [ E_Q3_MESH_SIZE ];
 	u32 itemSize;
 
+	// remember where the faces of the main level end up for the visibility
+	if ( 0 == num )
+	{
+		SFaceBuffer none;
+		none.Buffer = 0;
+		none.FirstIndex = 0;
+		none.IndexCount = 0;
+		FaceBuffers.set_used( 0 );
+		FaceBuffers.reallocate( NumFaces );
+		for ( i = 0; i < NumFaces; ++i )
+			FaceBuffers.push_back( none );
+	}
+
 	for (i = Models[num].faceIndex; i < Models[num].numOfFaces + Models[num].faceIndex; ++i)
 	{
 		const tBSPFace * face = Faces + i;
@@ -965,6 +1089,8 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 			}
 
 
+			const u32 firstIndex = buffer->getIndexCount();
+
 			switch(Faces[i].type)
 			{
 				case 4: // billboards
@@ -1018,6 +1144,13 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 					break;
 
 			} // end switch
+
+			if ( 0 == num && item[g].index == E_Q3_MESH_GEOMETRY )
+			{
+				FaceBuffers[i].Buffer = buffer;
+				FaceBuffers[i].FirstIndex = firstIndex;
+				FaceBuffers[i].IndexCount = buffer->getIndexCount() - firstIndex;
+			}
 		}
 	}
 
@@ -1933,6 +2066,137 @@ void CQ3LevelMesh::calcBoundingBoxes()
 }
 
 
+/*!
+	keep the bsp tree, the leafs and the cluster visibility of the main level
+	in irrlicht coordinates, the loader data is deleted afterwards.
+*/
+void CQ3LevelMesh::buildVisibility()
+{
+	s32 i;
+
+	Visibility.Planes.reallocate( NumPlanes );
+	for ( i = 0; i < NumPlanes; ++i )
+	{
+		const tBSPPlane& plane = Planes[i];
+		Visibility.Planes.push_back( core::plane3df(
+			core::vector3df( plane.vNormal[0], plane.vNormal[2], plane.vNormal[1] ),
+			-plane.d ) );
+	}
+
+	Visibility.Nodes.reallocate( NumNodes );
+	for ( i = 0; i < NumNodes; ++i )
+	{
+		SBSPVisibility::SNode node;
+		node.Plane = Nodes[i].plane;
+		node.Children[0] = Nodes[i].front;
+		node.Children[1] = Nodes[i].back;
+		Visibility.Nodes.push_back( node );
+	}
+
+	Visibility.Leafs.reallocate( NumLeafs );
+	for ( i = 0; i < NumLeafs; ++i )
+	{
+		const tBSPLeaf& leaf = Leafs[i];
+		SBSPVisibility::SLeaf l;
+		l.Cluster = leaf.cluster;
+		l.Box.reset( (f32) leaf.mins[0], (f32) leaf.mins[2], (f32) leaf.mins[1] );
+		l.Box.addInternalPoint( (f32) leaf.maxs[0], (f32) leaf.maxs[2], (f32) leaf.maxs[1] );
+		l.FirstFace = leaf.leafface;
+		l.FaceCount = leaf.numOfLeafFaces;
+		if ( l.FirstFace < 0 || l.FaceCount < 0 || l.FirstFace + l.FaceCount > NumLeafFaces )
+		{
+			l.FirstFace = 0;
+			l.FaceCount = 0;
+		}
+		Visibility.Leafs.push_back( l );
+	}
+
+	Visibility.LeafFaces.reallocate( NumLeafFaces );
+	for ( i = 0; i < NumLeafFaces; ++i )
+	{
+		Visibility.LeafFaces.push_back( LeafFaces[i] );
+	}
+
+	Visibility.ClusterCount = VisData.numOfClusters;
+	Visibility.BytesPerCluster = VisData.bytesPerCluster;
+	Visibility.ClusterBits.set_used( VisData.numOfClusters * VisData.bytesPerCluster );
+	if ( VisData.pBitsets )
+		memcpy( Visibility.ClusterBits.pointer(), VisData.pBitsets, Visibility.ClusterBits.size() );
+
+	// the buffers of the faces, after empty buffers were removed
+	const SMesh* mesh = Mesh[E_Q3_MESH_GEOMETRY];
+	core::map<const IMeshBuffer*, s32> bufferIndex;
+	for ( u32 b = 0; b < mesh->MeshBuffers.size(); ++b )
+		bufferIndex.insert( mesh->MeshBuffers[b], b );
+
+	Visibility.FaceRanges.reallocate( FaceBuffers.size() );
+	for ( u32 f = 0; f < FaceBuffers.size(); ++f )
+	{
+		SBSPVisibility::SFaceRange range;
+		range.Buffer = -1;
+		range.FirstIndex = FaceBuffers[f].FirstIndex;
+		range.IndexCount = FaceBuffers[f].IndexCount;
+
+		const core::map<const IMeshBuffer*, s32>::Node* node = bufferIndex.find( FaceBuffers[f].Buffer );
+		if ( node && range.IndexCount )
+			range.Buffer = node->getValue();
+		Visibility.FaceRanges.push_back( range );
+	}
+
+	// the indices are used as they come from the file, so check them once.
+	// without the tree and the cluster bits all leafs in the frustum are drawn
+	bool valid = Visibility.ClusterCount >= 0 && Visibility.BytesPerCluster >= 0 &&
+		Visibility.BytesPerCluster >= ( Visibility.ClusterCount + 7 ) / 8 &&
+		( Visibility.ClusterBits.empty() || Visibility.ClusterBits.size() / Visibility.BytesPerCluster == (u32) Visibility.ClusterCount );
+
+	for ( u32 n = 0; valid && n < Visibility.Nodes.size(); ++n )
+	{
+		const SBSPVisibility::SNode& node = Visibility.Nodes[n];
+		valid = node.Plane >= 0 && node.Plane < (s32) Visibility.Planes.size();
+		for ( u32 c = 0; valid && c < 2; ++c )
+		{
+			const s32 child = node.Children[c];
+			valid = child >= 0 ? child < (s32) Visibility.Nodes.size() : -( child + 1 ) < (s32) Visibility.Leafs.size();
+		}
+	}
+
+	for ( u32 l = 0; valid && l < Visibility.Leafs.size(); ++l )
+		valid = Visibility.Leafs[l].Cluster < Visibility.ClusterCount;
+
+	if ( !valid )
+	{
+		os::Printer::log("Quake 3 level has invalid visibility data, drawing all leafs", ELL_WARNING);
+		Visibility.Nodes.clear();
+		Visibility.ClusterCount = 0;
+		Visibility.BytesPerCluster = 0;
+		Visibility.ClusterBits.clear();
+	}
+}
+
+
+//! Index of the leaf containing the point, -1 without nodes
+s32 CQ3LevelMesh::SBSPVisibility::findLeaf(const core::vector3df& p) const
+{
+	if ( Nodes.empty() )
+		return -1;
+
+	// a valid tree reaches a leaf before it visits each node once,
+	// a child pointing back to an ancestor would loop forever
+	s32 index = 0;
+	for ( u32 steps = 0; index >= 0; ++steps )
+	{
+		if ( steps == Nodes.size() )
+			return -1;
+
+		const SNode& node = Nodes[index];
+		const core::plane3df& plane = Planes[node.Plane];
+		index = node.Children[ plane.Normal.dotProduct( p ) + plane.D > 0.f ? 0 : 1 ];
+	}
+
+	return -( index + 1 );
+}
+
+
 //! loads the textures
 void CQ3LevelMesh::loadTextures()
 {
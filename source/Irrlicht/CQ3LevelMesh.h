@@ -89,6 +89,64 @@ namespace scene
 		//! returns the requested brush entity
 		virtual IMesh* getBrushEntityMesh(quake3::IEntity &ent) const _IRR_OVERRIDE_;
 
+		//! BSP tree and potentially visible sets of the main level
+		/** In Irrlicht coordinates. Leaf faces index FaceRanges, which
+		locate the indices of each face in the buffers of
+		getMesh(quake3::E_Q3_MESH_GEOMETRY). */
+		struct SBSPVisibility
+		{
+			struct SNode
+			{
+				s32 Plane;
+				//! Front and back child, -(leaf+1) for leafs
+				s32 Children[2];
+			};
+
+			struct SLeaf
+			{
+				//! Visibility cluster, -1 for leafs outside the level
+				s32 Cluster;
+				core::aabbox3df Box;
+				s32 FirstFace;
+				s32 FaceCount;
+			};
+
+			struct SFaceRange
+			{
+				//! Mesh buffer of the face, -1 if it has no geometry
+				s32 Buffer;
+				u32 FirstIndex;
+				u32 IndexCount;
+			};
+
+			SBSPVisibility() : ClusterCount(0), BytesPerCluster(0) {}
+
+			//! Index of the leaf containing the point, -1 without nodes
+			s32 findLeaf(const core::vector3df& p) const;
+
+			//! Check if cluster b is potentially visible from cluster a
+			/** The clusters of all leafs are checked against ClusterCount
+			when the level is loaded. */
+			bool isClusterVisible(s32 a, s32 b) const
+			{
+				if (a < 0 || ClusterBits.empty())
+					return true;
+				return b >= 0 && (ClusterBits[a * BytesPerCluster + (b >> 3)] & (1 << (b & 7)));
+			}
+
+			core::array<core::plane3df> Planes;
+			core::array<SNode> Nodes;
+			core::array<SLeaf> Leafs;
+			core::array<s32> LeafFaces;
+			core::array<SFaceRange> FaceRanges;
+			s32 ClusterCount;
+			s32 BytesPerCluster;
+			core::array<u8> ClusterBits;
+		};
+
+		//! Get the BSP tree and visibility data of the main level
+		const SBSPVisibility& getVisibility() const { return Visibility; }
+
 		//Link to held meshes? ...
 
 
@@ -410,6 +468,19 @@ namespace scene
 		tBSPBrush* Brushes;
 		s32 NumBrushes;
 
+		tBSPVisData VisData;
+
+		//! Buffer and index range of each face of the main level while building it
+		struct SFaceBuffer
+		{
+			IMeshBuffer* Buffer;
+			u32 FirstIndex;
+			u32 IndexCount;
+		};
+		core::array<SFaceBuffer> FaceBuffers;
+
+		SBSPVisibility Visibility;
+
 		scene::SMesh** BrushEntities;
 
 		scene::SMesh* Mesh[quake3::E_Q3_MESH_SIZE];
@@ -477,6 +548,7 @@ namespace scene
 		void cleanMesh(SMesh *m, const bool texture0important = false);
 		void cleanLoader ();
 		void calcBoundingBoxes();
+		void buildVisibility();
 		c8 buf[128];
 		f32 FramesPerSecond;
 	};
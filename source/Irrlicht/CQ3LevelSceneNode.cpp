@@ -0,0 +1,267 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+
+#include "CQ3LevelSceneNode.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IVideoDriver.h"
+#include "IMaterialRenderer.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CQ3LevelSceneNode::CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id)
+	: ISceneNode(parent, mgr, id), Mesh(static_cast<CQ3LevelMesh*>(mesh)), Stamp(0), CulledCamera(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CQ3LevelSceneNode");
+	#endif
+
+	Mesh->grab();
+
+	const IMesh* geometry = Mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY);
+	Box = geometry->getBoundingBox();
+
+	// the vertices stay, the indices change every frame
+	Buffers.reallocate(geometry->getMeshBufferCount());
+	for (u32 i=0; i<geometry->getMeshBufferCount(); ++i)
+	{
+		const SMeshBufferLightMap* source = static_cast<const SMeshBufferLightMap*>(geometry->getMeshBuffer(i));
+		SMeshBufferLightMap* buffer = new SMeshBufferLightMap();
+		buffer->Vertices = source->Vertices;
+		buffer->Indices.reallocate(source->Indices.size());
+		buffer->Material = source->Material;
+		buffer->BoundingBox = source->BoundingBox;
+		buffer->setHardwareMappingHint(EHM_STATIC, EBT_VERTEX);
+		buffer->setHardwareMappingHint(EHM_STREAM, EBT_INDEX);
+		Buffers.push_back(buffer);
+	}
+
+	FaceStamps.set_used(Mesh->getVisibility().FaceRanges.size());
+	for (u32 i=0; i<FaceStamps.size(); ++i)
+		FaceStamps[i] = 0;
+}
+
+
+//! destructor
+CQ3LevelSceneNode::~CQ3LevelSceneNode()
+{
+	for (u32 i=0; i<Buffers.size(); ++i)
+		Buffers[i]->drop();
+
+	Mesh->drop();
+}
+
+
+//! frame
+void CQ3LevelSceneNode::OnRegisterSceneNode()
+{
+	if (!IsVisible)
+		return;
+
+	// the faces are collected in render(), each view of drawAll has its own camera
+	CulledCamera = 0;
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	const IMesh* geometry = Mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY);
+
+	u32 transparentCount = 0;
+	u32 solidCount = 0;
+	for (u32 i=0; i<Buffers.size(); ++i)
+	{
+		if (!geometry->getMeshBuffer(i)->getIndexCount())
+			continue;
+
+		const video::SMaterial& material = Buffers[i]->Material;
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+		if ((rnd && rnd->isTransparent()) || material.isTransparent())
+			++transparentCount;
+		else
+			++solidCount;
+	}
+
+	if (solidCount)
+		SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+
+	if (transparentCount)
+		SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! Collects the indices of the faces visible from the active camera
+void CQ3LevelSceneNode::updateVisibleFaces()
+{
+	const CQ3LevelMesh::SBSPVisibility& visibility = Mesh->getVisibility();
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (CulledCamera && camera == CulledCamera)
+		return;
+
+	CulledCamera = camera;
+
+	// the camera in the space of the level
+	SViewFrustum frustum;
+	s32 cluster = -1;
+	if (camera)
+	{
+		frustum = *camera->getViewFrustum();
+		core::matrix4 inverse;
+		if (AbsoluteTransformation.getInverse(inverse))
+			frustum.transform(inverse);
+
+		const s32 leaf = visibility.findLeaf(frustum.cameraPosition);
+		if (leaf >= 0 && leaf < (s32)visibility.Leafs.size())
+			cluster = visibility.Leafs[leaf].Cluster;
+	}
+
+	if (++Stamp == 0)
+	{
+		for (u32 i=0; i<FaceStamps.size(); ++i)
+			FaceStamps[i] = 0;
+		Stamp = 1;
+	}
+
+	// faces of the leafs in visible clusters and in the frustum, each once
+	VisibleFaces.set_used(0);
+	for (u32 i=0; i<visibility.Leafs.size(); ++i)
+	{
+		const CQ3LevelMesh::SBSPVisibility::SLeaf& leaf = visibility.Leafs[i];
+		if (!leaf.FaceCount || !visibility.isClusterVisible(cluster, leaf.Cluster))
+			continue;
+
+		if (camera && isOutside(leaf.Box, frustum))
+			continue;
+
+		for (s32 f=leaf.FirstFace; f<leaf.FirstFace+leaf.FaceCount; ++f)
+		{
+			const s32 face = visibility.LeafFaces[f];
+			if (face < 0 || face >= (s32)FaceStamps.size() || FaceStamps[face] == Stamp)
+				continue;
+
+			FaceStamps[face] = Stamp;
+			if (visibility.FaceRanges[face].Buffer >= 0)
+				VisibleFaces.push_back(face);
+		}
+	}
+
+	// keep the order of the faces in the level
+	VisibleFaces.sort();
+
+	for (u32 i=0; i<Buffers.size(); ++i)
+		Buffers[i]->Indices.set_used(0);
+
+	const IMesh* geometry = Mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY);
+	for (u32 i=0; i<VisibleFaces.size(); ++i)
+	{
+		const CQ3LevelMesh::SBSPVisibility::SFaceRange& range = visibility.FaceRanges[VisibleFaces[i]];
+		if (range.Buffer >= (s32)Buffers.size())
+			continue;
+
+		const u16* indices = geometry->getMeshBuffer(range.Buffer)->getIndices() + range.FirstIndex;
+		core::array<u16>& target = Buffers[range.Buffer]->Indices;
+		for (u32 j=0; j<range.IndexCount; ++j)
+			target.push_back(indices[j]);
+	}
+
+	for (u32 i=0; i<Buffers.size(); ++i)
+		Buffers[i]->setDirty(EBT_INDEX);
+}
+
+
+//! Check if a box in node space is outside the frustum
+bool CQ3LevelSceneNode::isOutside(const core::aabbox3df& box, const SViewFrustum& frustum)
+{
+	for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+	{
+		if (box.classifyPlaneRelation(frustum.planes[i]) == core::ISREL3D_FRONT)
+			return true;
+	}
+	return false;
+}
+
+
+//! renders the node.
+void CQ3LevelSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (!driver)
+		return;
+
+	updateVisibleFaces();
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == ESNRP_TRANSPARENT;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	for (u32 i=0; i<Buffers.size(); ++i)
+	{
+		SMeshBufferLightMap* mb = Buffers[i];
+		if (mb->Indices.empty())
+			continue;
+
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(mb->Material.MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent()) || mb->Material.isTransparent();
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(mb->Material);
+			driver->drawMeshBuffer(mb);
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible & EDS_BBOX)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		driver->draw3DBox(Box, video::SColor(255,255,255,255));
+	}
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CQ3LevelSceneNode::getMaterial(u32 i)
+{
+	if (i >= Buffers.size())
+		return ISceneNode::getMaterial(i);
+
+	return Buffers[i]->Material;
+}
+
+
+//! Creates a clone of this scene node and its children.
+ISceneNode* CQ3LevelSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
+{
+	if (!newParent)
+		newParent = Parent;
+	if (!newManager)
+		newManager = SceneManager;
+
+	CQ3LevelSceneNode* nb = new CQ3LevelSceneNode(Mesh, newParent, newManager, ID);
+
+	nb->cloneMembers(this, newManager);
+	for (u32 i=0; i<Buffers.size(); ++i)
+		nb->Buffers[i]->Material = Buffers[i]->Material;
+
+	if ( newParent )
+		nb->drop();
+	return nb;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BSP_LOADER_
+
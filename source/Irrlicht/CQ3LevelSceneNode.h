@@ -0,0 +1,76 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+#define __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "CQ3LevelMesh.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	class ICameraSceneNode;
+
+	//! Draws the geometry of a quake3 level, only the faces potentially visible from the camera.
+	class CQ3LevelSceneNode : public ISceneNode
+	{
+	public:
+
+		//! constructor
+		CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id);
+
+		//! destructor
+		virtual ~CQ3LevelSceneNode();
+
+		//! frame
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box of the level
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_ { return Box; }
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_ { return Buffers.size(); }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_Q3LEVEL_SCENE_NODE; }
+
+		//! Creates a clone of this scene node and its children.
+		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0) _IRR_OVERRIDE_;
+
+	private:
+
+		//! Collects the indices of the faces visible from the active camera
+		/** Only done once for each camera after the node was registered. */
+		void updateVisibleFaces();
+
+		//! Check if a box in node space is outside the frustum
+		static bool isOutside(const core::aabbox3df& box, const SViewFrustum& frustum);
+
+		CQ3LevelMesh* Mesh;
+		//! Copies of the geometry buffers with the indices of the visible faces
+		core::array<SMeshBufferLightMap*> Buffers;
+		core::aabbox3d<f32> Box;
+
+		//! Faces added in this frame have the current stamp
+		core::array<u32> FaceStamps;
+		u32 Stamp;
+		core::array<s32> VisibleFaces;
+		//! camera of the collected faces, 0 if they have to be collected again
+		const ICameraSceneNode* CulledCamera;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -44,7 +44,7 @@ CQuake3ShaderSceneNode::CQuake3ShaderSceneNode(
 	#endif
 
 	// name the Scene Node
-	this->Name = Shader->name;
+	setName(Shader->name);
 
 	// take lightmap vertex type
 	MeshBuffer = new SMeshBuffer();
@@ -0,0 +1,174 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CRenderQueue.h"
+#include <string.h>
+
+namespace irr
+{
+namespace scene
+{
+
+//! Below this size an insertion sort is faster than clearing the histograms
+static const u32 RADIX_SORT_THRESHOLD = 64;
+
+static inline u64 getPassBits(E_SCENE_NODE_RENDER_PASS pass)
+{
+	switch (pass)
+	{
+	case ESNRP_SOLID:
+	case ESNRP_AUTOMATIC:
+		return 0;
+	case ESNRP_TRANSPARENT:
+		return 1;
+	case ESNRP_TRANSPARENT_EFFECT:
+		return 2;
+	default:
+		return 3;
+	}
+}
+
+//! Bit pattern of a positive float, ordered like the float itself
+static inline u32 getDistanceBits(f32 distanceSQ)
+{
+	if (!(distanceSQ > 0.f))
+		return 0;
+	return core::IR(distanceSQ);
+}
+
+//! Folds the pointers of all textures of the material into a few bits.
+/** Only equal sets have to end up next to each other, so collisions just
+cost some texture changes. */
+static inline u32 getTextureSetBits(const video::SMaterial& material, u32 bits)
+{
+	u32 hash = 0;
+	for (u32 i=0; i<video::MATERIAL_MAX_TEXTURES; ++i)
+	{
+		const size_t p = (size_t)material.getTexture(i);
+		hash = hash * 31 + (u32)(p >> 4) + (u32)((u64)p >> 32);
+	}
+	hash ^= hash >> bits;
+	return hash & ((1u << bits) - 1);
+}
+
+//! Render states which are usually changed together with the material.
+static inline u32 getStateBits(const video::SMaterial& material)
+{
+	return (material.ZBuffer ? 1 : 0) |
+		(material.ZWriteEnable ? 2 : 0) |
+		(material.BackfaceCulling ? 4 : 0) |
+		(material.FrontfaceCulling ? 8 : 0) |
+		(material.Lighting ? 16 : 0) |
+		(material.FogEnable ? 32 : 0) |
+		(material.GouraudShading ? 64 : 0) |
+		(material.NormalizeNormals ? 128 : 0) |
+		(material.Wireframe ? 256 : 0) |
+		(material.PointCloud ? 512 : 0);
+}
+
+
+u64 CRenderQueue::makeSolidKey(E_SCENE_NODE_RENDER_PASS pass, const video::SMaterial& material, f32 distanceSQ)
+{
+	const u64 type = core::min_((u32)material.MaterialType, 0xfffu);
+
+	return (getPassBits(pass) << 62) |
+		(type << 50) |
+		((u64)getTextureSetBits(material, 24) << 26) |
+		((u64)getStateBits(material) << 16) |
+		// sign, exponent and the top of the mantissa, still monotonic
+		(u64)(getDistanceBits(distanceSQ) >> 16);
+}
+
+
+u64 CRenderQueue::makeTransparentKey(E_SCENE_NODE_RENDER_PASS pass, const video::SMaterial& material, f32 distanceSQ)
+{
+	const u64 type = core::min_((u32)material.MaterialType, 0xffu);
+
+	return (getPassBits(pass) << 62) |
+		((u64)(~getDistanceBits(distanceSQ)) << 30) |
+		(type << 22) |
+		(u64)getTextureSetBits(material, 22);
+}
+
+
+u32 CRenderQueue::countMaterialChanges(bool transparent) const
+{
+	// type, textures and states of solid keys, type and textures of transparent ones
+	const u64 mask = transparent ? 0x3fffffffULL : 0x3fffffffffff0000ULL;
+
+	u32 changes = 0;
+	u64 last = 0;
+	for (u32 i=0; i<Entries.size(); ++i)
+	{
+		const u64 material = Entries[i].Key & mask;
+		if (i == 0 || material != last)
+			++changes;
+		last = material;
+	}
+	return changes;
+}
+
+
+void CRenderQueue::sort()
+{
+	const u32 count = Entries.size();
+
+	if (count < RADIX_SORT_THRESHOLD)
+	{
+		// stable, like the radix sort
+		for (u32 i=1; i<count; ++i)
+		{
+			const SEntry e = Entries[i];
+			u32 j = i;
+			for (; j>0 && Entries[j-1].Key > e.Key; --j)
+				Entries[j] = Entries[j-1];
+			Entries[j] = e;
+		}
+		return;
+	}
+
+	// one histogram per byte of the key, all gathered in one pass
+	u32 histogram[8][256];
+	memset(histogram, 0, sizeof(histogram));
+
+	for (u32 i=0; i<count; ++i)
+	{
+		u64 key = Entries[i].Key;
+		for (u32 b=0; b<8; ++b)
+		{
+			++histogram[b][key & 0xff];
+			key >>= 8;
+		}
+	}
+
+	Scratch.set_used(count);
+
+	for (u32 b=0; b<8; ++b)
+	{
+		u32* h = histogram[b];
+		const u32 shift = b * 8;
+
+		// all keys share this byte, nothing to do
+		if (h[(Entries[0].Key >> shift) & 0xff] == count)
+			continue;
+
+		u32 offset = 0;
+		for (u32 i=0; i<256; ++i)
+		{
+			const u32 c = h[i];
+			h[i] = offset;
+			offset += c;
+		}
+
+		const SEntry* src = Entries.const_pointer();
+		SEntry* dst = Scratch.pointer();
+		for (u32 i=0; i<count; ++i)
+			dst[h[(src[i].Key >> shift) & 0xff]++] = src[i];
+
+		Entries.swap(Scratch);
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,101 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_RENDER_QUEUE_H_INCLUDED__
+#define __C_RENDER_QUEUE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "ISceneManager.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! List of scene nodes registered for one render pass, ordered by 64 bit keys.
+	/** The keys pack everything the order depends on, so sorting is a radix
+	sort over plain integers instead of a comparison sort calling into the
+	nodes. Nodes with equal keys keep the order in which they were added.
+
+	Key layout for solid nodes, from the most significant bit:
+	render pass (2 bits), material type (12), texture set (24),
+	render states (10), depth front to back (16).
+	This groups nodes by material renderer and shader first, then by the
+	textures, and draws the nearest ones of each group first.
+
+	Key layout for transparent nodes:
+	render pass (2 bits), depth back to front (32), material type (8),
+	texture set (22).
+	Depth has to come first here, material and textures only order nodes
+	at the same distance. */
+	class CRenderQueue
+	{
+	public:
+
+		//! Removes all nodes, but keeps the memory.
+		void clear()
+		{
+			Entries.set_used(0);
+		}
+
+		//! Adds a node with its sort key.
+		void push_back(ISceneNode* node, u64 key)
+		{
+			SEntry e;
+			e.Key = key;
+			e.Node = node;
+			Entries.push_back(e);
+		}
+
+		//! Sorts the nodes by ascending keys.
+		void sort();
+
+		//! Counts how often the material changes from one node to the next.
+		/** Only the parts of the keys made from the material are compared,
+		the first node counts as a change.
+		\param transparent True for keys made by makeTransparentKey(). */
+		u32 countMaterialChanges(bool transparent) const;
+
+		u32 size() const
+		{
+			return Entries.size();
+		}
+
+		ISceneNode* getNode(u32 index) const
+		{
+			return Entries[index].Node;
+		}
+
+		u64 getKey(u32 index) const
+		{
+			return Entries[index].Key;
+		}
+
+		//! Key for a node which is drawn in the solid pass.
+		/** \param pass Render pass the node is registered for.
+		\param material Material which decides the render states of the node.
+		\param distanceSQ Squared distance of the node to the camera. */
+		static u64 makeSolidKey(E_SCENE_NODE_RENDER_PASS pass, const video::SMaterial& material, f32 distanceSQ);
+
+		//! Key for a node which is drawn in one of the transparent passes.
+		static u64 makeTransparentKey(E_SCENE_NODE_RENDER_PASS pass, const video::SMaterial& material, f32 distanceSQ);
+
+	private:
+
+		struct SEntry
+		{
+			u64 Key;
+			ISceneNode* Node;
+		};
+
+		core::array<SEntry> Entries;
+		//! Second buffer for the radix sort passes
+		core::array<SEntry> Scratch;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,578 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSceneLoaderIrrb.h"
+#include "ISceneNodeAnimatorFactory.h"
+#include "ISceneUserDataSerializer.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "CMemoryFile.h"
+#include "os.h"
+
+#if defined(_IRR_WINDOWS_API_)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define _IRR_IRRB_MMAP_
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+//! Read only view of the whole content of a file
+/** Files on disk are mapped into memory, the buffer of memory files is used
+directly. Other files are read into a buffer. */
+class CFileView
+{
+public:
+
+	CFileView() : Data(0), Size(0)
+#if defined(_IRR_WINDOWS_API_)
+		, File(INVALID_HANDLE_VALUE), Mapping(0)
+#endif
+	{
+	}
+
+	~CFileView()
+	{
+#if defined(_IRR_WINDOWS_API_)
+		if (Mapping)
+		{
+			UnmapViewOfFile(Data);
+			CloseHandle(Mapping);
+		}
+		if (File != INVALID_HANDLE_VALUE)
+			CloseHandle(File);
+#elif defined(_IRR_IRRB_MMAP_)
+		if (Mapped)
+			munmap((void*)Data, Size);
+#endif
+	}
+
+	bool open(io::IReadFile* file)
+	{
+		const long size = file->getSize();
+		if (size <= 0)
+			return false;
+		Size = (u32)size;
+
+		if (file->getType() == io::EFIT_MEMORY)
+		{
+			Data = (const u8*)static_cast<io::CMemoryReadFile*>(file)->getBuffer();
+			return true;
+		}
+
+		if (file->getType() == io::EFIT_READ && map(file->getFileName()))
+			return true;
+
+		Copy.set_used(Size);
+		file->seek(0);
+		if (file->read(Copy.pointer(), Size) != Size)
+			return false;
+		Data = Copy.const_pointer();
+		return true;
+	}
+
+	const u8* Data;
+	u32 Size;
+
+private:
+
+	//! Maps the file on disk, which has to be of Size
+	bool map(const io::path& filename)
+	{
+#if defined(_IRR_WINDOWS_API_)
+#if defined(_IRR_WCHAR_FILESYSTEM)
+		File = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#else
+		File = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#endif
+		if (File == INVALID_HANDLE_VALUE || GetFileSize(File, 0) != Size)
+			return false;
+		Mapping = CreateFileMapping(File, 0, PAGE_READONLY, 0, 0, 0);
+		if (!Mapping)
+			return false;
+		Data = (const u8*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!Data)
+		{
+			CloseHandle(Mapping);
+			Mapping = 0;
+			return false;
+		}
+		return true;
+#elif defined(_IRR_IRRB_MMAP_)
+		Mapped = false;
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat status;
+		if (fstat(fd, &status) == 0 && status.st_size == (off_t)Size)
+		{
+			void* data = mmap(0, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED)
+			{
+				Data = (const u8*)data;
+				Mapped = true;
+			}
+		}
+		close(fd);
+		return Mapped;
+#else
+		return false;
+#endif
+	}
+
+	core::array<u8> Copy;
+#if defined(_IRR_WINDOWS_API_)
+	HANDLE File;
+	HANDLE Mapping;
+#elif defined(_IRR_IRRB_MMAP_)
+	bool Mapped;
+#endif
+};
+
+} // end anonymous namespace
+
+
+//! Constructor
+CSceneLoaderIrrb::CSceneLoaderIrrb(ISceneManager *smgr, io::IFileSystem* fs)
+ : SceneManager(smgr), FileSystem(fs), Attributes(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CSceneLoaderIrrb");
+	#endif
+}
+
+
+//! Destructor
+CSceneLoaderIrrb::~CSceneLoaderIrrb()
+{
+}
+
+
+//! Returns true if the class might be able to load this file.
+bool CSceneLoaderIrrb::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "irrb");
+}
+
+
+//! Returns true if the class might be able to load this file.
+bool CSceneLoaderIrrb::isALoadableFileFormat(io::IReadFile *file) const
+{
+	if (!file)
+		return false;
+
+	const long pos = file->getPos();
+	u32 header[2] = { 0, 0 };
+	const bool read = file->read(header, sizeof(header)) == sizeof(header);
+	file->seek(pos);
+
+#ifdef __BIG_ENDIAN__
+	header[0] = os::Byteswap::byteswap(header[0]);
+	header[1] = os::Byteswap::byteswap(header[1]);
+#endif
+	return read && header[0] == IRRB_MAGIC && header[1] <= IRRB_VERSION;
+}
+
+
+//! Loads the scene into the scene manager.
+bool CSceneLoaderIrrb::loadScene(io::IReadFile* file, ISceneUserDataSerializer* userDataSerializer,
+	ISceneNode* rootNode)
+{
+	if (!file)
+	{
+		os::Printer::log("Unable to open scene file", ELL_ERROR);
+		return false;
+	}
+
+	CFileView view;
+	if (!view.open(file))
+	{
+		os::Printer::log("Could not read scene file", file->getFileName().c_str(), ELL_ERROR);
+		return false;
+	}
+
+	SReader reader;
+	reader.Pos = view.Data;
+	reader.End = view.Data + view.Size;
+
+	u32 magic = 0;
+	u32 version = 0;
+	u32 id = 0;
+	SReader scene;
+	if (!reader.readU32(magic) || magic != IRRB_MAGIC || !reader.readU32(version) ||
+		version > IRRB_VERSION || !reader.readBlock(id, scene) || id != IRRB_SCENE)
+	{
+		os::Printer::log("Scene is not a valid irrb file", file->getFileName().c_str(), ELL_ERROR);
+		return false;
+	}
+
+	// meshes of the nodes are loaded as meshes, not as scenes of their own
+	bool oldColladaSingleMesh = SceneManager->getParameters()->getAttributeAsBool(COLLADA_CREATE_SCENE_INSTANCES);
+	SceneManager->getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, false);
+
+	Attributes = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+
+	const bool result = readNode(scene, rootNode ? rootNode : SceneManager->getRootSceneNode(), userDataSerializer);
+	if (!result)
+		os::Printer::log("Scene file is damaged", file->getFileName().c_str(), ELL_ERROR);
+
+	Attributes->drop();
+	Attributes = 0;
+	WideString.clear();
+
+	// restore old collada parameters
+	SceneManager->getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, oldColladaSingleMesh);
+
+	return result;
+}
+
+
+//! Reads the blocks of a node
+bool CSceneLoaderIrrb::readNode(SReader& reader, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer)
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	while (reader.Pos < reader.End)
+	{
+		u32 id;
+		SReader block;
+		if (!reader.readBlock(id, block))
+			return false;
+
+		switch (id)
+		{
+		case IRRB_ATTRIBUTES:
+			if (!readAttributes(block))
+				return false;
+			if (node)
+				node->deserializeAttributes(Attributes);
+			break;
+
+		case IRRB_MATERIALS:
+			for (u32 nr=0; block.Pos < block.End; ++nr)
+			{
+				SReader material;
+				if (!block.readBlock(id, material) || id != IRRB_ATTRIBUTES || !readAttributes(material))
+					return false;
+
+				if (node && driver && node->getMaterialCount() > nr)
+					driver->fillMaterialStructureFromAttributes(node->getMaterial(nr), Attributes);
+			}
+			break;
+
+		case IRRB_ANIMATORS:
+			while (block.Pos < block.End)
+			{
+				SReader animator;
+				if (!block.readBlock(id, animator) || id != IRRB_ATTRIBUTES || !readAttributes(animator))
+					return false;
+
+				if (node)
+				{
+					ISceneNodeAnimator* anim = SceneManager->createSceneNodeAnimator(
+						Attributes->getAttributeAsString("Type").c_str(), node);
+					if (anim)
+					{
+						anim->deserializeAttributes(Attributes);
+						anim->drop();
+					}
+				}
+			}
+			break;
+
+		case IRRB_USERDATA:
+			{
+				SReader userData;
+				if (!block.readBlock(id, userData) || id != IRRB_ATTRIBUTES || !readAttributes(userData))
+					return false;
+
+				if (node && userDataSerializer)
+					userDataSerializer->OnReadUserData(node, Attributes);
+			}
+			break;
+
+		case IRRB_NODE:
+			{
+				const c8* typeName;
+				u32 length;
+				if (!block.readString(typeName, length))
+					return false;
+
+				ISceneNode* child = 0;
+				if (node)
+				{
+					child = SceneManager->addSceneNode(typeName, node);
+					if (!child)
+						os::Printer::log("Could not create scene node of unknown type", typeName);
+				}
+
+				if (!readNode(block, child, userDataSerializer))
+					return false;
+			}
+			break;
+
+		default:
+			// skip blocks of later versions
+			break;
+		}
+	}
+
+	if (node && userDataSerializer)
+		userDataSerializer->OnCreateNode(node);
+
+	return true;
+}
+
+
+//! Reads an IRRB_ATTRIBUTES block into Attributes
+bool CSceneLoaderIrrb::readAttributes(SReader& reader)
+{
+	Attributes->clear();
+
+	u32 count;
+	if (!reader.readU32(count))
+		return false;
+
+	f32 f[16];
+	for (u32 i=0; i<count; ++i)
+	{
+		u32 type;
+		const c8* name;
+		u32 length;
+		if (!reader.readU32(type) || !reader.readString(name, length))
+			return false;
+
+		bool valid = true;
+		switch (type)
+		{
+		case io::EAT_INT:
+		case io::EAT_BOOL:
+		case io::EAT_COLOR:
+			{
+				u32 value;
+				valid = reader.readU32(value);
+				if (type == io::EAT_INT)
+					Attributes->addInt(name, (s32)value);
+				else if (type == io::EAT_BOOL)
+					Attributes->addBool(name, value != 0);
+				else
+					Attributes->addColor(name, video::SColor(value));
+			}
+			break;
+		case io::EAT_FLOAT:
+			valid = reader.readF32(f, 1);
+			Attributes->addFloat(name, f[0]);
+			break;
+		case io::EAT_STRING:
+		case io::EAT_ENUM:
+		case io::EAT_TEXTURE:
+		case io::EAT_BINARY:
+			{
+				const c8* value;
+				valid = reader.readString(value, length);
+				if (!valid)
+					break;
+
+				if (type == io::EAT_ENUM)
+					Attributes->addEnum(name, value, 0);
+				else if (type == io::EAT_TEXTURE)
+				{
+					video::IVideoDriver* driver = SceneManager->getVideoDriver();
+					Attributes->addTexture(name, (driver && *value) ? driver->getTexture(value) : 0, value);
+				}
+				else if (type == io::EAT_BINARY)
+				{
+					Attributes->addBinary(name, 0, 0);
+					Attributes->setAttribute((s32)Attributes->getAttributeCount()-1, value);
+				}
+				else
+				{
+					// strings in .irr files are wide, but ascii strings don't need a conversion
+					u32 c = 0;
+					while (c < length && !(value[c] & 0x80))
+						++c;
+
+					if (c == length)
+						Attributes->addString(name, value);
+					else
+					{
+						WideString.set_used(length + 1);
+						core::utf8ToWchar(value, WideString.pointer(), WideString.size() * sizeof(wchar_t));
+						Attributes->addString(name, WideString.const_pointer());
+					}
+				}
+			}
+			break;
+		case io::EAT_COLORF:
+			valid = reader.readF32(f, 4);
+			Attributes->addColorf(name, video::SColorf(f[0], f[1], f[2], f[3]));
+			break;
+		case io::EAT_VECTOR3D:
+			valid = reader.readF32(f, 3);
+			Attributes->addVector3d(name, core::vector3df(f[0], f[1], f[2]));
+			break;
+		case io::EAT_VECTOR2D:
+			valid = reader.readF32(f, 2);
+			Attributes->addVector2d(name, core::vector2df(f[0], f[1]));
+			break;
+		case io::EAT_POSITION2D:
+		case io::EAT_RECT:
+		case io::EAT_DIMENSION2D:
+			{
+				u32 v[4] = { 0, 0, 0, 0 };
+				const u32 size = (type == io::EAT_RECT) ? 4 : 2;
+				for (u32 j=0; j<size && valid; ++j)
+					valid = reader.readU32(v[j]);
+
+				if (type == io::EAT_POSITION2D)
+					Attributes->addPosition2d(name, core::position2di((s32)v[0], (s32)v[1]));
+				else if (type == io::EAT_RECT)
+					Attributes->addRect(name, core::rect<s32>((s32)v[0], (s32)v[1], (s32)v[2], (s32)v[3]));
+				else
+					Attributes->addDimension2d(name, core::dimension2du(v[0], v[1]));
+			}
+			break;
+		case io::EAT_MATRIX:
+			{
+				valid = reader.readF32(f, 16);
+				core::matrix4 m(core::matrix4::EM4CONST_NOTHING);
+				m.setM(f);
+				Attributes->addMatrix(name, m);
+			}
+			break;
+		case io::EAT_QUATERNION:
+			valid = reader.readF32(f, 4);
+			Attributes->addQuaternion(name, core::quaternion(f[0], f[1], f[2], f[3]));
+			break;
+		case io::EAT_BBOX:
+			valid = reader.readF32(f, 6);
+			Attributes->addBox3d(name, core::aabbox3df(f[0], f[1], f[2], f[3], f[4], f[5]));
+			break;
+		case io::EAT_PLANE:
+			valid = reader.readF32(f, 4);
+			Attributes->addPlane3d(name, core::plane3df(core::vector3df(f[0], f[1], f[2]), f[3]));
+			break;
+		case io::EAT_TRIANGLE3D:
+			valid = reader.readF32(f, 9);
+			Attributes->addTriangle3d(name, core::triangle3df(core::vector3df(f[0], f[1], f[2]),
+				core::vector3df(f[3], f[4], f[5]), core::vector3df(f[6], f[7], f[8])));
+			break;
+		case io::EAT_LINE2D:
+			valid = reader.readF32(f, 4);
+			Attributes->addLine2d(name, core::line2df(f[0], f[1], f[2], f[3]));
+			break;
+		case io::EAT_LINE3D:
+			valid = reader.readF32(f, 6);
+			Attributes->addLine3d(name, core::line3df(f[0], f[1], f[2], f[3], f[4], f[5]));
+			break;
+		case io::EAT_STRINGWARRAY:
+			{
+				u32 size = 0;
+				valid = reader.readU32(size);
+				core::array<core::stringw> strings;
+				for (u32 j=0; j<size && valid; ++j)
+				{
+					const c8* value;
+					valid = reader.readString(value, length);
+					if (valid)
+					{
+						WideString.set_used(length + 1);
+						core::utf8ToWchar(value, WideString.pointer(), WideString.size() * sizeof(wchar_t));
+						strings.push_back(WideString.const_pointer());
+					}
+				}
+				Attributes->addArray(name, strings);
+			}
+			break;
+		default:
+			// the writer doesn't know other types
+			valid = false;
+			break;
+		}
+
+		if (!valid)
+			return false;
+	}
+
+	return true;
+}
+
+
+bool CSceneLoaderIrrb::SReader::readU32(u32& value)
+{
+	if (End - Pos < 4)
+		return false;
+
+	memcpy(&value, Pos, 4);
+#ifdef __BIG_ENDIAN__
+	value = os::Byteswap::byteswap(value);
+#endif
+	Pos += 4;
+	return true;
+}
+
+
+bool CSceneLoaderIrrb::SReader::readF32(f32* values, u32 count)
+{
+	if ((u32)(End - Pos) < count * 4)
+		return false;
+
+	memcpy(values, Pos, count * 4);
+#ifdef __BIG_ENDIAN__
+	for (u32 i=0; i<count; ++i)
+		values[i] = os::Byteswap::byteswap(values[i]);
+#endif
+	Pos += count * 4;
+	return true;
+}
+
+
+//! Strings are used in place, they are terminated by 0 and padded to 4 bytes
+bool CSceneLoaderIrrb::SReader::readString(const c8*& string, u32& length)
+{
+	if (!readU32(length))
+		return false;
+
+	// the terminating 0 must be inside the data, this also keeps the padding from wrapping around
+	if (length >= (u32)(End - Pos))
+		return false;
+
+	const u32 size = (length + 4) & ~3;
+	if ((u32)(End - Pos) < size || Pos[length] != 0)
+		return false;
+
+	string = (const c8*)Pos;
+	Pos += size;
+	return true;
+}
+
+
+bool CSceneLoaderIrrb::SReader::readBlock(u32& id, SReader& content)
+{
+	u32 size;
+	if (!readU32(id) || !readU32(size) || (u32)(End - Pos) < size || (size & 3))
+		return false;
+
+	content.Pos = Pos;
+	content.End = Pos + size;
+	Pos += size;
+	return true;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,115 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_LOADER_IRRB_H_INCLUDED__
+#define __C_SCENE_LOADER_IRRB_H_INCLUDED__
+
+#include "ISceneLoader.h"
+#include "IAttributes.h"
+
+namespace irr
+{
+
+namespace io
+{
+	class IFileSystem;
+}
+
+namespace scene
+{
+
+class ISceneManager;
+
+//! Binary scene format, the same content as .irr files.
+/** All values are little endian and every item starts at a multiple of 4
+bytes. The file starts with IRRB_MAGIC and IRRB_VERSION, followed by one
+IRRB_SCENE block. A block is its id, the size of its content in bytes and the
+content. Loaders skip blocks with unknown ids.
+
+- IRRB_SCENE: blocks of the root node.
+- IRRB_NODE: the type name of the node as string, then its blocks.
+- IRRB_ATTRIBUTES: attributes of the node.
+- IRRB_MATERIALS: one IRRB_ATTRIBUTES block per material.
+- IRRB_ANIMATORS: one IRRB_ATTRIBUTES block per animator, with its "Type".
+- IRRB_USERDATA: the IRRB_ATTRIBUTES block of the ISceneUserDataSerializer.
+
+Attributes are their count followed by type (io::E_ATTRIBUTE_TYPE), name
+and value of each attribute. A string is its length in bytes, the utf-8
+characters and a terminating 0. Numbers are written as 32 bit ints or
+floats, bools as ints, colors as their 32 bit value and compound types as
+their members in declaration order. Enums, textures and binary data are
+strings like in .irr files, string arrays are the count and the strings.
+*/
+enum E_IRRB_ID
+{
+	IRRB_MAGIC = MAKE_IRR_ID('i','r','r','b'),
+	IRRB_SCENE = MAKE_IRR_ID('s','c','n','e'),
+	IRRB_NODE = MAKE_IRR_ID('n','o','d','e'),
+	IRRB_ATTRIBUTES = MAKE_IRR_ID('a','t','t','r'),
+	IRRB_MATERIALS = MAKE_IRR_ID('m','t','r','l'),
+	IRRB_ANIMATORS = MAKE_IRR_ID('a','n','i','m'),
+	IRRB_USERDATA = MAKE_IRR_ID('u','s','e','r')
+};
+
+//! Version of the binary scene format written by the engine
+const u32 IRRB_VERSION = 1;
+
+
+//! Class which can load a binary .irrb scene into the scene manager.
+/** Files on disk are mapped into memory and files in memory are read
+in place where possible. Numbers are taken directly from the file without
+converting them from text. */
+class CSceneLoaderIrrb : public virtual ISceneLoader
+{
+public:
+
+	//! Constructor
+	CSceneLoaderIrrb(ISceneManager *smgr, io::IFileSystem* fs);
+
+	//! Destructor
+	virtual ~CSceneLoaderIrrb();
+
+	//! Returns true if the class might be able to load this file.
+	virtual bool isALoadableFileExtension(const io::path& filename) const _IRR_OVERRIDE_;
+
+	//! Returns true if the class might be able to load this file.
+	virtual bool isALoadableFileFormat(io::IReadFile *file) const _IRR_OVERRIDE_;
+
+	//! Loads the scene into the scene manager.
+	virtual bool loadScene(io::IReadFile* file,
+		ISceneUserDataSerializer* userDataSerializer=0,
+		ISceneNode* rootNode=0) _IRR_OVERRIDE_;
+
+private:
+
+	//! Reads from the data of a block
+	struct SReader
+	{
+		const u8* Pos;
+		const u8* End;
+
+		bool readU32(u32& value);
+		bool readF32(f32* values, u32 count);
+		bool readString(const c8*& string, u32& length);
+		bool readBlock(u32& id, SReader& content);
+	};
+
+	//! Reads the blocks of a node
+	bool readNode(SReader& reader, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer);
+
+	//! Reads an IRRB_ATTRIBUTES block into Attributes
+	bool readAttributes(SReader& reader);
+
+	ISceneManager* SceneManager;
+	io::IFileSystem* FileSystem;
+	io::IAttributes* Attributes;
+	//! Conversion buffer for strings which are not ascii
+	core::array<wchar_t> WideString;
+};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
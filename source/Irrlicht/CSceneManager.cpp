@@ -17,6 +17,7 @@
 #include "ISceneLoader.h"
 #include "EProfileIDs.h"
 #include "IProfiler.h"
+#include "IJobSystem.h"
 
 #include "os.h"
 
@@ -114,6 +115,10 @@
 #include "CSceneLoaderIrr.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRRB_SCENE_LOADER_
+#include "CSceneLoaderIrrb.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_COLLADA_WRITER_
 #include "CColladaMeshWriter.h"
 #endif
@@ -146,6 +151,8 @@
 #include "CLightSceneNode.h"
 #include "CBillboardSceneNode.h"
 #include "CMeshSceneNode.h"
+#include "CInstancedMeshSceneNode.h"
+#include "CLODSceneNode.h"
 #include "CSkyBoxSceneNode.h"
 #include "CSkyDomeSceneNode.h"
 
@@ -159,6 +166,7 @@
 #include "CEmptySceneNode.h"
 #include "CTextSceneNode.h"
 #include "CQuake3ShaderSceneNode.h"
+#include "CQ3LevelSceneNode.h"
 #include "CVolumeLightSceneNode.h"
 
 #include "CDefaultSceneNodeFactory.h"
@@ -182,6 +190,7 @@
 #include "CDefaultSceneNodeAnimatorFactory.h"
 
 #include "CGeometryCreator.h"
+#include "CSceneWriterIrrb.h"
 
 #include <locale.h>
 
@@ -198,7 +207,11 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	CursorControl(cursorControl), CollisionManager(0),
 	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0), Parameters(0),
 	MeshCache(cache), CurrentRenderPass(ESNRP_NONE), LightManager(0),
-	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
+	LightCulling(0), UseLightCulling(false),
+	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type"),
+	UseCullingHierarchy(false), CullingHierarchyInside(false), RecordRegisteredNodes(false),
+	JobSystem(0), UseParallelAnimation(false), AnimationTime(0),
+	AnimationTimeStep(0), AnimationStepTime(0), AnimationUpdateTime(0), AnimationStarted(false)
 {
 	#ifdef _DEBUG
 	ISceneManager::setDebugName("CSceneManager ISceneManager");
@@ -208,6 +221,8 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	// root node's scene manager
 	SceneManager = this;
 
+	LightCulling = new CLightCullingManager(this);
+
 	if (Driver)
 		Driver->grab();
 
@@ -311,6 +326,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	#ifdef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 	SceneLoaderList.push_back(new CSceneLoaderIrr(this, FileSystem));
 	#endif
+	#ifdef _IRR_COMPILE_WITH_IRRB_SCENE_LOADER_
+	SceneLoaderList.push_back(new CSceneLoaderIrrb(this, FileSystem));
+	#endif
 
 	// factories
 	ISceneNodeFactory* factory = new CDefaultSceneNodeFactory(this);
@@ -393,9 +411,16 @@ CSceneManager::~CSceneManager()
 	if (LightManager)
 		LightManager->drop();
 
+	LightCulling->drop();
+
+	if (JobSystem)
+		JobSystem->drop();
+
 	// remove all nodes and animators before dropping the driver
 	// as render targets may be destroyed twice
 
+	TransformInterpolator.clear();
+	NodeIndex.clear();
 	removeAll();
 	removeAnimators();
 
@@ -564,6 +589,27 @@ IMeshSceneNode* CSceneManager::addQuake3SceneNode(const IMeshBuffer* meshBuffer,
 }
 
 
+//! Adds a scene node drawing the geometry of a quake3 level with its potentially visible sets.
+ISceneNode* CSceneManager::addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+					ISceneNode* parent, s32 id)
+{
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+	if (!mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	CQ3LevelSceneNode* node = new CQ3LevelSceneNode(mesh, parent, this, id);
+	node->drop();
+
+	return node;
+#else
+	return 0;
+#endif
+}
+
+
 //! adds Volume Lighting Scene Node.
 //! the returned pointer must not be dropped.
 IVolumeLightSceneNode* CSceneManager::addVolumeLightSceneNode(
@@ -632,6 +678,39 @@ IMeshSceneNode* CSceneManager::addMeshSceneNode(IMesh* mesh, ISceneNode* parent,
 }
 
 
+//! Adds a scene node for drawing a static mesh at many transformations.
+IInstancedMeshSceneNode* CSceneManager::addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, s32 id,
+	const core::vector3df& position, const core::vector3df& rotation,
+	const core::vector3df& scale)
+{
+	if (!mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	IInstancedMeshSceneNode* node = new CInstancedMeshSceneNode(mesh, parent, this, id, position, rotation, scale);
+	node->drop();
+
+	return node;
+}
+
+
+//! Adds a scene node switching between meshes of different detail by its size on screen.
+ILODSceneNode* CSceneManager::addLODSceneNode(ISceneNode* parent, s32 id,
+	const core::vector3df& position, const core::vector3df& rotation,
+	const core::vector3df& scale)
+{
+	if (!parent)
+		parent = this;
+
+	ILODSceneNode* node = new CLODSceneNode(parent, this, id, position, rotation, scale);
+	node->drop();
+
+	return node;
+}
+
+
 //! Adds a scene node for rendering a animated water surface mesh.
 ISceneNode* CSceneManager::addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 waveLength,
 	ISceneNode* parent, s32 id, const core::vector3df& position,
@@ -1182,30 +1261,43 @@ const core::aabbox3d<f32>& CSceneManager::getBoundingBox() const
 
 //! returns if node is culled
 bool CSceneManager::isCulled(const ISceneNode* node) const
+{
+	return getCullingType(node, CullingHierarchyInside, core::ISREL3D_CLIPPED) != EAC_OFF;
+}
+
+
+//! Get the culling type which culls the node, EAC_OFF if it is visible
+E_CULLING_TYPE CSceneManager::getCullingType(const ISceneNode* node, bool insideHierarchy,
+		core::EIntersectionRelation3D frustumRelation) const
 {
 	const ICameraSceneNode* cam = getActiveCamera();
 	if (!cam)
 	{
-		return false;
+		return EAC_OFF;
 	}
-	bool result = false;
 
 	// has occlusion query information
 	if (node->getAutomaticCulling() & scene::EAC_OCC_QUERY)
 	{
-		result = (Driver->getOcclusionQueryResult(const_cast<ISceneNode*>(node))==0);
+		if (Driver->getOcclusionQueryResult(const_cast<ISceneNode*>(node))==0)
+			return EAC_OCC_QUERY;
 	}
 
+	// known to be inside the frustum from the culling hierarchy
+	if (insideHierarchy)
+		return isOccluded(node) ? EAC_OCC_SOFTWARE : EAC_OFF;
+
 	// can be seen by a bounding box ?
-	if (!result && (node->getAutomaticCulling() & scene::EAC_BOX))
+	if (node->getAutomaticCulling() & scene::EAC_BOX)
 	{
 		core::aabbox3d<f32> tbox = node->getBoundingBox();
 		node->getAbsoluteTransformation().transformBoxEx(tbox);
-		result = !(tbox.intersectsWithBox(cam->getViewFrustum()->getBoundingBox() ));
+		if (!tbox.intersectsWithBox(cam->getViewFrustum()->getBoundingBox()))
+			return EAC_BOX;
 	}
 
 	// can be seen by a bounding sphere
-	if (!result && (node->getAutomaticCulling() & scene::EAC_FRUSTUM_SPHERE))
+	if (node->getAutomaticCulling() & scene::EAC_FRUSTUM_SPHERE)
 	{
 		const core::aabbox3df nbox = node->getTransformedBoundingBox();
 		const float rad = nbox.getRadius();
@@ -1217,12 +1309,19 @@ bool CSceneManager::isCulled(const ISceneNode* node) const
 		const float dist = (center - camcenter).getLengthSQ();
 		const float maxdist = (rad + camrad) * (rad + camrad);
 
-		result = dist > maxdist;
+		if (dist > maxdist)
+			return EAC_FRUSTUM_SPHERE;
 	}
 
 	// can be seen by cam pyramid planes ?
-	if (!result && (node->getAutomaticCulling() & scene::EAC_FRUSTUM_BOX))
+	if (node->getAutomaticCulling() & scene::EAC_FRUSTUM_BOX)
 	{
+		// the world box is completely outside of a plane, or completely inside
+		if (frustumRelation == core::ISREL3D_FRONT)
+			return EAC_FRUSTUM_BOX;
+		if (frustumRelation == core::ISREL3D_BACK)
+			return isOccluded(node) ? EAC_OCC_SOFTWARE : EAC_OFF;
+
 		SViewFrustum frust = *cam->getViewFrustum();
 
 		//transform the frustum to the node's current absolute transformation
@@ -1246,14 +1345,206 @@ bool CSceneManager::isCulled(const ISceneNode* node) const
 			}
 
 			if (!boxInFrustum)
-			{
-				result = true;
-				break;
-			}
+				return EAC_FRUSTUM_BOX;
 		}
 	}
 
-	return result;
+	return isOccluded(node) ? EAC_OCC_SOFTWARE : EAC_OFF;
+}
+
+
+//! Check if the node is hidden behind the occluders
+bool CSceneManager::isOccluded(const ISceneNode* node) const
+{
+	if (!(node->getAutomaticCulling() & scene::EAC_OCC_SOFTWARE))
+		return false;
+	return OcclusionCuller.isOccluded(node->getTransformedBoundingBox());
+}
+
+
+//! Enable or disable culling of static scene node groups with a bounding volume hierarchy.
+void CSceneManager::setUseCullingHierarchy(bool enable)
+{
+	UseCullingHierarchy = enable;
+	CullingHierarchy.clear();
+}
+
+
+//! Set the job system used for parallel work of the scene manager.
+void CSceneManager::setJobSystem(IJobSystem* jobSystem)
+{
+	if (jobSystem == JobSystem)
+		return;
+
+	if (JobSystem)
+		JobSystem->drop();
+
+	JobSystem = jobSystem;
+
+	if (JobSystem)
+		JobSystem->grab();
+}
+
+
+//! checks if a whole subtree can be animated in parallel to others
+bool CSceneManager::isAnimationThreadSafe(const ISceneNode* node)
+{
+	switch (node->getType())
+	{
+	case ESNT_CUBE:
+	case ESNT_SPHERE:
+	case ESNT_TEXT:
+	case ESNT_BILLBOARD:
+	case ESNT_MESH:
+	case ESNT_OCTREE:
+	case ESNT_LIGHT:
+	case ESNT_EMPTY:
+	case ESNT_DUMMY_TRANSFORMATION:
+	case ESNT_CAMERA:
+	case ESNT_SKY_BOX:
+	case ESNT_SKY_DOME:
+	case ESNT_SHADOW_VOLUME:
+	case ESNT_VOLUME_LIGHT:
+		break;
+	default:
+		// might share data with other nodes, like animated meshes
+		return false;
+	}
+
+	ISceneNodeAnimatorList::ConstIterator ait = node->getAnimators().begin();
+	for (; ait != node->getAnimators().end(); ++ait)
+	{
+		if (!(*ait)->isThreadSafe())
+			return false;
+	}
+
+	ISceneNodeList::ConstIterator it = node->getChildren().begin();
+	for (; it != node->getChildren().end(); ++it)
+	{
+		if (!isAnimationThreadSafe(*it))
+			return false;
+	}
+
+	return true;
+}
+
+
+//! job for animateParallel, animates one subtree if it is thread-safe
+void CSceneManager::animateSubtreeJob(void* userData, u32 index)
+{
+	CSceneManager* smgr = (CSceneManager*)userData;
+	ISceneNode* node = smgr->AnimationNodes[index];
+
+	if (isAnimationThreadSafe(node))
+	{
+		node->OnAnimate(smgr->AnimationTime);
+		smgr->AnimationSerial[index] = 0;
+	}
+	else
+		smgr->AnimationSerial[index] = 1;
+}
+
+
+//! animates the subtrees of the root node on the job system
+void CSceneManager::animateParallel(u32 timeMs)
+{
+	if (!IsVisible)
+		return;
+
+	// the root itself, like ISceneNode::OnAnimate
+	ISceneNodeAnimatorList::Iterator ait = Animators.begin();
+	while (ait != Animators.end())
+	{
+		ISceneNodeAnimator* anim = *ait;
+		++ait;
+		if (anim->isEnabled())
+			anim->animateNode(this, timeMs);
+	}
+	updateAbsolutePosition();
+
+	// keep the nodes alive in case serial animators remove some of them
+	AnimationNodes.set_used(0);
+	ISceneNodeList::Iterator it = Children.begin();
+	for (; it != Children.end(); ++it)
+	{
+		(*it)->grab();
+		AnimationNodes.push_back(*it);
+	}
+	AnimationSerial.set_used(AnimationNodes.size());
+	AnimationTime = timeMs;
+
+	JobSystem->parallelFor(AnimationNodes.size(), animateSubtreeJob, this);
+
+	u32 i;
+	for (i=0; i<AnimationNodes.size(); ++i)
+	{
+		if (AnimationSerial[i])
+			AnimationNodes[i]->OnAnimate(timeMs);
+	}
+
+	for (i=0; i<AnimationNodes.size(); ++i)
+		AnimationNodes[i]->drop();
+	AnimationNodes.set_used(0);
+}
+
+
+//! Registers all children, using the culling hierarchy if enabled
+void CSceneManager::OnRegisterSceneNode()
+{
+	if (!UseCullingHierarchy || !ActiveCamera)
+	{
+		ISceneNode::OnRegisterSceneNode();
+		return;
+	}
+
+	if (!IsVisible)
+		return;
+
+	// absolute transformations have been updated by OnAnimate already
+	if (CullingHierarchy.isDirty())
+		CullingHierarchy.build(this);
+
+	u32 i;
+	const core::array<ISceneNode*>& dynamicNodes = CullingHierarchy.getDynamicNodes();
+	for (i=0; i<dynamicNodes.size(); ++i)
+		dynamicNodes[i]->OnRegisterSceneNode();
+
+	CullingHierarchy.cull(*ActiveCamera->getViewFrustum(), CullingHierarchyClipped, CullingHierarchyVisible);
+
+	for (i=0; i<CullingHierarchyClipped.size(); ++i)
+		CullingHierarchyClipped[i]->OnRegisterSceneNode();
+
+	CullingHierarchyInside = true;
+	for (i=0; i<CullingHierarchyVisible.size(); ++i)
+		CullingHierarchyVisible[i]->OnRegisterSceneNode();
+	CullingHierarchyInside = false;
+}
+
+
+//! updates the absolute transformations of a node and all visible nodes below it
+static void updateAbsolutePositions(ISceneNode* node)
+{
+	if (!node->isVisible())
+		return;
+
+	node->updateAbsolutePosition();
+	const ISceneNodeList& children = node->getChildren();
+	ISceneNodeList::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+		updateAbsolutePositions(*it);
+}
+
+
+//! Material deciding the position of a node in the render queues
+static inline const video::SMaterial& getSortMaterial(ISceneNode* node)
+{
+	return node->getMaterialCount() ? node->getMaterial(0) : video::IdentityMaterial;
+}
+
+//! Squared distance of a node to the camera used for sorting
+static inline f32 getSortDistanceSQ(ISceneNode* node, const core::vector3df& camera)
+{
+	return node->getAbsoluteTransformation().getTranslation().getDistanceFromSQ(camera);
 }
 
 
@@ -1263,6 +1554,22 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 	IRR_PROFILE(CProfileScope p1(EPID_SM_REGISTER);)
 	u32 taken = 0;
 
+	// culled later for each view
+	if (RecordRegisteredNodes)
+	{
+		SRegisteredNode entry;
+		entry.Node = node;
+		entry.Pass = pass;
+		RegisteredNodes.push_back(entry);
+		return 1;
+	}
+
+	++Stats.NodesRegistered;
+
+	// static nodes are drawn by their batch
+	if ((pass == ESNRP_SOLID || pass == ESNRP_AUTOMATIC) && StaticBatcher.registerNode(node))
+		return 1;
+
 	switch(pass)
 	{
 		// take camera if it is not already registered
@@ -1285,9 +1592,7 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 		break;
 
 	case ESNRP_LIGHT:
-		// TODO: Point Light culling..
-		// Lighting model in irrlicht has to be redone..
-		//if (!isCulled(node))
+		// lights are culled by the light manager, see setUseLightCulling
 		{
 			LightList.push_back(node);
 			taken = 1;
@@ -1299,32 +1604,83 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 		taken = 1;
 		break;
 	case ESNRP_SOLID:
-		if (!isCulled(node))
+	case ESNRP_TRANSPARENT:
+	case ESNRP_TRANSPARENT_EFFECT:
+	case ESNRP_AUTOMATIC:
+	case ESNRP_SHADOW:
+		// culled together with all other nodes before drawing
 		{
-			SolidNodeList.push_back(node);
+			SPendingNode entry;
+			entry.Node = node;
+			entry.Pass = pass;
+			entry.InsideHierarchy = CullingHierarchyInside;
+			entry.BoxIndex = -1;
+			if (!CullingHierarchyInside && (node->getAutomaticCulling() & scene::EAC_FRUSTUM_BOX) && ActiveCamera)
+			{
+				core::aabbox3d<f32> tbox = node->getBoundingBox();
+				node->getAbsoluteTransformation().transformBoxEx(tbox);
+				entry.BoxIndex = (s32)PendingBoxes.size();
+				PendingBoxes.push_back(tbox);
+			}
+			PendingNodes.push_back(entry);
 			taken = 1;
 		}
 		break;
+
+	case ESNRP_NONE: // ignore this one
+		break;
+	}
+
+	return taken;
+}
+
+
+//! culls the waiting nodes of the culled passes together and queues the visible ones
+void CSceneManager::cullPendingNodes()
+{
+	IRR_PROFILE(CProfileScope p1(EPID_SM_REGISTER);)
+
+	// the world boxes of all nodes with EAC_FRUSTUM_BOX in one pass
+	PendingRelations.set_used(PendingBoxes.size());
+	if (ActiveCamera && PendingBoxes.size())
+		PendingBoxes.classify(*ActiveCamera->getViewFrustum(), 0, PendingBoxes.size(), PendingRelations.pointer());
+
+	for (u32 i=0; i<PendingNodes.size(); ++i)
+	{
+		const SPendingNode& entry = PendingNodes[i];
+		const core::EIntersectionRelation3D relation = (entry.BoxIndex >= 0 && ActiveCamera) ?
+			PendingRelations[entry.BoxIndex] : core::ISREL3D_CLIPPED;
+		if (!cullRegisteredNode(entry.Node, entry.InsideHierarchy, relation))
+			queueRegisteredNode(entry.Node, entry.Pass);
+	}
+
+	PendingNodes.set_used(0);
+	PendingBoxes.clear();
+}
+
+
+//! puts a node which passed culling into the render queue of its pass
+void CSceneManager::queueRegisteredNode(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass)
+{
+	switch(pass)
+	{
+	case ESNRP_SOLID:
+		SolidNodeList.push_back(node, CRenderQueue::makeSolidKey(pass,
+			getSortMaterial(node), getSortDistanceSQ(node, camWorldPos)));
+		break;
 	case ESNRP_TRANSPARENT:
-		if (!isCulled(node))
-		{
-			TransparentNodeList.push_back(TransparentNodeEntry(node, camWorldPos));
-			taken = 1;
-		}
+		TransparentNodeList.push_back(node, CRenderQueue::makeTransparentKey(pass,
+			getSortMaterial(node), getSortDistanceSQ(node, camWorldPos)));
 		break;
 	case ESNRP_TRANSPARENT_EFFECT:
-		if (!isCulled(node))
-		{
-			TransparentEffectNodeList.push_back(TransparentNodeEntry(node, camWorldPos));
-			taken = 1;
-		}
+		TransparentEffectNodeList.push_back(node, CRenderQueue::makeTransparentKey(pass,
+			getSortMaterial(node), getSortDistanceSQ(node, camWorldPos)));
 		break;
 	case ESNRP_AUTOMATIC:
-		if (!isCulled(node))
 		{
 			const u32 count = node->getMaterialCount();
+			const f32 distanceSQ = getSortDistanceSQ(node, camWorldPos);
 
-			taken = 0;
 			for (u32 i=0; i<count; ++i)
 			{
 				video::IMaterialRenderer* rnd =
@@ -1332,45 +1688,51 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 				if ((rnd && rnd->isTransparent()) || node->getMaterial(i).isTransparent())
 				{
 					// register as transparent node
-					TransparentNodeEntry e(node, camWorldPos);
-					TransparentNodeList.push_back(e);
-					taken = 1;
-					break;
+					TransparentNodeList.push_back(node, CRenderQueue::makeTransparentKey(ESNRP_TRANSPARENT,
+						node->getMaterial(i), distanceSQ));
+					return;
 				}
 			}
 
 			// not transparent, register as solid
-			if (!taken)
-			{
-				SolidNodeList.push_back(node);
-				taken = 1;
-			}
+			SolidNodeList.push_back(node, CRenderQueue::makeSolidKey(ESNRP_SOLID,
+				getSortMaterial(node), distanceSQ));
 		}
 		break;
 	case ESNRP_SHADOW:
-		if (!isCulled(node))
-		{
-			ShadowNodeList.push_back(node);
-			taken = 1;
-		}
+		ShadowNodeList.push_back(node);
 		break;
-
-	case ESNRP_NONE: // ignore this one
+	default:
 		break;
 	}
+}
 
-#ifdef _IRR_SCENEMANAGER_DEBUG
-	s32 index = Parameters->findAttribute("calls");
-	Parameters->setAttribute(index, Parameters->getAttributeAsInt(index)+1);
 
-	if (!taken)
+//! culls a node registered for rendering and counts it in the statistics
+bool CSceneManager::cullRegisteredNode(const ISceneNode* node, bool insideHierarchy,
+		core::EIntersectionRelation3D frustumRelation)
+{
+	switch (getCullingType(node, insideHierarchy, frustumRelation))
 	{
-		index = Parameters->findAttribute("culled");
-		Parameters->setAttribute(index, Parameters->getAttributeAsInt(index)+1);
+	case EAC_OFF:
+		return false;
+	case EAC_BOX:
+		++Stats.CulledBox;
+		break;
+	case EAC_FRUSTUM_BOX:
+		++Stats.CulledFrustumBox;
+		break;
+	case EAC_FRUSTUM_SPHERE:
+		++Stats.CulledFrustumSphere;
+		break;
+	case EAC_OCC_QUERY:
+		++Stats.CulledOcclusionQuery;
+		break;
+	case EAC_OCC_SOFTWARE:
+		++Stats.CulledOcclusionSoftware;
+		break;
 	}
-#endif
-
-	return taken;
+	return true;
 }
 
 void CSceneManager::clearAllRegisteredNodesForRendering()
@@ -1382,25 +1744,15 @@ void CSceneManager::clearAllRegisteredNodesForRendering()
 	TransparentNodeList.clear();
 	TransparentEffectNodeList.clear();
 	ShadowNodeList.clear();
+	RegisteredNodes.clear();
+	PendingNodes.clear();
+	PendingBoxes.clear();
 }
 
-//! This method is called just before the rendering process of the whole scene.
-//! draws all scene nodes
-void CSceneManager::drawAll()
+//! resets the driver transformations and animates the scene
+void CSceneManager::beginDrawAll()
 {
-	IRR_PROFILE(CProfileScope psAll(EPID_SM_DRAW_ALL);)
-
-	if (!Driver)
-		return;
-
-#ifdef _IRR_SCENEMANAGER_DEBUG
-	// reset attributes
-	Parameters->setAttribute("culled", 0);
-	Parameters->setAttribute("calls", 0);
-	Parameters->setAttribute("drawn_solid", 0);
-	Parameters->setAttribute("drawn_transparent", 0);
-	Parameters->setAttribute("drawn_transparent_effect", 0);
-#endif
+	Stats = SSceneStats();
 
 	u32 i; // new ISO for scoping problem in some compilers
 
@@ -1415,9 +1767,88 @@ void CSceneManager::drawAll()
 	Driver->setAllowZWriteOnTransparent(Parameters->getAttributeAsBool(ALLOW_ZWRITE_ON_TRANSPARENT));
 
 	// do animations and other stuff.
+	if (!AnimationTimeStep)
+		animateScene(os::Timer::getTime());
+	else
+	{
+		// animated by updateAnimation(), only nodes changed since then are updated
+		updateAbsolutePositions(this);
+		const f32 time = (f32)(AnimationUpdateTime - AnimationStepTime) / AnimationTimeStep;
+		TransformInterpolator.apply(core::min_(time, 1.f));
+	}
+}
+
+
+//! animates the whole scene, in parallel if enabled
+void CSceneManager::animateScene(u32 timeMs)
+{
 	IRR_PROFILE(getProfiler().start(EPID_SM_ANIMATE));
-	OnAnimate(os::Timer::getTime());
+	if (UseParallelAnimation && JobSystem && JobSystem->getWorkerCount())
+		animateParallel(timeMs);
+	else
+		OnAnimate(timeMs);
 	IRR_PROFILE(getProfiler().stop(EPID_SM_ANIMATE));
+}
+
+
+//! Set a fixed time step for animating the scene independent of drawing.
+void CSceneManager::setAnimationTimeStep(u32 stepMs)
+{
+	AnimationTimeStep = stepMs;
+	AnimationStarted = false;
+	TransformInterpolator.clear();
+}
+
+
+//! Animate the scene in fixed time steps up to a time.
+u32 CSceneManager::updateAnimation(u32 timeMs, u32 maxSteps)
+{
+	if (!AnimationTimeStep || !maxSteps)
+		return 0;
+
+	if (!AnimationStarted || timeMs < AnimationStepTime)
+	{
+		// nothing to interpolate from yet
+		TransformInterpolator.clear();
+		AnimationStarted = true;
+		AnimationStepTime = timeMs;
+		AnimationUpdateTime = timeMs;
+		animateScene(timeMs);
+		return 1;
+	}
+
+	u32 steps = (timeMs - AnimationStepTime) / AnimationTimeStep;
+	if (steps > maxSteps)
+	{
+		AnimationStepTime += (steps - maxSteps) * AnimationTimeStep;
+		steps = maxSteps;
+	}
+	AnimationUpdateTime = timeMs;
+
+	for (u32 i=0; i<steps; ++i)
+	{
+		if (i == steps - 1)
+			TransformInterpolator.capturePrevious(this);
+		AnimationStepTime += AnimationTimeStep;
+		animateScene(AnimationStepTime);
+	}
+	if (steps)
+		TransformInterpolator.captureCurrent();
+
+	return steps;
+}
+
+
+//! This method is called just before the rendering process of the whole scene.
+//! draws all scene nodes
+void CSceneManager::drawAll()
+{
+	IRR_PROFILE(CProfileScope psAll(EPID_SM_DRAW_ALL);)
+
+	if (!Driver)
+		return;
+
+	beginDrawAll();
 
 	/*!
 		First Scene Node for prerendering should be the active camera
@@ -1432,11 +1863,122 @@ void CSceneManager::drawAll()
 	}
 	IRR_PROFILE(getProfiler().stop(EPID_SM_RENDER_CAMERAS));
 
+	// depth of the occluders for EAC_OCC_SOFTWARE
+	OcclusionCuller.render(ActiveCamera, this);
+
 	// let all nodes register themselves
+	StaticBatcher.update(this);
 	OnRegisterSceneNode();
+	StaticBatcher.registerBatches(this);
 
-	if (LightManager)
-		LightManager->OnPreRender(LightList);
+	drawRegisteredNodes();
+
+	LightList.set_used(0);
+	TransformInterpolator.restore();
+	clearDeletionList();
+
+	CurrentRenderPass = ESNRP_NONE;
+}
+
+
+//! draws all scene nodes with another driver
+void CSceneManager::drawAll(video::IVideoDriver* driver)
+{
+	if (!driver)
+		return;
+
+	// the nodes get the driver from the scene manager while they render
+	video::IVideoDriver* oldDriver = Driver;
+	Driver = driver;
+	drawAll();
+	Driver = oldDriver;
+}
+
+
+//! draws all scene nodes from several cameras
+void CSceneManager::drawAll(const core::array<SSceneView>& views)
+{
+	IRR_PROFILE(CProfileScope psAll(EPID_SM_DRAW_ALL);)
+
+	if (!Driver || views.empty())
+		return;
+
+	ICameraSceneNode* oldCamera = ActiveCamera;
+	if (oldCamera)
+		oldCamera->grab();
+	const core::rect<s32> oldViewPort = Driver->getViewPort();
+
+	beginDrawAll();
+
+	// nodes depending on the camera while registering see the first one
+	setActiveCamera(views[0].Camera);
+	if (ActiveCamera)
+		ActiveCamera->render();
+
+	StaticBatcher.update(this);
+	RecordRegisteredNodes = true;
+	ISceneNode::OnRegisterSceneNode();
+	RecordRegisteredNodes = false;
+
+	u32 i;
+	for (u32 v=0; v<views.size(); ++v)
+	{
+		ICameraSceneNode* camera = views[v].Camera;
+		if (!camera)
+			continue;
+
+		setActiveCamera(camera);
+		Driver->setViewPort(views[v].Viewport);
+
+		IRR_PROFILE(getProfiler().start(EPID_SM_RENDER_CAMERAS));
+		camera->render();
+		camWorldPos = camera->getAbsolutePosition();
+		IRR_PROFILE(getProfiler().stop(EPID_SM_RENDER_CAMERAS));
+
+		OcclusionCuller.render(camera, this);
+
+		// cull the nodes for this view, only its own camera is rendered
+		registerNodeForRendering(camera, ESNRP_CAMERA);
+		for (i=0; i<RegisteredNodes.size(); ++i)
+		{
+			const SRegisteredNode& entry = RegisteredNodes[i];
+			if (entry.Pass != ESNRP_CAMERA || entry.Node->getType() != ESNT_CAMERA)
+				registerNodeForRendering(entry.Node, entry.Pass);
+		}
+		StaticBatcher.registerBatches(this);
+
+		drawRegisteredNodes();
+		LightList.set_used(0);
+	}
+
+	RegisteredNodes.set_used(0);
+
+	Driver->setViewPort(oldViewPort);
+	setActiveCamera(oldCamera);
+	if (oldCamera)
+		oldCamera->drop();
+
+	TransformInterpolator.restore();
+	clearDeletionList();
+
+	CurrentRenderPass = ESNRP_NONE;
+}
+
+
+//! draws the render passes of the registered nodes and clears them
+void CSceneManager::drawRegisteredNodes()
+{
+	u32 i;
+	u32 drawCalls;
+
+	cullPendingNodes();
+
+	ILightManager* lightManager = LightManager;
+	if (!lightManager && UseLightCulling)
+		lightManager = LightCulling;
+
+	if (lightManager)
+		lightManager->OnPreRender(LightList);
 
 	//render camera scenes
 	{
@@ -1444,16 +1986,16 @@ void CSceneManager::drawAll()
 		CurrentRenderPass = ESNRP_CAMERA;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
 
-		if (LightManager)
-			LightManager->OnRenderPassPreRender(CurrentRenderPass);
+		if (lightManager)
+			lightManager->OnRenderPassPreRender(CurrentRenderPass);
 
 		for (i=0; i<CameraList.size(); ++i)
 			CameraList[i]->render();
 
 		CameraList.set_used(0);
 
-		if (LightManager)
-			LightManager->OnRenderPassPostRender(CurrentRenderPass);
+		if (lightManager)
+			lightManager->OnRenderPassPostRender(CurrentRenderPass);
 	}
 
 	//render lights scenes
@@ -1462,9 +2004,9 @@ void CSceneManager::drawAll()
 		CurrentRenderPass = ESNRP_LIGHT;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
 
-		if (LightManager)
+		if (lightManager)
 		{
-			LightManager->OnRenderPassPreRender(CurrentRenderPass);
+			lightManager->OnRenderPassPreRender(CurrentRenderPass);
 		}
 		else
 		{
@@ -1491,14 +2033,15 @@ void CSceneManager::drawAll()
 
 		u32 maxLights = LightList.size();
 
-		if (!LightManager)
+		if (!lightManager)
 			maxLights = core::min_ ( Driver->getMaximalDynamicLightAmount(), maxLights);
 
 		for (i=0; i< maxLights; ++i)
 			LightList[i]->render();
+		Stats.LightsUsed += maxLights;
 
-		if (LightManager)
-			LightManager->OnRenderPassPostRender(CurrentRenderPass);
+		if (lightManager)
+			lightManager->OnRenderPassPostRender(CurrentRenderPass);
 	}
 
 	// render skyboxes
@@ -1506,16 +2049,17 @@ void CSceneManager::drawAll()
 		IRR_PROFILE(CProfileScope psSkyBox(EPID_SM_RENDER_SKYBOXES);)
 		CurrentRenderPass = ESNRP_SKY_BOX;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
+		drawCalls = Driver->getDrawCallCount();
 
-		if (LightManager)
+		if (lightManager)
 		{
-			LightManager->OnRenderPassPreRender(CurrentRenderPass);
+			lightManager->OnRenderPassPreRender(CurrentRenderPass);
 			for (i=0; i<SkyBoxList.size(); ++i)
 			{
 				ISceneNode* node = SkyBoxList[i];
-				LightManager->OnNodePreRender(node);
+				lightManager->OnNodePreRender(node);
 				node->render();
-				LightManager->OnNodePostRender(node);
+				lightManager->OnNodePostRender(node);
 			}
 		}
 		else
@@ -1524,10 +2068,12 @@ void CSceneManager::drawAll()
 				SkyBoxList[i]->render();
 		}
 
+		Stats.SkyBox.Nodes += SkyBoxList.size();
+		Stats.SkyBox.MeshBuffers += Driver->getDrawCallCount() - drawCalls;
 		SkyBoxList.set_used(0);
 
-		if (LightManager)
-			LightManager->OnRenderPassPostRender(CurrentRenderPass);
+		if (lightManager)
+			lightManager->OnRenderPassPostRender(CurrentRenderPass);
 	}
 
 
@@ -1536,33 +2082,34 @@ void CSceneManager::drawAll()
 		IRR_PROFILE(CProfileScope psDefault(EPID_SM_RENDER_DEFAULT);)
 		CurrentRenderPass = ESNRP_SOLID;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
+		drawCalls = Driver->getDrawCallCount();
 
-		SolidNodeList.sort(); // sort by textures
+		SolidNodeList.sort(); // sort by material, textures and depth
 
-		if (LightManager)
+		if (lightManager)
 		{
-			LightManager->OnRenderPassPreRender(CurrentRenderPass);
+			lightManager->OnRenderPassPreRender(CurrentRenderPass);
 			for (i=0; i<SolidNodeList.size(); ++i)
 			{
-				ISceneNode* node = SolidNodeList[i].Node;
-				LightManager->OnNodePreRender(node);
+				ISceneNode* node = SolidNodeList.getNode(i);
+				lightManager->OnNodePreRender(node);
 				node->render();
-				LightManager->OnNodePostRender(node);
+				lightManager->OnNodePostRender(node);
 			}
 		}
 		else
 		{
 			for (i=0; i<SolidNodeList.size(); ++i)
-				SolidNodeList[i].Node->render();
+				SolidNodeList.getNode(i)->render();
 		}
 
-#ifdef _IRR_SCENEMANAGER_DEBUG
-		Parameters->setAttribute("drawn_solid", (s32) SolidNodeList.size() );
-#endif
-		SolidNodeList.set_used(0);
+		Stats.Solid.Nodes += SolidNodeList.size();
+		Stats.Solid.MeshBuffers += Driver->getDrawCallCount() - drawCalls;
+		Stats.Solid.MaterialChanges += SolidNodeList.countMaterialChanges(false);
+		SolidNodeList.clear();
 
-		if (LightManager)
-			LightManager->OnRenderPassPostRender(CurrentRenderPass);
+		if (lightManager)
+			lightManager->OnRenderPassPostRender(CurrentRenderPass);
 	}
 
 	// render shadows
@@ -1570,16 +2117,17 @@ void CSceneManager::drawAll()
 		IRR_PROFILE(CProfileScope psShadow(EPID_SM_RENDER_SHADOWS);)
 		CurrentRenderPass = ESNRP_SHADOW;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
+		drawCalls = Driver->getDrawCallCount();
 
-		if (LightManager)
+		if (lightManager)
 		{
-			LightManager->OnRenderPassPreRender(CurrentRenderPass);
+			lightManager->OnRenderPassPreRender(CurrentRenderPass);
 			for (i=0; i<ShadowNodeList.size(); ++i)
 			{
 				ISceneNode* node = ShadowNodeList[i];
-				LightManager->OnNodePreRender(node);
+				lightManager->OnNodePreRender(node);
 				node->render();
-				LightManager->OnNodePostRender(node);
+				lightManager->OnNodePostRender(node);
 			}
 		}
 		else
@@ -1588,14 +2136,17 @@ void CSceneManager::drawAll()
 				ShadowNodeList[i]->render();
 		}
 
+		Stats.Shadow.Nodes += ShadowNodeList.size();
+		Stats.Shadow.MeshBuffers += Driver->getDrawCallCount() - drawCalls;
+
 		if (!ShadowNodeList.empty())
 			Driver->drawStencilShadow(true,ShadowColor, ShadowColor,
 				ShadowColor, ShadowColor);
 
 		ShadowNodeList.set_used(0);
 
-		if (LightManager)
-			LightManager->OnRenderPassPostRender(CurrentRenderPass);
+		if (lightManager)
+			lightManager->OnRenderPassPostRender(CurrentRenderPass);
 	}
 
 	// render transparent objects.
@@ -1603,33 +2154,34 @@ void CSceneManager::drawAll()
 		IRR_PROFILE(CProfileScope psTrans(EPID_SM_RENDER_TRANSPARENT);)
 		CurrentRenderPass = ESNRP_TRANSPARENT;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
+		drawCalls = Driver->getDrawCallCount();
 
 		TransparentNodeList.sort(); // sort by distance from camera
-		if (LightManager)
+		if (lightManager)
 		{
-			LightManager->OnRenderPassPreRender(CurrentRenderPass);
+			lightManager->OnRenderPassPreRender(CurrentRenderPass);
 
 			for (i=0; i<TransparentNodeList.size(); ++i)
 			{
-				ISceneNode* node = TransparentNodeList[i].Node;
-				LightManager->OnNodePreRender(node);
+				ISceneNode* node = TransparentNodeList.getNode(i);
+				lightManager->OnNodePreRender(node);
 				node->render();
-				LightManager->OnNodePostRender(node);
+				lightManager->OnNodePostRender(node);
 			}
 		}
 		else
 		{
 			for (i=0; i<TransparentNodeList.size(); ++i)
-				TransparentNodeList[i].Node->render();
+				TransparentNodeList.getNode(i)->render();
 		}
 
-#ifdef _IRR_SCENEMANAGER_DEBUG
-		Parameters->setAttribute ( "drawn_transparent", (s32) TransparentNodeList.size() );
-#endif
-		TransparentNodeList.set_used(0);
+		Stats.Transparent.Nodes += TransparentNodeList.size();
+		Stats.Transparent.MeshBuffers += Driver->getDrawCallCount() - drawCalls;
+		Stats.Transparent.MaterialChanges += TransparentNodeList.countMaterialChanges(true);
+		TransparentNodeList.clear();
 
-		if (LightManager)
-			LightManager->OnRenderPassPostRender(CurrentRenderPass);
+		if (lightManager)
+			lightManager->OnRenderPassPostRender(CurrentRenderPass);
 	}
 
 	// render transparent effect objects.
@@ -1637,39 +2189,35 @@ void CSceneManager::drawAll()
 		IRR_PROFILE(CProfileScope psEffect(EPID_SM_RENDER_EFFECT);)
 		CurrentRenderPass = ESNRP_TRANSPARENT_EFFECT;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
+		drawCalls = Driver->getDrawCallCount();
 
 		TransparentEffectNodeList.sort(); // sort by distance from camera
 
-		if (LightManager)
+		if (lightManager)
 		{
-			LightManager->OnRenderPassPreRender(CurrentRenderPass);
+			lightManager->OnRenderPassPreRender(CurrentRenderPass);
 
 			for (i=0; i<TransparentEffectNodeList.size(); ++i)
 			{
-				ISceneNode* node = TransparentEffectNodeList[i].Node;
-				LightManager->OnNodePreRender(node);
+				ISceneNode* node = TransparentEffectNodeList.getNode(i);
+				lightManager->OnNodePreRender(node);
 				node->render();
-				LightManager->OnNodePostRender(node);
+				lightManager->OnNodePostRender(node);
 			}
 		}
 		else
 		{
 			for (i=0; i<TransparentEffectNodeList.size(); ++i)
-				TransparentEffectNodeList[i].Node->render();
+				TransparentEffectNodeList.getNode(i)->render();
 		}
-#ifdef _IRR_SCENEMANAGER_DEBUG
-		Parameters->setAttribute("drawn_transparent_effect", (s32) TransparentEffectNodeList.size());
-#endif
-		TransparentEffectNodeList.set_used(0);
+		Stats.TransparentEffect.Nodes += TransparentEffectNodeList.size();
+		Stats.TransparentEffect.MeshBuffers += Driver->getDrawCallCount() - drawCalls;
+		Stats.TransparentEffect.MaterialChanges += TransparentEffectNodeList.countMaterialChanges(true);
+		TransparentEffectNodeList.clear();
 	}
 
-	if (LightManager)
-		LightManager->OnPostRender();
-
-	LightList.set_used(0);
-	clearDeletionList();
-
-	CurrentRenderPass = ESNRP_NONE;
+	if (lightManager)
+		lightManager->OnPostRender();
 }
 
 void CSceneManager::setLightManager(ILightManager* lightManager)
@@ -1952,6 +2500,99 @@ void CSceneManager::clearDeletionList()
 }
 
 
+namespace
+{
+	// Depth first searches for nodes outside of the index
+
+	ISceneNode* findSceneNodeFromName(const char* name, ISceneNode* start)
+	{
+		if (!strcmp(start->getName(),name))
+			return start;
+
+		const ISceneNodeList& list = start->getChildren();
+		ISceneNodeList::ConstIterator it = list.begin();
+		for (; it!=list.end(); ++it)
+		{
+			ISceneNode* node = findSceneNodeFromName(name, *it);
+			if (node)
+				return node;
+		}
+
+		return 0;
+	}
+
+	ISceneNode* findSceneNodeFromId(s32 id, ISceneNode* start)
+	{
+		if (start->getID() == id)
+			return start;
+
+		const ISceneNodeList& list = start->getChildren();
+		ISceneNodeList::ConstIterator it = list.begin();
+		for (; it!=list.end(); ++it)
+		{
+			ISceneNode* node = findSceneNodeFromId(id, *it);
+			if (node)
+				return node;
+		}
+
+		return 0;
+	}
+
+	ISceneNode* findSceneNodeFromType(ESCENE_NODE_TYPE type, ISceneNode* start)
+	{
+		if (start->getType() == type || ESNT_ANY == type)
+			return start;
+
+		const ISceneNodeList& list = start->getChildren();
+		ISceneNodeList::ConstIterator it = list.begin();
+		for (; it!=list.end(); ++it)
+		{
+			ISceneNode* node = findSceneNodeFromType(type, *it);
+			if (node)
+				return node;
+		}
+
+		return 0;
+	}
+
+	void findSceneNodesFromType(ESCENE_NODE_TYPE type, core::array<ISceneNode*>& outNodes, ISceneNode* start)
+	{
+		if (start->getType() == type || ESNT_ANY == type)
+			outNodes.push_back(start);
+
+		const ISceneNodeList& list = start->getChildren();
+		ISceneNodeList::ConstIterator it = list.begin();
+		for (; it!=list.end(); ++it)
+			findSceneNodesFromType(type, outNodes, *it);
+	}
+}
+
+
+//! Keeps the index of the nodes up to date
+void CSceneManager::onSceneGraphChange(ISceneNode* node, E_SCENE_GRAPH_CHANGE change)
+{
+	switch (change)
+	{
+	case ESGC_ADDED:
+		NodeIndex.add(node);
+		break;
+	case ESGC_REMOVED:
+		NodeIndex.remove(node);
+		break;
+	case ESGC_RENAMED:
+		NodeIndex.update(node);
+		break;
+	}
+}
+
+
+//! Check if the index can be used to search below the node
+bool CSceneManager::isIndexed(const ISceneNode* start) const
+{
+	return start == this || NodeIndex.contains(start);
+}
+
+
 //! Returns the first scene node with the specified name.
 ISceneNode* CSceneManager::getSceneNodeFromName(const char* name, ISceneNode* start)
 {
@@ -1961,18 +2602,15 @@ ISceneNode* CSceneManager::getSceneNodeFromName(const char* name, ISceneNode* st
 	if (!strcmp(start->getName(),name))
 		return start;
 
-	ISceneNode* node = 0;
+	// nodes without a name are not in the index
+	if (!name[0] || !isIndexed(start))
+		return findSceneNodeFromName(name, start);
 
-	const ISceneNodeList& list = start->getChildren();
-	ISceneNodeList::ConstIterator it = list.begin();
-	for (; it!=list.end(); ++it)
-	{
-		node = getSceneNodeFromName(name, *it);
-		if (node)
-			return node;
-	}
+	FoundNodes.set_used(0);
+	NodeIndex.findByName(name, FoundNodes);
+	NodeIndex.sortByTreeOrder(FoundNodes, start, true);
 
-	return 0;
+	return FoundNodes.size() ? FoundNodes[0] : 0;
 }
 
 
@@ -1985,18 +2623,15 @@ ISceneNode* CSceneManager::getSceneNodeFromId(s32 id, ISceneNode* start)
 	if (start->getID() == id)
 		return start;
 
-	ISceneNode* node = 0;
+	// nodes with id -1 are not in the index
+	if (id == -1 || !isIndexed(start))
+		return findSceneNodeFromId(id, start);
 
-	const ISceneNodeList& list = start->getChildren();
-	ISceneNodeList::ConstIterator it = list.begin();
-	for (; it!=list.end(); ++it)
-	{
-		node = getSceneNodeFromId(id, *it);
-		if (node)
-			return node;
-	}
+	FoundNodes.set_used(0);
+	NodeIndex.findById(id, FoundNodes);
+	NodeIndex.sortByTreeOrder(FoundNodes, start, true);
 
-	return 0;
+	return FoundNodes.size() ? FoundNodes[0] : 0;
 }
 
 
@@ -2009,18 +2644,14 @@ ISceneNode* CSceneManager::getSceneNodeFromType(scene::ESCENE_NODE_TYPE type, IS
 	if (start->getType() == type || ESNT_ANY == type)
 		return start;
 
-	ISceneNode* node = 0;
+	if (!isIndexed(start))
+		return findSceneNodeFromType(type, start);
 
-	const ISceneNodeList& list = start->getChildren();
-	ISceneNodeList::ConstIterator it = list.begin();
-	for (; it!=list.end(); ++it)
-	{
-		node = getSceneNodeFromType(type, *it);
-		if (node)
-			return node;
-	}
+	FoundNodes.set_used(0);
+	NodeIndex.findByType(type, FoundNodes);
+	NodeIndex.sortByTreeOrder(FoundNodes, start, true);
 
-	return 0;
+	return FoundNodes.size() ? FoundNodes[0] : 0;
 }
 
 
@@ -2030,16 +2661,21 @@ void CSceneManager::getSceneNodesFromType(ESCENE_NODE_TYPE type, core::array<sce
 	if (start == 0)
 		start = getRootSceneNode();
 
-	if (start->getType() == type || ESNT_ANY == type)
+	if (ESNT_ANY == type || !isIndexed(start))
+	{
+		findSceneNodesFromType(type, outNodes, start);
+		return;
+	}
+
+	if (start->getType() == type)
 		outNodes.push_back(start);
 
-	const ISceneNodeList& list = start->getChildren();
-	ISceneNodeList::ConstIterator it = list.begin();
+	FoundNodes.set_used(0);
+	NodeIndex.findByType(type, FoundNodes);
+	NodeIndex.sortByTreeOrder(FoundNodes, start, false);
 
-	for (; it!=list.end(); ++it)
-	{
-		getSceneNodesFromType(type, outNodes, *it);
-	}
+	for (u32 i=0; i<FoundNodes.size(); ++i)
+		outNodes.push_back(FoundNodes[i]);
 }
 
 
@@ -2056,10 +2692,31 @@ bool CSceneManager::postEventFromUser(const SEvent& event)
 }
 
 
+//! Adds a child to the root of the scene
+void CSceneManager::addChild(ISceneNode* child)
+{
+	ISceneNode::addChild(child);
+	CullingHierarchy.setDirty();
+}
+
+
+//! Removes a child from the root of the scene
+bool CSceneManager::removeChild(ISceneNode* child)
+{
+	// the hierarchy must not keep pointers to removed nodes
+	CullingHierarchy.clear();
+	return ISceneNode::removeChild(child);
+}
+
+
 //! Removes all children of this scene node
 void CSceneManager::removeAll()
 {
 	ISceneNode::removeAll();
+	TransformInterpolator.clear();
+	CullingHierarchy.clear();
+	StaticBatcher.clear();
+	OcclusionCuller.clear();
 	setActiveCamera(0);
 	// Make sure the driver is reset, might need a more complex method at some point
 	if (Driver)
@@ -2099,6 +2756,7 @@ IMeshCache* CSceneManager::getMeshCache()
 ISceneManager* CSceneManager::createNewSceneManager(bool cloneContent)
 {
 	CSceneManager* manager = new CSceneManager(Driver, FileSystem, CursorControl, MeshCache, GUIEnvironment);
+	manager->setJobSystem(JobSystem);
 
 	if (cloneContent)
 		manager->cloneMembers(this, manager);
@@ -2202,6 +2860,12 @@ bool CSceneManager::saveScene(io::IWriteFile* file, ISceneUserDataSerializer* us
 		return false;
 	}
 
+	if (core::hasFileExtension(file->getFileName(), "irrb"))
+	{
+		CSceneWriterIrrb writer(this, FileSystem);
+		return writer.write(file, this, node, userDataSerializer);
+	}
+
 	bool result=false;
 	io::IXMLWriter* writer = FileSystem->createXMLWriter(file);
 	if (!writer)
@@ -2513,6 +3177,7 @@ void CSceneManager::deserializeAttributes(io::IAttributes* in, io::SAttributeRea
 	DebugDataVisible = scene::EDS_OFF;
 	IsDebugObject = false;
 
+	setTransformationDirty();
 	updateAbsolutePosition();
 }
 
@@ -13,6 +13,14 @@
 #include "IMeshLoader.h"
 #include "CAttributes.h"
 #include "ILightManager.h"
+#include "CCullingHierarchy.h"
+#include "CFrustumBoxBatch.h"
+#include "CRenderQueue.h"
+#include "CStaticBatcher.h"
+#include "CLightCullingManager.h"
+#include "COcclusionCuller.h"
+#include "CTransformInterpolator.h"
+#include "CSceneNodeIndex.h"
 
 namespace irr
 {
@@ -97,6 +105,18 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false) _IRR_OVERRIDE_;
 
+		//! Adds a scene node for drawing a static mesh at many transformations.
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) _IRR_OVERRIDE_;
+
+		//! Adds a scene node switching between meshes of different detail by its size on screen.
+		virtual ILODSceneNode* addLODSceneNode(ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) _IRR_OVERRIDE_;
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		virtual ISceneNode* addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 wlength, ISceneNode* parent=0, s32 id=-1,
 			const core::vector3df& position = core::vector3df(0,0,0),
@@ -118,6 +138,12 @@ namespace scene
 		//! draws all scene nodes
 		virtual void drawAll() _IRR_OVERRIDE_;
 
+		//! draws all scene nodes from several cameras
+		virtual void drawAll(const core::array<SSceneView>& views) _IRR_OVERRIDE_;
+
+		//! draws all scene nodes with another driver
+		virtual void drawAll(video::IVideoDriver* driver) _IRR_OVERRIDE_;
+
 		//! Adds a scene node for rendering using a octree to the scene graph. This a good method for rendering
 		//! scenes with lots of geometry. The Octree is built on the fly from the mesh, much
 		//! faster then a bsp tree.
@@ -204,6 +230,10 @@ namespace scene
 		virtual IMeshSceneNode* addQuake3SceneNode(const IMeshBuffer* meshBuffer, const quake3::IShader * shader,
 			ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
 
+		//! Adds a scene node drawing the geometry of a quake3 level with its potentially visible sets.
+		virtual ISceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
+
 
 		//! Adds a Hill Plane mesh to the mesh pool. The mesh is
 		//! generated on the fly and looks like a plane with some hills
@@ -434,6 +464,15 @@ namespace scene
 		//! Removes all children of this scene node
 		virtual void removeAll() _IRR_OVERRIDE_;
 
+		//! Adds a child to the root of the scene
+		virtual void addChild(ISceneNode* child) _IRR_OVERRIDE_;
+
+		//! Removes a child from the root of the scene
+		virtual bool removeChild(ISceneNode* child) _IRR_OVERRIDE_;
+
+		//! Registers all children, using the culling hierarchy if enabled
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
 		//! Returns interface to the parameters set in this scene.
 		virtual io::IAttributes* getParameters() _IRR_OVERRIDE_;
 
@@ -532,54 +571,134 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(const ISceneNode* node) const _IRR_OVERRIDE_;
 
+		//! Enable or disable culling of static scene node groups with a bounding volume hierarchy.
+		virtual void setUseCullingHierarchy(bool enable) _IRR_OVERRIDE_;
+
+		//! Check if the culling hierarchy is used.
+		virtual bool getUseCullingHierarchy() const _IRR_OVERRIDE_ { return UseCullingHierarchy; }
+
+		//! Force a rebuild of the culling hierarchy in the next drawAll() call.
+		virtual void setCullingHierarchyDirty() _IRR_OVERRIDE_ { CullingHierarchy.setDirty(); }
+
+		//! Set the job system used for parallel work of the scene manager.
+		virtual void setJobSystem(IJobSystem* jobSystem) _IRR_OVERRIDE_;
+
+		//! Get the job system used for parallel work of the scene manager.
+		virtual IJobSystem* getJobSystem() const _IRR_OVERRIDE_ { return JobSystem; }
+
+		//! Enable or disable animating scene nodes on several threads.
+		virtual void setUseParallelAnimation(bool enable) _IRR_OVERRIDE_ { UseParallelAnimation = enable; }
+
+		//! Check if scene nodes are animated on several threads.
+		virtual bool getUseParallelAnimation() const _IRR_OVERRIDE_ { return UseParallelAnimation; }
+
+		//! Set a fixed time step for animating the scene independent of drawing.
+		virtual void setAnimationTimeStep(u32 stepMs) _IRR_OVERRIDE_;
+
+		//! Get the fixed time step for animating the scene.
+		virtual u32 getAnimationTimeStep() const _IRR_OVERRIDE_ { return AnimationTimeStep; }
+
+		//! Animate the scene in fixed time steps up to a time.
+		virtual u32 updateAnimation(u32 timeMs, u32 maxSteps=5) _IRR_OVERRIDE_;
+
+		//! Mark a mesh scene node as static, so it is drawn together with other static nodes.
+		virtual void setStaticBatching(IMeshSceneNode* node, bool isStatic) _IRR_OVERRIDE_ { StaticBatcher.setBatched(node, isStatic); }
+
+		//! Check if a mesh scene node was marked as static.
+		virtual bool getStaticBatching(const IMeshSceneNode* node) const _IRR_OVERRIDE_ { return StaticBatcher.isBatched(node); }
+
+		//! Set the edge length of the grid cells used to split the static batches.
+		virtual void setStaticBatchCellSize(f32 size) _IRR_OVERRIDE_ { StaticBatcher.setCellSize(size); }
+
+		//! Get the edge length of the grid cells used to split the static batches.
+		virtual f32 getStaticBatchCellSize() const _IRR_OVERRIDE_ { return StaticBatcher.getCellSize(); }
+
+		//! Force a rebuild of the static batches in the next drawAll() call.
+		virtual void setStaticBatchesDirty() _IRR_OVERRIDE_ { StaticBatcher.setDirty(); }
+
+		//! Enable or disable culling and per node selection of lights.
+		virtual void setUseLightCulling(bool enable) _IRR_OVERRIDE_ { UseLightCulling = enable; }
+
+		//! Check if lights are culled and selected per scene node.
+		virtual bool getUseLightCulling() const _IRR_OVERRIDE_ { return UseLightCulling; }
+
+		//! Set the maximal number of lights turned on for a scene node with light culling.
+		virtual void setMaxLightsPerNode(u32 count) _IRR_OVERRIDE_ { LightCulling->setMaxLightsPerNode(count); }
+
+		//! Get the maximal number of lights turned on for a scene node with light culling.
+		virtual u32 getMaxLightsPerNode() const _IRR_OVERRIDE_ { return LightCulling->getMaxLightsPerNode(); }
+
+		//! Set or remove the mesh a scene node hides other nodes with for EAC_OCC_SOFTWARE.
+		virtual void setOccluder(ISceneNode* node, IMesh* mesh) _IRR_OVERRIDE_ { OcclusionCuller.setOccluder(node, mesh); }
+
+		//! Get the occluder mesh of a scene node.
+		virtual IMesh* getOccluder(const ISceneNode* node) const _IRR_OVERRIDE_ { return OcclusionCuller.getOccluder(node); }
+
+		//! Set the resolution of the depth buffer for EAC_OCC_SOFTWARE.
+		virtual void setOcclusionBufferSize(const core::dimension2du& size) _IRR_OVERRIDE_ { OcclusionCuller.setSize(size); }
+
+		//! Get the resolution of the depth buffer for EAC_OCC_SOFTWARE.
+		virtual const core::dimension2du& getOcclusionBufferSize() const _IRR_OVERRIDE_ { return OcclusionCuller.getSize(); }
+
+		//! Get statistics of the last drawAll() call.
+		virtual const SSceneStats& getSceneStats() const _IRR_OVERRIDE_ { return Stats; }
+
+	protected:
+
+		//! Keeps the index of the nodes up to date
+		virtual void onSceneGraphChange(ISceneNode* node, E_SCENE_GRAPH_CHANGE change) _IRR_OVERRIDE_;
+
 	private:
 
+		//! Check if the index can be used to search below the node
+		bool isIndexed(const ISceneNode* start) const;
+
+		//! Check if the node uses EAC_OCC_SOFTWARE and is hidden behind the occluders
+		bool isOccluded(const ISceneNode* node) const;
+
+		//! Get the culling type which culls the node, EAC_OFF if it is visible
+		/** \param insideHierarchy The node is known to be inside the frustum from the culling hierarchy.
+		\param frustumRelation Relation of the world box of the node to the frustum if it is
+		known already, ISREL3D_CLIPPED otherwise. Decides EAC_FRUSTUM_BOX unless it is clipped. */
+		E_CULLING_TYPE getCullingType(const ISceneNode* node, bool insideHierarchy,
+				core::EIntersectionRelation3D frustumRelation) const;
+
+		//! culls a node registered for rendering and counts it in the statistics
+		bool cullRegisteredNode(const ISceneNode* node, bool insideHierarchy,
+				core::EIntersectionRelation3D frustumRelation);
+
+		//! culls the waiting nodes of the culled passes together and queues the visible ones
+		void cullPendingNodes();
+
+		//! puts a node which passed culling into the render queue of its pass
+		void queueRegisteredNode(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass);
+
 		// load and create a mesh which we know already isn't in the cache and put it in there
 		IAnimatedMesh* getUncachedMesh(io::IReadFile* file, const io::path& filename, const io::path& cachename);
 
 		//! clears the deletion list
 		void clearDeletionList();
 
-		//! writes a scene node
-		void writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer, const fschar_t* currentPath=0, bool init=false);
+		//! resets the driver transformations and animates the scene
+		void beginDrawAll();
 
-		struct DefaultNodeEntry
-		{
-			DefaultNodeEntry(ISceneNode* n) :
-				Node(n), TextureValue(0)
-			{
-				if (n->getMaterialCount())
-					TextureValue = (n->getMaterial(0).getTexture(0));
-			}
+		//! draws the render passes of the registered nodes and clears them
+		void drawRegisteredNodes();
 
-			bool operator < (const DefaultNodeEntry& other) const
-			{
-				return (TextureValue < other.TextureValue);
-			}
+		//! animates the whole scene, in parallel if enabled
+		void animateScene(u32 timeMs);
 
-			ISceneNode* Node;
-			private:
-			void* TextureValue;
-		};
+		//! animates the subtrees of the root node on the job system
+		void animateParallel(u32 timeMs);
 
-		//! sort on distance (center) to camera
-		struct TransparentNodeEntry
-		{
-			TransparentNodeEntry(ISceneNode* n, const core::vector3df& camera)
-				: Node(n)
-			{
-				Distance = Node->getAbsoluteTransformation().getTranslation().getDistanceFromSQ(camera);
-			}
+		//! job for animateParallel, animates one subtree if it is thread-safe
+		static void animateSubtreeJob(void* userData, u32 index);
 
-			bool operator < (const TransparentNodeEntry& other) const
-			{
-				return Distance > other.Distance;
-			}
+		//! checks if a whole subtree can be animated in parallel to others
+		static bool isAnimationThreadSafe(const ISceneNode* node);
 
-			ISceneNode* Node;
-			private:
-				f64 Distance;
-		};
+		//! writes a scene node
+		void writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer, const fschar_t* currentPath=0, bool init=false);
 
 		//! sort on distance (sphere) to camera
 		struct DistanceNodeEntry
@@ -627,9 +746,9 @@ namespace scene
 		core::array<ISceneNode*> LightList;
 		core::array<ISceneNode*> ShadowNodeList;
 		core::array<ISceneNode*> SkyBoxList;
-		core::array<DefaultNodeEntry> SolidNodeList;
-		core::array<TransparentNodeEntry> TransparentNodeList;
-		core::array<TransparentNodeEntry> TransparentEffectNodeList;
+		CRenderQueue SolidNodeList;
+		CRenderQueue TransparentNodeList;
+		CRenderQueue TransparentEffectNodeList;
 
 		core::array<IMeshLoader*> MeshLoaderList;
 		core::array<ISceneLoader*> SceneLoaderList;
@@ -657,6 +776,14 @@ namespace scene
 		//! over the scene lighting and rendering.
 		ILightManager* LightManager;
 
+		//! Light manager used without LightManager when UseLightCulling is set
+		CLightCullingManager* LightCulling;
+		bool UseLightCulling;
+
+		//! Index of all nodes below the root, for the getSceneNodeFrom functions
+		CSceneNodeIndex NodeIndex;
+		core::array<ISceneNode*> FoundNodes;
+
 		//! constants for reading and writing XML.
 		//! Not made static due to portability problems.
 		const core::stringw IRR_XML_FORMAT_SCENE;
@@ -664,6 +791,64 @@ namespace scene
 		const core::stringw IRR_XML_FORMAT_NODE_ATTR_TYPE;
 
 		IGeometryCreator* GeometryCreator;
+
+		//! boxes around static subtrees for culling
+		CCullingHierarchy CullingHierarchy;
+		core::array<ISceneNode*> CullingHierarchyClipped;
+		core::array<ISceneNode*> CullingHierarchyVisible;
+		bool UseCullingHierarchy;
+		//! true while registering nodes which are known to be inside the view frustum
+		bool CullingHierarchyInside;
+
+		//! node registered for rendering while drawing several views
+		struct SRegisteredNode
+		{
+			ISceneNode* Node;
+			E_SCENE_NODE_RENDER_PASS Pass;
+		};
+
+		//! node of a culled pass, waiting for drawing to test all boxes at once
+		struct SPendingNode
+		{
+			ISceneNode* Node;
+			E_SCENE_NODE_RENDER_PASS Pass;
+			bool InsideHierarchy;
+			//! index in PendingBoxes, -1 for nodes which don't use EAC_FRUSTUM_BOX
+			s32 BoxIndex;
+		};
+
+		//! nodes registered for the culled passes since the last drawing
+		core::array<SPendingNode> PendingNodes;
+		//! world boxes of the pending nodes with EAC_FRUSTUM_BOX
+		CFrustumBoxBatch PendingBoxes;
+		core::array<core::EIntersectionRelation3D> PendingRelations;
+
+		//! nodes registered once and culled for each view by drawAll(views)
+		core::array<SRegisteredNode> RegisteredNodes;
+		//! true while the nodes register for drawAll(views)
+		bool RecordRegisteredNodes;
+
+		CStaticBatcher StaticBatcher;
+
+		//! depth buffer of the occluders for EAC_OCC_SOFTWARE
+		COcclusionCuller OcclusionCuller;
+
+		IJobSystem* JobSystem;
+		bool UseParallelAnimation;
+		//! subtrees animated by animateParallel and if they still have to be animated serially
+		core::array<ISceneNode*> AnimationNodes;
+		core::array<u8> AnimationSerial;
+		u32 AnimationTime;
+
+		//! fixed rate animation, see updateAnimation()
+		u32 AnimationTimeStep;
+		u32 AnimationStepTime;
+		u32 AnimationUpdateTime;
+		bool AnimationStarted;
+		CTransformInterpolator TransformInterpolator;
+
+		//! counters of the last drawAll() call
+		SSceneStats Stats;
 	};
 
 } // end namespace video
@@ -0,0 +1,347 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSceneNodeIndex.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	const u32 INITIAL_BUCKET_COUNT = 64;
+
+	//! Spreads the bits of a value over the whole word
+	inline u32 hashValue(u32 h)
+	{
+		h ^= h >> 16;
+		h *= 0x7feb352d;
+		h ^= h >> 15;
+		h *= 0x846ca68b;
+		h ^= h >> 16;
+		return h;
+	}
+
+	inline u32 hashPointer(const void* ptr)
+	{
+		const size_t value = (size_t)ptr;
+		return hashValue((u32)value ^ (u32)(value >> 16 >> 16));
+	}
+
+	//! FNV-1a hash of a string
+	inline u32 hashName(const c8* name)
+	{
+		u32 h = 2166136261u;
+		for (; *name; ++name)
+		{
+			h ^= (u8)*name;
+			h *= 16777619u;
+		}
+		return h;
+	}
+}
+
+
+CSceneNodeIndex::CSceneNodeIndex()
+	: FreeRecord(-1), Count(0)
+{
+	rehash(INITIAL_BUCKET_COUNT);
+}
+
+
+//! Adds a node and all its children
+void CSceneNodeIndex::add(ISceneNode* node)
+{
+	if (findRecord(node) < 0)
+	{
+		s32 r = FreeRecord;
+		if (r >= 0)
+			FreeRecord = Records[r].Next[EIK_NODE];
+		else
+		{
+			r = (s32)Records.size();
+			Records.push_back(SRecord());
+		}
+
+		SRecord& record = Records[r];
+		record.Node = node;
+		record.Name = node->getName();
+		record.Id = node->getID();
+		record.Type = ESNT_UNKNOWN;
+		record.Linked = 0;
+		record.Hash[EIK_NODE] = hashPointer(node);
+		record.Hash[EIK_ID] = hashValue((u32)record.Id);
+		record.Hash[EIK_NAME] = hashName(record.Name.c_str());
+
+		link(r, EIK_NODE);
+		if (record.Id != -1)
+			link(r, EIK_ID);
+		if (!record.Name.empty())
+			link(r, EIK_NAME);
+
+		// records of removed nodes are skipped, but don't let them pile up
+		if (UntypedRecords.size() >= 2 * Records.size())
+		{
+			UntypedRecords.set_used(0);
+			for (u32 i=0; i<Records.size(); ++i)
+				if (Records[i].Node && !(Records[i].Linked & (1 << EIK_TYPE)))
+					UntypedRecords.push_back(i);
+		}
+		else
+			UntypedRecords.push_back(r);
+
+		++Count;
+		if (Count > Buckets[EIK_NODE].size())
+			rehash(Buckets[EIK_NODE].size() * 2);
+	}
+
+	const ISceneNodeList& children = node->getChildren();
+	for (ISceneNodeList::ConstIterator it = children.begin(); it != children.end(); ++it)
+		add(*it);
+}
+
+
+//! Removes a node and all its children
+void CSceneNodeIndex::remove(ISceneNode* node)
+{
+	const s32 r = findRecord(node);
+
+	// children of nodes outside of the index are not in it either
+	if (r < 0)
+		return;
+
+	for (u32 key=0; key<EIK_COUNT; ++key)
+		unlink(r, (E_INDEX_KEY)key);
+
+	SRecord& record = Records[r];
+	record.Node = 0;
+	record.Name = "";
+	record.Next[EIK_NODE] = FreeRecord;
+	FreeRecord = r;
+	--Count;
+
+	const ISceneNodeList& children = node->getChildren();
+	for (ISceneNodeList::ConstIterator it = children.begin(); it != children.end(); ++it)
+		remove(*it);
+}
+
+
+//! Updates the id and name of a node
+void CSceneNodeIndex::update(ISceneNode* node)
+{
+	const s32 r = findRecord(node);
+	if (r < 0)
+		return;
+
+	SRecord& record = Records[r];
+	if (record.Id != node->getID())
+	{
+		unlink(r, EIK_ID);
+		record.Id = node->getID();
+		record.Hash[EIK_ID] = hashValue((u32)record.Id);
+		if (record.Id != -1)
+			link(r, EIK_ID);
+	}
+
+	if (record.Name != node->getName())
+	{
+		unlink(r, EIK_NAME);
+		record.Name = node->getName();
+		record.Hash[EIK_NAME] = hashName(record.Name.c_str());
+		if (!record.Name.empty())
+			link(r, EIK_NAME);
+	}
+}
+
+
+//! Removes all nodes
+void CSceneNodeIndex::clear()
+{
+	Records.clear();
+	UntypedRecords.clear();
+	FreeRecord = -1;
+	Count = 0;
+	rehash(INITIAL_BUCKET_COUNT);
+}
+
+
+//! Adds all nodes with the id to the array
+void CSceneNodeIndex::findById(s32 id, core::array<ISceneNode*>& outNodes) const
+{
+	const u32 hash = hashValue((u32)id);
+	const u32 mask = Buckets[EIK_ID].size() - 1;
+
+	for (s32 r = Buckets[EIK_ID][hash & mask]; r >= 0; r = Records[r].Next[EIK_ID])
+		if (Records[r].Hash[EIK_ID] == hash && Records[r].Id == id)
+			outNodes.push_back(Records[r].Node);
+}
+
+
+//! Adds all nodes with the name to the array
+void CSceneNodeIndex::findByName(const c8* name, core::array<ISceneNode*>& outNodes) const
+{
+	const u32 hash = hashName(name);
+	const u32 mask = Buckets[EIK_NAME].size() - 1;
+
+	for (s32 r = Buckets[EIK_NAME][hash & mask]; r >= 0; r = Records[r].Next[EIK_NAME])
+		if (Records[r].Hash[EIK_NAME] == hash && Records[r].Name == name)
+			outNodes.push_back(Records[r].Node);
+}
+
+
+//! Adds all nodes of the type to the array
+void CSceneNodeIndex::findByType(ESCENE_NODE_TYPE type, core::array<ISceneNode*>& outNodes)
+{
+	// all constructors are done by now
+	for (u32 i=0; i<UntypedRecords.size(); ++i)
+	{
+		const s32 r = UntypedRecords[i];
+		SRecord& record = Records[r];
+		if (record.Node && !(record.Linked & (1 << EIK_TYPE)))
+		{
+			record.Type = record.Node->getType();
+			record.Hash[EIK_TYPE] = hashValue((u32)record.Type);
+			link(r, EIK_TYPE);
+		}
+	}
+	UntypedRecords.set_used(0);
+
+	const u32 hash = hashValue((u32)type);
+	const u32 mask = Buckets[EIK_TYPE].size() - 1;
+
+	for (s32 r = Buckets[EIK_TYPE][hash & mask]; r >= 0; r = Records[r].Next[EIK_TYPE])
+		if (Records[r].Type == type)
+			outNodes.push_back(Records[r].Node);
+}
+
+
+//! Sorts nodes into the order of a depth first walk from start
+void CSceneNodeIndex::sortByTreeOrder(core::array<ISceneNode*>& nodes, ISceneNode* start, bool firstOnly)
+{
+	Marked.set_used(0);
+	Hits.set_used(0);
+
+	// mark the nodes below start and their parents
+	for (u32 i=0; i<nodes.size(); ++i)
+	{
+		const u32 pathStart = Marked.size();
+		ISceneNode* node = nodes[i];
+		while (node && node != start)
+		{
+			Marked.push_back(node);
+			node = node->getParent();
+		}
+
+		if (node && Marked.size() > pathStart)
+			Hits.push_back(nodes[i]);
+		else
+			Marked.set_used(pathStart);
+	}
+
+	nodes.set_used(0);
+	if (Hits.size() <= 1)
+	{
+		if (Hits.size())
+			nodes.push_back(Hits[0]);
+		return;
+	}
+
+	// walk only down to marked nodes
+	Marked.sort();
+	Hits.sort();
+	collectInTreeOrder(start, nodes, firstOnly);
+}
+
+
+void CSceneNodeIndex::collectInTreeOrder(ISceneNode* node, core::array<ISceneNode*>& outNodes, bool firstOnly)
+{
+	const ISceneNodeList& children = node->getChildren();
+	for (ISceneNodeList::ConstIterator it = children.begin(); it != children.end(); ++it)
+	{
+		if (Marked.binary_search(*it) < 0)
+			continue;
+
+		if (Hits.binary_search(*it) >= 0)
+		{
+			outNodes.push_back(*it);
+			if (firstOnly)
+				return;
+		}
+
+		collectInTreeOrder(*it, outNodes, firstOnly);
+		if (firstOnly && outNodes.size())
+			return;
+	}
+}
+
+
+s32 CSceneNodeIndex::findRecord(const ISceneNode* node) const
+{
+	const u32 hash = hashPointer(node);
+	const u32 mask = Buckets[EIK_NODE].size() - 1;
+
+	for (s32 r = Buckets[EIK_NODE][hash & mask]; r >= 0; r = Records[r].Next[EIK_NODE])
+		if (Records[r].Node == node)
+			return r;
+
+	return -1;
+}
+
+
+void CSceneNodeIndex::link(s32 r, E_INDEX_KEY key)
+{
+	SRecord& record = Records[r];
+	s32& bucket = Buckets[key][record.Hash[key] & (Buckets[key].size() - 1)];
+
+	record.Prev[key] = -1;
+	record.Next[key] = bucket;
+	if (bucket >= 0)
+		Records[bucket].Prev[key] = r;
+	bucket = r;
+	record.Linked |= 1 << key;
+}
+
+
+void CSceneNodeIndex::unlink(s32 r, E_INDEX_KEY key)
+{
+	SRecord& record = Records[r];
+	if (!(record.Linked & (1 << key)))
+		return;
+
+	if (record.Prev[key] >= 0)
+		Records[record.Prev[key]].Next[key] = record.Next[key];
+	else
+		Buckets[key][record.Hash[key] & (Buckets[key].size() - 1)] = record.Next[key];
+
+	if (record.Next[key] >= 0)
+		Records[record.Next[key]].Prev[key] = record.Prev[key];
+
+	record.Linked &= ~(1 << key);
+}
+
+
+void CSceneNodeIndex::rehash(u32 bucketCount)
+{
+	for (u32 key=0; key<EIK_COUNT; ++key)
+	{
+		Buckets[key].set_used(bucketCount);
+		for (u32 i=0; i<bucketCount; ++i)
+			Buckets[key][i] = -1;
+	}
+
+	for (u32 i=0; i<Records.size(); ++i)
+	{
+		if (!Records[i].Node)
+			continue;
+
+		const u32 linked = Records[i].Linked;
+		for (u32 key=0; key<EIK_COUNT; ++key)
+			if (linked & (1 << key))
+				link(i, (E_INDEX_KEY)key);
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,112 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_NODE_INDEX_H_INCLUDED__
+#define __C_SCENE_NODE_INDEX_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "irrArray.h"
+#include "irrString.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Hash index of the scene nodes by id, name and type.
+	/** Used by the scene manager to find nodes without walking the whole
+	scene graph. Each key has its own hash chains through the same records,
+	so several nodes may share an id or name. Nodes with id -1 and nodes
+	without a name are not put into the id and name chains, as most nodes
+	have those. The type of a node is only known after its constructor
+	finished, so new nodes are put into the type chains on the next
+	lookup by type. */
+	class CSceneNodeIndex
+	{
+	public:
+
+		//! Constructor
+		CSceneNodeIndex();
+
+		//! Adds a node and all its children
+		void add(ISceneNode* node);
+
+		//! Removes a node and all its children
+		void remove(ISceneNode* node);
+
+		//! Updates the id and name of a node
+		void update(ISceneNode* node);
+
+		//! Removes all nodes
+		void clear();
+
+		//! Check if a node is in the index
+		bool contains(const ISceneNode* node) const
+		{
+			return findRecord(node) >= 0;
+		}
+
+		//! Adds all nodes with the id to the array, in no particular order
+		void findById(s32 id, core::array<ISceneNode*>& outNodes) const;
+
+		//! Adds all nodes with the name to the array, in no particular order
+		void findByName(const c8* name, core::array<ISceneNode*>& outNodes) const;
+
+		//! Adds all nodes of the type to the array, in no particular order
+		void findByType(ESCENE_NODE_TYPE type, core::array<ISceneNode*>& outNodes);
+
+		//! Sorts nodes into the order of a depth first walk from start.
+		/** Nodes which are not below start are removed, as is start itself.
+		\param nodes Nodes to sort.
+		\param start Node the walk starts from.
+		\param firstOnly Only keep the node which would be found first. */
+		void sortByTreeOrder(core::array<ISceneNode*>& nodes, ISceneNode* start, bool firstOnly);
+
+	private:
+
+		enum E_INDEX_KEY
+		{
+			EIK_NODE = 0,
+			EIK_ID,
+			EIK_NAME,
+			EIK_TYPE,
+			EIK_COUNT
+		};
+
+		struct SRecord
+		{
+			ISceneNode* Node;
+			core::stringc Name;
+			s32 Id;
+			ESCENE_NODE_TYPE Type;
+			u32 Hash[EIK_COUNT];
+			s32 Next[EIK_COUNT];
+			s32 Prev[EIK_COUNT];
+			//! Bit for each key with the record in its chain
+			u32 Linked;
+		};
+
+		s32 findRecord(const ISceneNode* node) const;
+		void link(s32 record, E_INDEX_KEY key);
+		void unlink(s32 record, E_INDEX_KEY key);
+		void rehash(u32 bucketCount);
+		void collectInTreeOrder(ISceneNode* node, core::array<ISceneNode*>& outNodes, bool firstOnly);
+
+		core::array<SRecord> Records;
+		core::array<s32> Buckets[EIK_COUNT];
+		//! Unused records, linked through their node chain
+		s32 FreeRecord;
+		u32 Count;
+		//! Records which are not in the type chains yet
+		core::array<s32> UntypedRecords;
+
+		// used by sortByTreeOrder
+		core::array<ISceneNode*> Marked;
+		core::array<ISceneNode*> Hits;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
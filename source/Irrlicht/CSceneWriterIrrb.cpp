@@ -0,0 +1,412 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSceneWriterIrrb.h"
+#include "CSceneLoaderIrrb.h"
+#include "ISceneManager.h"
+#include "ISceneNode.h"
+#include "ISceneUserDataSerializer.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IWriteFile.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Constructor
+CSceneWriterIrrb::CSceneWriterIrrb(ISceneManager* smgr, io::IFileSystem* fs)
+ : SceneManager(smgr), FileSystem(fs), UserDataSerializer(0), Attributes(0)
+{
+}
+
+
+//! Writes the scene
+bool CSceneWriterIrrb::write(io::IWriteFile* file, ISceneNode* scene, ISceneNode* node,
+	ISceneUserDataSerializer* userDataSerializer)
+{
+	if (!file || !scene)
+		return false;
+
+	if (!node)
+		node = scene;
+
+	const io::path currentPath = FileSystem->getFileDir(FileSystem->getAbsolutePath(file->getFileName()));
+	Options = io::SAttributeReadWriteOptions();
+	Options.Filename = currentPath.c_str();
+	Options.Flags |= io::EARWF_USE_RELATIVE_PATHS;
+	UserDataSerializer = userDataSerializer;
+	Attributes = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+
+	Data.set_used(0);
+	writeU32(IRRB_MAGIC);
+	writeU32(IRRB_VERSION);
+
+	// like in .irr files the scene has the attributes of the scene manager,
+	// a node other than the scene is its only child
+	const u32 sceneSize = beginBlock(IRRB_SCENE);
+	writeNode(scene, node == scene);
+	if (node != scene && !node->isDebugObject())
+	{
+		const u32 nodeSize = beginBlock(IRRB_NODE);
+		writeString(SceneManager->getSceneNodeTypeName(node->getType()), 0);
+		writeNode(node, true);
+		endBlock(nodeSize);
+	}
+	endBlock(sceneSize);
+
+	Attributes->drop();
+	Attributes = 0;
+	UserDataSerializer = 0;
+
+	const bool result = file->write(Data.const_pointer(), Data.size()) == Data.size();
+	if (!result)
+		os::Printer::log("Could not write scene file", file->getFileName(), ELL_ERROR);
+
+	// don't keep the memory of big scenes
+	Data.clear();
+	Utf8String.clear();
+
+	return result;
+}
+
+
+//! Writes the blocks of a node and its children
+void CSceneWriterIrrb::writeNode(ISceneNode* node, bool writeChildren)
+{
+	Attributes->clear();
+	node->serializeAttributes(Attributes, &Options);
+	if (Attributes->getAttributeCount() != 0)
+	{
+		const u32 size = beginBlock(IRRB_ATTRIBUTES);
+		writeAttributes(Attributes);
+		endBlock(size);
+	}
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (node->getMaterialCount() && driver)
+	{
+		const u32 materialsSize = beginBlock(IRRB_MATERIALS);
+		for (u32 i=0; i < node->getMaterialCount(); ++i)
+		{
+			io::IAttributes* material = driver->createAttributesFromMaterial(node->getMaterial(i), &Options);
+			const u32 size = beginBlock(IRRB_ATTRIBUTES);
+			writeAttributes(material);
+			endBlock(size);
+			material->drop();
+		}
+		endBlock(materialsSize);
+	}
+
+	if (!node->getAnimators().empty())
+	{
+		const u32 animatorsSize = beginBlock(IRRB_ANIMATORS);
+		ISceneNodeAnimatorList::ConstIterator it = node->getAnimators().begin();
+		for (; it != node->getAnimators().end(); ++it)
+		{
+			Attributes->clear();
+			Attributes->addString("Type", SceneManager->getAnimatorTypeName((*it)->getType()));
+			(*it)->serializeAttributes(Attributes);
+
+			const u32 size = beginBlock(IRRB_ATTRIBUTES);
+			writeAttributes(Attributes);
+			endBlock(size);
+		}
+		endBlock(animatorsSize);
+	}
+
+	if (UserDataSerializer)
+	{
+		io::IAttributes* userData = UserDataSerializer->createUserData(node);
+		if (userData)
+		{
+			const u32 userDataSize = beginBlock(IRRB_USERDATA);
+			const u32 size = beginBlock(IRRB_ATTRIBUTES);
+			writeAttributes(userData);
+			endBlock(size);
+			endBlock(userDataSize);
+			userData->drop();
+		}
+	}
+
+	if (!writeChildren)
+		return;
+
+	ISceneNodeList::ConstIterator it = node->getChildren().begin();
+	for (; it != node->getChildren().end(); ++it)
+	{
+		ISceneNode* child = *it;
+		if (child->isDebugObject())
+			continue;
+
+		const u32 size = beginBlock(IRRB_NODE);
+		writeString(SceneManager->getSceneNodeTypeName(child->getType()), 0);
+		writeNode(child, true);
+		endBlock(size);
+	}
+}
+
+
+void CSceneWriterIrrb::writeAttributes(const io::IAttributes* attr)
+{
+	const u32 countPos = Data.size();
+	writeU32(0);
+
+	u32 count = 0;
+	for (s32 i=0; i < (s32)attr->getAttributeCount(); ++i)
+	{
+		const io::E_ATTRIBUTE_TYPE type = attr->getAttributeType(i);
+		if (type == io::EAT_FLOATARRAY || type == io::EAT_INTARRAY ||
+			type == io::EAT_USER_POINTER || type >= io::EAT_COUNT)
+			continue;
+
+		writeU32((u32)type);
+		writeString(attr->getAttributeName(i), 0);
+		++count;
+
+		switch (type)
+		{
+		case io::EAT_INT:
+			writeU32((u32)attr->getAttributeAsInt(i));
+			break;
+		case io::EAT_FLOAT:
+			writeF32(attr->getAttributeAsFloat(i));
+			break;
+		case io::EAT_STRING:
+			writeString(attr->getAttributeAsStringW(i).c_str());
+			break;
+		case io::EAT_BOOL:
+			writeU32(attr->getAttributeAsBool(i) ? 1 : 0);
+			break;
+		case io::EAT_ENUM:
+			writeString(attr->getAttributeAsEnumeration(i), 0);
+			break;
+		case io::EAT_COLOR:
+			writeU32(attr->getAttributeAsColor(i).color);
+			break;
+		case io::EAT_COLORF:
+			{
+				const video::SColorf c = attr->getAttributeAsColorf(i);
+				writeF32(c.r);
+				writeF32(c.g);
+				writeF32(c.b);
+				writeF32(c.a);
+			}
+			break;
+		case io::EAT_VECTOR3D:
+			{
+				const core::vector3df v = attr->getAttributeAsVector3d(i);
+				writeF32(v.X);
+				writeF32(v.Y);
+				writeF32(v.Z);
+			}
+			break;
+		case io::EAT_POSITION2D:
+			{
+				const core::position2di p = attr->getAttributeAsPosition2d(i);
+				writeU32((u32)p.X);
+				writeU32((u32)p.Y);
+			}
+			break;
+		case io::EAT_VECTOR2D:
+			{
+				const core::vector2df v = attr->getAttributeAsVector2d(i);
+				writeF32(v.X);
+				writeF32(v.Y);
+			}
+			break;
+		case io::EAT_RECT:
+			{
+				const core::rect<s32> r = attr->getAttributeAsRect(i);
+				writeU32((u32)r.UpperLeftCorner.X);
+				writeU32((u32)r.UpperLeftCorner.Y);
+				writeU32((u32)r.LowerRightCorner.X);
+				writeU32((u32)r.LowerRightCorner.Y);
+			}
+			break;
+		case io::EAT_MATRIX:
+			{
+				const core::matrix4 m = attr->getAttributeAsMatrix(i);
+				for (u32 j=0; j<16; ++j)
+					writeF32(m[j]);
+			}
+			break;
+		case io::EAT_QUATERNION:
+			{
+				const core::quaternion q = attr->getAttributeAsQuaternion(i);
+				writeF32(q.X);
+				writeF32(q.Y);
+				writeF32(q.Z);
+				writeF32(q.W);
+			}
+			break;
+		case io::EAT_BBOX:
+			{
+				const core::aabbox3df b = attr->getAttributeAsBox3d(i);
+				writeF32(b.MinEdge.X);
+				writeF32(b.MinEdge.Y);
+				writeF32(b.MinEdge.Z);
+				writeF32(b.MaxEdge.X);
+				writeF32(b.MaxEdge.Y);
+				writeF32(b.MaxEdge.Z);
+			}
+			break;
+		case io::EAT_PLANE:
+			{
+				const core::plane3df p = attr->getAttributeAsPlane3d(i);
+				writeF32(p.Normal.X);
+				writeF32(p.Normal.Y);
+				writeF32(p.Normal.Z);
+				writeF32(p.D);
+			}
+			break;
+		case io::EAT_TRIANGLE3D:
+			{
+				const core::triangle3df t = attr->getAttributeAsTriangle3d(i);
+				const core::vector3df* points[3] = { &t.pointA, &t.pointB, &t.pointC };
+				for (u32 j=0; j<3; ++j)
+				{
+					writeF32(points[j]->X);
+					writeF32(points[j]->Y);
+					writeF32(points[j]->Z);
+				}
+			}
+			break;
+		case io::EAT_LINE2D:
+			{
+				const core::line2df l = attr->getAttributeAsLine2d(i);
+				writeF32(l.start.X);
+				writeF32(l.start.Y);
+				writeF32(l.end.X);
+				writeF32(l.end.Y);
+			}
+			break;
+		case io::EAT_LINE3D:
+			{
+				const core::line3df l = attr->getAttributeAsLine3d(i);
+				writeF32(l.start.X);
+				writeF32(l.start.Y);
+				writeF32(l.start.Z);
+				writeF32(l.end.X);
+				writeF32(l.end.Y);
+				writeF32(l.end.Z);
+			}
+			break;
+		case io::EAT_STRINGWARRAY:
+			{
+				const core::array<core::stringw> strings = attr->getAttributeAsArray(i);
+				writeU32(strings.size());
+				for (u32 j=0; j<strings.size(); ++j)
+					writeString(strings[j].c_str());
+			}
+			break;
+		case io::EAT_BINARY:
+		case io::EAT_TEXTURE:
+		case io::EAT_DIMENSION2D:
+			if (type == io::EAT_DIMENSION2D)
+			{
+				const core::dimension2du d = attr->getAttributeAsDimension2d(i);
+				writeU32(d.Width);
+				writeU32(d.Height);
+			}
+			else
+			{
+				const core::stringc value = attr->getAttributeAsString(i);
+				writeString(value.c_str(), value.size());
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	u32 value = count;
+#ifdef __BIG_ENDIAN__
+	value = os::Byteswap::byteswap(value);
+#endif
+	memcpy(&Data[countPos], &value, 4);
+}
+
+
+void CSceneWriterIrrb::writeU32(u32 value)
+{
+#ifdef __BIG_ENDIAN__
+	value = os::Byteswap::byteswap(value);
+#endif
+	memcpy(grow(4), &value, 4);
+}
+
+
+void CSceneWriterIrrb::writeF32(f32 value)
+{
+	u32 bits;
+	memcpy(&bits, &value, 4);
+	writeU32(bits);
+}
+
+
+//! Writes length, characters, a terminating 0 and the padding to 4 bytes
+/** length is computed when it is 0 */
+void CSceneWriterIrrb::writeString(const c8* string, u32 length)
+{
+	if (!string)
+		string = "";
+	if (!length)
+		length = (u32)strlen(string);
+
+	writeU32(length);
+	const u32 size = (length + 4) & ~3;
+	u8* data = grow(size);
+	memcpy(data, string, length);
+	memset(data + length, 0, size - length);
+}
+
+
+void CSceneWriterIrrb::writeString(const wchar_t* string)
+{
+	u32 length = 0;
+	while (string[length])
+		++length;
+
+	// 4 bytes are enough for each character in utf-8
+	Utf8String.set_used(length * 4 + 1);
+	core::wcharToUtf8(string, Utf8String.pointer(), Utf8String.size());
+	writeString(Utf8String.const_pointer(), 0);
+}
+
+
+//! Appends size bytes to Data and returns them
+u8* CSceneWriterIrrb::grow(u32 size)
+{
+	const u32 pos = Data.size();
+	// set_used only allocates what is needed
+	if (pos + size > Data.allocated_size())
+		Data.reallocate(core::max_(pos + size, Data.allocated_size() * 2), false);
+	Data.set_used(pos + size);
+	return &Data[pos];
+}
+
+
+u32 CSceneWriterIrrb::beginBlock(u32 id)
+{
+	writeU32(id);
+	writeU32(0);
+	return Data.size() - 4;
+}
+
+
+void CSceneWriterIrrb::endBlock(u32 sizePos)
+{
+	u32 size = Data.size() - sizePos - 4;
+#ifdef __BIG_ENDIAN__
+	size = os::Byteswap::byteswap(size);
+#endif
+	memcpy(&Data[sizePos], &size, 4);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,77 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_WRITER_IRRB_H_INCLUDED__
+#define __C_SCENE_WRITER_IRRB_H_INCLUDED__
+
+#include "IAttributes.h"
+#include "IAttributeExchangingObject.h"
+#include "irrArray.h"
+
+namespace irr
+{
+
+namespace io
+{
+	class IFileSystem;
+	class IWriteFile;
+}
+
+namespace scene
+{
+
+class ISceneManager;
+class ISceneNode;
+class ISceneUserDataSerializer;
+
+//! Writes scenes in the binary .irrb format, see CSceneLoaderIrrb.h
+/** The file is built in memory and written with a single write call. */
+class CSceneWriterIrrb
+{
+public:
+
+	//! Constructor
+	CSceneWriterIrrb(ISceneManager* smgr, io::IFileSystem* fs);
+
+	//! Writes the scene
+	/** \param file File to write to.
+	\param scene Node of the scene manager, its attributes are the attributes of the scene.
+	\param node Node to write with its children, the whole scene when it is scene.
+	\param userDataSerializer Optional serializer for user data of the nodes. */
+	bool write(io::IWriteFile* file, ISceneNode* scene, ISceneNode* node,
+		ISceneUserDataSerializer* userDataSerializer);
+
+private:
+
+	//! Writes the blocks of a node and its children
+	void writeNode(ISceneNode* node, bool writeChildren);
+
+	void writeAttributes(const io::IAttributes* attr);
+
+	void writeU32(u32 value);
+	void writeF32(f32 value);
+	void writeString(const c8* string, u32 length);
+	void writeString(const wchar_t* string);
+	u8* grow(u32 size);
+
+	//! Starts a block, returns the position of its size for endBlock
+	u32 beginBlock(u32 id);
+	void endBlock(u32 sizePos);
+
+	ISceneManager* SceneManager;
+	io::IFileSystem* FileSystem;
+	ISceneUserDataSerializer* UserDataSerializer;
+	io::SAttributeReadWriteOptions Options;
+	io::IAttributes* Attributes;
+
+	core::array<u8> Data;
+	//! Conversion buffer for strings which are not ascii
+	core::array<c8> Utf8String;
+};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
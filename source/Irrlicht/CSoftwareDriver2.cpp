@@ -13,6 +13,13 @@
 #include "S3DVertex.h"
 #include "S4DVertex.h"
 #include "CBlit.h"
+#include "IJobSystem.h"
+
+#if defined(_IRR_COMPILE_WITH_AVX_)
+#include <immintrin.h>
+#elif defined(_IRR_COMPILE_WITH_SSE2_)
+#include <emmintrin.h>
+#endif
 
 
 #define MAT_TEXTURE(tex) ( (video::CSoftwareTexture2*) Material.org.getTexture ( tex ) )
@@ -23,12 +30,98 @@ namespace irr
 namespace video
 {
 
+/*
+	Lanes of the batched vertex stage, see VertexCache_fill. The same
+	operations in the same order as the scalar code, so the results are the
+	same. Not with IRRLICHT_FAST_MATH, which changes the scalar code.
+*/
+#if defined(_IRR_COMPILE_WITH_SSE2_) && !defined(IRRLICHT_FAST_MATH)
+
+#if defined(_IRR_COMPILE_WITH_AVX_)
+
+#define BURNING_VERTEX_LANES 8
+typedef __m256 tVertexLanes;
+
+static inline tVertexLanes lanes_set ( const f32 v ) { return _mm256_set1_ps ( v ); }
+static inline tVertexLanes lanes_load ( const f32 *p ) { return _mm256_loadu_ps ( p ); }
+static inline void lanes_store ( f32 *p, const tVertexLanes &v ) { _mm256_storeu_ps ( p, v ); }
+static inline tVertexLanes lanes_add ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_add_ps ( a, b ); }
+static inline tVertexLanes lanes_sub ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_sub_ps ( a, b ); }
+static inline tVertexLanes lanes_mul ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_mul_ps ( a, b ); }
+static inline tVertexLanes lanes_div ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_div_ps ( a, b ); }
+static inline tVertexLanes lanes_sqrt ( const tVertexLanes &a ) { return _mm256_sqrt_ps ( a ); }
+static inline tVertexLanes lanes_neg ( const tVertexLanes &a ) { return _mm256_xor_ps ( a, _mm256_set1_ps ( -0.f ) ); }
+static inline tVertexLanes lanes_and ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_and_ps ( a, b ); }
+static inline tVertexLanes lanes_or ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_or_ps ( a, b ); }
+// mask ? bit : 0 as integer
+static inline tVertexLanes lanes_bit ( const tVertexLanes &mask, const s32 bit ) { return _mm256_and_ps ( mask, _mm256_castsi256_ps ( _mm256_set1_epi32 ( bit ) ) ); }
+// a <= b
+static inline tVertexLanes lanes_lessEqual ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_cmp_ps ( a, b, _CMP_LE_OQ ); }
+// !( a < b )
+static inline tVertexLanes lanes_notLess ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_cmp_ps ( a, b, _CMP_NLT_UQ ); }
+// mask ? a : b
+static inline tVertexLanes lanes_select ( const tVertexLanes &mask, const tVertexLanes &a, const tVertexLanes &b ) { return _mm256_blendv_ps ( b, a, mask ); }
+static inline u32 lanes_mask ( const tVertexLanes &mask ) { return (u32) _mm256_movemask_ps ( mask ); }
+
+#else
+
+#define BURNING_VERTEX_LANES 4
+typedef __m128 tVertexLanes;
+
+static inline tVertexLanes lanes_set ( const f32 v ) { return _mm_set1_ps ( v ); }
+static inline tVertexLanes lanes_load ( const f32 *p ) { return _mm_loadu_ps ( p ); }
+static inline void lanes_store ( f32 *p, const tVertexLanes &v ) { _mm_storeu_ps ( p, v ); }
+static inline tVertexLanes lanes_add ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_add_ps ( a, b ); }
+static inline tVertexLanes lanes_sub ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_sub_ps ( a, b ); }
+static inline tVertexLanes lanes_mul ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_mul_ps ( a, b ); }
+static inline tVertexLanes lanes_div ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_div_ps ( a, b ); }
+static inline tVertexLanes lanes_sqrt ( const tVertexLanes &a ) { return _mm_sqrt_ps ( a ); }
+static inline tVertexLanes lanes_neg ( const tVertexLanes &a ) { return _mm_xor_ps ( a, _mm_set1_ps ( -0.f ) ); }
+static inline tVertexLanes lanes_and ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_and_ps ( a, b ); }
+static inline tVertexLanes lanes_or ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_or_ps ( a, b ); }
+// mask ? bit : 0 as integer
+static inline tVertexLanes lanes_bit ( const tVertexLanes &mask, const s32 bit ) { return _mm_and_ps ( mask, _mm_castsi128_ps ( _mm_set1_epi32 ( bit ) ) ); }
+// a <= b
+static inline tVertexLanes lanes_lessEqual ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_cmple_ps ( a, b ); }
+// !( a < b )
+static inline tVertexLanes lanes_notLess ( const tVertexLanes &a, const tVertexLanes &b ) { return _mm_cmpnlt_ps ( a, b ); }
+// mask ? a : b
+static inline tVertexLanes lanes_select ( const tVertexLanes &mask, const tVertexLanes &a, const tVertexLanes &b ) { return _mm_or_ps ( _mm_and_ps ( mask, a ), _mm_andnot_ps ( mask, b ) ); }
+static inline u32 lanes_mask ( const tVertexLanes &mask ) { return (u32) _mm_movemask_ps ( mask ); }
+
+#endif
+
+// a.x * b.x + a.y * b.y + a.z * b.z
+static inline tVertexLanes lanes_dot ( const tVertexLanes &ax, const tVertexLanes &ay, const tVertexLanes &az,
+	const tVertexLanes &bx, const tVertexLanes &by, const tVertexLanes &bz )
+{
+	return lanes_add ( lanes_add ( lanes_mul ( ax, bx ), lanes_mul ( ay, by ) ), lanes_mul ( az, bz ) );
+}
+
+// row r of matrix4::rotateVect
+static inline tVertexLanes lanes_rotate ( const f32 *M, const u32 r, const tVertexLanes &x, const tVertexLanes &y, const tVertexLanes &z )
+{
+	return lanes_dot ( x, y, z, lanes_set ( M[r] ), lanes_set ( M[4 + r] ), lanes_set ( M[8 + r] ) );
+}
+
+// sVec4::normalize_xyz
+static inline void lanes_normalize ( tVertexLanes &x, tVertexLanes &y, tVertexLanes &z )
+{
+	const tVertexLanes l = lanes_div ( lanes_set ( 1.f ), lanes_sqrt ( lanes_dot ( x, y, z, x, y, z ) ) );
+	x = lanes_mul ( x, l );
+	y = lanes_mul ( y, l );
+	z = lanes_mul ( z, l );
+}
+
+#endif // _IRR_COMPILE_WITH_SSE2_
+
+
 //! constructor
 CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters& params, io::IFileSystem* io, video::IImagePresenter* presenter)
 : CNullDriver(io, params.WindowSize), BackBuffer(0), Presenter(presenter),
 	WindowId(0), SceneSourceRect(0),
-	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0),
-	 DepthBuffer(0), StencilBuffer ( 0 ),
+	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0), Binner(0),
+	 DepthBuffer(0), StencilBuffer ( 0 ), DepthCull ( false ),
 	 CurrentOut ( 16 * 2, 256 ), Temp ( 16 * 2, 256 )
 {
 	#ifdef _DEBUG
@@ -58,38 +151,8 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 	DriverAttributes->setAttribute("Version", 49);
 
 	// create triangle renderers
-
-	irr::memset32 ( BurningShader, 0, sizeof ( BurningShader ) );
-	//BurningShader[ETR_FLAT] = createTRFlat2(DepthBuffer);
-	//BurningShader[ETR_FLAT_WIRE] = createTRFlatWire2(DepthBuffer);
-	BurningShader[ETR_GOURAUD] = createTriangleRendererGouraud2(this);
-	BurningShader[ETR_GOURAUD_ALPHA] = createTriangleRendererGouraudAlpha2(this );
-	BurningShader[ETR_GOURAUD_ALPHA_NOZ] = createTRGouraudAlphaNoZ2(this );
-	//BurningShader[ETR_GOURAUD_WIRE] = createTriangleRendererGouraudWire2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT] = createTriangleRendererTextureFlat2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT_WIRE] = createTriangleRendererTextureFlatWire2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD] = createTriangleRendererTextureGouraud2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M1] = createTriangleRendererTextureLightMap2_M1(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M2] = createTriangleRendererTextureLightMap2_M2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M4] = createTriangleRendererGTextureLightMap2_M4(this);
-	BurningShader[ETR_TEXTURE_LIGHTMAP_M4] = createTriangleRendererTextureLightMap2_M4(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD] = createTriangleRendererTextureLightMap2_Add(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_DETAIL_MAP] = createTriangleRendererTextureDetailMap2(this);
-
-	BurningShader[ETR_TEXTURE_GOURAUD_WIRE] = createTriangleRendererTextureGouraudWire2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_NOZ] = createTRTextureGouraudNoZ2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD] = createTRTextureGouraudAdd2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD_NO_Z] = createTRTextureGouraudAddNoZ2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_VERTEX_ALPHA] = createTriangleRendererTextureVertexAlpha2 ( this );
-
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA] = createTRTextureGouraudAlpha(this );
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA_NOZ] = createTRTextureGouraudAlphaNoZ( this );
-
-	BurningShader[ETR_NORMAL_MAP_SOLID] = createTRNormalMap ( this );
-	BurningShader[ETR_STENCIL_SHADOW] = createTRStencilShadow ( this );
-	BurningShader[ETR_TEXTURE_BLEND] = createTRTextureBlend( this );
-
-	BurningShader[ETR_REFERENCE] = createTriangleRendererReference ( this );
+	for ( u32 i = 0; i != ETR2_COUNT; ++i )
+		BurningShader[i] = createShader ( (EBurningFFShader) i );
 
 
 	// add the same renderer for all solid types
@@ -141,6 +204,9 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 //! destructor
 CBurningVideoDriver::~CBurningVideoDriver()
 {
+	if (Binner)
+		Binner->drop();
+
 	// delete Backbuffer
 	if (BackBuffer)
 		BackBuffer->drop();
@@ -168,6 +234,46 @@ CBurningVideoDriver::~CBurningVideoDriver()
 }
 
 
+//! creates a triangle renderer, 0 if there is none for the type
+IBurningShader* CBurningVideoDriver::createShader(EBurningFFShader shader)
+{
+	switch ( shader )
+	{
+		//case ETR_FLAT: return createTRFlat2(DepthBuffer);
+		//case ETR_FLAT_WIRE: return createTRFlatWire2(DepthBuffer);
+		case ETR_GOURAUD: return createTriangleRendererGouraud2(this);
+		case ETR_GOURAUD_ALPHA: return createTriangleRendererGouraudAlpha2(this );
+		case ETR_GOURAUD_ALPHA_NOZ: return createTRGouraudAlphaNoZ2(this );
+		//case ETR_GOURAUD_WIRE: return createTriangleRendererGouraudWire2(DepthBuffer);
+		//case ETR_TEXTURE_FLAT: return createTriangleRendererTextureFlat2(DepthBuffer);
+		//case ETR_TEXTURE_FLAT_WIRE: return createTriangleRendererTextureFlatWire2(DepthBuffer);
+		case ETR_TEXTURE_GOURAUD: return createTriangleRendererTextureGouraud2(this);
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_M1: return createTriangleRendererTextureLightMap2_M1(this);
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_M2: return createTriangleRendererTextureLightMap2_M2(this);
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_M4: return createTriangleRendererGTextureLightMap2_M4(this);
+		case ETR_TEXTURE_LIGHTMAP_M4: return createTriangleRendererTextureLightMap2_M4(this);
+		case ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD: return createTriangleRendererTextureLightMap2_Add(this);
+		case ETR_TEXTURE_GOURAUD_DETAIL_MAP: return createTriangleRendererTextureDetailMap2(this);
+
+		case ETR_TEXTURE_GOURAUD_WIRE: return createTriangleRendererTextureGouraudWire2(this);
+		case ETR_TEXTURE_GOURAUD_NOZ: return createTRTextureGouraudNoZ2(this);
+		case ETR_TEXTURE_GOURAUD_ADD: return createTRTextureGouraudAdd2(this);
+		case ETR_TEXTURE_GOURAUD_ADD_NO_Z: return createTRTextureGouraudAddNoZ2(this);
+		case ETR_TEXTURE_GOURAUD_VERTEX_ALPHA: return createTriangleRendererTextureVertexAlpha2 ( this );
+
+		case ETR_TEXTURE_GOURAUD_ALPHA: return createTRTextureGouraudAlpha(this );
+		case ETR_TEXTURE_GOURAUD_ALPHA_NOZ: return createTRTextureGouraudAlphaNoZ( this );
+
+		case ETR_NORMAL_MAP_SOLID: return createTRNormalMap ( this );
+		case ETR_STENCIL_SHADOW: return createTRStencilShadow ( this );
+		case ETR_TEXTURE_BLEND: return createTRTextureBlend( this );
+
+		case ETR_REFERENCE: return createTriangleRendererReference ( this );
+		default: return 0;
+	}
+}
+
+
 /*!
 	selects the right triangle renderer based on the render states.
 */
@@ -280,6 +386,29 @@ void CBurningVideoDriver::setCurrentShader()
 
 	// switchToTriangleRenderer
 	CurrentShader = BurningShader[shader];
+
+	// the shaders without depth test and lines can't be culled by the depth tiles
+	switch ( shader )
+	{
+		case ETR_TEXTURE_GOURAUD_NOZ:
+		case ETR_GOURAUD_ALPHA_NOZ:
+		case ETR_TEXTURE_GOURAUD_WIRE:
+		case ETR_STENCIL_SHADOW:
+		case ETR_REFERENCE:
+			DepthCull = false;
+			break;
+		default:
+			DepthCull = true;
+			break;
+	}
+
+	// lines can't be restricted to the bands of the raster threads
+	if ( CurrentShader && Binner && shader != ETR_TEXTURE_GOURAUD_WIRE )
+	{
+		Binner->setShader ( shader, CurrentShader );
+		CurrentShader = Binner;
+	}
+
 	if ( CurrentShader )
 	{
 		CurrentShader->setZCompareFunc ( Material.org.ZBuffer );
@@ -404,6 +533,8 @@ bool CBurningVideoDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clear
 
 bool CBurningVideoDriver::endScene()
 {
+	flushBinner();
+
 	CNullDriver::endScene();
 
 	return Presenter->present(BackBuffer, WindowId, SceneSourceRect);
@@ -442,6 +573,8 @@ bool CBurningVideoDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag
 //! sets a render target
 void CBurningVideoDriver::setRenderTargetImage(video::CImage* image)
 {
+	flushBinner();
+
 	if (RenderTargetSurface)
 		RenderTargetSurface->drop();
 
@@ -613,8 +746,10 @@ u32 CBurningVideoDriver::clipToHyperPlane ( s4DVertex * dest, const s4DVertex *
 
 		a = &source[ index ];
 
+		const f32 aDotPlane = a->Pos.dotProduct ( plane );
+
 		// current point inside
-		if ( a->Pos.dotProduct ( plane ) <= 0.f )
+		if ( aDotPlane <= 0.f )
 		{
 			// last point outside
 			if ( F32_GREATER_0 ( bDotPlane ) )
@@ -649,7 +784,8 @@ u32 CBurningVideoDriver::clipToHyperPlane ( s4DVertex * dest, const s4DVertex *
 			b = a;
 		}
 
-		bDotPlane = b->Pos.dotProduct ( plane );
+		// b is a or its copy
+		bDotPlane = aDotPlane;
 
 	}
 
@@ -873,303 +1009,450 @@ const SVSize CBurningVideoDriver::vSize[] =
 
 /*!
 	fill a cache line with transformed, light and clipp test triangles
+
+	The vertices are transformed, clip tested and lit together, with
+	_IRR_COMPILE_WITH_SSE2_ 4 and with _IRR_COMPILE_WITH_AVX_ 8 at once.
+	The remaining attributes are filled vertex by vertex.
 */
-void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 destIndex)
+void CBurningVideoDriver::VertexCache_fill ( const u32 *sourceIndex, const u32 *destIndex, const u32 count )
 {
-	u8 * source;
-	s4DVertex *dest;
+	const S3DVertex *bases[VERTEXCACHE_ELEMENT];
+	s4DVertex *dests[VERTEXCACHE_ELEMENT];
 
-	source = (u8*) VertexCache.vertices + ( sourceIndex * vSize[VertexCache.vType].Pitch );
-
-	// it's a look ahead so we never hit it..
-	// but give priority...
-	//VertexCache.info[ destIndex ].hit = hitCount;
+	for ( u32 i = 0; i != count; ++i )
+	{
+		// store info
+		VertexCache.info[ destIndex[i] ].index = sourceIndex[i];
+		VertexCache.info[ destIndex[i] ].hit = 0;
 
-	// store info
-	VertexCache.info[ destIndex ].index = sourceIndex;
-	VertexCache.info[ destIndex ].hit = 0;
+		bases[i] = (const S3DVertex*) ( (const u8*) VertexCache.vertices + ( sourceIndex[i] * vSize[VertexCache.vType].Pitch ) );
 
-	// destination Vertex
-	dest = (s4DVertex *) ( (u8*) VertexCache.mem.data + ( destIndex << ( SIZEOF_SVERTEX_LOG2 + 1  ) ) );
+		// destination Vertex
+		dests[i] = (s4DVertex *) ( (u8*) VertexCache.mem.data + ( destIndex[i] << ( SIZEOF_SVERTEX_LOG2 + 1  ) ) );
+	}
 
 	// transform Model * World * Camera * Projection * NDCSpace matrix
-	const S3DVertex *base = ((S3DVertex*) source );
-	Transformation [ ETS_CURRENT].transformVect ( &dest->Pos.x, base->Pos );
-
-	//mhm ;-) maybe no goto
-	if ( VertexCache.vType == 4 ) goto clipandproject;
-
-
-#if defined (SOFTWARE_DRIVER_2_LIGHTING) || defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
+	VertexBatch_transform ( bases, dests, count );
 
-	// vertex normal in light space
-	if ( Material.org.Lighting || (LightSpace.Flags & VERTEXTRANSFORM) )
+	if ( VertexCache.vType != 4 )
 	{
-		if ( TransformationFlag[ETS_WORLD] & ETF_IDENTITY )
-		{
-			LightSpace.normal.set ( base->Normal.X, base->Normal.Y, base->Normal.Z, 1.f );
-			LightSpace.vertex.set ( base->Pos.X, base->Pos.Y, base->Pos.Z, 1.f );
-		}
-		else
-		{
-			Transformation[ETS_WORLD].rotateVect ( &LightSpace.normal.x, base->Normal );
+#if defined (SOFTWARE_DRIVER_2_LIGHTING) || defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
+		if ( Material.org.Lighting || (LightSpace.Flags & VERTEXTRANSFORM) )
+			VertexBatch_lightSpace ( bases, count );
+#endif
 
-			// vertex in light space
-			if ( LightSpace.Flags & ( POINTLIGHT | FOG | SPECULAR | VERTEXTRANSFORM) )
-				Transformation[ETS_WORLD].transformVect ( &LightSpace.vertex.x, base->Pos );
-		}
+#if defined ( SOFTWARE_DRIVER_2_USE_VERTEX_COLOR ) && defined (SOFTWARE_DRIVER_2_LIGHTING)
+		// apply lighting model
+		if ( Material.org.Lighting )
+			VertexBatch_light ( bases, dests, count );
+#endif
+	}
 
-		if ( LightSpace.Flags & NORMALIZE )
-			LightSpace.normal.normalize_xyz();
+	for ( u32 i = 0; i != count; ++i )
+	{
+		const S3DVertex *base = bases[i];
+		s4DVertex *dest = dests[i];
+		const u8 *source = (const u8*) base;
 
-	}
+		//mhm ;-) maybe no goto
+		if ( VertexCache.vType == 4 ) goto clipandproject;
 
+#if defined (SOFTWARE_DRIVER_2_LIGHTING) || defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
+		// vertex normal and vertex in light space for texture generation and tangents
+		if ( Material.org.Lighting || (LightSpace.Flags & VERTEXTRANSFORM) )
+		{
+			LightSpace.normal.set ( VertexBatch.Normal[0][i], VertexBatch.Normal[1][i], VertexBatch.Normal[2][i], 1.f );
+			LightSpace.vertex.set ( VertexBatch.Vertex[0][i], VertexBatch.Vertex[1][i], VertexBatch.Vertex[2][i], 1.f );
+		}
 #endif
 
 #if defined ( SOFTWARE_DRIVER_2_USE_VERTEX_COLOR )
-	// apply lighting model
-	#if defined (SOFTWARE_DRIVER_2_LIGHTING)
-		if ( Material.org.Lighting )
-		{
-			lightVertex ( dest, base->Color.color );
-		}
-		else
-		{
+		// the lit colors are calculated for the batch
+		#if defined (SOFTWARE_DRIVER_2_LIGHTING)
+			if ( !Material.org.Lighting )
+			{
+				dest->Color[0].setA8R8G8B8 ( base->Color.color );
+			}
+		#else
 			dest->Color[0].setA8R8G8B8 ( base->Color.color );
-		}
-	#else
-		dest->Color[0].setA8R8G8B8 ( base->Color.color );
-	#endif
+		#endif
 #endif
 
-	// Texture Transform
+		// Texture Transform
 #if !defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
-	irr::memcpy32_small ( &dest->Tex[0],&base->TCoords,
-					vSize[VertexCache.vType].TexSize << 3 //  * ( sizeof ( f32 ) * 2 )
-				);
-#else
-
-	if ( 0 == (LightSpace.Flags & VERTEXTRANSFORM) )
-	{
 		irr::memcpy32_small ( &dest->Tex[0],&base->TCoords,
 						vSize[VertexCache.vType].TexSize << 3 //  * ( sizeof ( f32 ) * 2 )
 					);
-	}
-	else
-	{
-	/*
-			Generate texture coordinates as linear functions so that:
-				u = Ux*x + Uy*y + Uz*z + Uw
-				v = Vx*x + Vy*y + Vz*z + Vw
-			The matrix M for this case is:
-				Ux  Vx  0  0
-				Uy  Vy  0  0
-				Uz  Vz  0  0
-				Uw  Vw  0  0
-	*/
-
-		u32 t;
-		sVec4 n;
-		sVec2 srcT;
+#else
 
-		for ( t = 0; t != vSize[VertexCache.vType].TexSize; ++t )
+		if ( 0 == (LightSpace.Flags & VERTEXTRANSFORM) )
 		{
-			const core::matrix4& M = Transformation [ ETS_TEXTURE_0 + t ];
-
-			// texgen
-			if ( TransformationFlag [ ETS_TEXTURE_0 + t ] & (ETF_TEXGEN_CAMERA_NORMAL|ETF_TEXGEN_CAMERA_REFLECTION) )
+			irr::memcpy32_small ( &dest->Tex[0],&base->TCoords,
+							vSize[VertexCache.vType].TexSize << 3 //  * ( sizeof ( f32 ) * 2 )
+						);
+		}
+		else
+		{
+		/*
+				Generate texture coordinates as linear functions so that:
+					u = Ux*x + Uy*y + Uz*z + Uw
+					v = Vx*x + Vy*y + Vz*z + Vw
+				The matrix M for this case is:
+					Ux  Vx  0  0
+					Uy  Vy  0  0
+					Uz  Vz  0  0
+					Uw  Vw  0  0
+		*/
+
+			u32 t;
+			sVec4 n;
+			sVec2 srcT;
+
+			for ( t = 0; t != vSize[VertexCache.vType].TexSize; ++t )
 			{
-				n.x = LightSpace.campos.x - LightSpace.vertex.x;
-				n.y = LightSpace.campos.x - LightSpace.vertex.y;
-				n.z = LightSpace.campos.x - LightSpace.vertex.z;
-				n.normalize_xyz();
-				n.x += LightSpace.normal.x;
-				n.y += LightSpace.normal.y;
-				n.z += LightSpace.normal.z;
-				n.normalize_xyz();
-
-				const f32 *view = Transformation[ETS_VIEW].pointer();
-
-				if ( TransformationFlag [ ETS_TEXTURE_0 + t ] & ETF_TEXGEN_CAMERA_REFLECTION )
+				const core::matrix4& M = Transformation [ ETS_TEXTURE_0 + t ];
+
+				// texgen
+				if ( TransformationFlag [ ETS_TEXTURE_0 + t ] & (ETF_TEXGEN_CAMERA_NORMAL|ETF_TEXGEN_CAMERA_REFLECTION) )
 				{
-					srcT.x = 0.5f * ( 1.f + (n.x * view[0] + n.y * view[4] + n.z * view[8] ));
-					srcT.y = 0.5f * ( 1.f + (n.x * view[1] + n.y * view[5] + n.z * view[9] ));
+					n.x = LightSpace.campos.x - LightSpace.vertex.x;
+					n.y = LightSpace.campos.x - LightSpace.vertex.y;
+					n.z = LightSpace.campos.x - LightSpace.vertex.z;
+					n.normalize_xyz();
+					n.x += LightSpace.normal.x;
+					n.y += LightSpace.normal.y;
+					n.z += LightSpace.normal.z;
+					n.normalize_xyz();
+
+					const f32 *view = Transformation[ETS_VIEW].pointer();
+
+					if ( TransformationFlag [ ETS_TEXTURE_0 + t ] & ETF_TEXGEN_CAMERA_REFLECTION )
+					{
+						srcT.x = 0.5f * ( 1.f + (n.x * view[0] + n.y * view[4] + n.z * view[8] ));
+						srcT.y = 0.5f * ( 1.f + (n.x * view[1] + n.y * view[5] + n.z * view[9] ));
+					}
+					else
+					{
+						srcT.x = 0.5f * ( 1.f + (n.x * view[0] + n.y * view[1] + n.z * view[2] ));
+						srcT.y = 0.5f * ( 1.f + (n.x * view[4] + n.y * view[5] + n.z * view[6] ));
+					}
 				}
 				else
 				{
-					srcT.x = 0.5f * ( 1.f + (n.x * view[0] + n.y * view[1] + n.z * view[2] ));
-					srcT.y = 0.5f * ( 1.f + (n.x * view[4] + n.y * view[5] + n.z * view[6] ));
+					irr::memcpy32_small ( &srcT,(&base->TCoords) + t,
+						sizeof ( f32 ) * 2 );
 				}
-			}
-			else
-			{
-				irr::memcpy32_small ( &srcT,(&base->TCoords) + t,
-					sizeof ( f32 ) * 2 );
-			}
 
-			switch ( Material.org.TextureLayer[t].TextureWrapU )
-			{
-				case ETC_CLAMP:
-				case ETC_CLAMP_TO_EDGE:
-				case ETC_CLAMP_TO_BORDER:
-					dest->Tex[t].x = core::clamp ( (f32) ( M[0] * srcT.x + M[4] * srcT.y + M[8] ), 0.f, 1.f );
+				switch ( Material.org.TextureLayer[t].TextureWrapU )
+				{
+					case ETC_CLAMP:
+					case ETC_CLAMP_TO_EDGE:
+					case ETC_CLAMP_TO_BORDER:
+						dest->Tex[t].x = core::clamp ( (f32) ( M[0] * srcT.x + M[4] * srcT.y + M[8] ), 0.f, 1.f );
+						break;
+					case ETC_MIRROR:
+						dest->Tex[t].x = M[0] * srcT.x + M[4] * srcT.y + M[8];
+						if (core::fract(dest->Tex[t].x)>0.5f)
+							dest->Tex[t].x=1.f-dest->Tex[t].x;
 					break;
-				case ETC_MIRROR:
-					dest->Tex[t].x = M[0] * srcT.x + M[4] * srcT.y + M[8];
-					if (core::fract(dest->Tex[t].x)>0.5f)
-						dest->Tex[t].x=1.f-dest->Tex[t].x;
-				break;
-				case ETC_MIRROR_CLAMP:
-				case ETC_MIRROR_CLAMP_TO_EDGE:
-				case ETC_MIRROR_CLAMP_TO_BORDER:
-					dest->Tex[t].x = core::clamp ( (f32) ( M[0] * srcT.x + M[4] * srcT.y + M[8] ), 0.f, 1.f );
-					if (core::fract(dest->Tex[t].x)>0.5f)
-						dest->Tex[t].x=1.f-dest->Tex[t].x;
-				break;
-				case ETC_REPEAT:
-				default:
-					dest->Tex[t].x = M[0] * srcT.x + M[4] * srcT.y + M[8];
+					case ETC_MIRROR_CLAMP:
+					case ETC_MIRROR_CLAMP_TO_EDGE:
+					case ETC_MIRROR_CLAMP_TO_BORDER:
+						dest->Tex[t].x = core::clamp ( (f32) ( M[0] * srcT.x + M[4] * srcT.y + M[8] ), 0.f, 1.f );
+						if (core::fract(dest->Tex[t].x)>0.5f)
+							dest->Tex[t].x=1.f-dest->Tex[t].x;
 					break;
-			}
-			switch ( Material.org.TextureLayer[t].TextureWrapV )
-			{
-				case ETC_CLAMP:
-				case ETC_CLAMP_TO_EDGE:
-				case ETC_CLAMP_TO_BORDER:
-					dest->Tex[t].y = core::clamp ( (f32) ( M[1] * srcT.x + M[5] * srcT.y + M[9] ), 0.f, 1.f );
+					case ETC_REPEAT:
+					default:
+						dest->Tex[t].x = M[0] * srcT.x + M[4] * srcT.y + M[8];
+						break;
+				}
+				switch ( Material.org.TextureLayer[t].TextureWrapV )
+				{
+					case ETC_CLAMP:
+					case ETC_CLAMP_TO_EDGE:
+					case ETC_CLAMP_TO_BORDER:
+						dest->Tex[t].y = core::clamp ( (f32) ( M[1] * srcT.x + M[5] * srcT.y + M[9] ), 0.f, 1.f );
+						break;
+					case ETC_MIRROR:
+						dest->Tex[t].y = M[1] * srcT.x + M[5] * srcT.y + M[9];
+						if (core::fract(dest->Tex[t].y)>0.5f)
+							dest->Tex[t].y=1.f-dest->Tex[t].y;
 					break;
-				case ETC_MIRROR:
-					dest->Tex[t].y = M[1] * srcT.x + M[5] * srcT.y + M[9];
-					if (core::fract(dest->Tex[t].y)>0.5f)
-						dest->Tex[t].y=1.f-dest->Tex[t].y;
-				break;
-				case ETC_MIRROR_CLAMP:
-				case ETC_MIRROR_CLAMP_TO_EDGE:
-				case ETC_MIRROR_CLAMP_TO_BORDER:
-					dest->Tex[t].y = core::clamp ( (f32) ( M[1] * srcT.x + M[5] * srcT.y + M[9] ), 0.f, 1.f );
-					if (core::fract(dest->Tex[t].y)>0.5f)
-						dest->Tex[t].y=1.f-dest->Tex[t].y;
-				break;
-				case ETC_REPEAT:
-				default:
-					dest->Tex[t].y = M[1] * srcT.x + M[5] * srcT.y + M[9];
+					case ETC_MIRROR_CLAMP:
+					case ETC_MIRROR_CLAMP_TO_EDGE:
+					case ETC_MIRROR_CLAMP_TO_BORDER:
+						dest->Tex[t].y = core::clamp ( (f32) ( M[1] * srcT.x + M[5] * srcT.y + M[9] ), 0.f, 1.f );
+						if (core::fract(dest->Tex[t].y)>0.5f)
+							dest->Tex[t].y=1.f-dest->Tex[t].y;
 					break;
+					case ETC_REPEAT:
+					default:
+						dest->Tex[t].y = M[1] * srcT.x + M[5] * srcT.y + M[9];
+						break;
+				}
 			}
 		}
-	}
 
 #if 0
-	// tangent space light vector, emboss
-	if ( Lights.size () && ( vSize[VertexCache.vType].Format & VERTEX4D_FORMAT_BUMP_DOT3 ) )
-	{
-		const S3DVertexTangents *tangent = ((S3DVertexTangents*) source );
-		const SBurningShaderLight &light = LightSpace.Light[0];
+		// tangent space light vector, emboss
+		if ( Lights.size () && ( vSize[VertexCache.vType].Format & VERTEX4D_FORMAT_BUMP_DOT3 ) )
+		{
+			const S3DVertexTangents *tangent = ((S3DVertexTangents*) source );
+			const SBurningShaderLight &light = LightSpace.Light[0];
 
-		sVec4 vp;
+			sVec4 vp;
 
-		vp.x = light.pos.x - LightSpace.vertex.x;
-		vp.y = light.pos.y - LightSpace.vertex.y;
-		vp.z = light.pos.z - LightSpace.vertex.z;
+			vp.x = light.pos.x - LightSpace.vertex.x;
+			vp.y = light.pos.y - LightSpace.vertex.y;
+			vp.z = light.pos.z - LightSpace.vertex.z;
 
-		vp.normalize_xyz();
+			vp.normalize_xyz();
 
-		LightSpace.tangent.x = vp.x * tangent->Tangent.X + vp.y * tangent->Tangent.Y + vp.z * tangent->Tangent.Z;
-		LightSpace.tangent.y = vp.x * tangent->Binormal.X + vp.y * tangent->Binormal.Y + vp.z * tangent->Binormal.Z;
-		//LightSpace.tangent.z = vp.x * tangent->Normal.X + vp.y * tangent->Normal.Y + vp.z * tangent->Normal.Z;
-		LightSpace.tangent.z = 0.f;
-		LightSpace.tangent.normalize_xyz();
+			LightSpace.tangent.x = vp.x * tangent->Tangent.X + vp.y * tangent->Tangent.Y + vp.z * tangent->Tangent.Z;
+			LightSpace.tangent.y = vp.x * tangent->Binormal.X + vp.y * tangent->Binormal.Y + vp.z * tangent->Binormal.Z;
+			//LightSpace.tangent.z = vp.x * tangent->Normal.X + vp.y * tangent->Normal.Y + vp.z * tangent->Normal.Z;
+			LightSpace.tangent.z = 0.f;
+			LightSpace.tangent.normalize_xyz();
 
-		f32 scale = 1.f / 128.f;
-		if ( Material.org.MaterialTypeParam > 0.f )
-			scale = Material.org.MaterialTypeParam;
+			f32 scale = 1.f / 128.f;
+			if ( Material.org.MaterialTypeParam > 0.f )
+				scale = Material.org.MaterialTypeParam;
 
-		// emboss, shift coordinates
-		dest->Tex[1].x = dest->Tex[0].x + LightSpace.tangent.x * scale;
-		dest->Tex[1].y = dest->Tex[0].y + LightSpace.tangent.y * scale;
-		//dest->Tex[1].z = LightSpace.tangent.z * scale;
-	}
+			// emboss, shift coordinates
+			dest->Tex[1].x = dest->Tex[0].x + LightSpace.tangent.x * scale;
+			dest->Tex[1].y = dest->Tex[0].y + LightSpace.tangent.y * scale;
+			//dest->Tex[1].z = LightSpace.tangent.z * scale;
+		}
 #endif
 
-	if ( LightSpace.Light.size () && ( vSize[VertexCache.vType].Format & VERTEX4D_FORMAT_BUMP_DOT3 ) )
-	{
-		const S3DVertexTangents *tangent = ((S3DVertexTangents*) source );
+		if ( LightSpace.Light.size () && ( vSize[VertexCache.vType].Format & VERTEX4D_FORMAT_BUMP_DOT3 ) )
+		{
+			const S3DVertexTangents *tangent = ((S3DVertexTangents*) source );
 
-		sVec4 vp;
+			sVec4 vp;
 
-		dest->LightTangent[0].x = 0.f;
-		dest->LightTangent[0].y = 0.f;
-		dest->LightTangent[0].z = 0.f;
-		for ( u32 i = 0; i < 2 && i < LightSpace.Light.size (); ++i )
-		{
-			const SBurningShaderLight &light = LightSpace.Light[i];
+			dest->LightTangent[0].x = 0.f;
+			dest->LightTangent[0].y = 0.f;
+			dest->LightTangent[0].z = 0.f;
+			for ( u32 i = 0; i < 2 && i < LightSpace.Light.size (); ++i )
+			{
+				const SBurningShaderLight &light = LightSpace.Light[i];
 
-			if ( !light.LightIsOn )
-				continue;
+				if ( !light.LightIsOn )
+					continue;
 
-			vp.x = light.pos.x - LightSpace.vertex.x;
-			vp.y = light.pos.y - LightSpace.vertex.y;
-			vp.z = light.pos.z - LightSpace.vertex.z;
+				vp.x = light.pos.x - LightSpace.vertex.x;
+				vp.y = light.pos.y - LightSpace.vertex.y;
+				vp.z = light.pos.z - LightSpace.vertex.z;
 
-	/*
-			vp.x = light.pos_objectspace.x - base->Pos.X;
-			vp.y = light.pos_objectspace.y - base->Pos.Y;
-			vp.z = light.pos_objectspace.z - base->Pos.Z;
-	*/
+		/*
+				vp.x = light.pos_objectspace.x - base->Pos.X;
+				vp.y = light.pos_objectspace.y - base->Pos.Y;
+				vp.z = light.pos_objectspace.z - base->Pos.Z;
+		*/
 
-			vp.normalize_xyz();
+				vp.normalize_xyz();
 
 
-			// transform by tangent matrix
-			sVec3 l;
-	#if 1
-			l.x = (vp.x * tangent->Tangent.X + vp.y * tangent->Tangent.Y + vp.z * tangent->Tangent.Z );
-			l.y = (vp.x * tangent->Binormal.X + vp.y * tangent->Binormal.Y + vp.z * tangent->Binormal.Z );
-			l.z = (vp.x * tangent->Normal.X + vp.y * tangent->Normal.Y + vp.z * tangent->Normal.Z );
-	#else
-			l.x = (vp.x * tangent->Tangent.X + vp.y * tangent->Binormal.X + vp.z * tangent->Normal.X );
-			l.y = (vp.x * tangent->Tangent.Y + vp.y * tangent->Binormal.Y + vp.z * tangent->Normal.Y );
-			l.z = (vp.x * tangent->Tangent.Z + vp.y * tangent->Binormal.Z + vp.z * tangent->Normal.Z );
-	#endif
+				// transform by tangent matrix
+				sVec3 l;
+		#if 1
+				l.x = (vp.x * tangent->Tangent.X + vp.y * tangent->Tangent.Y + vp.z * tangent->Tangent.Z );
+				l.y = (vp.x * tangent->Binormal.X + vp.y * tangent->Binormal.Y + vp.z * tangent->Binormal.Z );
+				l.z = (vp.x * tangent->Normal.X + vp.y * tangent->Normal.Y + vp.z * tangent->Normal.Z );
+		#else
+				l.x = (vp.x * tangent->Tangent.X + vp.y * tangent->Binormal.X + vp.z * tangent->Normal.X );
+				l.y = (vp.x * tangent->Tangent.Y + vp.y * tangent->Binormal.Y + vp.z * tangent->Normal.Y );
+				l.z = (vp.x * tangent->Tangent.Z + vp.y * tangent->Binormal.Z + vp.z * tangent->Normal.Z );
+		#endif
 
 
-	/*
-			f32 scale = 1.f / 128.f;
-			scale /= dest->LightTangent[0].b;
+		/*
+				f32 scale = 1.f / 128.f;
+				scale /= dest->LightTangent[0].b;
+
+				// emboss, shift coordinates
+				dest->Tex[1].x = dest->Tex[0].x + l.r * scale;
+				dest->Tex[1].y = dest->Tex[0].y + l.g * scale;
+		*/
+				dest->Tex[1].x = dest->Tex[0].x;
+				dest->Tex[1].y = dest->Tex[0].y;
+
+				// scale bias
+				dest->LightTangent[0].x += l.x;
+				dest->LightTangent[0].y += l.y;
+				dest->LightTangent[0].z += l.z;
+			}
+			dest->LightTangent[0].setLength ( 0.5f );
+			dest->LightTangent[0].x += 0.5f;
+			dest->LightTangent[0].y += 0.5f;
+			dest->LightTangent[0].z += 0.5f;
+		}
 
-			// emboss, shift coordinates
-			dest->Tex[1].x = dest->Tex[0].x + l.r * scale;
-			dest->Tex[1].y = dest->Tex[0].y + l.g * scale;
-	*/
-			dest->Tex[1].x = dest->Tex[0].x;
-			dest->Tex[1].y = dest->Tex[0].y;
 
-			// scale bias
-			dest->LightTangent[0].x += l.x;
-			dest->LightTangent[0].y += l.y;
-			dest->LightTangent[0].z += l.z;
+#endif
+
+	clipandproject:
+		dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
+
+		// frustum test of the batch
+		dest[0].flag |= VertexBatch.Flag[i];
+
+		// to DC Space, project homogenous vertex
+		if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+		{
+			ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
 		}
-		dest->LightTangent[0].setLength ( 0.5f );
-		dest->LightTangent[0].x += 0.5f;
-		dest->LightTangent[0].y += 0.5f;
-		dest->LightTangent[0].z += 0.5f;
 	}
+}
+
+
+/*!
+	transform the positions of a batch to clip space and test them against the frustum
+*/
+void CBurningVideoDriver::VertexBatch_transform ( const S3DVertex **base, s4DVertex **dest, const u32 count )
+{
+#if defined ( BURNING_VERTEX_LANES )
+	const f32 *M = Transformation [ ETS_CURRENT].pointer();
 
+	// the lanes behind the last vertex are calculated for nothing
+	f32 in[3][VERTEXCACHE_ELEMENT];
+	f32 out[4][VERTEXCACHE_ELEMENT];
+	u32 i;
 
+	for ( i = 0; i != count; ++i )
+	{
+		in[0][i] = base[i]->Pos.X;
+		in[1][i] = base[i]->Pos.Y;
+		in[2][i] = base[i]->Pos.Z;
+	}
+	for ( ; i != VERTEXCACHE_ELEMENT; ++i )
+		in[0][i] = in[1][i] = in[2][i] = 0.f;
+
+	for ( i = 0; i < count; i += BURNING_VERTEX_LANES )
+	{
+		const tVertexLanes x = lanes_load ( in[0] + i );
+		const tVertexLanes y = lanes_load ( in[1] + i );
+		const tVertexLanes z = lanes_load ( in[2] + i );
+
+		tVertexLanes p[4];
+		for ( u32 r = 0; r != 4; ++r )
+		{
+			p[r] = lanes_add ( lanes_rotate ( M, r, x, y, z ), lanes_set ( M[12 + r] ) );
+			lanes_store ( out[r] + i, p[r] );
+		}
+
+		// same tests as clipToFrustumTest
+		tVertexLanes flag = lanes_bit ( lanes_lessEqual ( p[2], p[3] ), 1 );
+		flag = lanes_or ( flag, lanes_bit ( lanes_lessEqual ( lanes_neg ( p[2] ), p[3] ), 2 ) );
+		flag = lanes_or ( flag, lanes_bit ( lanes_lessEqual ( p[0], p[3] ), 4 ) );
+		flag = lanes_or ( flag, lanes_bit ( lanes_lessEqual ( lanes_neg ( p[0] ), p[3] ), 8 ) );
+		flag = lanes_or ( flag, lanes_bit ( lanes_lessEqual ( p[1], p[3] ), 16 ) );
+		flag = lanes_or ( flag, lanes_bit ( lanes_lessEqual ( lanes_neg ( p[1] ), p[3] ), 32 ) );
+		lanes_store ( (f32*) VertexBatch.Flag + i, flag );
+	}
+
+	for ( i = 0; i != count; ++i )
+		dest[i]->Pos.set ( out[0][i], out[1][i], out[2][i], out[3][i] );
+#else
+	for ( u32 i = 0; i != count; ++i )
+	{
+		Transformation [ ETS_CURRENT].transformVect ( &dest[i]->Pos.x, base[i]->Pos );
+		VertexBatch.Flag[i] = clipToFrustumTest ( dest[i] );
+	}
 #endif
+}
+
 
-clipandproject:
-	dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
+/*!
+	normal and vertex of a batch in light space
+*/
+void CBurningVideoDriver::VertexBatch_lightSpace ( const S3DVertex **base, const u32 count )
+{
+	f32 (*normal)[VERTEXCACHE_ELEMENT] = VertexBatch.Normal;
+	f32 (*vertex)[VERTEXCACHE_ELEMENT] = VertexBatch.Vertex;
+	const bool identity = ( TransformationFlag[ETS_WORLD] & ETF_IDENTITY ) != 0;
+	const bool normalize = ( LightSpace.Flags & NORMALIZE ) != 0;
+	u32 i;
 
-	// test vertex
-	dest[0].flag |= clipToFrustumTest ( dest);
+	for ( i = 0; i != count; ++i )
+	{
+		normal[0][i] = base[i]->Normal.X;
+		normal[1][i] = base[i]->Normal.Y;
+		normal[2][i] = base[i]->Normal.Z;
+		vertex[0][i] = base[i]->Pos.X;
+		vertex[1][i] = base[i]->Pos.Y;
+		vertex[2][i] = base[i]->Pos.Z;
+	}
 
-	// to DC Space, project homogenous vertex
-	if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+#if defined ( BURNING_VERTEX_LANES )
+	// the lanes behind the last vertex are calculated for nothing
+	for ( ; i != VERTEXCACHE_ELEMENT; ++i )
 	{
-		ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
+		normal[0][i] = normal[1][i] = normal[2][i] = 1.f;
+		vertex[0][i] = vertex[1][i] = vertex[2][i] = 0.f;
 	}
+#endif
+
+	if ( identity && !normalize )
+		return;
+
+#if defined ( BURNING_VERTEX_LANES )
+	const f32 *M = Transformation[ETS_WORLD].pointer();
+	for ( i = 0; i < count; i += BURNING_VERTEX_LANES )
+	{
+		tVertexLanes n[3];
+		tVertexLanes v[3];
+		u32 r;
+		for ( r = 0; r != 3; ++r )
+		{
+			n[r] = lanes_load ( normal[r] + i );
+			v[r] = lanes_load ( vertex[r] + i );
+		}
+
+		if ( !identity )
+		{
+			const tVertexLanes nx = n[0], ny = n[1], nz = n[2];
+			const tVertexLanes vx = v[0], vy = v[1], vz = v[2];
+			for ( r = 0; r != 3; ++r )
+			{
+				n[r] = lanes_rotate ( M, r, nx, ny, nz );
+				v[r] = lanes_add ( lanes_rotate ( M, r, vx, vy, vz ), lanes_set ( M[12 + r] ) );
+			}
+		}
+
+		if ( normalize )
+			lanes_normalize ( n[0], n[1], n[2] );
 
-	//return dest;
+		for ( r = 0; r != 3; ++r )
+		{
+			lanes_store ( normal[r] + i, n[r] );
+			lanes_store ( vertex[r] + i, v[r] );
+		}
+	}
+#else
+	const core::matrix4 &world = Transformation[ETS_WORLD];
+	for ( i = 0; i != count; ++i )
+	{
+		sVec4 n ( normal[0][i], normal[1][i], normal[2][i], 1.f );
+		sVec4 v ( vertex[0][i], vertex[1][i], vertex[2][i], 1.f );
+		if ( !identity )
+		{
+			world.rotateVect ( &n.x, base[i]->Normal );
+			world.transformVect ( &v.x, base[i]->Pos );
+		}
+		if ( normalize )
+			n.normalize_xyz();
+
+		normal[0][i] = n.x;
+		normal[1][i] = n.y;
+		normal[2][i] = n.z;
+		vertex[0][i] = v.x;
+		vertex[1][i] = v.y;
+		vertex[2][i] = v.z;
+	}
+#endif
 }
 
 //
@@ -1268,7 +1551,11 @@ REALINLINE void CBurningVideoDriver::VertexCache_get(const s4DVertex ** face)
 			}
 		}
 
-		// fill new
+		// fill new, all missing vertices at once
+		u32 fillSource[VERTEXCACHE_ELEMENT];
+		u32 fillDest[VERTEXCACHE_ELEMENT];
+		u32 fillCount = 0;
+
 		for ( i = 0; i!= fillIndex; ++i )
 		{
 			if ( info[i].hit != VERTEXCACHE_MISS )
@@ -1278,13 +1565,17 @@ REALINLINE void CBurningVideoDriver::VertexCache_get(const s4DVertex ** face)
 			{
 				if ( 0 == VertexCache.info[dIndex].hit )
 				{
-					VertexCache_fill ( info[i].index, dIndex );
+					fillSource[fillCount] = info[i].index;
+					fillDest[fillCount] = dIndex;
+					fillCount += 1;
 					VertexCache.info[dIndex].hit += 1;
 					info[i].hit = dIndex;
 					break;
 				}
 			}
 		}
+
+		VertexCache_fill ( fillSource, fillDest, fillCount );
 	}
 
 	const u32 i0 = core::if_c_a_else_0 ( VertexCache.pType != scene::EPT_TRIANGLE_FAN, VertexCache.indicesRun );
@@ -1327,22 +1618,26 @@ REALINLINE void CBurningVideoDriver::VertexCache_get(const s4DVertex ** face)
 REALINLINE void CBurningVideoDriver::VertexCache_getbypass ( s4DVertex ** face )
 {
 	const u32 i0 = core::if_c_a_else_0 ( VertexCache.pType != scene::EPT_TRIANGLE_FAN, VertexCache.indicesRun );
+	const u32 dest[3] = { 0, 1, 2 };
+	u32 source[3];
 
 	if ( VertexCache.iType == 1 )
 	{
 		const u16 *p = (const u16 *) VertexCache.indices;
-		VertexCache_fill ( p[ i0    ], 0 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 1], 1 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 2], 2 );
+		source[0] = p[ i0    ];
+		source[1] = p[ VertexCache.indicesRun + 1];
+		source[2] = p[ VertexCache.indicesRun + 2];
 	}
 	else
 	{
 		const u32 *p = (const u32 *) VertexCache.indices;
-		VertexCache_fill ( p[ i0    ], 0 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 1], 1 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 2], 2 );
+		source[0] = p[ i0    ];
+		source[1] = p[ VertexCache.indicesRun + 1];
+		source[2] = p[ VertexCache.indicesRun + 2];
 	}
 
+	VertexCache_fill ( source, dest, 3 );
+
 	VertexCache.indicesRun += VertexCache.primitivePitch;
 
 	face[0] = (s4DVertex *) ( (u8*) VertexCache.mem.data + ( 0 << ( SIZEOF_SVERTEX_LOG2 + 1  ) ) );
@@ -1455,6 +1750,9 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 	if ( 0 == CurrentShader )
 		return;
 
+	if ( CurrentShader != Binner )
+		flushBinner();
+
 	VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType, iType );
 
 	const s4DVertex * face[3];
@@ -1502,7 +1800,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			}
 
 			// rasterize
-			CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
+			rasterizeTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
 			continue;
 		}
 
@@ -1556,7 +1854,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 		for ( g = 0; g <= vOut - 6; g += 2 )
 		{
 			// rasterize
-			CurrentShader->drawTriangle ( CurrentOut.data + 0 + 1,
+			rasterizeTriangle ( CurrentOut.data + 0 + 1,
 							CurrentOut.data + g + 3,
 							CurrentOut.data + g + 5);
 		}
@@ -1575,6 +1873,28 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 }
 
+//! Draws a mesh buffer several times with different transformations and colors
+void CBurningVideoDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+		const SInstanceData* instances, u32 instanceCount)
+{
+	if (!mb || !instances || !instanceCount)
+		return;
+
+	// calls of this class only, the vertex cache and all states are set up
+	// for each instance without going through the virtual interface
+	const core::matrix4 world = Transformation[ETS_WORLD];
+	core::matrix4 instanceWorld;
+	for (u32 i=0; i<instanceCount; ++i)
+	{
+		instanceWorld.setbyproduct_nocheck(world, instances[i].Transformation);
+		CBurningVideoDriver::setTransform(ETS_WORLD, instanceWorld);
+		CBurningVideoDriver::drawVertexPrimitiveList(getInstanceVertices(mb, instances[i].Color),
+			mb->getVertexCount(), mb->getIndices(), mb->getPrimitiveCount(),
+			mb->getVertexType(), mb->getPrimitiveType(), mb->getIndexType());
+	}
+	CBurningVideoDriver::setTransform(ETS_WORLD, world);
+}
+
 
 //! Sets the dynamic ambient light color. The default color is
 //! (0,0,0,0) which means it is dark.
@@ -1631,6 +1951,7 @@ s32 CBurningVideoDriver::addDynamicLight(const SLight& dl)
 	}
 
 	LightSpace.Light.push_back ( l );
+	LightSpace.Flags |= LIGHTCHANGE;
 	return LightSpace.Light.size() - 1;
 }
 
@@ -1639,7 +1960,11 @@ void CBurningVideoDriver::turnLightOn(s32 lightIndex, bool turnOn)
 {
 	if(lightIndex > -1 && lightIndex < (s32)LightSpace.Light.size())
 	{
-		LightSpace.Light[lightIndex].LightIsOn = turnOn;
+		if ( LightSpace.Light[lightIndex].LightIsOn != turnOn )
+		{
+			LightSpace.Light[lightIndex].LightIsOn = turnOn;
+			LightSpace.Flags |= LIGHTCHANGE;
+		}
 	}
 }
 
@@ -1757,6 +2082,9 @@ void CBurningVideoDriver::lightVertex ( s4DVertex *dest, u32 vertexargb )
 		return;
 	}
 
+	// only visit the lights which are on, there may be many more
+	updateLightOn ();
+
 	sVec3 ambient;
 	sVec3 diffuse;
 	sVec3 specular;
@@ -1775,12 +2103,9 @@ void CBurningVideoDriver::lightVertex ( s4DVertex *dest, u32 vertexargb )
 	sVec4 vp;			// unit vector vertex to light
 	sVec4 lightHalf;	// blinn-phong reflection
 
-	for ( i = 0; i!= LightSpace.Light.size (); ++i )
+	for ( i = 0; i!= LightSpace.LightOn.size (); ++i )
 	{
-		const SBurningShaderLight &light = LightSpace.Light[i];
-
-		if ( !light.LightIsOn )
-			continue;
+		const SBurningShaderLight &light = LightSpace.Light[LightSpace.LightOn[i]];
 
 		// accumulate ambient
 		ambient.add ( light.AmbientColor );
@@ -1861,6 +2186,186 @@ void CBurningVideoDriver::lightVertex ( s4DVertex *dest, u32 vertexargb )
 	dColor.saturate ( dest->Color[0], vertexargb );
 }
 
+
+//! rebuild the indices of the lights which are turned on
+void CBurningVideoDriver::updateLightOn ()
+{
+	if ( 0 == (LightSpace.Flags & LIGHTCHANGE) )
+		return;
+
+	LightSpace.LightOn.set_used ( 0 );
+	for ( u32 l = 0; l != LightSpace.Light.size (); ++l )
+	{
+		if ( LightSpace.Light[l].LightIsOn )
+			LightSpace.LightOn.push_back ( l );
+	}
+	LightSpace.Flags &= ~LIGHTCHANGE;
+}
+
+
+/*!
+	light the vertices of a batch, the normals and vertices in light space are in VertexBatch.
+	Same calculations as lightVertex, the lights are skipped per lane.
+*/
+void CBurningVideoDriver::VertexBatch_light ( const S3DVertex **base, s4DVertex **dest, const u32 count )
+{
+	u32 i;
+
+#if defined ( BURNING_VERTEX_LANES )
+	sVec3 dColor;
+
+	dColor = LightSpace.Global_AmbientLight;
+	dColor.add ( Material.EmissiveColor );
+
+	if ( Lights.size () == 0 )
+	{
+		for ( i = 0; i != count; ++i )
+			dColor.saturate ( dest[i]->Color[0], base[i]->Color.color );
+		return;
+	}
+
+	updateLightOn ();
+
+	// ambient is the same for all vertices
+	sVec3 ambient;
+	ambient.set ( 0.f, 0.f, 0.f );
+	for ( u32 l = 0; l != LightSpace.LightOn.size (); ++l )
+		ambient.add ( LightSpace.Light[LightSpace.LightOn[l]].AmbientColor );
+
+	dColor.mulAdd ( ambient, Material.AmbientColor );
+
+	const f32 (*normal)[VERTEXCACHE_ELEMENT] = VertexBatch.Normal;
+	const f32 (*vertex)[VERTEXCACHE_ELEMENT] = VertexBatch.Vertex;
+	const tVertexLanes zero = lanes_set ( 0.f );
+
+	for ( i = 0; i < count; i += BURNING_VERTEX_LANES )
+	{
+		tVertexLanes n[3];
+		tVertexLanes v[3];
+		tVertexLanes diffuse[3];
+		tVertexLanes specular[3];
+		tVertexLanes lightHalf[3];
+		u32 c;
+
+		for ( c = 0; c != 3; ++c )
+		{
+			n[c] = lanes_load ( normal[c] + i );
+			v[c] = lanes_load ( vertex[c] + i );
+			diffuse[c] = zero;
+			specular[c] = zero;
+		}
+
+		// surface to view
+		if ( LightSpace.Flags & SPECULAR )
+		{
+			lightHalf[0] = lanes_sub ( lanes_set ( LightSpace.campos.x ), v[0] );
+			lightHalf[1] = lanes_sub ( lanes_set ( LightSpace.campos.y ), v[1] );
+			lightHalf[2] = lanes_sub ( lanes_set ( LightSpace.campos.z ), v[2] );
+			lanes_normalize ( lightHalf[0], lightHalf[1], lightHalf[2] );
+		}
+
+		for ( u32 l = 0; l != LightSpace.LightOn.size (); ++l )
+		{
+			const SBurningShaderLight &light = LightSpace.Light[LightSpace.LightOn[l]];
+
+			switch ( light.Type )
+			{
+				case video::ELT_SPOT:
+				case video::ELT_POINT:
+				{
+					// surface to light
+					tVertexLanes vp[3];
+					vp[0] = lanes_sub ( lanes_set ( light.pos.x ), v[0] );
+					vp[1] = lanes_sub ( lanes_set ( light.pos.y ), v[1] );
+					vp[2] = lanes_sub ( lanes_set ( light.pos.z ), v[2] );
+
+					tVertexLanes len = lanes_dot ( vp[0], vp[1], vp[2], vp[0], vp[1], vp[2] );
+					tVertexLanes lit = lanes_notLess ( lanes_set ( light.radius ), len );
+
+					len = lanes_div ( lanes_set ( 1.f ), lanes_sqrt ( len ) );
+
+					//angle between normal and light vector
+					for ( c = 0; c != 3; ++c )
+						vp[c] = lanes_mul ( vp[c], len );
+					tVertexLanes dot = lanes_dot ( n[0], n[1], n[2], vp[0], vp[1], vp[2] );
+					lit = lanes_and ( lit, lanes_notLess ( dot, zero ) );
+					if ( 0 == lanes_mask ( lit ) )
+						break;
+
+					const tVertexLanes attenuation = lanes_add ( lanes_set ( light.constantAttenuation ),
+						lanes_sub ( lanes_set ( 1.f ), lanes_mul ( len, lanes_set ( light.linearAttenuation ) ) ) );
+
+					// diffuse component
+					tVertexLanes f = lanes_mul ( lanes_mul ( lanes_set ( 3.f ), dot ), attenuation );
+					diffuse[0] = lanes_select ( lit, lanes_add ( diffuse[0], lanes_mul ( lanes_set ( light.DiffuseColor.r ), f ) ), diffuse[0] );
+					diffuse[1] = lanes_select ( lit, lanes_add ( diffuse[1], lanes_mul ( lanes_set ( light.DiffuseColor.g ), f ) ), diffuse[1] );
+					diffuse[2] = lanes_select ( lit, lanes_add ( diffuse[2], lanes_mul ( lanes_set ( light.DiffuseColor.b ), f ) ), diffuse[2] );
+
+					if ( !(LightSpace.Flags & SPECULAR) )
+						break;
+
+					// build specular
+					tVertexLanes h[3];
+					for ( c = 0; c != 3; ++c )
+						h[c] = lanes_add ( lightHalf[c], vp[c] );
+					lanes_normalize ( h[0], h[1], h[2] );
+
+					dot = lanes_dot ( n[0], n[1], n[2], h[0], h[1], h[2] );
+					lit = lanes_and ( lit, lanes_notLess ( dot, zero ) );
+
+					f = lanes_mul ( dot, attenuation );
+					specular[0] = lanes_select ( lit, lanes_add ( specular[0], lanes_mul ( lanes_set ( light.SpecularColor.r ), f ) ), specular[0] );
+					specular[1] = lanes_select ( lit, lanes_add ( specular[1], lanes_mul ( lanes_set ( light.SpecularColor.g ), f ) ), specular[1] );
+					specular[2] = lanes_select ( lit, lanes_add ( specular[2], lanes_mul ( lanes_set ( light.SpecularColor.b ), f ) ), specular[2] );
+				} break;
+
+				case video::ELT_DIRECTIONAL:
+				{
+					//angle between normal and light vector
+					const tVertexLanes dot = lanes_dot ( n[0], n[1], n[2],
+						lanes_set ( light.pos.x ), lanes_set ( light.pos.y ), lanes_set ( light.pos.z ) );
+					const tVertexLanes lit = lanes_notLess ( dot, zero );
+
+					// diffuse component
+					diffuse[0] = lanes_select ( lit, lanes_add ( diffuse[0], lanes_mul ( lanes_set ( light.DiffuseColor.r ), dot ) ), diffuse[0] );
+					diffuse[1] = lanes_select ( lit, lanes_add ( diffuse[1], lanes_mul ( lanes_set ( light.DiffuseColor.g ), dot ) ), diffuse[1] );
+					diffuse[2] = lanes_select ( lit, lanes_add ( diffuse[2], lanes_mul ( lanes_set ( light.DiffuseColor.b ), dot ) ), diffuse[2] );
+				} break;
+
+				default:
+					break;
+			}
+		}
+
+		// sum up lights
+		f32 color[3][BURNING_VERTEX_LANES];
+		const f32 *base3 = &dColor.r;
+		const f32 *diffuseMaterial = &Material.DiffuseColor.r;
+		const f32 *specularMaterial = &Material.SpecularColor.r;
+		for ( c = 0; c != 3; ++c )
+		{
+			tVertexLanes sum = lanes_add ( lanes_set ( base3[c] ), lanes_mul ( diffuse[c], lanes_set ( diffuseMaterial[c] ) ) );
+			sum = lanes_add ( sum, lanes_mul ( specular[c], lanes_set ( specularMaterial[c] ) ) );
+			lanes_store ( color[c], sum );
+		}
+
+		for ( u32 l = 0; l != BURNING_VERTEX_LANES && i + l != count; ++l )
+		{
+			sVec3 lit;
+			lit.set ( color[0][l], color[1][l], color[2][l] );
+			lit.saturate ( dest[i + l]->Color[0], base[i + l]->Color.color );
+		}
+	}
+#else
+	for ( i = 0; i != count; ++i )
+	{
+		LightSpace.normal.set ( VertexBatch.Normal[0][i], VertexBatch.Normal[1][i], VertexBatch.Normal[2][i], 1.f );
+		LightSpace.vertex.set ( VertexBatch.Vertex[0][i], VertexBatch.Vertex[1][i], VertexBatch.Vertex[2][i], 1.f );
+		lightVertex ( dest[i], base[i]->Color.color );
+	}
+#endif
+}
+
 #endif
 
 
@@ -1870,6 +2375,8 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 					 const core::rect<s32>* clipRect, SColor color,
 					 bool useAlphaChannelOfTexture)
 {
+	flushBinner();
+
 	if (texture)
 	{
 		if (texture->getDriverType() != EDT_BURNINGSVIDEO)
@@ -1908,6 +2415,8 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 		const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect,
 		const video::SColor* const colors, bool useAlphaChannelOfTexture)
 {
+	flushBinner();
+
 	if (texture)
 	{
 		if (texture->getDriverType() != EDT_BURNINGSVIDEO)
@@ -1930,6 +2439,7 @@ void CBurningVideoDriver::draw2DLine(const core::position2d<s32>& start,
 					const core::position2d<s32>& end,
 					SColor color)
 {
+	flushBinner();
 	drawLine(BackBuffer, start, end, color );
 }
 
@@ -1937,6 +2447,7 @@ void CBurningVideoDriver::draw2DLine(const core::position2d<s32>& start,
 //! Draws a pixel
 void CBurningVideoDriver::drawPixel(u32 x, u32 y, const SColor & color)
 {
+	flushBinner();
 	BackBuffer->setPixel(x, y, color, true);
 }
 
@@ -1945,6 +2456,8 @@ void CBurningVideoDriver::drawPixel(u32 x, u32 y, const SColor & color)
 void CBurningVideoDriver::draw2DRectangle(SColor color, const core::rect<s32>& pos,
 									 const core::rect<s32>* clip)
 {
+	flushBinner();
+
 	if (clip)
 	{
 		core::rect<s32> p(pos);
@@ -1970,6 +2483,8 @@ void CBurningVideoDriver::draw2DRectangle(SColor color, const core::rect<s32>& p
 //! the window was resized.
 void CBurningVideoDriver::OnResize(const core::dimension2d<u32>& size)
 {
+	flushBinner();
+
 	// make sure width and height are multiples of 2
 	core::dimension2d<u32> realSize(size);
 
@@ -2018,6 +2533,8 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 {
 #ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
 
+	flushBinner();
+
 	core::rect<s32> pos = position;
 
 	if (clip)
@@ -2128,6 +2645,8 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 void CBurningVideoDriver::draw3DLine(const core::vector3df& start,
 	const core::vector3df& end, SColor color)
 {
+	flushBinner();
+
 	Transformation [ ETS_CURRENT].transformVect ( &CurrentOut.data[0].Pos.x, start );
 	Transformation [ ETS_CURRENT].transformVect ( &CurrentOut.data[2].Pos.x, end );
 
@@ -2229,6 +2748,8 @@ ITexture* CBurningVideoDriver::addRenderTargetTexture(const core::dimension2d<u3
 
 void CBurningVideoDriver::clearBuffers(u16 flag, SColor color, f32 depth, u8 stencil)
 {
+	flushBinner();
+
 	if ((flag & ECBF_COLOR) && RenderTargetSurface)
 		RenderTargetSurface->fill(color);
 
@@ -2246,6 +2767,8 @@ IImage* CBurningVideoDriver::createScreenShot(video::ECOLOR_FORMAT format, video
 	if (target != video::ERT_FRAME_BUFFER)
 		return 0;
 
+	flushBinner();
+
 	if (BackBuffer)
 	{
 		IImage* tmp = createImage(BackBuffer->getColorFormat(), BackBuffer->getDimension());
@@ -2259,7 +2782,7 @@ IImage* CBurningVideoDriver::createScreenShot(video::ECOLOR_FORMAT format, video
 ITexture* CBurningVideoDriver::createDeviceDependentTexture(const io::path& name, IImage* image)
 {
 	CSoftwareTexture2* texture = new CSoftwareTexture2(image, name, (getTextureCreationFlag(ETCF_CREATE_MIP_MAPS) ? CSoftwareTexture2::GEN_MIPMAP : 0) |
-		(getTextureCreationFlag(ETCF_ALLOW_NON_POWER_2) ? 0 : CSoftwareTexture2::NP2_SIZE));
+		(getTextureCreationFlag(ETCF_ALLOW_NON_POWER_2) ? 0 : CSoftwareTexture2::NP2_SIZE), JobSystem);
 
 	return texture;
 }
@@ -2279,6 +2802,8 @@ u32 CBurningVideoDriver::getMaximalPrimitiveCount() const
 //! volume. Next use IVideoDriver::drawStencilShadow() to visualize the shadow.
 void CBurningVideoDriver::drawStencilShadowVolume(const core::array<core::vector3df>& triangles, bool zfail, u32 debugDataVisible)
 {
+	flushBinner();
+
 	const u32 count = triangles.size();
 	IBurningShader *shader = BurningShader [ ETR_STENCIL_SHADOW ];
 
@@ -2342,6 +2867,9 @@ void CBurningVideoDriver::drawStencilShadow(bool clearStencilBuffer, video::SCol
 {
 	if (!StencilBuffer)
 		return;
+
+	flushBinner();
+
 	// draw a shadow rectangle covering the entire screen using stencil buffer
 	const u32 h = RenderTargetSurface->getDimension().Height;
 	const u32 w = RenderTargetSurface->getDimension().Width;
@@ -2378,6 +2906,70 @@ bool CBurningVideoDriver::queryTextureFormat(ECOLOR_FORMAT format) const
 }
 
 
+//! draws a triangle of the current shader, skips the rows hidden by the depth tiles
+void CBurningVideoDriver::rasterizeTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c)
+{
+#ifdef SOFTWARE_DRIVER_2_USE_WBUFFER
+	if ( !DepthCull || 0 == DepthBuffer )
+	{
+		CurrentShader->drawTriangle ( a, b, c );
+		return;
+	}
+
+	// the scanlines of the shaders start at the pixel after the edges,
+	// one more pixel covers the rounding of the interpolated edges
+	core::rect<s32> area (
+		core::ceil32 ( core::min_ ( a->Pos.x, b->Pos.x, c->Pos.x ) ) - 1,
+		core::ceil32 ( core::min_ ( a->Pos.y, b->Pos.y, c->Pos.y ) ) - 1,
+		core::ceil32 ( core::max_ ( a->Pos.x, b->Pos.x, c->Pos.x ) ) + 1,
+		core::ceil32 ( core::max_ ( a->Pos.y, b->Pos.y, c->Pos.y ) ) + 1 );
+
+	// the interpolated w might be a bit larger than the one of the vertices
+	const f32 w = core::max_ ( a->Pos.w, b->Pos.w, c->Pos.w ) * ( 1.f + 1.f / 256.f );
+	if ( !DepthBuffer->clipToDepth ( area, w ) )
+		return;
+
+	DepthBuffer->invalidate ( area );
+
+	// the binner bins the triangle into its own bands
+	if ( CurrentShader == Binner )
+	{
+		CurrentShader->drawTriangle ( a, b, c );
+		return;
+	}
+
+	CurrentShader->setBand ( area.UpperLeftCorner.Y, area.LowerRightCorner.Y );
+	CurrentShader->drawTriangle ( a, b, c );
+	CurrentShader->setBand ( 0, 0x7fffffff );
+#else
+	CurrentShader->drawTriangle ( a, b, c );
+#endif
+}
+
+
+//! Set the job system used to split the work of the driver over threads.
+void CBurningVideoDriver::setJobSystem(IJobSystem* jobSystem)
+{
+	if (jobSystem == JobSystem)
+		return;
+
+	CNullDriver::setJobSystem(jobSystem);
+
+	if (Binner)
+	{
+		Binner->flush();
+		Binner->drop();
+		Binner = 0;
+	}
+
+	// rasterize on the worker threads
+	if (JobSystem && JobSystem->getWorkerCount())
+		Binner = new CBurningBinner(this, JobSystem);
+
+	setCurrentShader();
+}
+
+
 } // end namespace video
 } // end namespace irr
 
@@ -7,6 +7,7 @@
 
 #include "SoftwareDriver2_compile_config.h"
 #include "IBurningShader.h"
+#include "CBurningBinner.h"
 #include "CNullDriver.h"
 #include "CImage.h"
 #include "os.h"
@@ -83,6 +84,10 @@ namespace video
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType) _IRR_OVERRIDE_;
 
+		//! Draws a mesh buffer several times with different transformations and colors
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const SInstanceData* instances, u32 instanceCount) _IRR_OVERRIDE_;
+
 		//! draws an 2d image, using a color (if color is other then Color(255,255,255,255)) and the alpha channel of the texture if wanted.
 		virtual void draw2DImage(const video::ITexture* texture, const core::position2d<s32>& destPos,
 			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
@@ -164,9 +169,15 @@ namespace video
 		//! Check if the driver supports creating textures with the given color format
 		virtual bool queryTextureFormat(ECOLOR_FORMAT format) const _IRR_OVERRIDE_;
 
+		//! Set the job system used to split the work of the driver over threads.
+		virtual void setJobSystem(IJobSystem* jobSystem) _IRR_OVERRIDE_;
+
 		IDepthBuffer * getDepthBuffer () { return DepthBuffer; }
 		IStencilBuffer * getStencilBuffer () { return StencilBuffer; }
 
+		//! creates a triangle renderer, 0 if there is none for the type
+		IBurningShader* createShader(EBurningFFShader shader);
+
 	protected:
 
 		//! sets a render target
@@ -193,9 +204,25 @@ namespace video
 		IBurningShader* CurrentShader;
 		IBurningShader* BurningShader[ETR2_COUNT];
 
+		//! records the triangles for the raster threads, 0 without worker threads
+		CBurningBinner* Binner;
+
+		//! draws the triangles recorded by the binner
+		void flushBinner()
+		{
+			if (Binner)
+				Binner->flush();
+		}
+
 		IDepthBuffer* DepthBuffer;
 		IStencilBuffer* StencilBuffer;
 
+		//! the current shader only draws pixels which pass the depth test
+		bool DepthCull;
+
+		//! draws a triangle of the current shader, skips the rows hidden by the depth tiles
+		void rasterizeTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c);
+
 
 		/*
 			extend Matrix Stack
@@ -239,9 +266,15 @@ namespace video
 		void VertexCache_get ( const s4DVertex ** face );
 		void VertexCache_getbypass ( s4DVertex ** face );
 
-		void VertexCache_fill ( const u32 sourceIndex,const u32 destIndex );
+		void VertexCache_fill ( const u32 *sourceIndex, const u32 *destIndex, const u32 count );
 		s4DVertex * VertexCache_getVertex ( const u32 sourceIndex );
 
+		// batched vertex stage, works on all vertices of a cache line
+		SVertexBatch VertexBatch;
+
+		void VertexBatch_transform ( const S3DVertex **base, s4DVertex **dest, const u32 count );
+		void VertexBatch_lightSpace ( const S3DVertex **base, const u32 count );
+
 
 		// culling & clipping
 		u32 clipToHyperPlane ( s4DVertex * dest, const s4DVertex * source, u32 inCount, const sVec4 &plane );
@@ -252,6 +285,8 @@ namespace video
 #ifdef SOFTWARE_DRIVER_2_LIGHTING
 
 		void lightVertex ( s4DVertex *dest, u32 vertexargb );
+		void VertexBatch_light ( const S3DVertex **base, s4DVertex **dest, const u32 count );
+		void updateLightOn ();
 		//! Sets the fog mode.
 		virtual void setFog(SColor color, E_FOG_TYPE fogType, f32 start,
 			f32 end, f32 density, bool pixelFog, bool rangeFog) _IRR_OVERRIDE_;
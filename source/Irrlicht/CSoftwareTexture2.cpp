@@ -9,6 +9,7 @@
 #include "SoftwareDriver2_helper.h"
 #include "CSoftwareTexture2.h"
 #include "CSoftwareDriver2.h"
+#include "IJobSystem.h"
 #include "os.h"
 
 namespace irr
@@ -16,14 +17,49 @@ namespace irr
 namespace video
 {
 
+//! copies rows of texels into tiles of texels
+static void copyToTiles(u8* dst, const u8* src, const core::dimension2d<u32>& size, u32 bytesPerTexel)
+{
+	const u32 tile = 1 << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2;
+	for (u32 y = 0; y < size.Height; ++y)
+	{
+		const u32 row = ( y & ~(tile - 1) ) * size.Width + ( y & (tile - 1) ) * tile;
+		for (u32 x = 0; x < size.Width; x += tile)
+		{
+			memcpy(dst + ( row + ( x << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 ) ) * bytesPerTexel,
+				src + ( y * size.Width + x ) * bytesPerTexel, tile * bytesPerTexel);
+		}
+	}
+}
+
+//! copies tiles of texels into rows of texels
+static void copyFromTiles(u8* dst, const u8* src, const core::dimension2d<u32>& size, u32 bytesPerTexel)
+{
+	const u32 tile = 1 << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2;
+	for (u32 y = 0; y < size.Height; ++y)
+	{
+		const u32 row = ( y & ~(tile - 1) ) * size.Width + ( y & (tile - 1) ) * tile;
+		for (u32 x = 0; x < size.Width; x += tile)
+		{
+			memcpy(dst + ( y * size.Width + x ) * bytesPerTexel,
+				src + ( row + ( x << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 ) ) * bytesPerTexel, tile * bytesPerTexel);
+		}
+	}
+}
+
+
 //! constructor
-CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name, u32 flags)
-	: ITexture(name, ETT_2D), MipMapLOD(0), Flags ( flags ), OriginalFormat(video::ECF_UNKNOWN)
+CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name, u32 flags, IJobSystem* jobSystem)
+	: ITexture(name, ETT_2D), TiledLevels(0), LockImage(0), LockLevel(0), LockReadOnly(true),
+	MipMapLOD(0), Flags ( flags ), OriginalFormat(video::ECF_UNKNOWN), JobSystem(jobSystem)
 {
 	#ifdef _DEBUG
 	setDebugName("CSoftwareTexture2");
 	#endif
 
+	if (JobSystem)
+		JobSystem->grab();
+
 #ifndef SOFTWARE_DRIVER_2_MIPMAPPING
 	Flags &= ~GEN_MIPMAP;
 #endif
@@ -85,6 +121,7 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name, u32 fl
 		HasMipMaps = (Flags & GEN_MIPMAP) != 0;
 
 		regenerateMipMapLevels(image->getMipMapsData());
+		storeTiled(0);
 	}
 }
 
@@ -97,6 +134,89 @@ CSoftwareTexture2::~CSoftwareTexture2()
 		if ( MipMap[i] )
 			MipMap[i]->drop();
 	}
+
+	if ( LockImage )
+		LockImage->drop();
+
+	if ( JobSystem )
+		JobSystem->drop();
+}
+
+
+//! lock function, returns the texels row by row
+void* CSoftwareTexture2::lock(E_TEXTURE_LOCK_MODE mode, u32 level, u32 layer)
+{
+	selectMipMapLevel(level);
+	LockReadOnly = mode == ETLM_READ_ONLY;
+
+	return getLinearImage(MipMapLOD)->getData();
+}
+
+
+//! unlock function, stores written texels in the layout of the level
+void CSoftwareTexture2::unlock()
+{
+	if ( !LockReadOnly && isTiled() && LockImage && LockLevel == MipMapLOD )
+	{
+		copyToTiles ( (u8*) MipMap[MipMapLOD]->getData(), (const u8*) LockImage->getData(),
+			LockImage->getDimension(), LockImage->getBytesPerPixel() );
+	}
+	LockReadOnly = true;
+}
+
+
+//! stores a mip map level in tiles of texels, if its size allows it
+void CSoftwareTexture2::storeTiled(u32 level)
+{
+	CImage* image = MipMap[level];
+	if ( !image )
+		return;
+
+	const core::dimension2d<u32>& size = image->getDimension();
+	const u32 tile = 1 << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2;
+
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_TILES
+	// render targets are drawn row by row, the shaders only wrap power of two sizes
+	const bool tiled = !(Flags & IS_RENDERTARGET) &&
+		size.Width >= tile && size.Height >= tile &&
+		( size.Width & ( size.Width - 1 ) ) == 0 && ( size.Height & ( size.Height - 1 ) ) == 0;
+#else
+	const bool tiled = false;
+#endif
+
+	if ( !tiled )
+	{
+		TiledLevels &= ~( 1 << level );
+		return;
+	}
+
+	MipMap[level] = new CImage ( image->getColorFormat(), size );
+	copyToTiles ( (u8*) MipMap[level]->getData(), (const u8*) image->getData(), size, image->getBytesPerPixel() );
+	TiledLevels |= 1 << level;
+	image->drop();
+}
+
+
+//! returns the texels of a mip map level row by row
+CImage* CSoftwareTexture2::getLinearImage(u32 level) const
+{
+	if ( !( ( TiledLevels >> level ) & 1 ) )
+		return MipMap[level];
+
+	if ( LockImage && LockLevel == level )
+		return LockImage;
+
+	const core::dimension2d<u32>& size = MipMap[level]->getDimension();
+	if ( !LockImage || LockImage->getDimension() != size )
+	{
+		if ( LockImage )
+			LockImage->drop();
+		LockImage = new CImage ( MipMap[level]->getColorFormat(), size );
+	}
+
+	copyFromTiles ( (u8*) LockImage->getData(), (const u8*) MipMap[level]->getData(), size, LockImage->getBytesPerPixel() );
+	LockLevel = level;
+	return LockImage;
 }
 
 
@@ -116,6 +236,13 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data, u32 layer)
 			MipMap[i]->drop();
 	}
 
+	// the converted rows of another level are replaced
+	if ( LockImage && LockLevel != 0 )
+	{
+		LockImage->drop();
+		LockImage = 0;
+	}
+
 	core::dimension2d<u32> newSize;
 	core::dimension2d<u32> origSize = Size;
 
@@ -154,14 +281,26 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data, u32 layer)
 			data = (u8*)data +origSize.getArea()*IImage::getBitsPerPixelFromFormat(OriginalFormat)/8;
 		}
 		else
-		{
 			MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
+	}
 
-			//static u32 color[] = { 0, 0xFFFF0000, 0xFF00FF00,0xFF0000FF,0xFFFFFF00,0xFFFF00FF,0xFF00FFFF,0xFF0F0F0F };
-			MipMap[i]->fill ( 0 );
-			MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0, false );
+	if (!data)
+	{
+		// all levels summed up from the full texture at once, the same pixels as scaling each of them down
+		CImage* source = getLinearImage(0);
+		if ( SOFTWARE_DRIVER_2_MIPMAPPING_SCALE != 1 || !source->copyToBoxMipMaps( MipMap + 1, SOFTWARE_DRIVER_2_MIPMAPPING_MAX - 1, JobSystem ) )
+		{
+			for ( i = 1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+			{
+				//static u32 color[] = { 0, 0xFFFF0000, 0xFF00FF00,0xFF0000FF,0xFFFFFF00,0xFFFF00FF,0xFF00FFFF,0xFF0F0F0F };
+				MipMap[i]->fill ( 0 );
+				source->copyToScalingBoxFilter( MipMap[i], 0, false );
+			}
 		}
 	}
+
+	for ( i = 1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+		storeTiled(i);
 }
 
 
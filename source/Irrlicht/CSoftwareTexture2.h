@@ -32,23 +32,13 @@ public:
 		IS_RENDERTARGET	= 2,
 		NP2_SIZE	= 4,
 	};
-	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags);
+	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags, IJobSystem* jobSystem = 0);
 
 	//! destructor
 	virtual ~CSoftwareTexture2();
 
-	//! lock function
-	virtual void* lock(E_TEXTURE_LOCK_MODE mode, u32 level, u32 layer)
-	{
-		if (Flags & GEN_MIPMAP)
-		{
-			MipMapLOD = level;
-			Size = MipMap[MipMapLOD]->getDimension();
-			Pitch = MipMap[MipMapLOD]->getPitch();
-		}
-
-		return MipMap[MipMapLOD]->getData();
-	}
+	//! lock function, returns the texels row by row
+	virtual void* lock(E_TEXTURE_LOCK_MODE mode, u32 level, u32 layer);
 
 	//! lock function
 	virtual void* lock(E_TEXTURE_LOCK_MODE mode = ETLM_READ_WRITE, u32 layer = 0) _IRR_OVERRIDE_
@@ -56,9 +46,20 @@ public:
 		return lock(mode, 0, layer);
 	}
 
-	//! unlock function
-	virtual void unlock() _IRR_OVERRIDE_
+	//! unlock function, stores written texels in the layout of the level
+	virtual void unlock() _IRR_OVERRIDE_;
+
+	//! selects a mip map level for the shaders, returns its texels as they are stored
+	void* getTexelData(u32 level)
 	{
+		selectMipMapLevel(level);
+		return MipMap[MipMapLOD]->getData();
+	}
+
+	//! true if the selected mip map level is stored in tiles of texels
+	bool isTiled() const
+	{
+		return ( TiledLevels >> MipMapLOD ) & 1;
 	}
 
 	//! Returns the size of the largest mipmap.
@@ -68,10 +69,10 @@ public:
 		//return MipMap[0]->getImageDataSizeInPixels () * texArea;
 	}
 
-	//! returns unoptimized surface
+	//! returns unoptimized surface, the texels row by row
 	virtual CImage* getImage() const
 	{
-		return MipMap[0];
+		return getLinearImage(0);
 	}
 
 	//! returns texture surface
@@ -83,13 +84,41 @@ public:
 	virtual void regenerateMipMapLevels(void* data = 0, u32 layer = 0) _IRR_OVERRIDE_;
 
 private:
+	//! selects the mip map level returned by lock and getTexelData
+	void selectMipMapLevel(u32 level)
+	{
+		if (Flags & GEN_MIPMAP)
+		{
+			MipMapLOD = level;
+			Size = MipMap[MipMapLOD]->getDimension();
+			Pitch = MipMap[MipMapLOD]->getPitch();
+		}
+	}
+
+	//! stores a mip map level in tiles of texels, if its size allows it
+	void storeTiled(u32 level);
+
+	//! returns the texels of a mip map level row by row
+	CImage* getLinearImage(u32 level) const;
+
 	f32 OrigImageDataSizeInPixels;
 
+	//! texels of the mip map levels as the shaders read them
 	CImage * MipMap[SOFTWARE_DRIVER_2_MIPMAPPING_MAX];
+	//! one bit for each level stored in tiles
+	u32 TiledLevels;
+
+	//! rows of a tiled level, converted on demand for lock and 2d drawing
+	mutable CImage* LockImage;
+	mutable u32 LockLevel;
+	bool LockReadOnly;
 
 	u32 MipMapLOD;
 	u32 Flags;
 	ECOLOR_FORMAT OriginalFormat;
+
+	//! threads halving large mip map levels, can be 0
+	IJobSystem* JobSystem;
 };
 
 /*!
@@ -0,0 +1,456 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CStaticBatcher.h"
+#include "IVideoDriver.h"
+#include "IMaterialRenderer.h"
+#include "CMeshBuffer.h"
+#include "irrMap.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Maximal number of vertices in one batch, so 16 bit indices can be used
+static const u32 MAX_BATCH_VERTICES = 65536;
+
+//! Range of indices in a batch, either of one node or of several visible nodes
+struct SBatchRange
+{
+	u32 Node;
+	u32 First;
+	u32 Count;
+};
+
+//! Draws the merged mesh buffers of one material in one grid cell.
+/** Not part of the scene graph, only registered for rendering. */
+class CStaticBatchSceneNode : public ISceneNode
+{
+public:
+
+	CStaticBatchSceneNode(ISceneManager* mgr, const video::SMaterial& material,
+			video::E_VERTEX_TYPE vertexType)
+		: ISceneNode(0, mgr, -1), Material(material), Buffer(0)
+	{
+		#ifdef _DEBUG
+		setDebugName("CStaticBatchSceneNode");
+		#endif
+
+		switch (vertexType)
+		{
+		case video::EVT_2TCOORDS:
+			Buffer = new SMeshBufferLightMap();
+			break;
+		case video::EVT_TANGENTS:
+			Buffer = new SMeshBufferTangents();
+			break;
+		default:
+			Buffer = new SMeshBuffer();
+			break;
+		}
+		Buffer->setHardwareMappingHint(EHM_STATIC);
+	}
+
+	virtual ~CStaticBatchSceneNode()
+	{
+		Buffer->drop();
+	}
+
+	virtual void render() _IRR_OVERRIDE_
+	{
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+		driver->setTransform(video::ETS_WORLD, core::IdentityMatrix);
+		driver->setMaterial(Material);
+
+		if (Runs.size() == 1 && Runs[0].Count == Buffer->getIndexCount())
+		{
+			driver->drawMeshBuffer(Buffer);
+			return;
+		}
+
+		for (u32 i=0; i<Runs.size(); ++i)
+		{
+			driver->drawVertexPrimitiveList(Buffer->getVertices(), Buffer->getVertexCount(),
+				Buffer->getIndices() + Runs[i].First, Runs[i].Count / 3,
+				Buffer->getVertexType(), EPT_TRIANGLES, video::EIT_16BIT);
+		}
+	}
+
+	virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_
+	{
+		return Box;
+	}
+
+	virtual u32 getMaterialCount() const _IRR_OVERRIDE_
+	{
+		return 1;
+	}
+
+	virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_
+	{
+		return Material;
+	}
+
+	//! Check if the buffer of a node with the given properties can be added
+	bool accepts(const video::SMaterial& material, video::E_VERTEX_TYPE vertexType, u32 vertexCount) const
+	{
+		return Buffer->getVertexType() == vertexType &&
+			Buffer->getVertexCount() + vertexCount <= MAX_BATCH_VERTICES &&
+			Material == material;
+	}
+
+	//! Adds a mesh buffer of the node with the given index in world space
+	void append(u32 node, const IMeshBuffer* mb, const core::matrix4& transform,
+			const core::matrix4& normalTransform)
+	{
+		const u32 first = Buffer->getIndexCount();
+
+		switch (Buffer->getVertexType())
+		{
+		case video::EVT_2TCOORDS:
+			appendBuffer(static_cast<SMeshBufferLightMap*>(Buffer), mb, transform, normalTransform);
+			break;
+		case video::EVT_TANGENTS:
+			appendBuffer(static_cast<SMeshBufferTangents*>(Buffer), mb, transform, normalTransform);
+			break;
+		default:
+			appendBuffer(static_cast<SMeshBuffer*>(Buffer), mb, transform, normalTransform);
+			break;
+		}
+
+		// buffers of the same node follow each other
+		const u32 count = Buffer->getIndexCount() - first;
+		if (!Ranges.empty() && Ranges.getLast().Node == node)
+			Ranges.getLast().Count += count;
+		else
+		{
+			SBatchRange range;
+			range.Node = node;
+			range.First = first;
+			range.Count = count;
+			Ranges.push_back(range);
+		}
+	}
+
+	//! Called after all buffers were added
+	void finish()
+	{
+		Buffer->recalculateBoundingBox();
+		Box = Buffer->getBoundingBox();
+	}
+
+	video::SMaterial Material;
+	//! Index ranges of the nodes in the buffer
+	core::array<SBatchRange> Ranges;
+	//! Index ranges drawn in the current frame
+	core::array<SBatchRange> Runs;
+
+private:
+
+	static void transformVertex(video::S3DVertex& v, const core::matrix4& transform,
+			const core::matrix4& normalTransform)
+	{
+		transform.transformVect(v.Pos);
+		normalTransform.rotateVect(v.Normal);
+		v.Normal.normalize();
+	}
+
+	static void transformVertex(video::S3DVertexTangents& v, const core::matrix4& transform,
+			const core::matrix4& normalTransform)
+	{
+		transform.transformVect(v.Pos);
+		normalTransform.rotateVect(v.Normal);
+		v.Normal.normalize();
+		transform.rotateVect(v.Tangent);
+		v.Tangent.normalize();
+		transform.rotateVect(v.Binormal);
+		v.Binormal.normalize();
+	}
+
+	template <class T>
+	static void appendBuffer(CMeshBuffer<T>* dst, const IMeshBuffer* src, const core::matrix4& transform,
+			const core::matrix4& normalTransform)
+	{
+		const u32 offset = dst->Vertices.size();
+		const u32 vertexCount = src->getVertexCount();
+		const T* vertices = static_cast<const T*>(src->getVertices());
+
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			T v = vertices[i];
+			transformVertex(v, transform, normalTransform);
+			dst->Vertices.push_back(v);
+		}
+
+		const u32 indexCount = src->getIndexCount();
+		if (src->getIndexType() == video::EIT_32BIT)
+		{
+			const u32* indices = reinterpret_cast<const u32*>(src->getIndices());
+			for (u32 i=0; i<indexCount; ++i)
+				dst->Indices.push_back((u16)(indices[i] + offset));
+		}
+		else
+		{
+			const u16* indices = src->getIndices();
+			for (u32 i=0; i<indexCount; ++i)
+				dst->Indices.push_back((u16)(indices[i] + offset));
+		}
+	}
+
+	core::aabbox3df Box;
+	IMeshBuffer* Buffer;
+};
+
+
+//! Material used for a mesh buffer of the node, like CMeshSceneNode::render does
+static inline const video::SMaterial& getBufferMaterial(IMeshSceneNode* node, const IMeshBuffer* mb, u32 index)
+{
+	if (node->isReadOnlyMaterials() || index >= node->getMaterialCount())
+		return mb->getMaterial();
+	return node->getMaterial(index);
+}
+
+//! Packs the grid cell containing a point into one integer
+static inline u64 getCellKey(const core::vector3df& p, f32 cellSize)
+{
+	const u64 x = (u64)(s64)floorf(p.X / cellSize) & 0x1fffff;
+	const u64 y = (u64)(s64)floorf(p.Y / cellSize) & 0x1fffff;
+	const u64 z = (u64)(s64)floorf(p.Z / cellSize) & 0x1fffff;
+	return (x << 42) | (y << 21) | z;
+}
+
+//! Index of the first node in the sorted array which isn't smaller than node
+static inline u32 lowerBound(const core::array<IMeshSceneNode*>& nodes, const IMeshSceneNode* node)
+{
+	u32 first = 0;
+	u32 count = nodes.size();
+	while (count)
+	{
+		const u32 step = count / 2;
+		if (nodes[first + step] < node)
+		{
+			first += step + 1;
+			count -= step + 1;
+		}
+		else
+			count = step;
+	}
+	return first;
+}
+
+//! Check if the node is still attached to the root of the scene
+static inline bool isInScene(const ISceneNode* node, const ISceneNode* root)
+{
+	while (node->getParent())
+		node = node->getParent();
+	return node == root;
+}
+
+
+CStaticBatcher::CStaticBatcher()
+	: CellSize(256.f), Dirty(false)
+{
+}
+
+
+CStaticBatcher::~CStaticBatcher()
+{
+	clear();
+}
+
+
+void CStaticBatcher::setBatched(IMeshSceneNode* node, bool batched)
+{
+	if (!node)
+		return;
+
+	const u32 index = lowerBound(Marked, node);
+	const bool found = index < Marked.size() && Marked[index] == node;
+	if (batched && !found)
+	{
+		node->grab();
+		Marked.insert(node, index);
+		Dirty = true;
+	}
+	else if (!batched && found)
+	{
+		Marked.erase(index);
+		node->drop();
+		Dirty = true;
+	}
+}
+
+
+bool CStaticBatcher::isBatched(const IMeshSceneNode* node) const
+{
+	const u32 index = lowerBound(Marked, node);
+	return index < Marked.size() && Marked[index] == node;
+}
+
+
+void CStaticBatcher::setCellSize(f32 size)
+{
+	if (size > 0.f && size != CellSize)
+	{
+		CellSize = size;
+		Dirty = true;
+	}
+}
+
+
+void CStaticBatcher::clear()
+{
+	clearBatches();
+	for (u32 i=0; i<Marked.size(); ++i)
+		Marked[i]->drop();
+	Marked.clear();
+	Dirty = false;
+}
+
+
+void CStaticBatcher::clearBatches()
+{
+	for (u32 i=0; i<Batches.size(); ++i)
+		Batches[i]->drop();
+	Batches.clear();
+	Batched.clear();
+}
+
+
+bool CStaticBatcher::canBatch(IMeshSceneNode* node, video::IVideoDriver* driver) const
+{
+	const IMesh* mesh = node->getMesh();
+	if (!mesh || node->isDebugDataVisible())
+		return false;
+
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		if (!mb || mb->getPrimitiveType() != EPT_TRIANGLES ||
+			mb->getVertexCount() > MAX_BATCH_VERTICES)
+			return false;
+
+		// transparent buffers have to be sorted with the other transparent nodes
+		const video::SMaterial& material = getBufferMaterial(node, mb, i);
+		const video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+		if ((rnd && rnd->isTransparent()) || material.isTransparent())
+			return false;
+	}
+
+	return true;
+}
+
+
+void CStaticBatcher::update(ISceneManager* smgr)
+{
+	if (!Dirty)
+		return;
+	Dirty = false;
+
+	clearBatches();
+
+	// forget nodes which were removed from the scene
+	const ISceneNode* root = smgr->getRootSceneNode();
+	for (u32 i=Marked.size(); i>0; --i)
+	{
+		if (!isInScene(Marked[i-1], root))
+		{
+			Marked[i-1]->drop();
+			Marked.erase(i-1);
+		}
+	}
+
+	video::IVideoDriver* driver = smgr->getVideoDriver();
+	for (u32 i=0; i<Marked.size(); ++i)
+	{
+		if (canBatch(Marked[i], driver))
+		{
+			SBatchedNode entry;
+			entry.Node = Marked[i];
+			entry.Visible = false;
+			Batched.push_back(entry);
+		}
+	}
+	// needed by binary_search in registerNode
+	Batched.sort();
+
+	// last batch created for each cell, older ones are chained by index
+	core::map<u64, u32> cellBatches;
+	core::array<u32> previousInCell;
+
+	for (u32 n=0; n<Batched.size(); ++n)
+	{
+		IMeshSceneNode* node = Batched[n].Node;
+		const IMesh* mesh = node->getMesh();
+		const core::matrix4& transform = node->getAbsoluteTransformation();
+		core::matrix4 normalTransform;
+		if (transform.getInverse(normalTransform))
+			normalTransform = normalTransform.getTransposed();
+		else
+			normalTransform = transform;
+
+		// all buffers of a node go into the same cell, so the node is culled as a whole
+		const u64 cell = getCellKey(node->getTransformedBoundingBox().getCenter(), CellSize);
+
+		for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+		{
+			const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			if (!mb->getIndexCount())
+				continue;
+			const video::SMaterial& material = getBufferMaterial(node, mb, i);
+
+			core::map<u64, u32>::Node* it = cellBatches.find(cell);
+			s32 batch = it ? (s32)it->getValue() : -1;
+			while (batch >= 0 && !Batches[batch]->accepts(material, mb->getVertexType(), mb->getVertexCount()))
+				batch = (s32)previousInCell[batch];
+
+			if (batch < 0)
+			{
+				batch = (s32)Batches.size();
+				Batches.push_back(new CStaticBatchSceneNode(smgr, material, mb->getVertexType()));
+				previousInCell.push_back(it ? it->getValue() : (u32)-1);
+				cellBatches.set(cell, (u32)batch);
+			}
+
+			Batches[batch]->append(n, mb, transform, normalTransform);
+		}
+	}
+
+	for (u32 i=0; i<Batches.size(); ++i)
+		Batches[i]->finish();
+}
+
+
+void CStaticBatcher::registerBatches(ISceneManager* smgr)
+{
+	for (u32 b=0; b<Batches.size(); ++b)
+	{
+		CStaticBatchSceneNode* batch = Batches[b];
+		batch->Runs.set_used(0);
+
+		// merge neighboring ranges of visible nodes
+		for (u32 i=0; i<batch->Ranges.size(); ++i)
+		{
+			const SBatchRange& range = batch->Ranges[i];
+			if (!Batched[range.Node].Visible)
+				continue;
+
+			if (!batch->Runs.empty() &&
+				batch->Runs.getLast().First + batch->Runs.getLast().Count == range.First)
+				batch->Runs.getLast().Count += range.Count;
+			else
+				batch->Runs.push_back(range);
+		}
+
+		if (!batch->Runs.empty())
+			smgr->registerNodeForRendering(batch, ESNRP_SOLID);
+	}
+
+	for (u32 i=0; i<Batched.size(); ++i)
+		Batched[i].Visible = false;
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,111 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_STATIC_BATCHER_H_INCLUDED__
+#define __C_STATIC_BATCHER_H_INCLUDED__
+
+#include "IMeshSceneNode.h"
+#include "ISceneManager.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+	class CStaticBatchSceneNode;
+
+	//! Draws static mesh scene nodes with equal materials from combined buffers.
+	/** Used by the scene manager. The mesh buffers of all marked nodes are
+	transformed to world space and merged into one buffer per material,
+	vertex type and cell of a regular grid. The cells keep the batches
+	small enough to be culled against the view frustum.
+	The nodes stay in the scene graph. When they register themselves for
+	the solid pass they are only flagged as visible, and each batch then
+	draws the index ranges of its visible nodes. Nodes with transparent
+	materials, visible debug data or meshes which can't be merged are
+	drawn on their own. */
+	class CStaticBatcher
+	{
+	public:
+
+		//! Constructor
+		CStaticBatcher();
+
+		//! Destructor
+		~CStaticBatcher();
+
+		//! Add or remove a node from the batches. Requests a rebuild.
+		void setBatched(IMeshSceneNode* node, bool batched);
+
+		//! Check if the node was marked for batching.
+		bool isBatched(const IMeshSceneNode* node) const;
+
+		//! Set the edge length of the grid cells.
+		void setCellSize(f32 size);
+
+		f32 getCellSize() const { return CellSize; }
+
+		//! Request a rebuild before the next use.
+		void setDirty() { Dirty = true; }
+
+		//! Drops all marked nodes and batches.
+		void clear();
+
+		//! Rebuilds the batches if needed.
+		/** The absolute transformations of all nodes must be up to date. */
+		void update(ISceneManager* smgr);
+
+		//! Called for each node registered for the solid pass.
+		/** \return True if the node is drawn by a batch and must not be drawn on its own. */
+		bool registerNode(const ISceneNode* node)
+		{
+			if (Batched.empty())
+				return false;
+			SBatchedNode key;
+			key.Node = (IMeshSceneNode*)node;
+			const s32 index = Batched.binary_search(key);
+			if (index < 0)
+				return false;
+			Batched[index].Visible = true;
+			return true;
+		}
+
+		//! Registers all batches with visible nodes for the solid pass.
+		void registerBatches(ISceneManager* smgr);
+
+		//! Get the number of batches.
+		u32 getBatchCount() const { return Batches.size(); }
+
+	private:
+
+		struct SBatchedNode
+		{
+			IMeshSceneNode* Node;
+			bool Visible;
+
+			bool operator < (const SBatchedNode& other) const
+			{
+				return Node < other.Node;
+			}
+		};
+
+		//! Check if all mesh buffers of a node can be put into batches
+		bool canBatch(IMeshSceneNode* node, video::IVideoDriver* driver) const;
+
+		//! Removes all batches
+		void clearBatches();
+
+		//! Marked nodes, kept sorted by pointer
+		core::array<IMeshSceneNode*> Marked;
+		//! Marked nodes which are drawn by batches, sorted by pointer
+		core::array<SBatchedNode> Batched;
+		core::array<CStaticBatchSceneNode*> Batches;
+		f32 CellSize;
+		bool Dirty;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
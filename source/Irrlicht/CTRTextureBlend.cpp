@@ -1499,6 +1499,60 @@ void CTRTextureBlend::fragment_dst_color_zero ()
 	switch ( ZCompare )
 	{
 	case 1:
+#ifdef SOFTWARE_DRIVER_2_SPAN_SIMD
+	{
+	sSpanLanes lanes;
+	tSpanFix sr0, sg0, sb0;
+	tSpanFix sr1, sg1, sb1;
+
+	for ( i = 0; i <= dx; i += BURNING_SPAN_LANES )
+	{
+		const u32 n = core::s32_min ( dx + 1 - i, BURNING_SPAN_LANES );
+
+		for ( u32 k = 0; k != BURNING_SPAN_LANES; ++k )
+		{
+			lanes.w[k] = line.w[0];
+			lanes.t[0][0][k] = line.t[0][0].x;
+			lanes.t[0][1][k] = line.t[0][0].y;
+#ifdef IPOL_C0
+			lanes.c[0][k] = line.c[0][0].y;
+			lanes.c[1][k] = line.c[0][0].z;
+			lanes.c[2][k] = line.c[0][0].w;
+#endif
+
+			line.w[0] += slopeW;
+			line.t[0][0] += slopeT[0];
+#ifdef IPOL_C0
+			line.c[0][0] += slopeC[0];
+#endif
+		}
+
+		const tSpanFloat w = span_load ( lanes.w );
+		const tSpanFix mask = span_depth_test ( z + i, w, n );
+		if ( 0 == span_bits ( mask ) )
+			continue;
+
+		span_store ( z + i, span_loadi ( lanes.w ), mask, n );
+
+		const tSpanFloat siw = span_inverse ( w );
+		span_sample_texture ( sr0, sg0, sb0, IT + 0,	span_tofix ( span_load ( lanes.t[0][0] ), siw ),
+														span_tofix ( span_load ( lanes.t[0][1] ), siw ) );
+		span_color_to_fix1 ( sr1, sg1, sb1, span_load_part ( dst + i, n ) );
+
+#ifdef IPOL_C0
+		span_store ( dst + i, span_fix_to_color (	span_imulFix ( span_imulFix ( sr0, sr1 ), span_tofix ( span_load ( lanes.c[0] ), siw ) ),
+													span_imulFix ( span_imulFix ( sg0, sg1 ), span_tofix ( span_load ( lanes.c[1] ), siw ) ),
+													span_imulFix ( span_imulFix ( sb0, sb1 ), span_tofix ( span_load ( lanes.c[2] ), siw ) )
+												), mask, n );
+#else
+		span_store ( dst + i, span_fix_to_color (	span_imulFix ( sr0, sr1 ),
+													span_imulFix ( sg0, sg1 ),
+													span_imulFix ( sb0, sb1 )
+												), mask, n );
+#endif
+	}
+	}
+#else
 	for ( i = 0; i <= dx; ++i )
 	{
 #ifdef CMP_W
@@ -1544,6 +1598,7 @@ void CTRTextureBlend::fragment_dst_color_zero ()
 		line.c[0][0] += slopeC[0];
 #endif
 	}
+#endif // SOFTWARE_DRIVER_2_SPAN_SIMD
 	break;
 
 	case 2:
@@ -2161,7 +2216,8 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 #endif
 
 			// render a scanline
-			(this->*fragmentShader) ();
+			if ( inBand ( line.y ) )
+				(this->*fragmentShader) ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -2321,7 +2377,8 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 #endif
 
 			// render a scanline
-			(this->*fragmentShader) ();
+			if ( inBand ( line.y ) )
+				(this->*fragmentShader) ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -190,6 +190,55 @@ void CTRTextureGouraud2::scanline_bilinear ()
 #endif
 
 
+#ifdef SOFTWARE_DRIVER_2_SPAN_SIMD
+	sSpanLanes lanes;
+	tSpanFix r0, g0, b0;
+
+	for ( s32 i = 0; i <= dx; i += BURNING_SPAN_LANES )
+	{
+		const u32 n = core::s32_min ( dx + 1 - i, BURNING_SPAN_LANES );
+
+		for ( u32 k = 0; k != BURNING_SPAN_LANES; ++k )
+		{
+			lanes.w[k] = line.w[0];
+			lanes.t[0][0][k] = line.t[0][0].x;
+			lanes.t[0][1][k] = line.t[0][0].y;
+#ifdef IPOL_C0
+			lanes.c[0][k] = line.c[0][0].y;
+			lanes.c[1][k] = line.c[0][0].z;
+			lanes.c[2][k] = line.c[0][0].w;
+#endif
+
+			line.w[0] += slopeW;
+#ifdef IPOL_C0
+			line.c[0][0] += slopeC;
+#endif
+			line.t[0][0] += slopeT[0];
+		}
+
+		const tSpanFloat w = span_load ( lanes.w );
+		const tSpanFix mask = span_depth_test ( z + i, w, n );
+		if ( 0 == span_bits ( mask ) )
+			continue;
+
+		span_store ( z + i, span_loadi ( lanes.w ), mask, n );
+
+		const tSpanFloat inversew = span_inverse ( w );
+		span_sample_texture ( r0, g0, b0, &IT[0],	span_tofix ( span_load ( lanes.t[0][0] ), inversew ),
+													span_tofix ( span_load ( lanes.t[0][1] ), inversew ) );
+
+#ifdef IPOL_C0
+		span_store ( dst + i, span_fix_to_color (	span_imulFix ( r0, span_tofix ( span_load ( lanes.c[0] ), inversew ) ),
+													span_imulFix ( g0, span_tofix ( span_load ( lanes.c[1] ), inversew ) ),
+													span_imulFix ( b0, span_tofix ( span_load ( lanes.c[2] ), inversew ) )
+												), mask, n );
+#else
+		span_store ( dst + i, span_fix_to_color ( r0, g0, b0 ), mask, n );
+#endif
+	}
+
+#else
+
 	f32 inversew = FIX_POINT_F32_MUL;
 
 	tFixPoint tx0;
@@ -279,6 +328,7 @@ void CTRTextureGouraud2::scanline_bilinear ()
 #endif
 	}
 
+#endif // SOFTWARE_DRIVER_2_SPAN_SIMD
 }
 
 void CTRTextureGouraud2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c )
@@ -449,7 +499,8 @@ void CTRTextureGouraud2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,co
 #endif
 
 			// render a scanline
-			scanline_bilinear ();
+			if ( inBand ( line.y ) )
+				scanline_bilinear ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -609,7 +660,8 @@ void CTRTextureGouraud2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,co
 #endif
 
 			// render a scanline
-			scanline_bilinear ( );
+			if ( inBand ( line.y ) )
+				scanline_bilinear ( );
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
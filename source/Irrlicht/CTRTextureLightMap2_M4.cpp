@@ -185,6 +185,49 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_mag ()
 	line.t[1][0] += line.t[1][1] * a;
 
 
+#ifdef SOFTWARE_DRIVER_2_SPAN_SIMD
+	sSpanLanes lanes;
+	tSpanFix r0, g0, b0;
+	tSpanFix r1, g1, b1;
+
+	for ( ;i <= dx; i += BURNING_SPAN_LANES )
+	{
+		const u32 n = core::s32_min ( dx + 1 - i, BURNING_SPAN_LANES );
+
+		for ( u32 k = 0; k != BURNING_SPAN_LANES; ++k )
+		{
+			lanes.w[k] = line.w[0];
+			lanes.t[0][0][k] = line.t[0][0].x;
+			lanes.t[0][1][k] = line.t[0][0].y;
+			lanes.t[1][0][k] = line.t[1][0].x;
+			lanes.t[1][1][k] = line.t[1][0].y;
+
+			line.w[0] += line.w[1];
+			line.t[0][0] += line.t[0][1];
+			line.t[1][0] += line.t[1][1];
+		}
+
+		const tSpanFloat w = span_load ( lanes.w );
+		const tSpanFix mask = span_depth_test ( z + i, w, n );
+		if ( 0 == span_bits ( mask ) )
+			continue;
+
+		span_store ( z + i, span_loadi ( lanes.w ), mask, n );
+
+		const tSpanFloat inversew = span_inverse ( w );
+		span_sample_texture ( r0, g0, b0, &IT[0],	span_tofix ( span_load ( lanes.t[0][0] ), inversew ),
+										span_tofix ( span_load ( lanes.t[0][1] ), inversew ) );
+		span_sample_texture ( r1, g1, b1, &IT[1],	span_tofix ( span_load ( lanes.t[1][0] ), inversew ),
+										span_tofix ( span_load ( lanes.t[1][1] ), inversew ) );
+
+		span_store ( dst + i, span_fix_to_color (	span_clampfix_maxcolor ( span_imulFix_tex4 ( r0, r1 ) ),
+													span_clampfix_maxcolor ( span_imulFix_tex4 ( g0, g1 ) ),
+													span_clampfix_maxcolor ( span_imulFix_tex4 ( b0, b1 ) )
+												), mask, n );
+	}
+
+#else
+
 #ifdef BURNINGVIDEO_RENDERER_FAST
 	u32 dIndex = ( line.y & 3 ) << 2;
 
@@ -245,6 +288,7 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_mag ()
 		line.t[1][0] += line.t[1][1];
 	}
 
+#endif // SOFTWARE_DRIVER_2_SPAN_SIMD
 }
 
 
@@ -326,6 +370,49 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_min ()
 	line.t[1][0] += line.t[1][1] * a;
 
 
+#ifdef SOFTWARE_DRIVER_2_SPAN_SIMD
+	sSpanLanes lanes;
+	tSpanFix r0, g0, b0;
+	tSpanFix r1, g1, b1;
+
+	for ( ;i <= dx; i += BURNING_SPAN_LANES )
+	{
+		const u32 n = core::s32_min ( dx + 1 - i, BURNING_SPAN_LANES );
+
+		for ( u32 k = 0; k != BURNING_SPAN_LANES; ++k )
+		{
+			lanes.w[k] = line.w[0];
+			lanes.t[0][0][k] = line.t[0][0].x;
+			lanes.t[0][1][k] = line.t[0][0].y;
+			lanes.t[1][0][k] = line.t[1][0].x;
+			lanes.t[1][1][k] = line.t[1][0].y;
+
+			line.w[0] += line.w[1];
+			line.t[0][0] += line.t[0][1];
+			line.t[1][0] += line.t[1][1];
+		}
+
+		const tSpanFloat w = span_load ( lanes.w );
+		const tSpanFix mask = span_depth_test ( z + i, w, n );
+		if ( 0 == span_bits ( mask ) )
+			continue;
+
+		span_store ( z + i, span_loadi ( lanes.w ), mask, n );
+
+		const tSpanFloat inversew = span_inverse ( w );
+		span_texel_fix ( r0, g0, b0, &IT[0],	span_tofix ( span_load ( lanes.t[0][0] ), inversew ),
+										span_tofix ( span_load ( lanes.t[0][1] ), inversew ) );
+		span_texel_fix ( r1, g1, b1, &IT[1],	span_tofix ( span_load ( lanes.t[1][0] ), inversew ),
+										span_tofix ( span_load ( lanes.t[1][1] ), inversew ) );
+
+		span_store ( dst + i, span_fix_to_color (	span_clampfix_maxcolor ( span_imulFix_tex4 ( r0, r1 ) ),
+													span_clampfix_maxcolor ( span_imulFix_tex4 ( g0, g1 ) ),
+													span_clampfix_maxcolor ( span_imulFix_tex4 ( b0, b1 ) )
+												), mask, n );
+	}
+
+#else
+
 	tFixPoint r0, g0, b0;
 	tFixPoint r1, g1, b1;
 
@@ -367,6 +454,7 @@ REALINLINE void CTRTextureLightMap2_M4::scanline_bilinear2_min ()
 		line.t[1][0] += line.t[1][1];
 	}
 
+#endif // SOFTWARE_DRIVER_2_SPAN_SIMD
 }
 
 //#ifdef BURNINGVIDEO_RENDERER_FAST
@@ -550,7 +638,8 @@ void CTRTextureLightMap2_M4::drawTriangle_Min ( const s4DVertex *a,const s4DVert
 #endif
 
 			// render a scanline
-			scanline_bilinear2_min ();
+			if ( inBand ( line.y ) )
+				scanline_bilinear2_min ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -711,7 +800,8 @@ void CTRTextureLightMap2_M4::drawTriangle_Min ( const s4DVertex *a,const s4DVert
 #endif
 
 			// render a scanline
-			scanline_bilinear2_min ();
+			if ( inBand ( line.y ) )
+				scanline_bilinear2_min ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -924,7 +1014,8 @@ void CTRTextureLightMap2_M4::drawTriangle ( const s4DVertex *a,const s4DVertex *
 #endif
 
 			// render a scanline
-			scanline_bilinear2_mag ();
+			if ( inBand ( line.y ) )
+				scanline_bilinear2_mag ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
@@ -1085,7 +1176,8 @@ void CTRTextureLightMap2_M4::drawTriangle ( const s4DVertex *a,const s4DVertex *
 #endif
 
 			// render a scanline
-			scanline_bilinear2_mag ();
+			if ( inBand ( line.y ) )
+				scanline_bilinear2_mag ();
 
 			scan.x[0] += scan.slopeX[0];
 			scan.x[1] += scan.slopeX[1];
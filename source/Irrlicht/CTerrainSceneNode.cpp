@@ -558,11 +558,7 @@ namespace scene
 	}
 
 
-	//! Updates the scene nodes indices if the camera has moved or rotated by a certain
-	//! threshold, which can be changed using the SetCameraMovementDeltaThreshold and
-	//! SetCameraRotationDeltaThreshold functions. This also determines if a given patch
-	//! for the scene node is within the view frustum and if it's not the indices are not
-	//! generated for that patch.
+	//! Registers the node, the indices are updated in render() for the camera of each view
 	void CTerrainSceneNode::OnRegisterSceneNode()
 	{
 		if (!IsVisible || !SceneManager->getActiveCamera())
@@ -570,12 +566,9 @@ namespace scene
 
 		SceneManager->registerNodeForRendering(this);
 
-		preRenderCalculationsIfNeeded();
-
 		// Do Not call ISceneNode::OnRegisterSceneNode(), this node should have no children (luke: is this comment still true, as ISceneNode::OnRegisterSceneNode() is called?)
 
 		ISceneNode::OnRegisterSceneNode();
-		ForceRecalculation = false;
 	}
 
 	void CTerrainSceneNode::preRenderCalculationsIfNeeded()
@@ -731,7 +724,7 @@ namespace scene
 	}
 
 
-	//! Render the scene node
+	//! Render the scene node, with the indices for the active camera
 	void CTerrainSceneNode::render()
 	{
 		if (!IsVisible || !SceneManager->getActiveCamera())
@@ -740,6 +733,9 @@ namespace scene
 		if (!Mesh->getMeshBufferCount())
 			return;
 
+		preRenderCalculationsIfNeeded();
+		ForceRecalculation = false;
+
 		video::IVideoDriver* driver = SceneManager->getVideoDriver();
 
 		driver->setTransform (video::ETS_WORLD, core::IdentityMatrix);
@@ -111,14 +111,16 @@ namespace scene
 		//! \param newpos: Vector specifying how much to move each vertex of the scene node.
 		virtual void setPosition(const core::vector3df& newpos) _IRR_OVERRIDE_;
 
-		//! Updates the scene nodes indices if the camera has moved or rotated by a certain
-		//! threshold, which can be changed using the SetCameraMovementDeltaThreshold and
-		//! SetCameraRotationDeltaThreshold functions.  This also determines if a given patch
-		//! for the scene node is within the view frustum and if it's not the indices are not
-		//! generated for that patch.
+		//! Registers the node for rendering
 		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
 
 		//! Render the scene node
+		//! Updates the scene nodes indices first if the camera has moved or rotated by a certain
+		//! threshold, which can be changed using the SetCameraMovementDeltaThreshold and
+		//! SetCameraRotationDeltaThreshold functions.  This also determines if a given patch
+		//! for the scene node is within the view frustum and if it's not the indices are not
+		//! generated for that patch. Done here, as drawAll can render several views with
+		//! different cameras after registering the nodes once.
 		virtual void render() _IRR_OVERRIDE_;
 
 		//! Return the bounding box of the entire terrain.
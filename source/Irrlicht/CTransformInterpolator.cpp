@@ -0,0 +1,221 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTransformInterpolator.h"
+#include "ICameraSceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+//! Get the scale of a transformation, false if it is mirrored or degenerated
+bool getPositiveScale(const core::matrix4& m, core::vector3df& scale)
+{
+	// not matrix4::getScale(), it returns the diagonal of unrotated matrices with its sign
+	scale.set(core::vector3df(m[0], m[1], m[2]).getLength(),
+		core::vector3df(m[4], m[5], m[6]).getLength(),
+		core::vector3df(m[8], m[9], m[10]).getLength());
+	if (scale.X < core::ROUNDING_ERROR_f32 || scale.Y < core::ROUNDING_ERROR_f32 ||
+		scale.Z < core::ROUNDING_ERROR_f32)
+		return false;
+
+	const f32 determinant = m[0] * (m[5] * m[10] - m[6] * m[9]) -
+		m[1] * (m[4] * m[10] - m[6] * m[8]) +
+		m[2] * (m[4] * m[9] - m[5] * m[8]);
+	return determinant > 0.f;
+}
+
+//! Get the rotation of a transformation with a positive scale
+core::quaternion getRotation(const core::matrix4& m, const core::vector3df& scale)
+{
+	core::matrix4 rotation(m);
+	for (u32 i=0; i<3; ++i)
+	{
+		rotation[i] /= scale.X;
+		rotation[4 + i] /= scale.Y;
+		rotation[8 + i] /= scale.Z;
+	}
+	return core::quaternion(rotation);
+}
+
+} // end anonymous namespace
+
+
+CTransformInterpolator::CTransformInterpolator()
+	: Applied(false)
+{
+}
+
+
+CTransformInterpolator::~CTransformInterpolator()
+{
+	clear();
+}
+
+
+void CTransformInterpolator::capturePrevious(ISceneNode* root)
+{
+	clear();
+	collect(root);
+}
+
+
+void CTransformInterpolator::collect(ISceneNode* node)
+{
+	// invisible nodes aren't animated
+	if (!node->isVisible())
+		return;
+
+	node->grab();
+	Nodes.push_back(SNode());
+	SNode& entry = Nodes.getLast();
+	entry.Node = node;
+	entry.Previous = node->getAbsoluteTransformation();
+	if (node->getType() == ESNT_CAMERA)
+		entry.PreviousTarget = static_cast<ICameraSceneNode*>(node)->getTarget();
+
+	const ISceneNodeList& children = node->getChildren();
+	ISceneNodeList::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+		collect(*it);
+}
+
+
+void CTransformInterpolator::captureCurrent()
+{
+	u32 moved = 0;
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		SNode& entry = Nodes[i];
+		entry.Current = entry.Node->getAbsoluteTransformation();
+		if (entry.Node->getType() == ESNT_CAMERA)
+			entry.CurrentTarget = static_cast<ICameraSceneNode*>(entry.Node)->getTarget();
+
+		if (entry.Previous == entry.Current && entry.PreviousTarget == entry.CurrentTarget)
+			entry.Node->drop();
+		else
+		{
+			decompose(entry);
+			Nodes[moved++] = entry;
+		}
+	}
+	Nodes.set_used(moved);
+}
+
+
+void CTransformInterpolator::decompose(SNode& entry)
+{
+	entry.Decomposed = getPositiveScale(entry.Previous, entry.PreviousScale) &&
+		getPositiveScale(entry.Current, entry.CurrentScale);
+	if (!entry.Decomposed)
+		return;
+
+	entry.PreviousRotation = getRotation(entry.Previous, entry.PreviousScale);
+	entry.CurrentRotation = getRotation(entry.Current, entry.CurrentScale);
+
+	// like quaternion::slerp, the short way and linear for small angles
+	f32 cosAngle = entry.PreviousRotation.dotProduct(entry.CurrentRotation);
+	if (cosAngle < 0.f)
+	{
+		entry.PreviousRotation *= -1.f;
+		cosAngle = -cosAngle;
+	}
+	entry.Angle = 0.f;
+	entry.InvSinAngle = 0.f;
+	if (cosAngle <= 0.95f)
+	{
+		entry.Angle = acosf(cosAngle);
+		entry.InvSinAngle = core::reciprocal(sinf(entry.Angle));
+	}
+}
+
+
+void CTransformInterpolator::interpolate(const SNode& entry, f32 time, core::matrix4& result)
+{
+	if (!entry.Decomposed)
+	{
+		result = entry.Previous.interpolate(entry.Current, time);
+		return;
+	}
+
+	core::quaternion rotation;
+	if (entry.Angle > 0.f)
+		rotation = entry.PreviousRotation * (sinf(entry.Angle * (1.f - time)) * entry.InvSinAngle) +
+			entry.CurrentRotation * (sinf(entry.Angle * time) * entry.InvSinAngle);
+	else
+		rotation.lerp(entry.PreviousRotation, entry.CurrentRotation, time);
+
+	rotation.getMatrix(result, core::lerp(entry.Previous.getTranslation(), entry.Current.getTranslation(), time));
+
+	const core::vector3df scale(core::lerp(entry.PreviousScale, entry.CurrentScale, time));
+	for (u32 i=0; i<3; ++i)
+	{
+		result[i] *= scale.X;
+		result[4 + i] *= scale.Y;
+		result[8 + i] *= scale.Z;
+	}
+}
+
+
+void CTransformInterpolator::apply(f32 time)
+{
+	core::matrix4 transformation;
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		const SNode& entry = Nodes[i];
+		interpolate(entry, time, transformation);
+		entry.Node->setAbsoluteTransformation(transformation);
+
+		if (entry.Node->getType() == ESNT_CAMERA)
+		{
+			// without changing the rotation of the camera
+			ICameraSceneNode* camera = static_cast<ICameraSceneNode*>(entry.Node);
+			const bool bound = camera->getTargetAndRotationBinding();
+			camera->bindTargetAndRotation(false);
+			camera->setTarget(core::lerp(entry.PreviousTarget, entry.CurrentTarget, time));
+			camera->bindTargetAndRotation(bound);
+		}
+	}
+	Applied = true;
+}
+
+
+void CTransformInterpolator::restore()
+{
+	if (!Applied)
+		return;
+
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		const SNode& entry = Nodes[i];
+		entry.Node->setAbsoluteTransformation(entry.Current);
+
+		if (entry.Node->getType() == ESNT_CAMERA)
+		{
+			ICameraSceneNode* camera = static_cast<ICameraSceneNode*>(entry.Node);
+			const bool bound = camera->getTargetAndRotationBinding();
+			camera->bindTargetAndRotation(false);
+			camera->setTarget(entry.CurrentTarget);
+			camera->bindTargetAndRotation(bound);
+		}
+	}
+	Applied = false;
+}
+
+
+void CTransformInterpolator::clear()
+{
+	for (u32 i=0; i<Nodes.size(); ++i)
+		Nodes[i].Node->drop();
+	Nodes.set_used(0);
+	Applied = false;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
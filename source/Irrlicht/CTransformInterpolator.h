@@ -0,0 +1,90 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_TRANSFORM_INTERPOLATOR_H_INCLUDED__
+#define __C_TRANSFORM_INTERPOLATOR_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "irrArray.h"
+#include "quaternion.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Draws the scene between the last two steps of a fixed rate animation.
+	/** Used by the scene manager when ISceneManager::setAnimationTimeStep()
+	is set. The absolute transformations of all visible nodes are stored
+	before the last step of an update, afterwards only the nodes which moved
+	are kept. Translation and scale are interpolated linearly, rotations
+	spherically. The targets of camera nodes are interpolated as well. */
+	class CTransformInterpolator
+	{
+	public:
+
+		//! Constructor
+		CTransformInterpolator();
+
+		//! Destructor
+		~CTransformInterpolator();
+
+		//! Stores the absolute transformations of root and all visible nodes below it. Grabs the nodes.
+		void capturePrevious(ISceneNode* root);
+
+		//! Stores the new transformations and drops the nodes which didn't move.
+		void captureCurrent();
+
+		//! Sets the interpolated transformations.
+		/** \param time 0 for the previous transformations, 1 for the current ones. */
+		void apply(f32 time);
+
+		//! Sets the current transformations again after apply().
+		void restore();
+
+		//! Drops all nodes
+		void clear();
+
+		//! Get the number of nodes moved by the last step.
+		u32 getNodeCount() const { return Nodes.size(); }
+
+	private:
+
+		struct SNode
+		{
+			ISceneNode* Node;
+			core::matrix4 Previous;
+			core::matrix4 Current;
+			//! targets of camera nodes
+			core::vector3df PreviousTarget;
+			core::vector3df CurrentTarget;
+
+			//! the transformations split up by captureCurrent()
+			core::quaternion PreviousRotation;
+			core::quaternion CurrentRotation;
+			core::vector3df PreviousScale;
+			core::vector3df CurrentScale;
+			//! angle between the rotations and 1/sin of it, 0 to interpolate them linearly
+			f32 Angle;
+			f32 InvSinAngle;
+			//! mirrored or degenerated transformations are interpolated element by element
+			bool Decomposed;
+		};
+
+		void collect(ISceneNode* node);
+
+		//! splits up the transformations of a moved node
+		static void decompose(SNode& entry);
+
+		//! interpolates the transformations of a node
+		static void interpolate(const SNode& entry, f32 time, core::matrix4& result);
+
+		core::array<SNode> Nodes;
+		bool Applied;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
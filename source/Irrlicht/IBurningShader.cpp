@@ -36,6 +36,8 @@ namespace video
 		Driver = driver;
 		RenderTarget = 0;
 		ColorMask = COLOR_BRIGHT_WHITE;
+		BandStart = 0;
+		BandEnd = 0x7fffffff;
 		DepthBuffer = (CDepthBuffer*) driver->getDepthBuffer ();
 		if ( DepthBuffer )
 			DepthBuffer->grab();
@@ -100,8 +102,8 @@ namespace video
 			// select mignify and magnify ( lodLevel )
 			//SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS
 			it->lodLevel = lodLevel;
-			it->data = (tVideoSample*) it->Texture->lock(ETLM_READ_ONLY,
-				core::s32_clamp ( lodLevel + SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS, 0, SOFTWARE_DRIVER_2_MIPMAPPING_MAX - 1 ), 0);
+			it->data = (tVideoSample*) it->Texture->getTexelData(
+				core::s32_clamp ( lodLevel + SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS, 0, SOFTWARE_DRIVER_2_MIPMAPPING_MAX - 1 ) );
 
 			// prepare for optimal fixpoint
 			it->pitchlog2 = s32_log2_s32 ( it->Texture->getPitch() );
@@ -109,10 +111,49 @@ namespace video
 			const core::dimension2d<u32> &dim = it->Texture->getSize();
 			it->textureXMask = s32_to_fixPoint ( dim.Width - 1 ) & FIX_POINT_UNSIGNED_MASK;
 			it->textureYMask = s32_to_fixPoint ( dim.Height - 1 ) & FIX_POINT_UNSIGNED_MASK;
+
+			// split the texel coordinates into tile and texel inside of the tile
+			if ( it->Texture->isTiled() )
+			{
+				const u32 tile = s32_to_fixPoint ( ( 1 << SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 ) - 1 );
+				it->tileXMask = it->textureXMask & ~tile;
+				it->tileYMask = it->textureYMask & ~tile;
+				it->texelXMask = it->textureXMask & tile;
+				it->texelYMask = it->textureYMask & tile;
+			}
+			else
+			{
+				it->tileXMask = 0;
+				it->tileYMask = it->textureYMask;
+				it->texelXMask = it->textureXMask;
+				it->texelYMask = 0;
+			}
 		}
 	}
 
 
+	//! Restricts drawTriangle to the rows [start,end) of the render target
+	void IBurningShader::setBand ( s32 start, s32 end )
+	{
+		BandStart = start;
+		BandEnd = end;
+	}
+
+
+	//! Sets the render target without grabbing it
+	void IBurningShader::setRasterTarget ( video::IImage* surface )
+	{
+		RenderTarget = (video::CImage*) surface;
+	}
+
+
+	//! Sets a texture prepared by setTextureParam without grabbing it
+	void IBurningShader::setRasterTexture ( u32 stage, const sInternalTexture& texture )
+	{
+		IT[stage] = texture;
+	}
+
+
 } // end namespace video
 } // end namespace irr
 
@@ -13,6 +13,7 @@
 #include "rect.h"
 #include "CDepthBuffer.h"
 #include "S4DVertex.h"
+#include "SoftwareDriver2_span.h"
 #include "irrArray.h"
 #include "SLight.h"
 #include "SMaterial.h"
@@ -51,6 +52,7 @@ namespace video
 		FOG			= 0x08,
 		NORMALIZE	= 0x10,
 		VERTEXTRANSFORM	= 0x20,
+		LIGHTCHANGE	= 0x40,
 	};
 
 	struct SBurningShaderLightSpace
@@ -58,10 +60,13 @@ namespace video
 		void reset ()
 		{
 			Light.set_used ( 0 );
+			LightOn.set_used ( 0 );
 			Global_AmbientLight.set ( 0.f, 0.f, 0.f );
 			Flags = 0;
 		}
 		core::array<SBurningShaderLight> Light;
+		// indices of the lights which are turned on, rebuilt after LIGHTCHANGE
+		core::array<u32> LightOn;
 		sVec3 Global_AmbientLight;
 		sVec4 FogColor;
 		sVec4 campos;
@@ -144,8 +149,26 @@ namespace video
 
 		virtual void setMaterial ( const SBurningShaderMaterial &material ) {};
 
+		//! Restricts drawTriangle to the rows [start,end) of the render target
+		/** Used by the raster threads of the driver, each draws its own band of rows. */
+		void setBand ( s32 start, s32 end );
+
+		//! Sets the render target without grabbing it
+		/** Used for the shaders of the raster threads, which must not change
+		reference counts. Set it to 0 before the shader is dropped. */
+		void setRasterTarget ( video::IImage* surface );
+
+		//! Sets a texture prepared by setTextureParam without grabbing it
+		void setRasterTexture ( u32 stage, const sInternalTexture& texture );
+
 	protected:
 
+		//! Check if a row is inside the band set by setBand
+		inline bool inBand ( s32 y ) const
+		{
+			return y >= BandStart && y < BandEnd;
+		}
+
 		CBurningVideoDriver *Driver;
 
 		video::CImage* RenderTarget;
@@ -153,6 +176,9 @@ namespace video
 		CStencilBuffer * Stencil;
 		tVideoSample ColorMask;
 
+		s32 BandStart;
+		s32 BandEnd;
+
 		sInternalTexture IT[ BURNING_MATERIAL_MAX_TEXTURES ];
 
 		static const tFixPointu dithermask[ 4 * 4];
@@ -7,6 +7,7 @@
 
 #include "IReferenceCounted.h"
 #include "dimension2d.h"
+#include "rect.h"
 #include "S4DVertex.h"
 
 namespace irr
@@ -38,6 +39,18 @@ namespace video
 		//! returns pitch of depthbuffer (in bytes)
 		virtual u32 getPitch() const = 0;
 
+		//! shrinks the rows of area to the tiles a triangle with largest w could pass the depth test
+		/** \param area Screen rectangle of the triangle, lower right is exclusive.
+		\param w Largest w of the triangle.
+		\return false if the triangle is hidden in all tiles of the area. */
+		virtual bool clipToDepth(core::rect<s32>& area, f32 w) = 0;
+
+		//! the tiles of area have to be updated before the next test
+		virtual void invalidate(const core::rect<s32>& area) = 0;
+
+		//! all tiles have to be updated before the next test
+		virtual void invalidate() = 0;
+
 	};
 
 
@@ -562,6 +562,17 @@ struct SVertexCache
 
 };
 
+// the vertices of a cache line filled together, as structure of arrays
+struct SVertexBatch
+{
+	// frustum test result of the clip space position
+	u32 Flag[VERTEXCACHE_ELEMENT];
+
+	// normal and vertex in light space
+	f32 Normal[3][VERTEXCACHE_ELEMENT];
+	f32 Vertex[3][VERTEXCACHE_ELEMENT];
+};
+
 
 // swap 2 pointer
 REALINLINE void swapVertexPointer(const s4DVertex** v1, const s4DVertex** v2)
@@ -93,6 +93,12 @@
 
 #define SOFTWARE_DRIVER_2_MIPMAPPING_SCALE (16/SOFTWARE_DRIVER_2_MIPMAPPING_MAX)
 
+// texture layout
+// the texels of the mip map levels are stored in tiles of 4x4 texels, one
+// cache line with 32 bit texels. Undefine to store them row by row.
+#define SOFTWARE_DRIVER_2_TEXTURE_TILES
+#define SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2	2
+
 #ifndef REALINLINE
 	#ifdef _MSC_VER
 		#define REALINLINE __forceinline
@@ -753,6 +753,13 @@ struct sInternalTexture
 	u32 textureXMask;
 	u32 textureYMask;
 
+	// fixpoint texel bits of the tiles and of the texels inside of a tile,
+	// a level stored row by row has all x bits in the tile
+	u32 tileXMask;
+	u32 tileYMask;
+	u32 texelXMask;
+	u32 texelYMask;
+
 	u32 pitchlog2;
 	void *data;
 
@@ -760,6 +767,20 @@ struct sInternalTexture
 	s32 lodLevel;
 };
 
+// byte offset of the texel row ty, wrapped
+REALINLINE u32 texelRow ( const sInternalTexture * t, const tFixPointu ty )
+{
+	return ( ( ( ty & t->tileYMask ) >> FIX_POINT_PRE ) << t->pitchlog2 ) |
+		( ( ty & t->texelYMask ) >> ( FIX_POINT_PRE - SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 - VIDEO_SAMPLE_GRANULARITY ) );
+}
+
+// byte offset of the texel column tx inside of a row, wrapped
+REALINLINE u32 texelColumn ( const sInternalTexture * t, const tFixPointu tx )
+{
+	return ( ( tx & t->tileXMask ) >> ( FIX_POINT_PRE - SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 - VIDEO_SAMPLE_GRANULARITY ) ) |
+		( ( tx & t->texelXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY ) );
+}
+
 
 
 // get video sample plain
@@ -767,8 +788,7 @@ inline tVideoSample getTexel_plain ( const sInternalTexture * t, const tFixPoint
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty ) | texelColumn ( t, tx );
 
 	// texel
 	return *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -781,8 +801,7 @@ inline void getTexel_fix ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty ) | texelColumn ( t, tx );
 
 	// texel
 	tVideoSample t00;
@@ -800,8 +819,7 @@ REALINLINE void getTexel_fix ( tFixPoint &a,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty ) | texelColumn ( t, tx );
 
 	// texel
 	tVideoSample t00;
@@ -826,12 +844,8 @@ inline void getSample_texture_dither (	tFixPoint &r, tFixPoint &g, tFixPoint &b,
 
 	const u32 index = (y & 3 ) << 2 | (x & 3);
 
-	const tFixPointu _ntx = (tx + dithermask [ index ] ) & t->textureXMask;
-	const tFixPointu _nty = (ty + dithermask [ index ] ) & t->textureYMask;
-
 	u32 ofs;
-	ofs = ( ( _nty ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( _ntx ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty + dithermask [ index ] ) | texelColumn ( t, tx + dithermask [ index ] );
 
 	// texel
 	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -855,8 +869,7 @@ inline void getSample_texture ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty ) | texelColumn ( t, tx );
 
 	// texel
 	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -872,8 +885,7 @@ inline void getSample_texture ( tFixPoint &a, tFixPoint &r, tFixPoint &g, tFixPo
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty ) | texelColumn ( t, tx );
 
 	// texel
 	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
@@ -895,8 +907,7 @@ REALINLINE void getSample_linear ( tFixPointu &r, tFixPointu &g, tFixPointu &b,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty ) | texelColumn ( t, tx );
 
 	// texel
 	tVideoSample t00;
@@ -927,10 +938,10 @@ REALINLINE void getSample_texture ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 	u32 o0, o1,o2,o3;
 	tVideoSample t00;
 
-	o0 = ( ( (ty) & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	o1 = ( ( (ty+FIX_POINT_ONE) & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	o2 =   ( (tx) & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-	o3 =   ( (tx+FIX_POINT_ONE) & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	o0 = texelRow ( t, ty );
+	o1 = texelRow ( t, ty + FIX_POINT_ONE );
+	o2 = texelColumn ( t, tx );
+	o3 = texelColumn ( t, tx + FIX_POINT_ONE );
 
 	t00 = *((tVideoSample*)( (u8*) t->data + (o0 | o2 ) ));
 	r00 =	(t00 & MASK_R) >> SHIFT_R;
@@ -990,8 +1001,7 @@ REALINLINE void getSample_linear ( tFixPointu &a, tFixPointu &r, tFixPointu &g,
 {
 	u32 ofs;
 
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
+	ofs = texelRow ( t, ty ) | texelColumn ( t, tx );
 
 	// texel
 	tVideoSample t00;
@@ -0,0 +1,384 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+	Span kernels of the Burning scanline shaders. Process
+	BURNING_SPAN_LANES pixels of a scanline per step, 4 with SSE2 and 8 with
+	AVX2. The functions mirror the fixpoint helpers of
+	SoftwareDriver2_helper.h with the same operations, so the pixels are the
+	same as with the scalar loops. The interpolated values are still added
+	up pixel by pixel in the order of the scalar loop, only the depth test,
+	the perspective divide, the texel fetch and the color combine use the
+	lanes. The last step of a span masks the lanes behind its end.
+*/
+
+#ifndef __S_VIDEO_2_SOFTWARE_SPAN_H_INCLUDED__
+#define __S_VIDEO_2_SOFTWARE_SPAN_H_INCLUDED__
+
+#include "SoftwareDriver2_helper.h"
+
+// the spans need the w-buffer and the perspective divide of the beautiful renderer
+#if defined(_IRR_COMPILE_WITH_SSE2_) && defined(SOFTWARE_DRIVER_2_32BIT) && \
+	defined(SOFTWARE_DRIVER_2_USE_WBUFFER) && defined(SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT) && \
+	!defined(BURNINGVIDEO_RENDERER_FAST)
+
+#define SOFTWARE_DRIVER_2_SPAN_SIMD
+
+#if defined(_IRR_COMPILE_WITH_AVX2_)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+
+namespace video
+{
+
+#if defined(_IRR_COMPILE_WITH_AVX2_)
+
+#define BURNING_SPAN_LANES 8
+typedef __m256 tSpanFloat;
+typedef __m256i tSpanFix;
+
+REALINLINE tSpanFloat span_load ( const f32 *p ) { return _mm256_loadu_ps ( p ); }
+REALINLINE tSpanFix span_set ( const s32 v ) { return _mm256_set1_epi32 ( v ); }
+REALINLINE tSpanFix span_and ( const tSpanFix &a, const tSpanFix &b ) { return _mm256_and_si256 ( a, b ); }
+REALINLINE tSpanFix span_andnot ( const tSpanFix &a, const tSpanFix &b ) { return _mm256_andnot_si256 ( a, b ); }
+REALINLINE tSpanFix span_or ( const tSpanFix &a, const tSpanFix &b ) { return _mm256_or_si256 ( a, b ); }
+REALINLINE tSpanFix span_add ( const tSpanFix &a, const tSpanFix &b ) { return _mm256_add_epi32 ( a, b ); }
+REALINLINE tSpanFix span_sub ( const tSpanFix &a, const tSpanFix &b ) { return _mm256_sub_epi32 ( a, b ); }
+REALINLINE tSpanFix span_shl ( const tSpanFix &a, const s32 n ) { return _mm256_sll_epi32 ( a, _mm_cvtsi32_si128 ( n ) ); }
+REALINLINE tSpanFix span_shr ( const tSpanFix &a, const s32 n ) { return _mm256_srl_epi32 ( a, _mm_cvtsi32_si128 ( n ) ); }
+REALINLINE tSpanFix span_sar ( const tSpanFix &a, const s32 n ) { return _mm256_sra_epi32 ( a, _mm_cvtsi32_si128 ( n ) ); }
+
+// low 32 bit of a * b, like the scalar multiply
+REALINLINE tSpanFix span_mul ( const tSpanFix &a, const tSpanFix &b ) { return _mm256_mullo_epi32 ( a, b ); }
+
+// a * b for 0 <= a,b < 0x8000
+REALINLINE tSpanFix span_mul15 ( const tSpanFix &a, const tSpanFix &b ) { return _mm256_madd_epi16 ( a, b ); }
+
+// FIX_POINT_F32_MUL / w
+REALINLINE tSpanFloat span_inverse ( const tSpanFloat &w ) { return _mm256_div_ps ( _mm256_set1_ps ( FIX_POINT_F32_MUL ), w ); }
+
+// tofix ( x, y )
+REALINLINE tSpanFix span_tofix ( const tSpanFloat &x, const tSpanFloat &y ) { return _mm256_cvttps_epi32 ( _mm256_mul_ps ( x, y ) ); }
+
+// all bits set in the lanes before n
+REALINLINE tSpanFix span_lanes ( const u32 n ) { return _mm256_cmpgt_epi32 ( _mm256_set1_epi32 ( (s32) n ), _mm256_setr_epi32 ( 0, 1, 2, 3, 4, 5, 6, 7 ) ); }
+
+// w >= z
+REALINLINE tSpanFix span_cmp_w ( const tSpanFloat &w, const tSpanFloat &z ) { return _mm256_castps_si256 ( _mm256_cmp_ps ( w, z, _CMP_GE_OQ ) ); }
+
+// mask ? a : b
+REALINLINE tSpanFix span_select ( const tSpanFix &mask, const tSpanFix &a, const tSpanFix &b ) { return _mm256_blendv_epi8 ( b, a, mask ); }
+
+// one bit per lane
+REALINLINE u32 span_bits ( const tSpanFix &mask ) { return (u32) _mm256_movemask_ps ( _mm256_castsi256_ps ( mask ) ); }
+
+REALINLINE tSpanFix span_loadi ( const void *p ) { return _mm256_loadu_si256 ( (const __m256i*) p ); }
+REALINLINE void span_storei ( void *p, const tSpanFix &v ) { _mm256_storeu_si256 ( (__m256i*) p, v ); }
+
+// texels at byte offsets
+REALINLINE tSpanFix span_gather ( const void *data, const tSpanFix &ofs ) { return _mm256_i32gather_epi32 ( (const int*) data, ofs, 1 ); }
+
+#else
+
+#define BURNING_SPAN_LANES 4
+typedef __m128 tSpanFloat;
+typedef __m128i tSpanFix;
+
+REALINLINE tSpanFloat span_load ( const f32 *p ) { return _mm_loadu_ps ( p ); }
+REALINLINE tSpanFix span_set ( const s32 v ) { return _mm_set1_epi32 ( v ); }
+REALINLINE tSpanFix span_and ( const tSpanFix &a, const tSpanFix &b ) { return _mm_and_si128 ( a, b ); }
+REALINLINE tSpanFix span_andnot ( const tSpanFix &a, const tSpanFix &b ) { return _mm_andnot_si128 ( a, b ); }
+REALINLINE tSpanFix span_or ( const tSpanFix &a, const tSpanFix &b ) { return _mm_or_si128 ( a, b ); }
+REALINLINE tSpanFix span_add ( const tSpanFix &a, const tSpanFix &b ) { return _mm_add_epi32 ( a, b ); }
+REALINLINE tSpanFix span_sub ( const tSpanFix &a, const tSpanFix &b ) { return _mm_sub_epi32 ( a, b ); }
+REALINLINE tSpanFix span_shl ( const tSpanFix &a, const s32 n ) { return _mm_sll_epi32 ( a, _mm_cvtsi32_si128 ( n ) ); }
+REALINLINE tSpanFix span_shr ( const tSpanFix &a, const s32 n ) { return _mm_srl_epi32 ( a, _mm_cvtsi32_si128 ( n ) ); }
+REALINLINE tSpanFix span_sar ( const tSpanFix &a, const s32 n ) { return _mm_sra_epi32 ( a, _mm_cvtsi32_si128 ( n ) ); }
+
+// low 32 bit of a * b, like the scalar multiply
+REALINLINE tSpanFix span_mul ( const tSpanFix &a, const tSpanFix &b )
+{
+	const __m128i even = _mm_mul_epu32 ( a, b );
+	const __m128i odd = _mm_mul_epu32 ( _mm_srli_epi64 ( a, 32 ), _mm_srli_epi64 ( b, 32 ) );
+	return _mm_unpacklo_epi32 ( _mm_shuffle_epi32 ( even, _MM_SHUFFLE ( 0, 0, 2, 0 ) ),
+								_mm_shuffle_epi32 ( odd, _MM_SHUFFLE ( 0, 0, 2, 0 ) ) );
+}
+
+// a * b for 0 <= a,b < 0x8000
+REALINLINE tSpanFix span_mul15 ( const tSpanFix &a, const tSpanFix &b ) { return _mm_madd_epi16 ( a, b ); }
+
+// FIX_POINT_F32_MUL / w
+REALINLINE tSpanFloat span_inverse ( const tSpanFloat &w ) { return _mm_div_ps ( _mm_set1_ps ( FIX_POINT_F32_MUL ), w ); }
+
+// tofix ( x, y )
+REALINLINE tSpanFix span_tofix ( const tSpanFloat &x, const tSpanFloat &y ) { return _mm_cvttps_epi32 ( _mm_mul_ps ( x, y ) ); }
+
+// all bits set in the lanes before n
+REALINLINE tSpanFix span_lanes ( const u32 n ) { return _mm_cmpgt_epi32 ( _mm_set1_epi32 ( (s32) n ), _mm_setr_epi32 ( 0, 1, 2, 3 ) ); }
+
+// w >= z
+REALINLINE tSpanFix span_cmp_w ( const tSpanFloat &w, const tSpanFloat &z ) { return _mm_castps_si128 ( _mm_cmpge_ps ( w, z ) ); }
+
+// mask ? a : b
+REALINLINE tSpanFix span_select ( const tSpanFix &mask, const tSpanFix &a, const tSpanFix &b ) { return _mm_or_si128 ( _mm_and_si128 ( mask, a ), _mm_andnot_si128 ( mask, b ) ); }
+
+// one bit per lane
+REALINLINE u32 span_bits ( const tSpanFix &mask ) { return (u32) _mm_movemask_ps ( _mm_castsi128_ps ( mask ) ); }
+
+REALINLINE tSpanFix span_loadi ( const void *p ) { return _mm_loadu_si128 ( (const __m128i*) p ); }
+REALINLINE void span_storei ( void *p, const tSpanFix &v ) { _mm_storeu_si128 ( (__m128i*) p, v ); }
+
+// texels at byte offsets
+REALINLINE tSpanFix span_gather ( const void *data, const tSpanFix &ofs )
+{
+	u32 o[4];
+	_mm_storeu_si128 ( (__m128i*) o, ofs );
+	const u8 *d = (const u8*) data;
+	return _mm_setr_epi32 ( *(const s32*) ( d + o[0] ), *(const s32*) ( d + o[1] ),
+							*(const s32*) ( d + o[2] ), *(const s32*) ( d + o[3] ) );
+}
+
+#endif
+
+//! interpolated values of the pixels of one step
+/** Filled pixel by pixel in the order of the scalar loop. The lanes behind
+the end of the span get values as well, they are masked later. */
+struct sSpanLanes
+{
+	f32 w[BURNING_SPAN_LANES];
+	f32 t[BURNING_MATERIAL_MAX_TEXTURES][2][BURNING_SPAN_LANES];
+	f32 c[3][BURNING_SPAN_LANES];
+};
+
+/*
+	depth test of the first n pixels, like CMP_W.
+	returns all bits set in the lanes which pass
+*/
+REALINLINE tSpanFix span_depth_test ( const fp24 *z, const tSpanFloat &w, const u32 n )
+{
+	if ( n == BURNING_SPAN_LANES )
+		return span_cmp_w ( w, span_load ( z ) );
+
+	f32 part[BURNING_SPAN_LANES];
+	for ( u32 i = 0; i != n; ++i )
+		part[i] = z[i];
+	for ( u32 i = n; i != BURNING_SPAN_LANES; ++i )
+		part[i] = 0.f;
+	return span_and ( span_cmp_w ( w, span_load ( part ) ), span_lanes ( n ) );
+}
+
+/*
+	load the first n values of src, the other lanes are 0
+*/
+REALINLINE tSpanFix span_load_part ( const void *src, const u32 n )
+{
+	if ( n == BURNING_SPAN_LANES )
+		return span_loadi ( src );
+
+	u32 part[BURNING_SPAN_LANES];
+	for ( u32 i = 0; i != n; ++i )
+		part[i] = ((const u32*) src)[i];
+	for ( u32 i = n; i != BURNING_SPAN_LANES; ++i )
+		part[i] = 0;
+	return span_loadi ( part );
+}
+
+/*
+	write the lanes of v with mask set to the first n values of dst
+*/
+REALINLINE void span_store ( void *dst, const tSpanFix &v, const tSpanFix &mask, const u32 n )
+{
+	if ( n == BURNING_SPAN_LANES )
+	{
+		span_storei ( dst, span_select ( mask, v, span_loadi ( dst ) ) );
+		return;
+	}
+
+	u32 value[BURNING_SPAN_LANES];
+	span_storei ( value, v );
+	const u32 bits = span_bits ( mask );
+	for ( u32 i = 0; i != n; ++i )
+	{
+		if ( bits & ( 1 << i ) )
+			((u32*) dst)[i] = value[i];
+	}
+}
+
+/*
+	Fix Point , Fix Point Multiply
+*/
+REALINLINE tSpanFix span_imulFix ( const tSpanFix &x, const tSpanFix &y )
+{
+	return span_sar ( span_mul ( x, y ), FIX_POINT_PRE );
+}
+
+/*
+	Multiply x * y * 1
+*/
+REALINLINE tSpanFix span_imulFix_tex1 ( const tSpanFix &x, const tSpanFix &y )
+{
+	return span_shr ( span_mul ( span_shr ( x, 2 ), span_shr ( y, 2 ) ), FIX_POINT_PRE + 4 );
+}
+
+/*
+	Multiply x * y * 2
+*/
+REALINLINE tSpanFix span_imulFix_tex2 ( const tSpanFix &x, const tSpanFix &y )
+{
+	return span_shr ( span_mul ( span_shr ( x, 2 ), span_shr ( y, 2 ) ), FIX_POINT_PRE + 3 );
+}
+
+/*
+	Multiply x * y * 4
+*/
+REALINLINE tSpanFix span_imulFix_tex4 ( const tSpanFix &x, const tSpanFix &y )
+{
+	return span_shr ( span_mul ( span_shr ( x, 2 ), span_shr ( y, 2 ) ), FIX_POINT_PRE + 2 );
+}
+
+/*
+	clamp FixPoint to maxcolor in FixPoint, min(a,31)
+*/
+REALINLINE tSpanFix span_clampfix_maxcolor ( const tSpanFix &a )
+{
+	const tSpanFix c = span_sar ( span_sub ( a, span_set ( FIXPOINT_COLOR_MAX ) ), 31 );
+	return span_or ( span_and ( a, c ), span_andnot ( c, span_set ( FIXPOINT_COLOR_MAX ) ) );
+}
+
+/*
+	clamp FixPoint to 0 in FixPoint, max(a,0)
+*/
+REALINLINE tSpanFix span_clampfix_mincolor ( const tSpanFix &a )
+{
+	return span_sub ( a, span_and ( a, span_sar ( a, 31 ) ) );
+}
+
+/*
+	return VideoSample from fixpoint
+*/
+REALINLINE tSpanFix span_fix_to_color ( const tSpanFix &r, const tSpanFix &g, const tSpanFix &b )
+{
+	const tSpanFix max = span_set ( FIXPOINT_COLOR_MAX );
+	return span_or ( span_or ( span_set ( ( FIXPOINT_COLOR_MAX & FIXPOINT_COLOR_MAX ) << ( SHIFT_A - FIX_POINT_PRE ) ),
+								span_shl ( span_and ( r, max ), SHIFT_R - FIX_POINT_PRE ) ),
+					span_or ( span_shr ( span_and ( g, max ), FIX_POINT_PRE - SHIFT_G ),
+								span_shr ( span_and ( b, max ), FIX_POINT_PRE - SHIFT_B ) ) );
+}
+
+/*
+	return fixpoint from VideoSample granularity 0..FIX_POINT_ONE, like color_to_fix1
+*/
+REALINLINE void span_color_to_fix1 ( tSpanFix &r, tSpanFix &g, tSpanFix &b, const tSpanFix &t00 )
+{
+	r = span_shr ( span_and ( t00, span_set ( MASK_R ) ), SHIFT_R + COLOR_MAX_LOG2 - FIX_POINT_PRE );
+	g = span_shr ( span_and ( t00, span_set ( MASK_G ) ), SHIFT_G + COLOR_MAX_LOG2 - FIX_POINT_PRE );
+	b = span_shl ( span_and ( t00, span_set ( MASK_B ) ), FIX_POINT_PRE - COLOR_MAX_LOG2 );
+}
+
+/*
+	byte offsets of the texel rows and columns, like texelRow and texelColumn
+*/
+REALINLINE tSpanFix span_texel_row ( const sInternalTexture * t, const tSpanFix &ty )
+{
+	return span_or ( span_shl ( span_shr ( span_and ( ty, span_set ( t->tileYMask ) ), FIX_POINT_PRE ), t->pitchlog2 ),
+					span_shr ( span_and ( ty, span_set ( t->texelYMask ) ),
+						FIX_POINT_PRE - SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 - VIDEO_SAMPLE_GRANULARITY ) );
+}
+
+REALINLINE tSpanFix span_texel_column ( const sInternalTexture * t, const tSpanFix &tx )
+{
+	return span_or ( span_shr ( span_and ( tx, span_set ( t->tileXMask ) ),
+						FIX_POINT_PRE - SOFTWARE_DRIVER_2_TEXTURE_TILE_LOG2 - VIDEO_SAMPLE_GRANULARITY ),
+					span_shr ( span_and ( tx, span_set ( t->texelXMask ) ), FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY ) );
+}
+
+/*
+	byte offset of the texel at tx,ty
+*/
+REALINLINE tSpanFix span_texel_offset ( const sInternalTexture * t, const tSpanFix &tx, const tSpanFix &ty )
+{
+	return span_or ( span_texel_row ( t, ty ), span_texel_column ( t, tx ) );
+}
+
+// get video sample to fix, like getTexel_fix
+REALINLINE void span_texel_fix ( tSpanFix &r, tSpanFix &g, tSpanFix &b,
+						const sInternalTexture * t, const tSpanFix &tx, const tSpanFix &ty )
+{
+	const tSpanFix t00 = span_gather ( t->data, span_texel_offset ( t, tx, ty ) );
+
+	r = span_shr ( span_and ( t00, span_set ( MASK_R ) ), SHIFT_R - FIX_POINT_PRE );
+	g = span_shl ( span_and ( t00, span_set ( MASK_G ) ), FIX_POINT_PRE - SHIFT_G );
+	b = span_shl ( span_and ( t00, span_set ( MASK_B ) ), FIX_POINT_PRE - SHIFT_B );
+}
+
+#ifndef SOFTWARE_DRIVER_2_BILINEAR
+
+// get Sample linear == getSample_fixpoint
+REALINLINE void span_sample_texture ( tSpanFix &r, tSpanFix &g, tSpanFix &b,
+						const sInternalTexture * t, const tSpanFix &tx, const tSpanFix &ty )
+{
+	span_texel_fix ( r, g, b, t, tx, ty );
+}
+
+#else
+
+// get Sample bilinear, like getSample_texture
+REALINLINE void span_sample_texture ( tSpanFix &r, tSpanFix &g, tSpanFix &b,
+						const sInternalTexture * t, const tSpanFix &tx, const tSpanFix &ty )
+{
+	const tSpanFix one = span_set ( FIX_POINT_ONE );
+
+	const tSpanFix o0 = span_texel_row ( t, ty );
+	const tSpanFix o1 = span_texel_row ( t, span_add ( ty, one ) );
+	const tSpanFix o2 = span_texel_column ( t, tx );
+	const tSpanFix o3 = span_texel_column ( t, span_add ( tx, one ) );
+
+	const tSpanFix t00 = span_gather ( t->data, span_or ( o0, o2 ) );
+	const tSpanFix t10 = span_gather ( t->data, span_or ( o0, o3 ) );
+	const tSpanFix t01 = span_gather ( t->data, span_or ( o1, o2 ) );
+	const tSpanFix t11 = span_gather ( t->data, span_or ( o1, o3 ) );
+
+	const tSpanFix fract = span_set ( FIX_POINT_FRACT_MASK );
+	const tSpanFix txFract = span_and ( tx, fract );
+	const tSpanFix txFractInv = span_sub ( one, txFract );
+
+	const tSpanFix tyFract = span_and ( ty, fract );
+	const tSpanFix tyFractInv = span_sub ( one, tyFract );
+
+	// imulFixu
+	const tSpanFix w00 = span_shr ( span_mul15 ( txFractInv, tyFractInv ), FIX_POINT_PRE );
+	const tSpanFix w10 = span_shr ( span_mul15 ( txFract, tyFractInv ), FIX_POINT_PRE );
+	const tSpanFix w01 = span_shr ( span_mul15 ( txFractInv, tyFract ), FIX_POINT_PRE );
+	const tSpanFix w11 = span_shr ( span_mul15 ( txFract, tyFract ), FIX_POINT_PRE );
+
+	const tSpanFix mask = span_set ( 0xFF );
+
+	r =	span_add ( span_add ( span_mul15 ( span_and ( span_shr ( t00, SHIFT_R ), mask ), w00 ),
+							span_mul15 ( span_and ( span_shr ( t01, SHIFT_R ), mask ), w01 ) ),
+				span_add ( span_mul15 ( span_and ( span_shr ( t10, SHIFT_R ), mask ), w10 ),
+							span_mul15 ( span_and ( span_shr ( t11, SHIFT_R ), mask ), w11 ) ) );
+
+	g =	span_add ( span_add ( span_mul15 ( span_and ( span_shr ( t00, SHIFT_G ), mask ), w00 ),
+							span_mul15 ( span_and ( span_shr ( t01, SHIFT_G ), mask ), w01 ) ),
+				span_add ( span_mul15 ( span_and ( span_shr ( t10, SHIFT_G ), mask ), w10 ),
+							span_mul15 ( span_and ( span_shr ( t11, SHIFT_G ), mask ), w11 ) ) );
+
+	b =	span_add ( span_add ( span_mul15 ( span_and ( t00, mask ), w00 ),
+							span_mul15 ( span_and ( t01, mask ), w01 ) ),
+				span_add ( span_mul15 ( span_and ( t10, mask ), w10 ),
+							span_mul15 ( span_and ( t11, mask ), w11 ) ) );
+}
+
+#endif
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_SSE2_
+
+#endif
@@ -0,0 +1,207 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Moves and turns a node, or moves the target of a camera, with the time
+class CStepAnimator : public ISceneNodeAnimator
+{
+public:
+
+	virtual void animateNode(ISceneNode* node, u32 timeMs) _IRR_OVERRIDE_
+	{
+		Times.push_back(timeMs);
+		const f32 time = (f32)(timeMs - 1000);
+		if (node->getType() == ESNT_CAMERA)
+			static_cast<ICameraSceneNode*>(node)->setTarget(vector3df(time, 0, 100.f));
+		else
+		{
+			node->setPosition(vector3df(time, 0, 0));
+			node->setRotation(vector3df(0, time * 0.9f, 0));
+		}
+	}
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0) _IRR_OVERRIDE_
+	{
+		return new CStepAnimator();
+	}
+
+	array<u32> Times;
+};
+
+//! Remembers its transformation and the camera target when it is drawn
+class CRecordingSceneNode : public ISceneNode
+{
+public:
+
+	CRecordingSceneNode(ISceneNode* parent, ISceneManager* mgr)
+		: ISceneNode(parent, mgr), Drawn(false)
+	{
+		setAutomaticCulling(EAC_OFF);
+	}
+
+	virtual void OnRegisterSceneNode() _IRR_OVERRIDE_
+	{
+		if (IsVisible)
+			SceneManager->registerNodeForRendering(this);
+		ISceneNode::OnRegisterSceneNode();
+	}
+
+	virtual void render() _IRR_OVERRIDE_
+	{
+		Drawn = true;
+		Transformation = AbsoluteTransformation;
+		Target = SceneManager->getActiveCamera()->getTarget();
+	}
+
+	virtual const aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_
+	{
+		return Box;
+	}
+
+	aabbox3df Box;
+	bool Drawn;
+	matrix4 Transformation;
+	vector3df Target;
+};
+
+bool checkTimes(const CStepAnimator* animator, const u32* times, u32 count, const char* name)
+{
+	bool result = (animator->Times.size() == count);
+	for (u32 i=0; result && i<count; ++i)
+		result = (animator->Times[i] == times[i]);
+	if (!result)
+		logTestString("Wrong animation times %s\n", name);
+	return result;
+}
+
+bool checkDrawn(CRecordingSceneNode* node, const vector3df& position, f32 rotation, const char* name)
+{
+	matrix4 expected;
+	expected.setRotationDegrees(vector3df(0, rotation, 0));
+	expected.setTranslation(position);
+	if (!node->Drawn || !node->Transformation.equals(expected, 0.001f))
+	{
+		logTestString("Wrong transformation drawn %s: %f %f %f\n", name,
+			node->Transformation.getTranslation().X, node->Transformation.getTranslation().Y,
+			node->Transformation.getTranslation().Z);
+		return false;
+	}
+	node->Drawn = false;
+	return true;
+}
+
+} // end anonymous namespace
+
+
+//! Animation in fixed time steps with interpolated transformations
+bool animationTimeStep(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0, 0, -100.f), vector3df(0, 0, 100.f));
+	CStepAnimator* cameraAnimator = new CStepAnimator();
+	camera->addAnimator(cameraAnimator);
+
+	CRecordingSceneNode* moving = new CRecordingSceneNode(smgr->getRootSceneNode(), smgr);
+	CStepAnimator* animator = new CStepAnimator();
+	moving->addAnimator(animator);
+
+	CRecordingSceneNode* still = new CRecordingSceneNode(smgr->getRootSceneNode(), smgr);
+	still->setPosition(vector3df(0, 10.f, 0));
+
+	bool result = (smgr->getAnimationTimeStep() == 0);
+	result &= (smgr->updateAnimation(1000) == 0);
+
+	smgr->setAnimationTimeStep(100);
+	result &= (smgr->getAnimationTimeStep() == 100);
+
+	// the first update animates at the time passed
+	result &= (smgr->updateAnimation(1000) == 1);
+	const u32 first[] = { 1000 };
+	result &= checkTimes(animator, first, 1, "after the first update");
+
+	// drawAll doesn't animate
+	driver->beginScene();
+	smgr->drawAll();
+	driver->endScene();
+	result &= checkTimes(animator, first, 1, "after drawing");
+	result &= checkDrawn(moving, vector3df(0, 0, 0), 0, "after the first update");
+	result &= checkDrawn(still, vector3df(0, 10.f, 0), 0, "of a node without animators");
+
+	// steps of the same length independent of the updates
+	result &= (smgr->updateAnimation(1150) == 1);
+	result &= (smgr->updateAnimation(1199) == 0);
+	result &= (smgr->updateAnimation(1200) == 1);
+	const u32 steps[] = { 1000, 1100, 1200 };
+	result &= checkTimes(animator, steps, 3, "in steps");
+	result &= checkTimes(cameraAnimator, steps, 3, "of the camera");
+
+	// at the time of the last step the previous one is drawn
+	driver->beginScene();
+	smgr->drawAll();
+	driver->endScene();
+	result &= checkDrawn(moving, vector3df(100.f, 0, 0), 90.f, "at a step");
+	result &= (moving->getAbsoluteTransformation().getTranslation() == vector3df(200.f, 0, 0));
+
+	// half way to the next step
+	result &= (smgr->updateAnimation(1250) == 0);
+	driver->beginScene();
+	smgr->drawAll();
+	driver->endScene();
+	result &= checkDrawn(moving, vector3df(150.f, 0, 0), 135.f, "between steps");
+	result &= (moving->Target.equals(vector3df(150.f, 0, 100.f)));
+	result &= checkDrawn(still, vector3df(0, 10.f, 0), 0, "of a node without animators between steps");
+
+	// the last step is drawn again after drawAll
+	result &= (moving->getAbsoluteTransformation().getTranslation() == vector3df(200.f, 0, 0));
+	result &= (camera->getTarget() == vector3df(200.f, 0, 100.f));
+
+	// changes made outside of animators are drawn immediately
+	still->setPosition(vector3df(0, 20.f, 0));
+	driver->beginScene();
+	smgr->drawAll();
+	driver->endScene();
+	result &= checkDrawn(still, vector3df(0, 20.f, 0), 0, "after it was moved");
+
+	// steps which can't be done in time are skipped
+	animator->Times.clear();
+	result &= (smgr->updateAnimation(2000, 3) == 3);
+	const u32 skipped[] = { 1800, 1900, 2000 };
+	result &= checkTimes(animator, skipped, 3, "after skipping steps");
+
+	// without a time step drawAll animates again
+	smgr->setAnimationTimeStep(0);
+	animator->Times.clear();
+	result &= (smgr->updateAnimation(2100) == 0);
+	driver->beginScene();
+	smgr->drawAll();
+	driver->endScene();
+	result &= (animator->Times.size() == 1);
+	result &= (moving->Transformation == moving->getAbsoluteTransformation());
+
+	animator->drop();
+	cameraAnimator->drop();
+	moving->drop();
+	still->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
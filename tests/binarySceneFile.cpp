@@ -0,0 +1,174 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Stores the name of each node and a text which isn't ascii as user data,
+//! counts the nodes read back
+class CNameSerializer : public ISceneUserDataSerializer
+{
+public:
+
+	CNameSerializer(io::IFileSystem* fs) : FileSystem(fs), Read(0), Created(0) {}
+
+	virtual void OnCreateNode(ISceneNode* node) _IRR_OVERRIDE_
+	{
+		++Created;
+	}
+
+	virtual void OnReadUserData(ISceneNode* forSceneNode, io::IAttributes* userData) _IRR_OVERRIDE_
+	{
+		if (userData->getAttributeAsString("NodeName") == forSceneNode->getName() &&
+			userData->getAttributeAsStringW("Text") == L"\x00e4\x00f6\x00fc \x20ac")
+			++Read;
+	}
+
+	virtual io::IAttributes* createUserData(ISceneNode* forSceneNode) _IRR_OVERRIDE_
+	{
+		io::IAttributes* attr = FileSystem->createEmptyAttributes();
+		attr->addString("NodeName", forSceneNode->getName());
+		attr->addString("Text", L"\x00e4\x00f6\x00fc \x20ac");
+		return attr;
+	}
+
+	io::IFileSystem* FileSystem;
+	u32 Read;
+	u32 Created;
+};
+
+
+//! Builds a scene with different nodes, materials and animators
+void createScene(ISceneManager* smgr)
+{
+	video::IVideoDriver* driver = smgr->getVideoDriver();
+
+	ISceneNode* cube = smgr->addCubeSceneNode(10.f, 0, 1, vector3df(1.f, 2.f, 3.f), vector3df(0, 45.f, 0));
+	cube->setMaterialTexture(0, driver->getTexture("../media/wall.bmp"));
+	cube->setMaterialFlag(video::EMF_LIGHTING, false);
+	cube->setName("cube");
+	ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0, 1.f, 0));
+	cube->addAnimator(anim);
+	anim->drop();
+
+	ISceneNode* sphere = smgr->addSphereSceneNode(5.f, 16, cube, 2, vector3df(0, 10.f, 0));
+	sphere->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+	anim = smgr->createFlyCircleAnimator(vector3df(0, 10.f, 0), 20.f);
+	sphere->addAnimator(anim);
+	anim->drop();
+
+	smgr->addLightSceneNode(0, vector3df(0, 50.f, 0), video::SColorf(1.f, 0.5f, 0.25f), 80.f, 3);
+	smgr->addBillboardSceneNode(smgr->addEmptySceneNode(0, 4), dimension2df(5.f, 3.f), vector3df(-10.f, 0, 0));
+	smgr->addCameraSceneNode(0, vector3df(0, 20.f, -40.f), vector3df(0, 0, 0), 5);
+
+	IParticleSystemSceneNode* particles = smgr->addParticleSystemSceneNode(false, 0, 6);
+	IParticleEmitter* emitter = particles->createBoxEmitter(aabbox3df(-5.f, 0, -5.f, 5.f, 1.f, 5.f));
+	particles->setEmitter(emitter);
+	emitter->drop();
+
+	// not saved
+	smgr->addCubeSceneNode(1.f, cube)->setIsDebugObject(true);
+}
+
+//! Saves the scene as .irr so that the content can be compared
+bool compareWithXml(ISceneManager* smgr, const char* name)
+{
+	smgr->saveScene(name);
+	const bool result = binaryCompareFiles(name, "binarySceneFile.irr");
+	if (!result)
+		logTestString("%s differs from the scene saved as .irr\n", name);
+	return result;
+}
+
+} // end anonymous namespace
+
+
+//! Scenes written as .irrb are loaded with the same content as .irr scenes
+bool binarySceneFile(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	io::IFileSystem* fs = device->getFileSystem();
+
+	createScene(smgr);
+
+	CNameSerializer serializer(fs);
+	bool result = smgr->saveScene("binarySceneFile.irrb", &serializer);
+	smgr->saveScene("binarySceneFile.irr");
+
+	smgr->clear();
+	result &= smgr->loadScene("binarySceneFile.irrb", &serializer);
+	result &= compareWithXml(smgr, "binarySceneFile-irrb.irr");
+	// the root and 7 nodes
+	result &= (serializer.Read == 8 && serializer.Created == 8);
+	
+	// from memory
+	io::IReadFile* file = fs->createAndOpenFile("binarySceneFile.irrb");
+	result &= (file != 0);
+	if (file)
+	{
+		array<u8> data;
+		data.set_used(file->getSize());
+		file->read(data.pointer(), data.size());
+		file->drop();
+
+		smgr->clear();
+		io::IReadFile* memoryFile = fs->createMemoryReadFile(data.pointer(), data.size(), "binarySceneFile.irrb");
+		result &= smgr->loadScene(memoryFile);
+		memoryFile->drop();
+		result &= compareWithXml(smgr, "binarySceneFile-memory.irr");
+
+		// below a node of the scene
+		ISceneNode* parent = smgr->addEmptySceneNode(0, 7);
+		memoryFile = fs->createMemoryReadFile(data.pointer(), data.size(), "binarySceneFile.irrb");
+		serializer.Read = 0;
+		result &= smgr->loadScene(memoryFile, &serializer, parent);
+		memoryFile->drop();
+		result &= (serializer.Read == 8 && parent->getChildren().size() == 5);
+
+		// a damaged file fails without crashing
+		smgr->clear();
+		memoryFile = fs->createMemoryReadFile(data.pointer(), data.size() / 2, "binarySceneFile.irrb");
+		smgr->loadScene(memoryFile);
+		memoryFile->drop();
+		if (!smgr->getRootSceneNode()->getChildren().empty())
+		{
+			logTestString("Nodes of a truncated file were loaded\n");
+			result = false;
+		}
+	}
+
+	// a node whose type name has a length which wraps around when padded
+	const u32 corrupt[] = { MAKE_IRR_ID('i','r','r','b'), 1,
+		MAKE_IRR_ID('s','c','n','e'), 16, MAKE_IRR_ID('n','o','d','e'), 8, 0xfffffffc, 0 };
+	io::IReadFile* corruptFile = fs->createMemoryReadFile(corrupt, sizeof(corrupt), "corrupt.irrb");
+	smgr->loadScene(corruptFile);
+	corruptFile->drop();
+	if (!smgr->getRootSceneNode()->getChildren().empty())
+	{
+		logTestString("Nodes of a file with a corrupt string length were loaded\n");
+		result = false;
+	}
+
+	remove("binarySceneFile.irrb");
+	remove("binarySceneFile.irr");
+	remove("binarySceneFile-irrb.irr");
+	remove("binarySceneFile-memory.irr");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
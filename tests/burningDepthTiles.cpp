@@ -0,0 +1,87 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Renders walls with a gap in front of nodes which are mostly hidden
+bool drawHiddenScene(u32 jobThreads)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	params.JobThreads = jobThreads;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	video::ITexture* wall = driver->getTexture("../media/wall.bmp");
+	video::ITexture* fire = driver->getTexture("../media/fire.bmp");
+
+	// two walls with a gap, drawn first as the nearest solid nodes
+	ISceneNode* node = smgr->addCubeSceneNode(1.f, 0, -1, vector3df(-9.5f, 0, 15.f), vector3df(0), vector3df(15.f, 30.f, 1.f));
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+	node->setMaterialTexture(0, wall);
+	node = smgr->addCubeSceneNode(1.f, 0, -1, vector3df(9.5f, 0, 15.f), vector3df(0), vector3df(15.f, 30.f, 1.f));
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+	node->setMaterialTexture(0, wall);
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(5.f));
+	IMesh* lightmapped = smgr->getMeshManipulator()->createMeshWith2TCoords(cube);
+	for (s32 i=0; i<16; ++i)
+	{
+		node = smgr->addMeshSceneNode((i % 4 == 1) ? lightmapped : cube, 0, -1,
+			vector3df((i % 4) * 6.f - 9.f, (i / 4) * 6.f - 9.f, 30.f + (i % 3) * 5.f),
+			vector3df(i * 20.f, i * 35.f, 0));
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setMaterialTexture(0, wall);
+		node->setMaterialTexture(1, fire);
+		if (i % 4 == 1)
+			node->setMaterialType(video::EMT_LIGHTMAP_M4);
+		else if (i % 4 == 3)
+			node->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+	}
+	lightmapped->drop();
+	cube->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	// the second frame starts with the coarse depth of the first one
+	for (u32 i=0; i<2; ++i)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255, 60, 60, 90));
+		smgr->drawAll();
+		driver->endScene();
+	}
+
+	const bool result = takeScreenshotAndCompareAgainstReference(driver, "-burningDepthTiles.png", 100.f);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+} // end anonymous namespace
+
+//! Triangles hidden by the coarse depth of Burning's Video
+/** The reference image is the output without the coarse depth, skipped
+triangles and rows must not change any pixel. With and without raster
+threads. */
+bool burningDepthTiles(void)
+{
+	bool result = drawHiddenScene(0);
+	result &= drawHiddenScene(2);
+	return result;
+}
@@ -0,0 +1,69 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+//! Vertex lighting of Burning's Video with point, directional and specular lights
+/** Transformed, scaled and normalized nodes and texture generation, all
+computed in the batched vertex stage. The reference image is the output of
+the scalar vertex stage, the batches have to give the same pixels. */
+bool burningLighting(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	video::ITexture* wall = driver->getTexture("../media/wall.bmp");
+
+	for (s32 i=0; i<12; ++i)
+	{
+		ISceneNode* node = smgr->addSphereSceneNode(3.f + i * 0.3f, 24, 0, -1,
+			vector3df((i % 4) * 8.f - 12.f, (i / 4) * 7.f - 7.f, 30.f),
+			vector3df(i * 10.f, i * 20.f, 0), vector3df(1.f, 1.f + 0.1f * i, 1.f));
+		node->setMaterialTexture(0, wall);
+		video::SMaterial& material = node->getMaterial(0);
+		material.Shininess = (i % 2) ? 20.f : 0.f;
+		material.SpecularColor.set(255, 255, 255, 255);
+		material.NormalizeNormals = (i % 3) == 0;
+		if (i == 5)
+			node->setMaterialType(video::EMT_SPHERE_MAP);
+		else if (i == 7)
+		{
+			node->setMaterialTexture(1, wall);
+			node->setMaterialType(video::EMT_REFLECTION_2_LAYER);
+		}
+	}
+	smgr->addCubeSceneNode(4.f, 0, -1, vector3df(0, 0, 15.f))->setMaterialTexture(0, wall);
+
+	smgr->addLightSceneNode(0, vector3df(-10.f, 10.f, 10.f), video::SColorf(1.f, 0.5f, 0.5f), 40.f);
+	smgr->addLightSceneNode(0, vector3df(10.f, -5.f, 20.f), video::SColorf(0.3f, 0.5f, 1.f), 30.f);
+	ILightSceneNode* sun = smgr->addLightSceneNode(0, vector3df(0, 0, 0), video::SColorf(0.4f, 0.4f, 0.3f));
+	sun->setLightType(video::ELT_DIRECTIONAL);
+	sun->setRotation(vector3df(30.f, 40.f, 0));
+	smgr->setAmbientLight(video::SColorf(0.1f, 0.1f, 0.1f));
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255, 20, 20, 20));
+	smgr->drawAll();
+	driver->endScene();
+
+	const bool result = takeScreenshotAndCompareAgainstReference(driver, "-burningLighting.png", 100.f);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
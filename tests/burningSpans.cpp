@@ -0,0 +1,71 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+//! Scanlines of the Burning's Video renderers which have vectorized spans
+/** Vertex colored, lightmapped and blended cubes, overlapping each other so
+the depth test passes and fails inside of the spans. The window width is not
+a multiple of the span lanes. The reference image is the output of the
+scalar scanlines, the spans have to give the same pixels. */
+bool burningSpans(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(157, 113);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	video::ITexture* wall = driver->getTexture("../media/wall.bmp");
+	video::ITexture* fire = driver->getTexture("../media/fire.bmp");
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(8.f));
+	IMeshBuffer* buffer = cube->getMeshBuffer(0);
+	video::S3DVertex* vertices = (video::S3DVertex*)buffer->getVertices();
+	for (u32 i=0; i<buffer->getVertexCount(); ++i)
+		vertices[i].Color.set(255, 255 - i * 20, 100 + i * 10, i * 21);
+	IMesh* lightmapped = smgr->getMeshManipulator()->createMeshWith2TCoords(cube);
+
+	for (s32 i=0; i<12; ++i)
+	{
+		ISceneNode* node = smgr->addMeshSceneNode((i % 3 == 1) ? lightmapped : cube, 0, -1,
+			vector3df((i % 4) * 7.f - 10.5f, (i / 4) * 7.f - 7.f, 22.f + (i % 2) * 4.f),
+			vector3df(i * 25.f, i * 15.f, i * 5.f));
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setMaterialTexture(0, wall);
+		node->setMaterialTexture(1, fire);
+		if (i % 3 == 1)
+			node->setMaterialType(video::EMT_LIGHTMAP_M4);
+		else if (i % 3 == 2)
+		{
+			video::SMaterial& material = node->getMaterial(0);
+			material.MaterialType = video::EMT_ONETEXTURE_BLEND;
+			material.MaterialTypeParam = video::pack_textureBlendFunc(video::EBF_DST_COLOR, video::EBF_ZERO);
+		}
+	}
+	lightmapped->drop();
+	cube->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255, 90, 110, 130));
+	smgr->drawAll();
+	driver->endScene();
+
+	const bool result = takeScreenshotAndCompareAgainstReference(driver, "-burningSpans.png", 100.f);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,117 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+u32 patternColor(u32 x, u32 y)
+{
+	return 0xff000000 | (x * 4) << 16 | (y * 8) << 8 | ((x ^ y) & 7) * 32;
+}
+
+//! lock has to return the rows of the texture, whatever the driver stores
+bool lockTexels(video::IVideoDriver* driver, video::ITexture* texture)
+{
+	u32* data = (u32*)texture->lock(video::ETLM_READ_ONLY);
+	if (!data)
+		return false;
+
+	bool result = texture->getPitch() == 64 * 4;
+	for (u32 y=0; y<32; ++y)
+		for (u32 x=0; x<64; ++x)
+			result &= data[y * 64 + x] == patternColor(x, y);
+	texture->unlock();
+	assert_log(result);
+
+	// written texels are drawn and returned by the next lock
+	data = (u32*)texture->lock(video::ETLM_READ_WRITE);
+	for (u32 x=0; x<64; ++x)
+		data[5 * 64 + x] = 0xffffffff;
+	for (u32 y=0; y<32; ++y)
+		data[y * 64 + 9] = 0xff0000ff;
+	texture->unlock();
+	texture->regenerateMipMapLevels();
+
+	data = (u32*)texture->lock(video::ETLM_READ_ONLY);
+	for (u32 y=0; y<32; ++y)
+		for (u32 x=0; x<64; ++x)
+		{
+			const u32 color = x == 9 ? 0xff0000ff : (y == 5 ? 0xffffffff : patternColor(x, y));
+			result &= data[y * 64 + x] == color;
+		}
+	texture->unlock();
+	assert_log(result);
+
+	return result;
+}
+
+} // end anonymous namespace
+
+//! Textures of Burning's Video sampled on rotated and minified surfaces
+/** The reference image is the output with the texels stored row by row, the
+tiles have to give the same pixels. Also locks the texels and draws the
+texture in 2d. */
+bool burningTextureTiles(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, dimension2du(64, 32));
+	for (u32 y=0; y<32; ++y)
+		for (u32 x=0; x<64; ++x)
+			image->setPixel(x, y, patternColor(x, y));
+	video::ITexture* pattern = driver->addTexture("pattern", image);
+	image->drop();
+
+	bool result = lockTexels(driver, pattern);
+
+	// a rotated floor from magnified to far minified
+	IMesh* plane = smgr->getGeometryCreator()->createPlaneMesh(dimension2df(10.f, 10.f),
+		dimension2du(8, 8), 0, dimension2df(8.f, 8.f));
+	ISceneNode* node = smgr->addMeshSceneNode(plane, 0, -1, vector3df(0, -6.f, 20.f), vector3df(0, 35.f, 0));
+	plane->drop();
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+	node->setMaterialTexture(0, driver->getTexture("../media/wall.bmp"));
+
+	// lightmaps need the second texture coordinates
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(8.f));
+	IMesh* lightmapped = smgr->getMeshManipulator()->createMeshWith2TCoords(cube);
+	node = smgr->addMeshSceneNode(lightmapped, 0, -1, vector3df(2.f, 4.f, 18.f), vector3df(30.f, 40.f, 15.f));
+	lightmapped->drop();
+	cube->drop();
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+	node->setMaterialTexture(0, pattern);
+	node->setMaterialTexture(1, driver->getTexture("../media/fire.bmp"));
+	node->setMaterialType(video::EMT_LIGHTMAP_M4);
+
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, -4.f, 100.f));
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255, 40, 60, 80));
+	smgr->drawAll();
+	driver->draw2DImage(pattern, position2di(4, 4));
+	driver->endScene();
+
+	result &= takeScreenshotAndCompareAgainstReference(driver, "-burningTextureTiles.png", 100.f);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,157 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+IrrlichtDevice* createBurningDevice(u32 jobThreads)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	params.JobThreads = jobThreads;
+	return createDeviceEx(params);
+}
+
+//! Adds solid, transparent and lightmapped nodes which overlap many rows
+void addScene(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	video::ITexture* wall = driver->getTexture("../media/wall.bmp");
+	video::ITexture* fire = driver->getTexture("../media/fire.bmp");
+	video::ITexture* particle = driver->getTexture("../media/particle.bmp");
+	video::ITexture* logo = driver->getTexture("../media/irrlichtlogoalpha2.tga");
+
+	ISceneNode* node = smgr->addSphereSceneNode(8.f, 32, 0, 1, vector3df(-4.f, 0, 25.f));
+	node->setMaterialTexture(0, wall);
+
+	// lightmaps need the second texture coordinates
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(10.f));
+	IMesh* lightmapped = smgr->getMeshManipulator()->createMeshWith2TCoords(cube);
+	node = smgr->addMeshSceneNode(lightmapped, 0, 2, vector3df(6.f, 2.f, 30.f));
+	lightmapped->drop();
+	cube->drop();
+	node->setMaterialTexture(0, wall);
+	node->setMaterialTexture(1, fire);
+	node->setMaterialType(video::EMT_LIGHTMAP_M2);
+
+	node = smgr->addCubeSceneNode(6.f, 0, 3, vector3df(2.f, -2.f, 18.f));
+	node->setMaterialTexture(0, fire);
+	node->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+
+	node = smgr->addBillboardSceneNode(0, dimension2df(12.f, 8.f), vector3df(-2.f, 3.f, 15.f), 4);
+	node->setMaterialTexture(0, logo);
+	node->setMaterialType(video::EMT_TRANSPARENT_ALPHA_CHANNEL);
+
+	node = smgr->addCubeSceneNode(4.f, 0, 5, vector3df(-8.f, -5.f, 14.f));
+	node->setMaterialTexture(0, particle);
+	node->setMaterialType(video::EMT_TRANSPARENT_VERTEX_ALPHA);
+
+	// a node partly behind the camera, clipped against the near plane
+	node = smgr->addCubeSceneNode(20.f, 0, 6, vector3df(0, -12.f, 0));
+	node->setMaterialTexture(0, wall);
+
+	smgr->addLightSceneNode(0, vector3df(0, 20.f, 0), video::SColorf(1.f, 0.8f, 0.6f), 50.f);
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+}
+
+void drawFrame(IrrlichtDevice* device, u32 frame)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	for (s32 id=1; id<=6; ++id)
+		smgr->getSceneNodeFromId(id)->setRotation(vector3df(frame * 17.f, frame * 29.f + id * 11.f, 0));
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255, 40, 60, 80));
+	smgr->drawAll();
+	// 2D draws in between have to flush the triangles of the threads
+	driver->draw2DRectangle(video::SColor(128, 255, 255, 0), recti(10, 10, 60, 40));
+	driver->draw2DLine(position2di(0, 119), position2di(159, 0), video::SColor(255, 255, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+}
+
+bool compareImages(video::IImage* single, video::IImage* threaded)
+{
+	const dimension2du size = single->getDimension();
+	if (size != threaded->getDimension())
+	{
+		logTestString("Screenshots differ in size\n");
+		return false;
+	}
+
+	u32 different = 0;
+	for (u32 y=0; y<size.Height; ++y)
+		for (u32 x=0; x<size.Width; ++x)
+			if (single->getPixel(x, y) != threaded->getPixel(x, y))
+				++different;
+
+	if (different)
+		logTestString("%u pixels differ\n", different);
+	return different == 0;
+}
+
+} // end anonymous namespace
+
+//! Burning's Video draws the same image when rasterizing on several threads
+bool burningThreads(void)
+{
+	IrrlichtDevice* single = createBurningDevice(0);
+	IrrlichtDevice* threaded = createBurningDevice(3);
+	assert_log(single && threaded);
+	if (!single || !threaded)
+	{
+		if (single)
+			single->drop();
+		if (threaded)
+			threaded->drop();
+		return false;
+	}
+
+	addScene(single);
+	addScene(threaded);
+
+	bool result = true;
+	for (u32 frame=0; frame<4; ++frame)
+	{
+		drawFrame(single, frame);
+		drawFrame(threaded, frame);
+
+		video::IImage* singleShot = single->getVideoDriver()->createScreenShot();
+		video::IImage* threadedShot = threaded->getVideoDriver()->createScreenShot();
+		if (singleShot && threadedShot)
+		{
+			if (!compareImages(singleShot, threadedShot))
+			{
+				logTestString("Frame %u differs\n", frame);
+				result = false;
+			}
+		}
+		else
+			result = false;
+
+		if (singleShot)
+			singleShot->drop();
+		if (threadedShot)
+			threadedShot->drop();
+	}
+
+	single->closeDevice();
+	single->run();
+	single->drop();
+	threaded->closeDevice();
+	threaded->run();
+	threaded->drop();
+
+	return result;
+}
@@ -0,0 +1,105 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+// 2d drawing on top of the scene, the triangles are built on the stack of the
+// driver, so the recorder sees the same address for different vertices
+void drawOverlay(video::IVideoDriver* driver, video::ITexture* texture)
+{
+	driver->setTransform(video::ETS_WORLD, matrix4());
+	video::SMaterial material;
+	material.Lighting = false;
+	driver->setMaterial(material);
+	driver->draw3DTriangle(triangle3df(vector3df(-9.f, 6.f, 20.f), vector3df(-5.f, 9.f, 20.f), vector3df(-5.f, 5.f, 20.f)),
+		video::SColor(255, 255, 255, 0));
+	driver->draw3DTriangle(triangle3df(vector3df(5.f, -5.f, 20.f), vector3df(9.f, -4.f, 20.f), vector3df(7.f, -8.f, 20.f)),
+		video::SColor(255, 0, 255, 255));
+	driver->draw3DBox(aabbox3df(-3.f, -3.f, 14.f, 3.f, 3.f, 18.f), video::SColor(255, 255, 0, 0));
+
+	driver->draw2DImage(texture, position2di(4, 4), recti(0, 0, 32, 32));
+	const video::SColor colors[4] = { 0xffff0000, 0xff00ff00, 0xff0000ff, 0xffffffff };
+	driver->draw2DImage(texture, recti(120, 4, 152, 20), recti(0, 0, 64, 64), 0, colors, false);
+	driver->draw2DRectangle(recti(4, 90, 40, 110), 0xff203040, 0xff405060, 0xff6080a0, 0xffa0c0e0);
+	driver->draw2DRectangleOutline(recti(44, 90, 80, 110), video::SColor(255, 255, 128, 0));
+	driver->draw2DLine(position2di(90, 95), position2di(150, 108), video::SColor(255, 0, 255, 0));
+}
+
+}
+
+//! Scenes recorded into a command list and replayed with Burning's Video
+/** A lit and textured scene with 3d and 2d drawing on top. The replayed frames
+have to match the frame drawn directly, the reference image was rendered
+without the command list. */
+bool commandList(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	video::ITexture* wall = driver->getTexture("../media/wall.bmp");
+
+	ISceneNode* cube = smgr->addCubeSceneNode(8.f, 0, -1, vector3df(-6.f, 0, 30.f), vector3df(30.f, 45.f, 0));
+	cube->setMaterialTexture(0, wall);
+	ISceneNode* sphere = smgr->addSphereSceneNode(5.f, 16, 0, -1, vector3df(7.f, 2.f, 28.f));
+	sphere->setMaterialTexture(0, wall);
+	sphere->getMaterial(0).Shininess = 20.f;
+	smgr->addLightSceneNode(0, vector3df(0, 20.f, 0), video::SColorf(1.f, 0.9f, 0.7f), 60.f);
+	smgr->setAmbientLight(video::SColorf(0.2f, 0.2f, 0.3f));
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255, 90, 110, 130));
+	smgr->drawAll();
+	drawOverlay(driver, wall);
+	driver->endScene();
+
+	bool result = takeScreenshotAndCompareAgainstReference(driver, "-commandList.png", 100.f);
+
+	const u32 drawCalls = driver->getDrawCallCount();
+	video::ICommandList* list = driver->createCommandList();
+	video::IVideoDriver* recorder = list->getRecorder();
+	smgr->drawAll(recorder);
+	drawOverlay(recorder, wall);
+
+	// nothing is drawn while recording
+	result &= (driver->getDrawCallCount() == drawCalls);
+	result &= (smgr->getVideoDriver() == driver);
+	result &= (list->getCommandCount() > 0);
+	result &= (list->getSize() > 0);
+	assert_log(result);
+
+	for (u32 i=0; i<2; ++i)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255, 90, 110, 130));
+		list->replay(driver);
+		driver->endScene();
+
+		result &= takeScreenshotAndCompareAgainstReference(driver, "-commandList.png", 100.f);
+	}
+
+	list->clear();
+	result &= (list->getCommandCount() == 0 && list->getSize() == 0);
+	assert_log(result);
+	list->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,131 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+u32 drawFrame(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	return driver->getPrimitiveCountDrawn(0);
+}
+
+u32 drawFrameBoth(IrrlichtDevice* device, bool& same)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	smgr->setUseCullingHierarchy(false);
+	const u32 reference = drawFrame(device);
+	smgr->setUseCullingHierarchy(true);
+	const u32 result = drawFrame(device);
+	if (result != reference)
+	{
+		logTestString("Culling hierarchy drew %u primitives, expected %u\n", result, reference);
+		same = false;
+	}
+	return result;
+}
+
+}
+
+//! Check that the culling hierarchy renders the same nodes as culling each node on its own
+bool cullingHierarchy(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	bool result = !smgr->getUseCullingHierarchy();
+
+	const u32 cubeTriangles = 12;
+	const s32 gridSize = 16;
+	for (s32 x=0; x<gridSize; ++x)
+	{
+		for (s32 z=0; z<gridSize; ++z)
+		{
+			ISceneNode* cube = smgr->addCubeSceneNode(5.f, 0, -1,
+				vector3df(x*20.f - gridSize*10.f, 0, z*20.f - gridSize*10.f));
+			cube->setAutomaticCulling(EAC_FRUSTUM_BOX);
+		}
+	}
+
+	// nested static nodes are culled together with their parent
+	ISceneNode* group = smgr->addEmptySceneNode();
+	group->setPosition(vector3df(0, 0, 500.f));
+	for (u32 i=0; i<4; ++i)
+	{
+		ISceneNode* cube = smgr->addCubeSceneNode(5.f, group, -1, vector3df(i*10.f, 0, 0));
+		cube->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	}
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0, 50.f, 0));
+
+	// look around, so leaves are partially visible in all directions
+	for (u32 i=0; i<16; ++i)
+	{
+		const f32 angle = i * PI / 8.f;
+		camera->setTarget(vector3df(sinf(angle), 0.7f, cosf(angle)) * -100.f + camera->getPosition());
+		drawFrameBoth(device, result);
+	}
+
+	camera->setPosition(vector3df(0, 50.f, -200.f));
+	camera->setTarget(vector3df(0, 0, 0));
+
+	const u32 visible = drawFrameBoth(device, result);
+	if (visible == 0 || visible >= (gridSize*gridSize + 4) * cubeTriangles)
+	{
+		logTestString("Unexpected number of primitives %u\n", visible);
+		result = false;
+	}
+
+	// move a node from behind the camera into the view
+	ISceneNode* moved = smgr->addCubeSceneNode(5.f, 0, -1, vector3df(0, 50.f, -400.f));
+	moved->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	drawFrameBoth(device, result);
+	moved->setPosition(vector3df(0, 0, -100.f));
+	moved->updateAbsolutePosition();
+	smgr->setCullingHierarchyDirty();
+	if (drawFrameBoth(device, result) != visible + cubeTriangles)
+	{
+		logTestString("Moved node not drawn\n");
+		result = false;
+	}
+
+	// nodes with animators are always checked on their own
+	ISceneNode* animated = smgr->addCubeSceneNode(5.f, 0, -1, vector3df(0, 0, -400.f));
+	animated->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	ISceneNodeAnimator* anim = smgr->createFlyStraightAnimator(vector3df(0, 0, -100.f),
+		vector3df(0, 0, -100.f), 1000, true);
+	animated->addAnimator(anim);
+	anim->drop();
+	if (drawFrameBoth(device, result) != visible + 2*cubeTriangles)
+	{
+		logTestString("Animated node not drawn\n");
+		result = false;
+	}
+
+	// removing nodes must not leave stale pointers in the hierarchy
+	moved->remove();
+	animated->remove();
+	if (drawFrameBoth(device, result) != visible)
+	{
+		logTestString("Removed nodes still drawn\n");
+		result = false;
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,260 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+// a pattern with all channels changing between neighboring pixels
+video::SColor patternColor(u32 x, u32 y)
+{
+	return video::SColor(255 - (x * 7 + y * 3) % 256, (x * 37 + y * 11) % 256, (x * 13 + y * 29) % 256, (x * y * 5) % 256);
+}
+
+video::IImage* createPattern(video::IVideoDriver* driver, video::ECOLOR_FORMAT format, const dimension2du& size, bool opaque)
+{
+	video::IImage* image = driver->createImage(format, size);
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		for (u32 x=0; x<size.Width; ++x)
+		{
+			video::SColor color = patternColor(x, y);
+			if (opaque)
+				color.setAlpha(255);
+			image->setPixel(x, y, color);
+		}
+	}
+	return image;
+}
+
+// Halves images of each supported format and compares the pixels with the
+// average of 2x2 source pixels. Channels with less than 8 bit are averaged
+// in their own precision, so they may differ by one step of that precision.
+bool halveFormats(video::IVideoDriver* driver)
+{
+	static const video::ECOLOR_FORMAT formats[] = { video::ECF_A8R8G8B8, video::ECF_R8G8B8, video::ECF_A1R5G5B5, video::ECF_R5G6B5 };
+	static const s32 tolerance[] = { 0, 0, 8, 8 };
+
+	bool result = true;
+	for (u32 f=0; f<4; ++f)
+	{
+		// odd width and more than a few pixels per row, so the vectorized loop and the rest are used
+		video::IImage* source = createPattern(driver, formats[f], dimension2du(67, 34), f > 1);
+		video::IImage* target = driver->createImage(formats[f], dimension2du(33, 17));
+
+		if (!source->copyToHalfSize(target))
+		{
+			logTestString("copyToHalfSize failed for format %d\n", formats[f]);
+			result = false;
+		}
+
+		for (u32 y=0; y<17 && result; ++y)
+		{
+			for (u32 x=0; x<33; ++x)
+			{
+				s32 sum[4] = { 0, 0, 0, 0 };
+				for (u32 i=0; i<4; ++i)
+				{
+					const video::SColor c = source->getPixel(x * 2 + (i & 1), y * 2 + (i >> 1));
+					sum[0] += c.getAlpha();
+					sum[1] += c.getRed();
+					sum[2] += c.getGreen();
+					sum[3] += c.getBlue();
+				}
+
+				const video::SColor c = target->getPixel(x, y);
+				const s32 channel[4] = { (s32)c.getAlpha(), (s32)c.getRed(), (s32)c.getGreen(), (s32)c.getBlue() };
+				for (u32 i=0; i<4; ++i)
+				{
+					if (abs_(channel[i] - sum[i] / 4) > tolerance[f])
+					{
+						logTestString("format %d pixel %d,%d channel %d is %d instead of %d\n",
+							formats[f], x, y, i, channel[i], sum[i] / 4);
+						result = false;
+						break;
+					}
+				}
+			}
+		}
+
+		target->drop();
+		source->drop();
+	}
+
+	return result;
+}
+
+// Box filtered mip maps of power of two images have the pixels which
+// copyToScalingBoxFilter gives from the full image, in every format and also
+// for the levels which are only one pixel high.
+bool scaledBoxLevels(video::IVideoDriver* driver)
+{
+	static const video::ECOLOR_FORMAT formats[] = { video::ECF_A8R8G8B8, video::ECF_R8G8B8, video::ECF_A1R5G5B5, video::ECF_R5G6B5 };
+
+	bool result = true;
+	for (u32 f=0; f<4 && result; ++f)
+	{
+		video::IImage* image = createPattern(driver, formats[f], dimension2du(64, 8), f > 1);
+		result &= image->createMipMaps();
+
+		const u8* level = (const u8*)image->getMipMapsData();
+		dimension2du size(64, 8);
+		while (result && (size.Width > 1 || size.Height > 1))
+		{
+			size.set(core::max_(1u, size.Width / 2), core::max_(1u, size.Height / 2));
+
+			video::IImage* scaled = driver->createImage(formats[f], size);
+			image->copyToScalingBoxFilter(scaled);
+			if (memcmp(level, scaled->getData(), scaled->getImageDataSizeInBytes()))
+			{
+				logTestString("format %d mip map level %dx%d differs from copyToScalingBoxFilter\n", formats[f], size.Width, size.Height);
+				result = false;
+			}
+			level += scaled->getImageDataSizeInBytes();
+			scaled->drop();
+		}
+		image->drop();
+	}
+
+	return result;
+}
+
+// The threads of the job system halve the same pixels as the calling thread.
+bool halveWithJobs(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	video::IImage* source = createPattern(driver, video::ECF_A8R8G8B8, dimension2du(1024, 600), false);
+	video::IImage* serial = driver->createImage(video::ECF_A8R8G8B8, dimension2du(512, 300));
+	video::IImage* parallel = driver->createImage(video::ECF_A8R8G8B8, dimension2du(512, 300));
+
+	bool result = source->copyToHalfSize(serial, video::EMMF_BOX, 0);
+	result &= source->copyToHalfSize(parallel, video::EMMF_BOX, device->getJobSystem());
+	result &= 0 == memcmp(serial->getData(), parallel->getData(), serial->getImageDataSizeInBytes());
+
+	result &= source->copyToHalfSize(serial, video::EMMF_KAISER, 0);
+	result &= source->copyToHalfSize(parallel, video::EMMF_KAISER, device->getJobSystem());
+	result &= 0 == memcmp(serial->getData(), parallel->getData(), serial->getImageDataSizeInBytes());
+
+	// summed up levels
+	video::IImage* square = createPattern(driver, video::ECF_A8R8G8B8, dimension2du(1024, 1024), false);
+	result &= square->createMipMaps(video::EMMF_BOX, 0);
+	video::IImage* half = driver->createImage(video::ECF_A8R8G8B8, dimension2du(512, 512));
+	memcpy(half->getData(), square->getMipMapsData(), half->getImageDataSizeInBytes());
+	result &= square->createMipMaps(video::EMMF_BOX, device->getJobSystem());
+	result &= 0 == memcmp(half->getData(), square->getMipMapsData(), half->getImageDataSizeInBytes());
+	half->drop();
+	square->drop();
+
+	if (!result)
+		logTestString("halving with the job system differs\n");
+
+	parallel->drop();
+	serial->drop();
+	source->drop();
+
+	return result;
+}
+
+// The mip map chain goes down to 1x1, the first level is the halved image, and
+// both filters keep a constant color. 64x16 is summed up, 48x16 halved level by level.
+bool mipMapChain(video::IVideoDriver* driver)
+{
+	bool result = true;
+
+	video::IImage* image;
+	for (u32 width=48; width<=64; width+=16)
+	{
+		image = createPattern(driver, video::ECF_A8R8G8B8, dimension2du(width, 16), false);
+		video::IImage* half = driver->createImage(video::ECF_A8R8G8B8, dimension2du(width / 2, 8));
+		image->copyToHalfSize(half);
+
+		result &= image->createMipMaps();
+		result &= image->getMipMapsData() != 0 &&
+			0 == memcmp(image->getMipMapsData(), half->getData(), half->getImageDataSizeInBytes());
+
+		half->drop();
+		image->drop();
+	}
+
+	const video::SColor color(200, 10, 128, 255);
+	for (u32 filter=video::EMMF_BOX; filter<=video::EMMF_KAISER; ++filter)
+	{
+		image = driver->createImage(video::ECF_A8R8G8B8, dimension2du(16, 4));
+		image->fill(color);
+		result &= image->createMipMaps((video::E_MIP_MAP_FILTER)filter);
+
+		// levels 8x2, 4x1, 2x1 and 1x1
+		const u32* texels = (const u32*)image->getMipMapsData();
+		for (u32 i=0; i<16+4+2+1; ++i)
+		{
+			if (texels[i] != color.color)
+			{
+				logTestString("mip map texel %d is %08x with filter %d\n", i, texels[i], filter);
+				result = false;
+				break;
+			}
+		}
+		image->drop();
+	}
+
+	if (!result)
+		logTestString("mip map chain failed\n");
+
+	return result;
+}
+
+// Other formats and sizes are refused.
+bool refuseOthers(video::IVideoDriver* driver)
+{
+	video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, dimension2du(16, 16));
+	video::IImage* wrongSize = driver->createImage(video::ECF_A8R8G8B8, dimension2du(16, 8));
+	video::IImage* wrongFormat = driver->createImage(video::ECF_R5G6B5, dimension2du(8, 8));
+	video::IImage* compressed = driver->createImage(video::ECF_DXT1, dimension2du(16, 16));
+
+	const bool result = !image->copyToHalfSize(wrongSize) && !image->copyToHalfSize(wrongFormat) &&
+		!compressed->createMipMaps() && compressed->getMipMapsData() == 0;
+
+	if (!result)
+		logTestString("copyToHalfSize accepted a wrong target\n");
+
+	compressed->drop();
+	wrongFormat->drop();
+	wrongSize->drop();
+	image->drop();
+
+	return result;
+}
+
+}
+
+//! Halving images and creating mip map chains with IImage::copyToHalfSize and createMipMaps
+bool imageMipMaps(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.DeviceType = EIDT_CONSOLE;
+	params.JobThreads = 2;
+	params.LoggingLevel = ELL_ERROR;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	bool result = halveFormats(driver);
+	result &= scaledBoxLevels(driver);
+	result &= halveWithJobs(device);
+	result &= mipMapChain(driver);
+	result &= refuseOthers(driver);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,186 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+vector3df getInstancePosition(u32 i)
+{
+	return vector3df((f32)(i % 10) * 20.f - 100.f, 0, (f32)(i / 10) * 20.f - 100.f);
+}
+
+vector3df getInstanceRotation(u32 i)
+{
+	return vector3df(0, (f32)i * 7.f, 0);
+}
+
+//! Same matrix as the relative transformation of a scene node
+matrix4 getInstanceMatrix(u32 i)
+{
+	matrix4 m;
+	m.setRotationDegrees(getInstanceRotation(i));
+	m.setTranslation(getInstancePosition(i));
+	return m;
+}
+
+//! Culling of the single instances and the primitives drawn for them
+bool testCulling()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	bool result = true;
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(5.f));
+	IInstancedMeshSceneNode* node = smgr->addInstancedMeshSceneNode(cube);
+	cube->drop();
+	result &= (node->getType() == ESNT_INSTANCED_MESH);
+
+	for (u32 i=0; i<100; ++i)
+		result &= (node->addInstance(getInstanceMatrix(i)) == i);
+	result &= (node->getInstanceCount() == 100);
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0, 200.f, -300.f), vector3df(0, 0, 0));
+
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	result &= (node->getVisibleInstanceCount() == 100);
+	result &= (driver->getPrimitiveCountDrawn() == 100 * 12);
+
+	// only the left column in view
+	camera->setPosition(vector3df(-100.f, 5.f, -150.f));
+	camera->setTarget(vector3df(-100.f, 5.f, 0));
+	camera->setFOV(0.1f);
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	if (node->getVisibleInstanceCount() != 10)
+	{
+		logTestString("%u instances visible, expected 10\n", node->getVisibleInstanceCount());
+		result = false;
+	}
+	result &= (driver->getPrimitiveCountDrawn() == 10 * 12);
+
+	// instances are in the space of the node
+	node->setPosition(vector3df(20.f, 0, 0));
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	result &= (node->getVisibleInstanceCount() == 0);
+
+	node->setPosition(vector3df(0, 0, 0));
+	node->removeInstance(0);
+	node->setInstanceTransformation(10, getInstanceMatrix(0));
+	result &= (node->getInstanceCount() == 99);
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	result &= (node->getVisibleInstanceCount() == 9);
+
+	// bounding box around all instances
+	const aabbox3df& box = node->getBoundingBox();
+	result &= box.isPointInside(vector3df(-100.f, 0, -100.f)) && box.isPointInside(vector3df(80.f, 0, 80.f));
+
+	node->clearInstances();
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	result &= (driver->getPrimitiveCountDrawn() == 0);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		logTestString("Culling of instances failed\n");
+	return result;
+}
+
+//! The instances have to look exactly like single mesh scene nodes
+bool testDrawing(video::E_DRIVER_TYPE driverType)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = driverType;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return true; // No error if device does not exist
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(5.f));
+	IInstancedMeshSceneNode* node = smgr->addInstancedMeshSceneNode(cube);
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+	for (u32 i=0; i<100; ++i)
+		node->addInstance(getInstanceMatrix(i), video::SColor(255, 255, (i * 40) % 256, (i * 90) % 256));
+
+	smgr->addCameraSceneNode(0, vector3df(0, 200.f, -300.f), vector3df(0, 0, 0));
+
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	video::IImage* instanced = driver->createScreenShot();
+
+	// same scene with one node per instance, colors set in copies of the mesh
+	node->remove();
+	for (u32 i=0; i<100; ++i)
+	{
+		IMesh* copy = smgr->getMeshManipulator()->createMeshCopy(cube);
+		smgr->getMeshManipulator()->setVertexColors(copy, video::SColor(255, 255, (i * 40) % 256, (i * 90) % 256));
+		IMeshSceneNode* single = smgr->addMeshSceneNode(copy, 0, -1, getInstancePosition(i), getInstanceRotation(i));
+		single->setMaterialFlag(video::EMF_LIGHTING, false);
+		copy->drop();
+	}
+	cube->drop();
+
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	video::IImage* single = driver->createScreenShot();
+
+	bool result = instanced && single;
+	if (result)
+	{
+		const u32 size = instanced->getImageDataSizeInBytes();
+		result = (size == single->getImageDataSizeInBytes()) &&
+			!memcmp(instanced->getData(), single->getData(), size);
+	}
+	if (instanced)
+		instanced->drop();
+	if (single)
+		single->drop();
+
+	if (!result)
+		logTestString("Instances drawn differently than single nodes with %ls\n", driver->getName());
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+}
+
+bool instancedMeshSceneNode(void)
+{
+	bool result = testCulling();
+	result &= testDrawing(video::EDT_BURNINGSVIDEO);
+	result &= testDrawing(video::EDT_SOFTWARE);
+	return result;
+}
+
@@ -0,0 +1,143 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Lights which can't reach into the view frustum are not added to the driver
+bool testFrustumCulling()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	bool result = true;
+
+	smgr->addCameraSceneNode(0, vector3df(0, 0, -100.f), vector3df(0, 0, 0));
+
+	// a row of small lights, -100 to 100 are close enough to the frustum
+	for (s32 i=-10; i<=10; ++i)
+		smgr->addLightSceneNode(0, vector3df((f32)i * 50.f, 0, 0), video::SColorf(1.f, 1.f, 1.f), 10.f);
+	// behind the camera
+	smgr->addLightSceneNode(0, vector3df(0, 0, -200.f), video::SColorf(1.f, 1.f, 1.f), 10.f);
+	// directional lights are never culled
+	ILightSceneNode* sun = smgr->addLightSceneNode(0, vector3df(0, 0, -5000.f));
+	sun->setLightType(video::ELT_DIRECTIONAL);
+
+	result &= !smgr->getUseLightCulling();
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	// the null driver has no lights, so none are added at all
+	result &= (driver->getDynamicLightCount() == core::min_(driver->getMaximalDynamicLightAmount(), 23u));
+
+	smgr->setUseLightCulling(true);
+	result &= smgr->getUseLightCulling();
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	if (driver->getDynamicLightCount() != 6)
+	{
+		logTestString("%u lights after culling, expected 6\n", driver->getDynamicLightCount());
+		result = false;
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+//! Brightness of the screen pixel at a position
+u32 getBrightness(ISceneManager* smgr, video::IImage* image, const vector3df& pos)
+{
+	const position2di p = smgr->getSceneCollisionManager()->getScreenCoordinatesFrom3DPosition(pos);
+	const video::SColor c = image->getPixel(p.X, p.Y);
+	return c.getRed() + c.getGreen() + c.getBlue();
+}
+
+//! Each node gets the lights next to it, no matter how many lights there are
+bool testSelection()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(320, 240);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return true; // No error if device does not exist
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	bool result = true;
+
+	// 16 cubes in a row, each with a light above which doesn't reach the others
+	const u32 count = 16;
+	for (u32 i=0; i<count; ++i)
+	{
+		const f32 x = ((f32)i - (count - 1) * 0.5f) * 15.f;
+		smgr->addCubeSceneNode(5.f, 0, -1, vector3df(x, 0, 0));
+		smgr->addLightSceneNode(0, vector3df(x, 8.f, 0), video::SColorf(1.f, 1.f, 1.f), 10.f);
+	}
+	smgr->addCameraSceneNode(0, vector3df(0, 150.f, -1.f), vector3df(0, 0, 0));
+
+	for (u32 pass=0; pass<2; ++pass)
+	{
+		smgr->setUseLightCulling(pass == 1);
+
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+
+		video::IImage* image = driver->createScreenShot();
+		if (!image)
+		{
+			result = false;
+			break;
+		}
+
+		u32 lit = 0;
+		for (u32 i=0; i<count; ++i)
+		{
+			const f32 x = ((f32)i - (count - 1) * 0.5f) * 15.f;
+			if (getBrightness(smgr, image, vector3df(x, 2.5f, 0)) > 30)
+				++lit;
+		}
+		image->drop();
+
+		// without light culling only the 8 lights closest to the camera are on
+		const u32 expected = pass ? count : driver->getMaximalDynamicLightAmount();
+		if (lit != expected)
+		{
+			logTestString("%u cubes lit, expected %u\n", lit, expected);
+			result = false;
+		}
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+}
+
+bool lightCulling(void)
+{
+	bool result = testFrustumCulling();
+	result &= testSelection();
+	return result;
+}
+
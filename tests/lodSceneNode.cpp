@@ -0,0 +1,159 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Moves the camera on the z axis to see the node at the screen size
+void moveToScreenSize(ICameraSceneNode* camera, ILODSceneNode* node, f32 screenSize)
+{
+	const f32 radius = node->getBoundingBox().getExtent().getLength() * 0.5f;
+	const f32 distance = radius * camera->getProjectionMatrix()[5] / screenSize;
+	camera->setPosition(vector3df(camera->getPosition().X, 0, -distance));
+}
+
+//! Number of triangles of a level, 0 for the level behind the last one
+u32 getLevelPrimitives(ILODSceneNode* node, u32 level)
+{
+	u32 primitives = 0;
+	if (level < node->getLevelCount())
+	{
+		IMesh* mesh = node->getLevelMesh(level);
+		for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+			primitives += mesh->getMeshBuffer(i)->getIndexCount() / 3;
+	}
+	return primitives;
+}
+
+//! Moves the camera to get the screen size, draws and checks the level
+bool drawAtScreenSize(IrrlichtDevice* device, ILODSceneNode* node, f32 screenSize, u32 expectedLevel)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	moveToScreenSize(smgr->getActiveCamera(), node, screenSize);
+
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+
+	const u32 primitives = getLevelPrimitives(node, expectedLevel);
+	if (node->getCurrentLevel() != expectedLevel || driver->getPrimitiveCountDrawn() != primitives ||
+		!equals(node->getScreenSize(), screenSize, 0.001f))
+	{
+		logTestString("At screen size %f level %u with %u primitives was drawn instead of level %u\n",
+			screenSize, node->getCurrentLevel(), driver->getPrimitiveCountDrawn(), expectedLevel);
+		return false;
+	}
+	return true;
+}
+
+//! Draws two views with the cameras at different screen sizes and checks the level of each
+bool drawViews(IrrlichtDevice* device, ILODSceneNode* node, const array<SSceneView>& views,
+		f32 nearSize, f32 farSize, u32 nearLevel, u32 farLevel)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	moveToScreenSize(views[0].Camera, node, nearSize);
+	moveToScreenSize(views[1].Camera, node, farSize);
+
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	device->getSceneManager()->drawAll(views);
+	driver->endScene();
+
+	// the far camera draws last
+	const u32 primitives = getLevelPrimitives(node, nearLevel) + getLevelPrimitives(node, farLevel);
+	if (node->getCurrentLevel() != farLevel || driver->getPrimitiveCountDrawn() != primitives)
+	{
+		logTestString("Views at screen sizes %f and %f drew %u primitives instead of levels %u and %u\n",
+			nearSize, farSize, driver->getPrimitiveCountDrawn(), nearLevel, farLevel);
+		return false;
+	}
+	return true;
+}
+
+} // end anonymous namespace
+
+
+//! The LOD scene node draws the level for its screen size, without flickering at the thresholds
+bool lodSceneNode(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	const IGeometryCreator* geometry = smgr->getGeometryCreator();
+
+	smgr->addCameraSceneNode(0, vector3df(0, 0, -10.f), vector3df(0, 0, 0));
+
+	ILODSceneNode* node = smgr->addLODSceneNode();
+	IMesh* meshes[3];
+	meshes[0] = geometry->createSphereMesh(1.f, 32, 32);
+	meshes[1] = geometry->createSphereMesh(1.f, 16, 16);
+	meshes[2] = geometry->createSphereMesh(1.f, 8, 8);
+
+	// added out of order, kept sorted by screen size
+	bool result = (node->addLevel(meshes[1], 0.1f) == 0);
+	result &= (node->addLevel(meshes[0], 0.5f) == 0);
+	result &= (node->addLevel(meshes[2], 0.02f) == 2);
+	result &= (node->getLevelCount() == 3);
+	result &= (node->getLevelMesh(0) == meshes[0] && node->getLevelMesh(1) == meshes[1] && node->getLevelMesh(2) == meshes[2]);
+	result &= (node->getMaterialCount() == 3);
+	result &= equals(node->getHysteresis(), 0.1f);
+
+	for (u32 i=0; i<3; ++i)
+		meshes[i]->drop();
+
+	result &= drawAtScreenSize(device, node, 1.f, 0);
+	// the level only changes 10% past the threshold
+	result &= drawAtScreenSize(device, node, 0.47f, 0);
+	result &= drawAtScreenSize(device, node, 0.44f, 1);
+	result &= drawAtScreenSize(device, node, 0.53f, 1);
+	result &= drawAtScreenSize(device, node, 0.56f, 0);
+	result &= drawAtScreenSize(device, node, 0.05f, 2);
+	// too small for the last level
+	result &= drawAtScreenSize(device, node, 0.01f, 3);
+	result &= drawAtScreenSize(device, node, 0.021f, 3);
+	result &= drawAtScreenSize(device, node, 0.023f, 2);
+
+	// each view of drawAll selects the level for its own camera, with its own hysteresis
+	array<SSceneView> views;
+	views.push_back(SSceneView(smgr->addCameraSceneNode(0, vector3df(0, 0, -10.f), vector3df(0, 0, 0), -1, false),
+		rect<s32>(0, 0, 80, 120)));
+	views.push_back(SSceneView(smgr->addCameraSceneNode(0, vector3df(0, 0, -20.f), vector3df(0, 0, 0), -1, false),
+		rect<s32>(80, 0, 160, 120)));
+	result &= drawViews(device, node, views, 1.f, 0.05f, 0, 2);
+	// past the threshold by less than the hysteresis, so both cameras keep their level
+	result &= drawViews(device, node, views, 0.47f, 0.105f, 0, 2);
+	result &= drawViews(device, node, views, 0.3f, 0.105f, 1, 2);
+	result &= drawViews(device, node, views, 0.3f, 0.12f, 1, 1);
+	views[0].Camera->remove();
+	views[1].Camera->remove();
+
+	// without hysteresis the thresholds are exact
+	node->setHysteresis(0.f);
+	result &= drawAtScreenSize(device, node, 0.11f, 1);
+	result &= drawAtScreenSize(device, node, 0.09f, 2);
+
+	// clones have the same levels
+	ILODSceneNode* clone = (ILODSceneNode*)node->clone();
+	result &= (clone->getType() == ESNT_LOD_MESH && clone->getLevelCount() == 3);
+	result &= (clone->getLevelMesh(1) == node->getLevelMesh(1));
+	clone->remove();
+
+	node->clearLevels();
+	result &= (node->getLevelCount() == 0 && node->getMaterialCount() == 0);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -82,6 +82,30 @@ int main(int argumentCount, char * arguments[])
 	TEST(removeCustomAnimator);
 	TEST(sceneCollisionManager);
 	TEST(sceneNodeAnimator);
+	TEST(cullingHierarchy);
+	TEST(parallelAnimation);
+	TEST(sceneNodeTransformation);
+	TEST(renderQueue);
+	TEST(staticBatching);
+	TEST(instancedMeshSceneNode);
+	TEST(lightCulling);
+	TEST(objectPool);
+	TEST(sceneNodeLookup);
+	TEST(lodSceneNode);
+	TEST(meshSimplification);
+	TEST(softwareOcclusionCulling);
+	TEST(q3LevelSceneNode);
+	TEST(binarySceneFile);
+	TEST(multipleViews);
+	TEST(animationTimeStep);
+	TEST(sceneStats);
+	TEST(burningThreads);
+	TEST(burningLighting);
+	TEST(burningSpans);
+	TEST(burningDepthTiles);
+	TEST(burningTextureTiles);
+	TEST(imageMipMaps);
+	TEST(commandList);
 	TEST(meshLoaders);
 	TEST(testTimer);
 	TEST(testCoreutil);
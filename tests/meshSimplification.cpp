@@ -0,0 +1,192 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+u32 getTriangleCount(IMesh* mesh)
+{
+	u32 count = 0;
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+		count += mesh->getMeshBuffer(i)->getIndexCount() / 3;
+	return count;
+}
+
+//! Adds a flat grid of quads in the x/z plane to the mesh
+void addGrid(SMesh* mesh, f32 x, u32 size)
+{
+	SMeshBuffer* mb = new SMeshBuffer();
+	for (u32 z=0; z<=size; ++z)
+		for (u32 i=0; i<=size; ++i)
+			mb->Vertices.push_back(video::S3DVertex(x + i, 0, (f32)z, 0, 1, 0,
+				video::SColor(255, 255, 255, 255), (f32)i / size, (f32)z / size));
+
+	for (u32 z=0; z<size; ++z)
+	{
+		for (u32 i=0; i<size; ++i)
+		{
+			const u16 v = (u16)(z * (size + 1) + i);
+			mb->Indices.push_back(v);
+			mb->Indices.push_back(v + size + 1);
+			mb->Indices.push_back(v + size + 2);
+			mb->Indices.push_back(v);
+			mb->Indices.push_back(v + size + 2);
+			mb->Indices.push_back(v + 1);
+		}
+	}
+	mb->recalculateBoundingBox();
+	mesh->addMeshBuffer(mb);
+	mb->drop();
+}
+
+//! Checks that the mesh buffer has a vertex at the position
+bool hasPosition(IMeshBuffer* mb, const vector3df& position)
+{
+	for (u32 i=0; i<mb->getVertexCount(); ++i)
+		if (mb->getPosition(i) == position)
+			return true;
+	return false;
+}
+
+//! Checks that all vertices of the simplified buffer were in the original one
+bool keepsVertices(IMeshBuffer* original, IMeshBuffer* simplified)
+{
+	const u32 pitch = video::getVertexPitchFromType(original->getVertexType());
+	if (simplified->getVertexType() != original->getVertexType())
+		return false;
+
+	for (u32 i=0; i<simplified->getVertexCount(); ++i)
+	{
+		const u8* vertex = (const u8*)simplified->getVertices() + i * pitch;
+		u32 j = 0;
+		while (j < original->getVertexCount() && memcmp(vertex, (const u8*)original->getVertices() + j * pitch, pitch))
+			++j;
+		if (j == original->getVertexCount())
+			return false;
+	}
+	return true;
+}
+
+//! Two grids with different materials next to each other, simplified as far as possible
+bool simplifyGrids(IMeshManipulator* manipulator, video::E_VERTEX_TYPE vertexType)
+{
+	SMesh* grids = new SMesh();
+	addGrid(grids, 0, 8);
+	addGrid(grids, 8, 8);
+	grids->getMeshBuffer(1)->getMaterial().DiffuseColor.set(255, 255, 0, 0);
+	grids->recalculateBoundingBox();
+
+	IMesh* mesh = grids;
+	if (vertexType == video::EVT_2TCOORDS)
+		mesh = manipulator->createMeshWith2TCoords(grids);
+	else if (vertexType == video::EVT_TANGENTS)
+		mesh = manipulator->createMeshWithTangents(grids, false, false, false, false);
+	if (mesh != grids)
+		grids->drop();
+
+	IMesh* simplified = manipulator->createMeshSimplified(mesh, 0.f);
+
+	bool result = (simplified->getMeshBufferCount() == 2);
+	result &= (simplified->getBoundingBox() == mesh->getBoundingBox());
+	result &= (simplified->getMeshBuffer(1)->getMaterial() == mesh->getMeshBuffer(1)->getMaterial());
+
+	// the positions on the shared edge stay where they are
+	for (u32 z=0; z<=8; ++z)
+	{
+		result &= hasPosition(simplified->getMeshBuffer(0), vector3df(8.f, 0, (f32)z));
+		result &= hasPosition(simplified->getMeshBuffer(1), vector3df(8.f, 0, (f32)z));
+	}
+
+	for (u32 i=0; i<2; ++i)
+		result &= keepsVertices(mesh->getMeshBuffer(i), simplified->getMeshBuffer(i));
+
+	// only the triangles along the shared edge are needed
+	const u32 triangles = getTriangleCount(simplified);
+	result &= (triangles >= 2 * 8 && triangles < 2 * 8 * 2);
+
+	if (!result)
+		logTestString("Simplifying the grids with vertex type %d failed, %u triangles left\n", vertexType, triangles);
+
+	simplified->drop();
+	mesh->drop();
+	return result;
+}
+
+//! A sphere with a texture seam and poles, simplified to a quarter and by error
+bool simplifySphere(IMeshManipulator* manipulator, const IGeometryCreator* geometry)
+{
+	IMesh* sphere = geometry->createSphereMesh(1.f, 64, 64);
+	const u32 original = getTriangleCount(sphere);
+
+	IMesh* simplified = manipulator->createMeshSimplified(sphere, 0.25f);
+	const u32 triangles = getTriangleCount(simplified);
+
+	bool result = (triangles <= original / 4 + 1 && triangles > original / 8);
+	result &= keepsVertices(sphere->getMeshBuffer(0), simplified->getMeshBuffer(0));
+
+	// the shape stays close to the sphere
+	const aabbox3df& box = simplified->getBoundingBox();
+	result &= (box.MinEdge.X < -0.95f && box.MaxEdge.X > 0.95f && box.MinEdge.Y < -0.99f && box.MaxEdge.Y > 0.99f);
+
+	// the seam of the texture coordinates keeps both sides
+	IMeshBuffer* mb = simplified->getMeshBuffer(0);
+	u32 seamVertices = 0;
+	for (u32 i=0; i<mb->getVertexCount(); ++i)
+		if (mb->getTCoords(i).X == 0.f || mb->getTCoords(i).X == 1.f)
+			++seamVertices;
+	result &= (seamVertices >= 4);
+
+	if (!result)
+		logTestString("Simplifying the sphere left %u of %u triangles\n", triangles, original);
+	simplified->drop();
+
+	// a small error allows to remove only a few triangles
+	simplified = manipulator->createMeshSimplified(sphere, 0.f, 0.0001f);
+	const u32 accurate = getTriangleCount(simplified);
+	simplified->drop();
+	simplified = manipulator->createMeshSimplified(sphere, 0.f, 0.01f);
+	const u32 coarse = getTriangleCount(simplified);
+	simplified->drop();
+
+	if (accurate < original * 3 / 4 || coarse >= accurate || coarse == 0)
+	{
+		logTestString("Simplifying the sphere by error left %u and %u of %u triangles\n", accurate, coarse, original);
+		result = false;
+	}
+
+	sphere->drop();
+	return result;
+}
+
+} // end anonymous namespace
+
+
+//! Simplified meshes have less triangles but keep borders, seams and material boundaries
+bool meshSimplification(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	IMeshManipulator* manipulator = smgr->getMeshManipulator();
+
+	bool result = simplifyGrids(manipulator, video::EVT_STANDARD);
+	result &= simplifyGrids(manipulator, video::EVT_2TCOORDS);
+	result &= simplifyGrids(manipulator, video::EVT_TANGENTS);
+	result &= simplifySphere(manipulator, smgr->getGeometryCreator());
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,150 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Counts how often the scene is animated
+class CCountingAnimator : public ISceneNodeAnimator
+{
+public:
+
+	CCountingAnimator() : Count(0) {}
+
+	virtual void animateNode(ISceneNode* node, u32 timeMs) _IRR_OVERRIDE_
+	{
+		++Count;
+	}
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0) _IRR_OVERRIDE_
+	{
+		return new CCountingAnimator();
+	}
+
+	u32 Count;
+};
+
+bool compareImages(video::IImage* a, video::IImage* b)
+{
+	if (!a || !b || a->getDimension() != b->getDimension() || a->getColorFormat() != b->getColorFormat())
+		return false;
+
+	const bool equal = memcmp(a->getData(), b->getData(), a->getImageDataSizeInBytes()) == 0;
+	if (!equal)
+		logTestString("The views differ from drawing each camera on its own\n");
+	return equal;
+}
+
+} // end anonymous namespace
+
+
+//! drawAll with several views animates once and draws like drawAll for each camera
+bool multipleViews(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	ISceneNode* cube = smgr->addCubeSceneNode(10.f, 0, -1, vector3df(0, 0, 20.f));
+	cube->setMaterialFlag(video::EMF_LIGHTING, false);
+	cube->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	cube->setMaterialTexture(0, driver->getTexture("../media/wall.bmp"));
+	ISceneNode* sphere = smgr->addSphereSceneNode(5.f, 16, 0, -1, vector3df(30.f, 0, 20.f));
+	sphere->setMaterialFlag(video::EMF_LIGHTING, false);
+	sphere->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	sphere->setMaterialTexture(0, driver->getTexture("../media/fire.bmp"));
+	sphere->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+
+	// nodes which cull their geometry against the camera themselves
+	IMesh* mesh = smgr->getGeometryCreator()->createCubeMesh(vector3df(4.f));
+	IInstancedMeshSceneNode* instances = smgr->addInstancedMeshSceneNode(mesh, 0, -1, vector3df(500.f, 0, 20.f));
+	mesh->drop();
+	instances->setMaterialFlag(video::EMF_LIGHTING, false);
+	for (u32 i=0; i<3; ++i)
+	{
+		matrix4 m;
+		m.setTranslation(vector3df((f32)i * 8.f - 8.f, 0, 0));
+		instances->addInstance(m, video::SColor(255, 255, 128 * i, 0));
+	}
+	ITerrainSceneNode* terrain = smgr->addTerrainSceneNode("../media/terrain-heightmap.bmp", 0, -1,
+		vector3df(440.f, -30.f, 20.f), vector3df(0, 0, 0), vector3df(0.5f, 0.05f, 0.5f));
+	assert_log(terrain);
+	if (terrain)
+	{
+		terrain->setMaterialFlag(video::EMF_LIGHTING, false);
+		terrain->setMaterialTexture(0, driver->getTexture("../media/terrain-texture.jpg"));
+	}
+
+	CCountingAnimator* counter = new CCountingAnimator();
+	cube->addAnimator(counter);
+	counter->drop();
+
+	// the cube, the sphere and the instances with the terrain are each seen by one camera only
+	ICameraSceneNode* left = smgr->addCameraSceneNode(0, vector3df(0, 10.f, 0), vector3df(0, 0, 20.f));
+	ICameraSceneNode* right = smgr->addCameraSceneNode(0, vector3df(30.f, -5.f, 0), vector3df(30.f, 0, 20.f));
+	ICameraSceneNode* bottom = smgr->addCameraSceneNode(0, vector3df(500.f, 20.f, -30.f), vector3df(500.f, 0, 20.f));
+	ICameraSceneNode* main = smgr->addCameraSceneNode(0, vector3df(15.f, 0, -20.f), vector3df(15.f, 0, 20.f));
+	left->setAspectRatio(1.f);
+	right->setAspectRatio(1.f);
+	bottom->setAspectRatio(160.f / 40.f);
+
+	array<SSceneView> views;
+	views.push_back(SSceneView(left, rect<s32>(0, 0, 80, 80)));
+	views.push_back(SSceneView(right, rect<s32>(80, 0, 160, 80)));
+	views.push_back(SSceneView(bottom, rect<s32>(0, 80, 160, 120)));
+
+	// reference, drawAll for each camera
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 50));
+	for (u32 i=0; i<views.size(); ++i)
+	{
+		driver->setViewPort(views[i].Viewport);
+		smgr->setActiveCamera(views[i].Camera);
+		smgr->drawAll();
+	}
+	driver->endScene();
+	const u32 primitives = driver->getPrimitiveCountDrawn();
+	video::IImage* reference = driver->createScreenShot();
+	bool result = (counter->Count == 3);
+
+	smgr->setActiveCamera(main);
+	driver->setViewPort(rect<s32>(0, 0, 160, 120));
+
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 50));
+	smgr->drawAll(views);
+	driver->endScene();
+	video::IImage* image = driver->createScreenShot();
+
+	result &= (counter->Count == 4);
+	result &= compareImages(reference, image);
+	// 12 triangles of the cube, 16 * 16 * 2 of the sphere, 12 of each instance and the terrain
+	result &= (primitives > 12 + 512 + 3 * 12 && driver->getPrimitiveCountDrawn() == primitives);
+	result &= (instances->getVisibleInstanceCount() == 3);
+	result &= (smgr->getActiveCamera() == main && driver->getViewPort() == rect<s32>(0, 0, 160, 120));
+
+	if (reference)
+		reference->drop();
+	if (image)
+		image->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,119 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! A scene node which is its own animator, both bases have the pooled operators
+class CSelfAnimatedSceneNode : public ISceneNode, public ISceneNodeAnimator
+{
+public:
+
+	CSelfAnimatedSceneNode(ISceneManager* mgr) : ISceneNode(0, mgr), Count(0) {}
+
+	virtual void render() _IRR_OVERRIDE_ {}
+
+	virtual const aabbox3df& getBoundingBox() const _IRR_OVERRIDE_ { return Box; }
+
+	virtual void animateNode(ISceneNode* node, u32 timeMs) _IRR_OVERRIDE_ { ++Count; }
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0) _IRR_OVERRIDE_ { return 0; }
+
+	aabbox3df Box;
+	u32 Count;
+};
+
+}
+
+//! Scene nodes, animators and mesh buffers from pools behave like the ones from the heap
+bool objectPool(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	bool result = !getUseObjectPools();
+
+	// created before the pools are used, freed from the heap later
+	ISceneNode* heapNode = smgr->addEmptySceneNode();
+	CSelfAnimatedSceneNode* heapBoth = new CSelfAnimatedSceneNode(smgr);
+
+	setUseObjectPools(true);
+	result &= getUseObjectPools();
+
+	// nodes of one type are next to each other
+	array<ISceneNode*> nodes;
+	for (u32 i=0; i<3; ++i)
+		nodes.push_back(smgr->addEmptySceneNode());
+	const size_t stride = (size_t)((u8*)nodes[1] - (u8*)nodes[0]);
+	if ((u8*)nodes[2] - (u8*)nodes[1] != (ptrdiff_t)stride || stride > 1024)
+	{
+		logTestString("Pooled scene nodes are not allocated in sequence\n");
+		result = false;
+	}
+
+	// grab and drop work as usual
+	nodes[1]->grab();
+	nodes[1]->remove();
+	result &= (nodes[1]->getReferenceCount() == 1);
+	nodes[1]->drop();
+
+	// the freed memory is used again
+	ISceneNode* reused = smgr->addEmptySceneNode();
+	result &= (reused == nodes[1]);
+
+	// also after all objects of the size class were freed
+	CSelfAnimatedSceneNode* both = new CSelfAnimatedSceneNode(smgr);
+	both->animateNode(both, 0);
+	result &= (both->Count == 1);
+	void* freed = both;
+	both->ISceneNode::drop();
+	both = new CSelfAnimatedSceneNode(smgr);
+	result &= ((void*)both == freed);
+	both->ISceneNode::drop();
+	heapBoth->ISceneNode::drop();
+
+	// draw a scene of pooled nodes
+	for (u32 i=0; i<10; ++i)
+	{
+		ISceneNode* cube = smgr->addCubeSceneNode(5.f, nodes[0], -1, vector3df((f32)i * 10.f, 0, 0));
+		ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0, 1.f, 0));
+		cube->addAnimator(anim);
+		anim->drop();
+	}
+	smgr->addCameraSceneNode(0, vector3df(45.f, 20.f, -100.f), vector3df(45.f, 0, 0));
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	result &= (driver->getPrimitiveCountDrawn() == 10 * 12);
+
+	SMeshBuffer* buffer = new SMeshBuffer();
+	buffer->Vertices.push_back(video::S3DVertex());
+	result &= (buffer->getVertexCount() == 1);
+
+	// objects from the pools are freed after the pools are disabled
+	setUseObjectPools(false);
+	result &= !getUseObjectPools();
+	buffer->drop();
+	heapNode->remove();
+	smgr->clear();
+
+	ISceneNode* node = smgr->addEmptySceneNode();
+	result &= (node != 0);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,195 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+void countJob(void* userData, u32 index)
+{
+	// distinct indices, so no synchronization needed
+	((u32*)userData)[index] += 1;
+}
+
+struct SNestedData
+{
+	IJobSystem* Jobs;
+	u32* Counters;
+};
+
+void nestedJob(void* userData, u32 index)
+{
+	SNestedData* data = (SNestedData*)userData;
+	data->Jobs->parallelFor(4, countJob, data->Counters + index * 4);
+}
+
+bool testParallelFor(IJobSystem* jobs)
+{
+	bool result = true;
+
+	const u32 count = 10000;
+	array<u32> counters;
+	counters.set_used(count);
+	for (u32 grain=1; grain<=64; grain*=4)
+	{
+		for (u32 i=0; i<count; ++i)
+			counters[i] = 0;
+		jobs->parallelFor(count, countJob, counters.pointer(), grain);
+		for (u32 i=0; i<count; ++i)
+		{
+			if (counters[i] != 1)
+			{
+				logTestString("Index %u called %u times with grain size %u\n", i, counters[i], grain);
+				result = false;
+				break;
+			}
+		}
+	}
+
+	// nested calls run serially
+	for (u32 i=0; i<count; ++i)
+		counters[i] = 0;
+	SNestedData nested;
+	nested.Jobs = jobs;
+	nested.Counters = counters.pointer();
+	jobs->parallelFor(100, nestedJob, &nested);
+	for (u32 i=0; i<400; ++i)
+	{
+		if (counters[i] != 1)
+		{
+			logTestString("Nested index %u called %u times\n", i, counters[i]);
+			result = false;
+			break;
+		}
+	}
+
+	return result;
+}
+
+void createScene(ISceneManager* smgr)
+{
+	for (u32 i=0; i<200; ++i)
+	{
+		ISceneNode* node = smgr->addCubeSceneNode(1.f, 0, -1, vector3df((f32)i, 0, 0));
+		ISceneNodeAnimator* anim = 0;
+		switch (i % 4)
+		{
+		case 0:
+			anim = smgr->createRotationAnimator(vector3df(0, (f32)i * 0.1f, 0));
+			break;
+		case 1:
+			anim = smgr->createFlyCircleAnimator(vector3df((f32)i, 0, 0), 10.f, 0.001f * i);
+			break;
+		case 2:
+			// not thread-safe, animated serially
+			anim = smgr->createFlyCircleAnimator(vector3df(0, (f32)i, 0), 5.f);
+			node->addAnimator(anim);
+			anim->drop();
+			anim = smgr->createDeleteAnimator(1000000);
+			break;
+		default:
+			break;
+		}
+		if (anim)
+		{
+			node->addAnimator(anim);
+			anim->drop();
+		}
+
+		// children follow their parents
+		ISceneNode* child = smgr->addSphereSceneNode(0.5f, 8, node, -1, vector3df(0, 2.f, 0));
+		anim = smgr->createFlyStraightAnimator(vector3df(0, 0, 0), vector3df(0, 0, (f32)i), 3000, true);
+		child->addAnimator(anim);
+		anim->drop();
+	}
+}
+
+bool compareNodes(ISceneNode* a, ISceneNode* b)
+{
+	if (!a->getAbsoluteTransformation().equals(b->getAbsoluteTransformation(), 0.f))
+		return false;
+
+	if (a->getChildren().size() != b->getChildren().size())
+		return false;
+
+	ISceneNodeList::ConstIterator ita = a->getChildren().begin();
+	ISceneNodeList::ConstIterator itb = b->getChildren().begin();
+	for (; ita != a->getChildren().end(); ++ita, ++itb)
+	{
+		if (!compareNodes(*ita, *itb))
+			return false;
+	}
+	return true;
+}
+
+}
+
+//! Check the job system and that parallel animation gives the same results as serial animation
+bool parallelAnimation(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WindowSize = dimension2du(160, 120);
+	params.JobThreads = 3;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	params.JobThreads = 0;
+	IrrlichtDevice* serialDevice = createDeviceEx(params);
+	assert_log(serialDevice);
+	if (!serialDevice)
+	{
+		device->drop();
+		return false;
+	}
+
+	bool result = device->getJobSystem()->getWorkerCount() == 3;
+	result &= serialDevice->getJobSystem()->getWorkerCount() == 0;
+	result &= device->getSceneManager()->getJobSystem() == device->getJobSystem();
+
+	result &= testParallelFor(device->getJobSystem());
+	result &= testParallelFor(serialDevice->getJobSystem());
+
+	ISceneManager* smgr = device->getSceneManager();
+	ISceneManager* serialSmgr = serialDevice->getSceneManager();
+	smgr->setUseParallelAnimation(true);
+
+	// animators use the creation time as start time
+	ITimer* timer = device->getTimer();
+	timer->stop();
+	timer->setTime(0);
+	createScene(smgr);
+	createScene(serialSmgr);
+
+	for (u32 frame=0; frame<20; ++frame)
+	{
+		timer->setTime(frame * 33);
+		smgr->drawAll();
+		serialSmgr->drawAll();
+
+		if (!compareNodes(smgr->getRootSceneNode(), serialSmgr->getRootSceneNode()))
+		{
+			logTestString("Parallel animation differs from serial animation in frame %u\n", frame);
+			result = false;
+			break;
+		}
+	}
+	timer->start();
+
+	serialDevice->closeDevice();
+	serialDevice->run();
+	serialDevice->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,203 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+video::IImage* drawFrame(IrrlichtDevice* device, u32& primitives)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	primitives = driver->getPrimitiveCountDrawn();
+	return driver->createScreenShot();
+}
+
+bool isEqual(video::IImage* a, video::IImage* b)
+{
+	const u32 size = a->getImageDataSizeInBytes();
+	return size == b->getImageDataSizeInBytes() && !memcmp(a->getData(), b->getData(), size);
+}
+
+//! Count the pixels which are not the background color
+u32 countDrawn(video::IImage* image)
+{
+	u32 count = 0;
+	for (u32 y=0; y<image->getDimension().Height; ++y)
+		for (u32 x=0; x<image->getDimension().Width; ++x)
+			if (image->getPixel(x, y).color != 0xff000000)
+				++count;
+	return count;
+}
+
+//! Loads a copy of the level with every node pointing back to the root or
+//! with leaf clusters out of range
+IQ3LevelMesh* loadCorruptLevel(IrrlichtDevice* device, bool cycle)
+{
+	io::IReadFile* file = device->getFileSystem()->createAndOpenFile("20kdm2.bsp");
+	if (!file)
+		return 0;
+
+	array<u8> data;
+	data.set_used(file->getSize());
+	file->read(data.pointer(), data.size());
+	file->drop();
+
+	// header of id and version, then offset and length of each lump
+	s32* lumps = (s32*)(data.pointer() + 8);
+	if (cycle)
+	{
+		// nodes of plane, front, back and their box
+		s32* nodes = (s32*)(data.pointer() + lumps[3*2]);
+		for (s32 i=0; i<lumps[3*2+1] / 36; ++i)
+			nodes[i*9+1] = 0;
+	}
+	else
+	{
+		// leafs starting with their cluster
+		s32* leafs = (s32*)(data.pointer() + lumps[4*2]);
+		for (s32 i=0; i<lumps[4*2+1] / 48; ++i)
+			leafs[i*12] = 0x7fffffff - i;
+	}
+
+	io::IReadFile* memoryFile = device->getFileSystem()->createMemoryReadFile(data.pointer(), data.size(),
+		cycle ? "cycle.bsp" : "clusters.bsp");
+	IAnimatedMesh* level = device->getSceneManager()->getMesh(memoryFile);
+	memoryFile->drop();
+	return (level && level->getMeshType() == EAMT_BSP) ? static_cast<IQ3LevelMesh*>(level) : 0;
+}
+
+} // end anonymous namespace
+
+
+//! The level node looks like a mesh scene node of the level, but draws less from inside the level
+bool q3LevelSceneNode(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	bool result = device->getFileSystem()->addFileArchive("../media/map-20kdm2.pk3");
+	IAnimatedMesh* level = result ? smgr->getMesh("20kdm2.bsp") : 0;
+	result &= (level && level->getMeshType() == EAMT_BSP);
+	if (!result)
+	{
+		logTestString("Could not load the level\n");
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	const vector3df position(-1300.f, -144.f, -1249.f);
+	ISceneNode* meshNode = smgr->addMeshSceneNode(level->getMesh(0), 0, -1, position);
+	ISceneNode* levelNode = smgr->addQuake3LevelSceneNode(static_cast<IQ3LevelMesh*>(level));
+	result &= (levelNode && levelNode->getType() == ESNT_Q3LEVEL_SCENE_NODE);
+	levelNode->setPosition(position);
+	result &= (levelNode->getMaterialCount() == level->getMesh(0)->getMeshBufferCount());
+	levelNode->setMaterialFlag(video::EMF_LIGHTING, false);
+	meshNode->setMaterialFlag(video::EMF_LIGHTING, false);
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode();
+
+	// inside the level and far outside of it
+	const vector3df cameras[][2] = {
+		{ vector3df(0, 0, 0), vector3df(40.f, 10.f, 30.f) },
+		{ vector3df(0, 0, 0), vector3df(-40.f, -5.f, -30.f) },
+		{ vector3df(300.f, 50.f, -200.f), vector3df(250.f, 40.f, 0) },
+		{ vector3df(-300.f, 20.f, 400.f), vector3df(0, 0, 0) },
+		{ vector3df(0, 8000.f, 0), vector3df(0, 0, 0) }
+	};
+	const u32 count = sizeof(cameras) / sizeof(cameras[0]);
+
+	for (u32 i=0; i<count; ++i)
+	{
+		camera->setPosition(cameras[i][0]);
+		camera->setTarget(cameras[i][1]);
+		camera->setFarValue(10000.f);
+
+		u32 levelPrimitives = 0;
+		u32 meshPrimitives = 0;
+		meshNode->setVisible(false);
+		levelNode->setVisible(true);
+		video::IImage* levelImage = drawFrame(device, levelPrimitives);
+		meshNode->setVisible(true);
+		levelNode->setVisible(false);
+		video::IImage* meshImage = drawFrame(device, meshPrimitives);
+
+		if (!levelImage || !meshImage || !isEqual(levelImage, meshImage) || countDrawn(levelImage) < 100)
+		{
+			logTestString("Level drawn differently from camera %u\n", i);
+			result = false;
+		}
+		if (levelImage)
+			levelImage->drop();
+		if (meshImage)
+			meshImage->drop();
+
+		// only the leafs seen from inside are culled
+		const bool inside = (i + 1 < count);
+		if (levelPrimitives == 0 || (inside && levelPrimitives >= meshPrimitives))
+		{
+			logTestString("Camera %u: %u primitives of %u drawn\n", i, levelPrimitives, meshPrimitives);
+			result = false;
+		}
+	}
+
+	// levels with broken visibility data draw all leafs in the frustum
+	camera->setPosition(cameras[0][0]);
+	camera->setTarget(cameras[0][1]);
+	meshNode->setVisible(true);
+	levelNode->setVisible(false);
+	u32 meshPrimitives = 0;
+	video::IImage* meshImage = drawFrame(device, meshPrimitives);
+	meshNode->setVisible(false);
+	for (u32 c=0; c<2; ++c)
+	{
+		IQ3LevelMesh* corrupt = loadCorruptLevel(device, c == 0);
+		ISceneNode* corruptNode = corrupt ? smgr->addQuake3LevelSceneNode(corrupt) : 0;
+		if (!corruptNode)
+		{
+			logTestString("Could not load the level with broken visibility %u\n", c);
+			result = false;
+			continue;
+		}
+		corruptNode->setPosition(position);
+		corruptNode->setMaterialFlag(video::EMF_LIGHTING, false);
+
+		u32 primitives = 0;
+		video::IImage* image = drawFrame(device, primitives);
+		if (!image || !meshImage || !isEqual(image, meshImage))
+		{
+			logTestString("Level with broken visibility %u drawn differently\n", c);
+			result = false;
+		}
+		if (image)
+			image->drop();
+		corruptNode->remove();
+	}
+	if (meshImage)
+		meshImage->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
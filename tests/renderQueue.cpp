@@ -0,0 +1,213 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+array<ISceneNode*> RenderOrder;
+
+//! Registers itself for a fixed pass and records when it is drawn
+class CRecordingSceneNode : public ISceneNode
+{
+public:
+	CRecordingSceneNode(ISceneManager* mgr, E_SCENE_NODE_RENDER_PASS pass)
+		: ISceneNode(mgr->getRootSceneNode(), mgr, -1), Pass(pass)
+	{
+		Box.reset(vector3df(-1.f));
+		Box.addInternalPoint(vector3df(1.f));
+		setAutomaticCulling(EAC_OFF);
+	}
+
+	virtual void OnRegisterSceneNode()
+	{
+		if (IsVisible)
+			SceneManager->registerNodeForRendering(this, Pass);
+		ISceneNode::OnRegisterSceneNode();
+	}
+
+	virtual void render()
+	{
+		RenderOrder.push_back(this);
+	}
+
+	virtual const aabbox3d<f32>& getBoundingBox() const { return Box; }
+	virtual u32 getMaterialCount() const { return 1; }
+	virtual video::SMaterial& getMaterial(u32 i) { return Material; }
+
+	video::SMaterial Material;
+
+private:
+	E_SCENE_NODE_RENDER_PASS Pass;
+	aabbox3df Box;
+};
+
+f32 getDistanceSQ(ISceneNode* node)
+{
+	return node->getAbsolutePosition().getLengthSQ();
+}
+
+CRecordingSceneNode* addNode(ISceneManager* smgr, E_SCENE_NODE_RENDER_PASS pass, const vector3df& pos)
+{
+	CRecordingSceneNode* node = new CRecordingSceneNode(smgr, pass);
+	node->setPosition(pos);
+	node->drop();
+	return node;
+}
+
+//! Solid nodes have to be grouped by material type and texture, nearest first in each group
+bool checkSolidOrder(IrrlichtDevice* device, u32 count)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	video::ITexture* textures[4];
+	for (u32 i=0; i<4; ++i)
+	{
+		video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, dimension2du(2, 2));
+		image->fill(video::SColor(255, i * 60, 0, 0));
+		stringc name("renderQueue");
+		name += i;
+		textures[i] = driver->addTexture(name, image);
+		image->drop();
+	}
+
+	const video::E_MATERIAL_TYPE types[3] =
+		{ video::EMT_SOLID, video::EMT_LIGHTMAP, video::EMT_DETAIL_MAP };
+
+	for (u32 i=0; i<count; ++i)
+	{
+		CRecordingSceneNode* node = addNode(smgr, ESNRP_SOLID,
+			vector3df((f32)((i * 37) % 101), (f32)((i * 13) % 7), (f32)((i * 71) % 53)));
+		node->Material.MaterialType = types[(i * 7) % 3];
+		node->Material.setTexture(0, textures[(i * 5) % 4]);
+	}
+
+	RenderOrder.set_used(0);
+	smgr->drawAll();
+
+	bool result = (RenderOrder.size() == count);
+
+	u32 groups = 0;
+	u32 seen[3][4] = { {0} };
+	for (u32 i=0; i<RenderOrder.size(); ++i)
+	{
+		const video::SMaterial& m = RenderOrder[i]->getMaterial(0);
+		const video::SMaterial* prev = i ? &RenderOrder[i-1]->getMaterial(0) : 0;
+		if (!prev || prev->MaterialType != m.MaterialType || prev->getTexture(0) != m.getTexture(0))
+		{
+			++groups;
+			u32 t = 0;
+			while (textures[t] != m.getTexture(0))
+				++t;
+			u32 type = 0;
+			while (types[type] != m.MaterialType)
+				++type;
+			if (seen[type][t]++)
+			{
+				logTestString("Solid nodes with type %d and texture %d are not drawn together\n", type, t);
+				result = false;
+			}
+		}
+		// depth is quantized to about 1%
+		else if (getDistanceSQ(RenderOrder[i]) < getDistanceSQ(RenderOrder[i-1]) * 0.98f)
+		{
+			logTestString("Solid node %d is drawn after a node further away\n", i);
+			result = false;
+		}
+	}
+
+	// all type/texture combinations are used
+	result &= (groups == 12);
+
+	smgr->clear();
+	driver->removeAllTextures();
+	return result;
+}
+
+//! Transparent nodes have to be drawn back to front
+bool checkTransparentOrder(IrrlichtDevice* device, E_SCENE_NODE_RENDER_PASS pass, u32 count)
+{
+	ISceneManager* smgr = device->getSceneManager();
+
+	for (u32 i=0; i<count; ++i)
+	{
+		CRecordingSceneNode* node = addNode(smgr, pass,
+			vector3df((f32)((i * 37) % 101) * 0.25f, 0, (f32)((i * 71) % 53) * 3.f));
+		node->Material.MaterialType = (i & 1) ? video::EMT_TRANSPARENT_ALPHA_CHANNEL : video::EMT_TRANSPARENT_ADD_COLOR;
+	}
+
+	RenderOrder.set_used(0);
+	smgr->drawAll();
+
+	bool result = (RenderOrder.size() == count);
+	for (u32 i=1; i<RenderOrder.size(); ++i)
+	{
+		if (getDistanceSQ(RenderOrder[i]) > getDistanceSQ(RenderOrder[i-1]))
+		{
+			logTestString("Transparent node %d is drawn after a nearer node\n", i);
+			result = false;
+		}
+	}
+
+	smgr->clear();
+	return result;
+}
+
+//! Nodes with the same material and position are drawn in the order they were registered
+bool checkStableOrder(IrrlichtDevice* device, u32 count)
+{
+	ISceneManager* smgr = device->getSceneManager();
+
+	array<ISceneNode*> nodes;
+	for (u32 i=0; i<count; ++i)
+		nodes.push_back(addNode(smgr, ESNRP_SOLID, vector3df(0, 0, 10.f)));
+
+	RenderOrder.set_used(0);
+	smgr->drawAll();
+
+	bool result = (RenderOrder.size() == count);
+	for (u32 i=0; result && i<count; ++i)
+		result = (RenderOrder[i] == nodes[i]);
+
+	if (!result)
+		logTestString("Order of equal solid nodes changed\n");
+
+	smgr->clear();
+	return result;
+}
+
+}
+
+//! Check the order in which the scene manager draws the nodes of each render pass
+bool renderQueue(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	bool result = true;
+
+	// small queues are sorted differently than large ones
+	result &= checkSolidOrder(device, 40);
+	result &= checkSolidOrder(device, 1000);
+	result &= checkTransparentOrder(device, ESNRP_TRANSPARENT, 20);
+	result &= checkTransparentOrder(device, ESNRP_TRANSPARENT, 1000);
+	result &= checkTransparentOrder(device, ESNRP_TRANSPARENT_EFFECT, 500);
+	result &= checkStableOrder(device, 30);
+	result &= checkStableOrder(device, 300);
+
+	RenderOrder.clear();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
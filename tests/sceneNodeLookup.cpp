@@ -0,0 +1,201 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+// the searches as done before the scene manager had an index
+ISceneNode* walkForId(s32 id, ISceneNode* start)
+{
+	if (start->getID() == id)
+		return start;
+
+	ISceneNodeList::ConstIterator it = start->getChildren().begin();
+	for (; it != start->getChildren().end(); ++it)
+	{
+		ISceneNode* node = walkForId(id, *it);
+		if (node)
+			return node;
+	}
+	return 0;
+}
+
+ISceneNode* walkForName(const c8* name, ISceneNode* start)
+{
+	if (!strcmp(start->getName(), name))
+		return start;
+
+	ISceneNodeList::ConstIterator it = start->getChildren().begin();
+	for (; it != start->getChildren().end(); ++it)
+	{
+		ISceneNode* node = walkForName(name, *it);
+		if (node)
+			return node;
+	}
+	return 0;
+}
+
+void walkForType(ESCENE_NODE_TYPE type, array<ISceneNode*>& outNodes, ISceneNode* start)
+{
+	if (start->getType() == type)
+		outNodes.push_back(start);
+
+	ISceneNodeList::ConstIterator it = start->getChildren().begin();
+	for (; it != start->getChildren().end(); ++it)
+		walkForType(type, outNodes, *it);
+}
+
+//! Compares the lookups of the scene manager with walking the scene graph
+bool compareLookups(ISceneManager* smgr, ISceneNode* start, const c8* when)
+{
+	ISceneNode* walkStart = start ? start : smgr->getRootSceneNode();
+	bool result = true;
+
+	for (s32 id=-1; id<12; ++id)
+	{
+		if (smgr->getSceneNodeFromId(id, start) != walkForId(id, walkStart))
+		{
+			logTestString("getSceneNodeFromId(%d) failed %s\n", id, when);
+			result = false;
+		}
+	}
+
+	const c8* names[] = { "", "a", "b", "c", "d", "e", "none" };
+	for (u32 i=0; i<sizeof(names)/sizeof(names[0]); ++i)
+	{
+		if (smgr->getSceneNodeFromName(names[i], start) != walkForName(names[i], walkStart))
+		{
+			logTestString("getSceneNodeFromName(\"%s\") failed %s\n", names[i], when);
+			result = false;
+		}
+	}
+
+	const ESCENE_NODE_TYPE types[] = { ESNT_EMPTY, ESNT_CUBE, ESNT_SPHERE, ESNT_LIGHT, ESNT_BILLBOARD };
+	for (u32 i=0; i<sizeof(types)/sizeof(types[0]); ++i)
+	{
+		array<ISceneNode*> expected;
+		walkForType(types[i], expected, walkStart);
+		array<ISceneNode*> found;
+		smgr->getSceneNodesFromType(types[i], found, start);
+
+		bool same = (found.size() == expected.size());
+		for (u32 j=0; same && j<found.size(); ++j)
+			same = (found[j] == expected[j]);
+
+		ISceneNode* first = smgr->getSceneNodeFromType(types[i], start);
+		if (!same || first != (expected.size() ? expected[0] : 0))
+		{
+			logTestString("Lookup of type %d failed %s\n", i, when);
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+} // end anonymous namespace
+
+
+//! Indexed lookups of scene nodes find the same nodes as walking the scene graph
+bool sceneNodeLookup(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	// a tree with shared names and ids, deeper nodes added first
+	array<ISceneNode*> nodes;
+	const c8* names[] = { "a", "b", "c", "d", "e" };
+	for (u32 i=0; i<60; ++i)
+	{
+		ISceneNode* parent = (i < 6) ? 0 : nodes[(i * 7) % nodes.size()];
+		ISceneNode* node;
+		switch (i % 3)
+		{
+		case 0: node = smgr->addEmptySceneNode(parent, i % 10); break;
+		case 1: node = smgr->addCubeSceneNode(1.f, parent, i % 11); break;
+		default: node = smgr->addSphereSceneNode(1.f, 8, parent, i % 7); break;
+		}
+		node->setName(names[(i * 3) % 5]);
+		nodes.push_back(node);
+	}
+
+	bool result = compareLookups(smgr, 0, "after adding");
+	result &= compareLookups(smgr, nodes[2], "below a node");
+
+	// change names and ids
+	for (u32 i=0; i<nodes.size(); i+=4)
+	{
+		nodes[i]->setID((nodes[i]->getID() + 5) % 12);
+		nodes[i]->setName(names[i % 5]);
+	}
+	nodes[10]->setName("");
+	result &= compareLookups(smgr, 0, "after renaming");
+
+	// move subtrees around
+	nodes[3]->setParent(nodes[40]);
+	nodes[8]->setParent(smgr->getRootSceneNode());
+	nodes[1]->addChild(nodes[0]);
+	result &= compareLookups(smgr, 0, "after moving");
+	result &= compareLookups(smgr, nodes[1], "below a moved node");
+
+	// removed nodes are not found, also not after renaming them
+	ISceneNode* removed = nodes[5];
+	removed->grab();
+	removed->remove();
+	removed->setID(11);
+	removed->setName("none");
+	result &= (smgr->getSceneNodeFromId(11) != removed);
+	result &= (smgr->getSceneNodeFromName("none") == 0);
+	result &= compareLookups(smgr, 0, "after removing");
+
+	// detached trees are searched by walking
+	result &= compareLookups(smgr, removed, "below a removed node");
+
+	// and found again when added back
+	smgr->getRootSceneNode()->addChild(removed);
+	removed->drop();
+	result &= (smgr->getSceneNodeFromName("none") == removed);
+	result &= compareLookups(smgr, 0, "after adding again");
+
+	// clones get the names and ids of their originals
+	ISceneNode* clone = nodes[7]->clone();
+	result &= compareLookups(smgr, 0, "after cloning");
+	clone->remove();
+
+	// a node created in another scene manager
+	ISceneManager* other = smgr->createNewSceneManager(false);
+	ISceneNode* moved = other->addEmptySceneNode(0, 11);
+	moved->setName("e");
+	smgr->getRootSceneNode()->addChild(moved);
+	result &= compareLookups(smgr, 0, "after moving from another scene manager");
+	result &= (other->getSceneNodeFromId(11) == 0);
+	other->drop();
+
+	// removing everything
+	nodes[1]->removeAll();
+	result &= compareLookups(smgr, 0, "after removing children");
+	smgr->clear();
+	result &= (smgr->getSceneNodeFromId(1) == 0);
+	result &= (smgr->getSceneNodeFromName("a") == 0);
+	result &= (smgr->getSceneNodeFromType(ESNT_CUBE) == 0);
+
+	// the scene manager itself is still found
+	result &= (smgr->getSceneNodeFromType(ESNT_SCENE_MANAGER) == smgr->getRootSceneNode());
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
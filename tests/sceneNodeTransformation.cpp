@@ -0,0 +1,109 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+bool checkPosition(ISceneNode* node, const vector3df& expected, const char* what)
+{
+	if (!node->getAbsolutePosition().equals(expected))
+	{
+		logTestString("%s: absolute position is %f %f %f, expected %f %f %f\n", what,
+			node->getAbsolutePosition().X, node->getAbsolutePosition().Y, node->getAbsolutePosition().Z,
+			expected.X, expected.Y, expected.Z);
+		return false;
+	}
+	return true;
+}
+
+}
+
+//! Check that absolute transformations follow all changes although unchanged nodes aren't recalculated
+bool sceneNodeTransformation(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	bool result = true;
+
+	ISceneNode* parent = smgr->addEmptySceneNode(0, -1);
+	parent->setPosition(vector3df(10.f, 0, 0));
+	ISceneNode* child = smgr->addEmptySceneNode(parent, -1);
+	child->setPosition(vector3df(0, 5.f, 0));
+	ISceneNode* grandChild = smgr->addEmptySceneNode(child, -1);
+	grandChild->setPosition(vector3df(0, 0, 1.f));
+
+	smgr->drawAll();
+	result &= checkPosition(grandChild, vector3df(10.f, 5.f, 1.f), "initial");
+
+	// nothing changed
+	smgr->drawAll();
+	result &= checkPosition(grandChild, vector3df(10.f, 5.f, 1.f), "unchanged");
+
+	// changes of parents are passed down
+	parent->setPosition(vector3df(20.f, 0, 0));
+	smgr->drawAll();
+	result &= checkPosition(grandChild, vector3df(20.f, 5.f, 1.f), "moved parent");
+
+	parent->setScale(vector3df(2.f));
+	smgr->drawAll();
+	result &= checkPosition(grandChild, vector3df(20.f, 10.f, 2.f), "scaled parent");
+
+	child->setRotation(vector3df(0, 90.f, 0));
+	smgr->drawAll();
+	result &= checkPosition(grandChild, vector3df(22.f, 10.f, 0), "rotated child");
+
+	// manual updates
+	grandChild->setPosition(vector3df(0, 0, 2.f));
+	grandChild->updateAbsolutePosition();
+	result &= checkPosition(grandChild, vector3df(24.f, 10.f, 0), "manual update");
+
+	// new parent
+	grandChild->setParent(smgr->getRootSceneNode());
+	grandChild->updateAbsolutePosition();
+	result &= checkPosition(grandChild, vector3df(0, 0, 2.f), "new parent");
+
+	// resetting the scene manager moves the scene back
+	smgr->getRootSceneNode()->setPosition(vector3df(5.f, 0, 0));
+	smgr->drawAll();
+	result &= checkPosition(grandChild, vector3df(5.f, 0, 2.f), "moved root");
+	io::IAttributes* attributes = device->getFileSystem()->createEmptyAttributes();
+	smgr->getRootSceneNode()->deserializeAttributes(attributes);
+	attributes->drop();
+	smgr->drawAll();
+	result &= checkPosition(grandChild, vector3df(0, 0, 2.f), "reset root");
+
+	// absolute transformations set directly are passed down
+	ISceneNode* lateChild = smgr->addEmptySceneNode(child, -1);
+	lateChild->setPosition(vector3df(1.f, 0, 0));
+	lateChild->updateAbsolutePosition();
+	matrix4 transformation;
+	transformation.setTranslation(vector3df(0, 3.f, 0));
+	child->setAbsoluteTransformation(transformation);
+	lateChild->updateAbsolutePosition();
+	result &= checkPosition(lateChild, vector3df(1.f, 3.f, 0), "set absolute transformation");
+
+	// dummy transformation nodes change their matrix directly
+	IDummyTransformationSceneNode* dummy = smgr->addDummyTransformationSceneNode();
+	ISceneNode* dummyChild = smgr->addEmptySceneNode(dummy, -1);
+	smgr->drawAll();
+	result &= checkPosition(dummyChild, vector3df(0, 0, 0), "dummy");
+	dummy->getRelativeTransformationMatrix().setTranslation(vector3df(1.f, 2.f, 3.f));
+	smgr->drawAll();
+	result &= checkPosition(dummyChild, vector3df(1.f, 2.f, 3.f), "changed dummy");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,117 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+bool checkCount(u32 count, u32 expected, const char* what)
+{
+	if (count != expected)
+	{
+		logTestString("%s: %u, expected %u\n", what, count, expected);
+		return false;
+	}
+	return true;
+}
+
+ISceneNode* addCube(ISceneManager* smgr, const vector3df& position, video::ITexture* texture)
+{
+	ISceneNode* cube = smgr->addCubeSceneNode(2.f, 0, -1, position);
+	cube->setMaterialTexture(0, texture);
+	return cube;
+}
+
+} // end anonymous namespace
+
+//! The scene statistics count the registered, culled and drawn nodes of a frame
+bool sceneStats(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(160, 120);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	video::ITexture* wall = driver->getTexture("../media/wall.bmp");
+	video::ITexture* fire = driver->getTexture("../media/fire.bmp");
+
+	// three solid cubes with two materials
+	addCube(smgr, vector3df(0, 0, 20.f), wall);
+	addCube(smgr, vector3df(5.f, 0, 20.f), fire);
+	addCube(smgr, vector3df(-5.f, 0, 20.f), wall);
+	// a transparent cube
+	addCube(smgr, vector3df(0, 0, 30.f), fire)->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+	// two cubes behind the camera
+	addCube(smgr, vector3df(0, 0, -20.f), wall);
+	addCube(smgr, vector3df(0, 0, -20.f), wall)->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	smgr->addLightSceneNode(0, vector3df(0, 10.f, 0));
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	bool result = true;
+	for (u32 frame=0; frame<2; ++frame)
+	{
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+
+		const SSceneStats& stats = smgr->getSceneStats();
+		// the camera, the light and the cubes
+		result &= checkCount(stats.NodesRegistered, 8, "registered");
+		result &= checkCount(stats.CulledBox, 1, "culled by box");
+		result &= checkCount(stats.CulledFrustumBox, 1, "culled by frustum box");
+		result &= checkCount(stats.getCulledCount(), 2, "culled");
+		result &= checkCount(stats.LightsUsed, 1, "lights");
+		result &= checkCount(stats.Solid.Nodes, 3, "solid nodes");
+		result &= checkCount(stats.Solid.MeshBuffers, 3, "solid mesh buffers");
+		result &= checkCount(stats.Solid.MaterialChanges, 2, "solid material changes");
+		result &= checkCount(stats.Transparent.Nodes, 1, "transparent nodes");
+		result &= checkCount(stats.Transparent.MeshBuffers, 1, "transparent mesh buffers");
+		result &= checkCount(stats.Transparent.MaterialChanges, 1, "transparent material changes");
+		result &= checkCount(stats.SkyBox.Nodes + stats.Shadow.Nodes + stats.TransparentEffect.Nodes, 0, "other nodes");
+		result &= checkCount(driver->getDrawCallCount(), 4, "draw calls");
+	}
+
+	// several views add up
+	array<SSceneView> views;
+	views.push_back(SSceneView(smgr->getActiveCamera(), rect<s32>(0, 0, 80, 120)));
+	views.push_back(SSceneView(smgr->getActiveCamera(), rect<s32>(80, 0, 160, 120)));
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll(views);
+	driver->endScene();
+	result &= checkCount(smgr->getSceneStats().Solid.Nodes, 6, "solid nodes of two views");
+	result &= checkCount(smgr->getSceneStats().getCulledCount(), 4, "culled of two views");
+
+	// nodes with EAC_FRUSTUM_BOX are tested in batches, with a count which
+	// doesn't fill the last one: four behind the camera, five in front and
+	// one on the right plane of the frustum
+	for (s32 i=0; i<5; ++i)
+	{
+		if (i < 4)
+			addCube(smgr, vector3df((f32)(i * 4 - 8), 0, -20.f), wall)->setAutomaticCulling(EAC_FRUSTUM_BOX);
+		addCube(smgr, vector3df((f32)(i * 4 - 8), 0, 40.f), wall)->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	}
+	addCube(smgr, vector3df(19.4f, 0, 20.f), wall)->setAutomaticCulling(EAC_FRUSTUM_BOX);
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	result &= checkCount(smgr->getSceneStats().CulledFrustumBox, 5, "culled by frustum box in batches");
+	result &= checkCount(smgr->getSceneStats().Solid.Nodes, 9, "solid nodes with batches");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,121 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+bool checkCulled(ISceneManager* smgr, ISceneNode* node, bool expected, const char* name)
+{
+	if (smgr->isCulled(node) != expected)
+	{
+		logTestString("%s is %s\n", name, expected ? "not culled" : "culled");
+		return false;
+	}
+	return true;
+}
+
+void drawFrame(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+}
+
+} // end anonymous namespace
+
+
+//! Nodes with EAC_OCC_SOFTWARE are culled when they are behind occluder meshes
+bool softwareOcclusionCulling(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	const IGeometryCreator* geometry = smgr->getGeometryCreator();
+
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 1.f));
+
+	// a wall in front of the camera, its mesh is a bit smaller than it
+	IMesh* wallMesh = geometry->createCubeMesh(vector3df(4.f, 4.f, 1.f));
+	IMesh* occluderMesh = geometry->createCubeMesh(vector3df(3.8f, 3.8f, 0.8f));
+	ISceneNode* wall = smgr->addMeshSceneNode(wallMesh, 0, -1, vector3df(0, 0, 10.f));
+	wall->setAutomaticCulling(EAC_FRUSTUM_BOX | EAC_OCC_SOFTWARE);
+	smgr->setOccluder(wall, occluderMesh);
+	wallMesh->drop();
+	occluderMesh->drop();
+
+	IMesh* cubeMesh = geometry->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+	ISceneNode* hidden = smgr->addMeshSceneNode(cubeMesh, 0, -1, vector3df(0, 0, 20.f));
+	ISceneNode* beside = smgr->addMeshSceneNode(cubeMesh, 0, -1, vector3df(6.f, 0, 20.f));
+	ISceneNode* inFront = smgr->addMeshSceneNode(cubeMesh, 0, -1, vector3df(0, 0, 5.f));
+	ISceneNode* partly = smgr->addMeshSceneNode(cubeMesh, 0, -1, vector3df(3.5f, 0, 20.f));
+	ISceneNode* notTested = smgr->addMeshSceneNode(cubeMesh, 0, -1, vector3df(0, 1.f, 20.f));
+	ISceneNode* nearPlane = smgr->addMeshSceneNode(cubeMesh, 0, -1, vector3df(0, 0, 0.5f));
+	cubeMesh->drop();
+
+	hidden->setAutomaticCulling(EAC_FRUSTUM_BOX | EAC_OCC_SOFTWARE);
+	beside->setAutomaticCulling(EAC_FRUSTUM_BOX | EAC_OCC_SOFTWARE);
+	inFront->setAutomaticCulling(EAC_OCC_SOFTWARE);
+	partly->setAutomaticCulling(EAC_OCC_SOFTWARE);
+	nearPlane->setAutomaticCulling(EAC_OCC_SOFTWARE);
+
+	bool result = (smgr->getOccluder(wall) != 0 && smgr->getOccluder(hidden) == 0);
+	result &= (smgr->getOcclusionBufferSize() == dimension2du(256, 128));
+
+	// nothing is culled before the occluders were rendered
+	result &= checkCulled(smgr, hidden, false, "hidden before drawing");
+
+	drawFrame(device);
+	result &= checkCulled(smgr, hidden, true, "hidden");
+	result &= checkCulled(smgr, beside, false, "beside");
+	result &= checkCulled(smgr, inFront, false, "in front");
+	result &= checkCulled(smgr, partly, false, "partly hidden");
+	result &= checkCulled(smgr, notTested, false, "without EAC_OCC_SOFTWARE");
+	result &= checkCulled(smgr, nearPlane, false, "at the near plane");
+	result &= checkCulled(smgr, wall, false, "occluder");
+
+	// 5 visible cubes and the wall, 12 triangles each
+	result &= (device->getVideoDriver()->getPrimitiveCountDrawn() == 5 * 12 + 12);
+
+	// invisible occluders don't hide anything
+	wall->setVisible(false);
+	drawFrame(device);
+	result &= checkCulled(smgr, hidden, false, "hidden by an invisible wall");
+	wall->setVisible(true);
+
+	// lower resolutions are coarser but still hide what is completely behind
+	smgr->setOcclusionBufferSize(dimension2du(32, 16));
+	drawFrame(device);
+	result &= checkCulled(smgr, hidden, true, "hidden at low resolution");
+	result &= checkCulled(smgr, beside, false, "beside at low resolution");
+
+	// the camera is behind the wall
+	ICameraSceneNode* camera = smgr->getActiveCamera();
+	camera->setPosition(vector3df(0, 0, 15.f));
+	camera->setTarget(vector3df(0, 0, 20.f));
+	drawFrame(device);
+	result &= checkCulled(smgr, hidden, false, "hidden with the wall behind the camera");
+
+	smgr->setOccluder(wall, 0);
+	result &= (smgr->getOccluder(wall) == 0);
+	camera->setPosition(vector3df(0, 0, 0));
+	camera->setTarget(vector3df(0, 0, 1.f));
+	drawFrame(device);
+	result &= checkCulled(smgr, hidden, false, "hidden without occluders");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,137 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+u32 drawScene(ISceneManager* smgr)
+{
+	video::IVideoDriver* driver = smgr->getVideoDriver();
+	driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+	smgr->drawAll();
+	driver->endScene();
+	return driver->getPrimitiveCountDrawn();
+}
+
+//! Number of nodes drawn in the solid pass, each batch counts once
+s32 getDrawnSolid(ISceneManager* smgr)
+{
+	return smgr->getSceneStats().Solid.Nodes;
+}
+
+bool checkPrimitives(u32 drawn, u32 expected, const char* what)
+{
+	if (drawn != expected)
+	{
+		logTestString("%s: %u primitives drawn, expected %u\n", what, drawn, expected);
+		return false;
+	}
+	return true;
+}
+
+}
+
+//! Static batching has to draw the same geometry as the single nodes, with less draw calls
+bool staticBatching(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	bool result = true;
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0, 200.f, -300.f), vector3df(0, 0, 0));
+
+	// 10x10 cubes with two different materials, 12 triangles each
+	array<IMeshSceneNode*> cubes;
+	for (u32 i=0; i<100; ++i)
+	{
+		IMeshSceneNode* cube = smgr->addCubeSceneNode(5.f, 0, -1,
+			vector3df((f32)(i % 10) * 20.f - 100.f, 0, (f32)(i / 10) * 20.f - 100.f),
+			vector3df(0, (f32)i, 0));
+		cube->setMaterialFlag(video::EMF_LIGHTING, (i % 2) == 0);
+		cubes.push_back(cube);
+	}
+
+	// a transparent cube is never batched
+	IMeshSceneNode* transparent = smgr->addCubeSceneNode(5.f, 0, -1, vector3df(0, 20.f, 0));
+	transparent->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+
+	const u32 all = drawScene(smgr);
+	result &= checkPrimitives(all, 101 * 12, "not batched");
+	const s32 singleDrawn = getDrawnSolid(smgr);
+
+	for (u32 i=0; i<cubes.size(); ++i)
+		smgr->setStaticBatching(cubes[i], true);
+	smgr->setStaticBatching(transparent, true);
+	result &= smgr->getStaticBatching(cubes[0]);
+
+	result &= checkPrimitives(drawScene(smgr), all, "batched");
+
+	// the cubes are around the origin, so they fall into 2x2 cells with one batch per material
+	if (singleDrawn)
+		result &= (getDrawnSolid(smgr) == 8);
+
+	// hidden nodes are skipped
+	for (u32 i=0; i<cubes.size(); i+=3)
+		cubes[i]->setVisible(false);
+	result &= checkPrimitives(drawScene(smgr), all - 34 * 12, "some hidden");
+
+	for (u32 i=0; i<cubes.size(); i+=3)
+		cubes[i]->setVisible(true);
+	result &= checkPrimitives(drawScene(smgr), all, "visible again");
+
+	// smaller cells are culled on their own
+	smgr->setStaticBatchCellSize(40.f);
+	camera->setPosition(vector3df(-90.f, 5.f, -150.f));
+	camera->setTarget(vector3df(-90.f, 5.f, 0));
+	camera->setFarValue(80.f);
+	const u32 nearDrawn = drawScene(smgr);
+	result &= (nearDrawn > 0 && nearDrawn < all / 2);
+
+	camera->setFarValue(3000.f);
+	camera->setPosition(vector3df(0, 200.f, -300.f));
+	camera->setTarget(vector3df(0, 0, 0));
+	result &= checkPrimitives(drawScene(smgr), all, "small cells");
+
+	// nodes are still found by picking
+	const line3df ray(vector3df(-100.f, 50.f, -100.f), vector3df(-100.f, -50.f, -100.f));
+	ISceneNode* picked = smgr->getSceneCollisionManager()->getSceneNodeFromRayBB(ray);
+	if (picked != cubes[0])
+	{
+		logTestString("Picking of batched node failed\n");
+		result = false;
+	}
+
+	// removed nodes disappear
+	cubes[5]->remove();
+	result &= checkPrimitives(drawScene(smgr), all - 12, "removed node");
+
+	// unmarked nodes are drawn on their own
+	smgr->setStaticBatching(cubes[6], false);
+	result &= !smgr->getStaticBatching(cubes[6]);
+	result &= checkPrimitives(drawScene(smgr), all - 12, "unmarked node");
+
+	// moved nodes after an update
+	cubes[7]->setPosition(vector3df(0, 0, -1000.f));
+	smgr->setStaticBatchesDirty();
+	result &= checkPrimitives(drawScene(smgr), all - 24, "moved node");
+
+	smgr->clear();
+	result &= checkPrimitives(drawScene(smgr), 0, "cleared scene");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,72 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Time of the animation pass with serial and parallel animation
+// for different numbers of worker threads.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runAnimation(u32 workers, u32 frames)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	params.JobThreads = workers;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	smgr->setUseParallelAnimation(workers > 0);
+
+	// 1000 groups of 10 nodes, all with thread-safe animators
+	for (u32 i=0; i<1000; ++i)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode();
+		ISceneNodeAnimator* anim = smgr->createFlyCircleAnimator(vector3df((f32)i, 0, 0), 10.f);
+		group->addAnimator(anim);
+		anim->drop();
+
+		for (u32 j=0; j<10; ++j)
+		{
+			ISceneNode* node = smgr->addCubeSceneNode(1.f, group, -1, vector3df((f32)j, 0, 0));
+			anim = smgr->createRotationAnimator(vector3df(0, 0.1f * j, 0));
+			node->addAnimator(anim);
+			anim->drop();
+		}
+	}
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		smgr->drawAll();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	if (workers)
+		sprintf(variant, "parallel, %u workers", workers);
+	else
+		sprintf(variant, "serial");
+	printResult("animation", variant, frames, time);
+
+	device->drop();
+}
+
+
+void benchmarkAnimation(u32 frames)
+{
+	runAnimation(0, frames);
+	runAnimation(1, frames);
+	runAnimation(3, frames);
+	runAnimation(7, frames);
+	runAnimation(15, frames);
+}
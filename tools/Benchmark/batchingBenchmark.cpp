@@ -0,0 +1,57 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Drawing many small cubes with four materials, each cube on its own and
+// merged into static batches.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runBatching(bool batched, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	// 100x100 cubes, all visible
+	for (u32 i=0; i<10000; ++i)
+	{
+		IMeshSceneNode* cube = smgr->addCubeSceneNode(2.f, 0, -1,
+			vector3df((f32)(i % 100) * 4.f - 200.f, 0, (f32)(i / 100) * 4.f),
+			vector3df(0, (f32)i, 0));
+		cube->setMaterialFlag(video::EMF_LIGHTING, (i & 1) != 0);
+		cube->setMaterialFlag(video::EMF_FOG_ENABLE, (i & 2) != 0);
+		if (batched)
+			smgr->setStaticBatching(cube, true);
+	}
+	smgr->addCameraSceneNode(0, vector3df(0, 300.f, -150.f), vector3df(0, 0, 200.f));
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	printResult("batching", batched ? "static batches" : "single nodes", frames, time,
+		driver->getPrimitiveCountDrawn());
+
+	device->drop();
+}
+
+
+void benchmarkBatching(u32 frames)
+{
+	runBatching(false, frames);
+	runBatching(true, frames);
+}
+
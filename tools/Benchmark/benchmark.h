@@ -0,0 +1,41 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __BENCHMARK_H_INCLUDED__
+#define __BENCHMARK_H_INCLUDED__
+
+#include <irrlicht.h>
+
+//! Creates a device which doesn't need a window
+irr::IrrlichtDevice* createBenchmarkDevice(irr::video::E_DRIVER_TYPE driverType=irr::video::EDT_NULL,
+	const irr::core::dimension2du& size=irr::core::dimension2du(640, 480));
+
+//! Prints one line of results, time is the total time for all frames in milliseconds
+void printResult(const char* name, const char* variant, irr::u32 frames, irr::u32 time, irr::u32 primitives=0);
+
+// The benchmark cases, each one gets the number of frames to render
+void benchmarkCulling(irr::u32 frames);
+void benchmarkAnimation(irr::u32 frames);
+void benchmarkTransform(irr::u32 frames);
+void benchmarkSort(irr::u32 frames);
+void benchmarkBatching(irr::u32 frames);
+void benchmarkInstancing(irr::u32 frames);
+void benchmarkLights(irr::u32 frames);
+void benchmarkPool(irr::u32 frames);
+void benchmarkLookup(irr::u32 frames);
+void benchmarkLOD(irr::u32 frames);
+void benchmarkSimplify(irr::u32 frames);
+void benchmarkOcclusion(irr::u32 frames);
+void benchmarkBSP(irr::u32 frames);
+void benchmarkSceneLoad(irr::u32 frames);
+void benchmarkViews(irr::u32 frames);
+void benchmarkTimeStep(irr::u32 frames);
+void benchmarkRaster(irr::u32 frames);
+void benchmarkVertex(irr::u32 frames);
+void benchmarkSpans(irr::u32 frames);
+void benchmarkDepthTiles(irr::u32 frames);
+void benchmarkTextures(irr::u32 frames);
+void benchmarkMipMaps(irr::u32 frames);
+void benchmarkCommandList(irr::u32 frames);
+
+#endif
@@ -0,0 +1,78 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// A walk through the 20kdm2 quake3 level of the examples, drawn with an
+// octree scene node and with the level scene node using the potentially
+// visible sets of the level. The primitives are the average per frame.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runBSP(video::E_DRIVER_TYPE driverType, bool visibility, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(driverType, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	IAnimatedMesh* level = 0;
+	if (device->getFileSystem()->addFileArchive("../../media/map-20kdm2.pk3"))
+		level = smgr->getMesh("20kdm2.bsp");
+	if (!level || level->getMeshType() != EAMT_BSP)
+	{
+		device->drop();
+		return;
+	}
+
+	ISceneNode* node = visibility ?
+		smgr->addQuake3LevelSceneNode(static_cast<IQ3LevelMesh*>(level)) :
+		smgr->addOctreeSceneNode(level->getMesh(0), 0, -1, 1024);
+	node->setPosition(vector3df(-1300.f, -144.f, -1249.f));
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+
+	// around the rooms and corridors near the center of the level
+	const vector3df path[] = { vector3df(0, 0, 0), vector3df(300.f, 50.f, -200.f),
+		vector3df(250.f, 40.f, 0), vector3df(-300.f, 20.f, 400.f), vector3df(0, 0, 0) };
+	const u32 points = sizeof(path) / sizeof(path[0]) - 1;
+	ICameraSceneNode* camera = smgr->addCameraSceneNode();
+	camera->setFarValue(10000.f);
+
+	u32 primitives = 0;
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		const f32 t = (f32)i * points / frames;
+		const u32 segment = core::min_((u32)t, points - 1);
+		const vector3df position = path[segment].getInterpolated(path[segment + 1], 1.f - (t - segment));
+		camera->setPosition(position);
+		camera->setTarget(position + vector3df(cosf(i * 0.05f), 0, sinf(i * 0.05f)));
+
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+		primitives += driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant(driverType == video::EDT_NULL ? "null, " : "burning, ");
+	variant += visibility ? "pvs" : "octree";
+	printResult("bsp", variant.c_str(), frames, time, frames ? primitives / frames : 0);
+
+	device->drop();
+}
+
+
+void benchmarkBSP(u32 frames)
+{
+	runBSP(video::EDT_NULL, false, frames);
+	runBSP(video::EDT_NULL, true, frames);
+	runBSP(video::EDT_BURNINGSVIDEO, false, frames);
+	runBSP(video::EDT_BURNINGSVIDEO, true, frames);
+}
+
@@ -0,0 +1,100 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// A static field of nodes with a 2d overlay, drawn with drawAll in each frame
+// and recorded once into a command list which is replayed in each frame.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void drawOverlay(video::IVideoDriver* driver)
+{
+	for (s32 i=0; i<200; ++i)
+	{
+		const s32 x = (i % 20) * 16;
+		const s32 y = 200 + (i / 20) * 4;
+		driver->draw2DRectangle(video::SColor(255, i, 255 - i, 128), rect<s32>(x, y, x + 14, y + 3));
+	}
+}
+
+
+static void runCommandList(video::E_DRIVER_TYPE driverType, bool replay, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(driverType, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	IMesh* mesh = smgr->getGeometryCreator()->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+
+	// 2000 nodes in groups, 50 of them in each group
+	for (u32 g=0; g<40; ++g)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode();
+		group->setPosition(vector3df((f32)(g % 8) * 10.f - 40.f, (f32)(g / 8) * 10.f - 25.f, 60.f));
+		for (u32 i=0; i<50; ++i)
+		{
+			ISceneNode* node = smgr->addMeshSceneNode(mesh, group, -1,
+				vector3df((f32)(i % 7), (f32)(i / 7), 0), vector3df((f32)i * 7.f, (f32)g * 9.f, 0));
+			node->setMaterialFlag(video::EMF_LIGHTING, false);
+		}
+	}
+	mesh->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	ITimer* timer = device->getTimer();
+	timer->stop();
+
+	video::ICommandList* list = 0;
+	u32 recordTime = 0;
+	if (replay)
+	{
+		const u32 start = timer->getRealTime();
+		list = driver->createCommandList();
+		smgr->drawAll(list->getRecorder());
+		drawOverlay(list->getRecorder());
+		recordTime = timer->getRealTime() - start;
+	}
+
+	u32 primitives = 0;
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		if (list)
+			list->replay(driver);
+		else
+		{
+			smgr->drawAll();
+			drawOverlay(driver);
+		}
+		driver->endScene();
+		primitives = driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant(driverType == video::EDT_NULL ? "null, " : "burning, ");
+	if (list)
+	{
+		printResult("commandlist", (variant + "record once").c_str(), 1, recordTime);
+		list->drop();
+	}
+	variant += replay ? "replay" : "drawAll";
+	printResult("commandlist", variant.c_str(), frames, time, primitives);
+
+	device->drop();
+}
+
+
+void benchmarkCommandList(u32 frames)
+{
+	runCommandList(video::EDT_NULL, false, frames);
+	runCommandList(video::EDT_NULL, true, frames);
+	runCommandList(video::EDT_BURNINGSVIDEO, false, frames);
+	runCommandList(video::EDT_BURNINGSVIDEO, true, frames);
+}
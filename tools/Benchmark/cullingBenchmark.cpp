@@ -0,0 +1,70 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Frame time of a big static scene with per node culling and with the
+// culling hierarchy of the scene manager.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runCulling(IrrlichtDevice* device, ICameraSceneNode* camera, const char* variant, u32 frames)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ITimer* timer = device->getTimer();
+
+	u32 primitives = 0;
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		// turn around once during the run
+		const f32 angle = (f32)i / frames * 2.f * PI;
+		camera->setTarget(camera->getPosition() + vector3df(sinf(angle), -0.2f, cosf(angle)));
+
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+		primitives += driver->getPrimitiveCountDrawn(0);
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	printResult("culling", variant, frames, time, frames ? primitives / frames : 0);
+}
+
+
+void benchmarkCulling(u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	// 128x128 static nodes, some of them grouped below a parent
+	const s32 gridSize = 128;
+	for (s32 x=0; x<gridSize; ++x)
+	{
+		for (s32 z=0; z<gridSize; ++z)
+		{
+			const vector3df pos((x - gridSize/2) * 20.f, 0, (z - gridSize/2) * 20.f);
+			// exact culling, so both variants draw the same nodes
+			ISceneNode* cube = smgr->addCubeSceneNode(5.f, 0, -1, pos);
+			cube->setAutomaticCulling(EAC_FRUSTUM_BOX);
+			if ((x + z) % 8 == 0)
+				smgr->addSphereSceneNode(2.f, 8, cube, -1, vector3df(0, 5.f, 0))->setAutomaticCulling(EAC_FRUSTUM_BOX);
+		}
+	}
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0, 50.f, 0));
+	camera->setFarValue(1000.f);
+
+	smgr->setUseCullingHierarchy(false);
+	runCulling(device, camera, "per node", frames);
+	smgr->setUseCullingHierarchy(true);
+	runCulling(device, camera, "hierarchy", frames);
+
+	device->drop();
+}
@@ -0,0 +1,72 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Overdraw of Burning's Video with the coarse depth tiles. 8 screen covering
+// layers compared to only the nearest one. The render queue draws the solid
+// layers front to back, so all but the first are hidden.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runDepthTiles(u32 layers, const dimension2du& size, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(video::EDT_BURNINGSVIDEO, size);
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	video::ITexture* wall = driver->getTexture("../../media/wall.bmp");
+
+	IMesh* plane = smgr->getGeometryCreator()->createPlaneMesh(dimension2df(60.f, 60.f),
+		dimension2du(4, 4), 0, dimension2df(4.f, 4.f));
+
+	for (u32 i=0; i<layers; ++i)
+	{
+		ISceneNode* node = smgr->addMeshSceneNode(plane, 0, -1,
+			vector3df(0, 0, 19.f + i * 3.f), vector3df(-90.f, 0, i * 10.f));
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setMaterialFlag(video::EMF_BACK_FACE_CULLING, false);
+		node->setMaterialTexture(0, wall);
+	}
+	plane->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	ITimer* timer = device->getTimer();
+	u32 primitives = 0;
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+		primitives = driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	sprintf(variant, "%u layers %ux%u", layers, size.Width, size.Height);
+	printResult("depthtiles", variant, frames, time, primitives);
+
+	device->drop();
+}
+
+
+void benchmarkDepthTiles(u32 frames)
+{
+	static const dimension2du sizes[] =
+	{
+		dimension2du(320, 240), dimension2du(640, 480), dimension2du(1024, 768)
+	};
+
+	for (u32 i=0; i<3; ++i)
+	{
+		runDepthTiles(1, sizes[i], frames);
+		runDepthTiles(8, sizes[i], frames);
+	}
+}
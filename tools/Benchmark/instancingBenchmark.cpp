@@ -0,0 +1,76 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Drawing many copies of one mesh, each copy as its own mesh scene node and
+// all copies as instances of one instanced mesh scene node.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runInstancing(video::E_DRIVER_TYPE driverType, bool instanced, u32 count, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(driverType, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(2.f));
+	IInstancedMeshSceneNode* instances = 0;
+	if (instanced)
+	{
+		instances = smgr->addInstancedMeshSceneNode(cube);
+		instances->setMaterialFlag(video::EMF_LIGHTING, false);
+	}
+
+	// a square of cubes, all visible
+	const f32 side = floorf(sqrtf((f32)count));
+	for (u32 i=0; i<count; ++i)
+	{
+		const vector3df position((f32)(i % (u32)side) * 4.f - side * 2.f, 0, (f32)(i / (u32)side) * 4.f);
+		const vector3df rotation(0, (f32)i, 0);
+		if (instances)
+		{
+			matrix4 m;
+			m.setRotationDegrees(rotation);
+			m.setTranslation(position);
+			instances->addInstance(m);
+		}
+		else
+		{
+			IMeshSceneNode* node = smgr->addMeshSceneNode(cube, 0, -1, position, rotation);
+			node->setMaterialFlag(video::EMF_LIGHTING, false);
+		}
+	}
+	cube->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, side * 3.f, -side * 1.5f), vector3df(0, 0, side * 2.f));
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant(driverType == video::EDT_NULL ? "null, " : "burning, ");
+	variant += instanced ? "instanced" : "single nodes";
+	printResult("instancing", variant.c_str(), frames, time, driver->getPrimitiveCountDrawn());
+
+	device->drop();
+}
+
+
+void benchmarkInstancing(u32 frames)
+{
+	runInstancing(video::EDT_NULL, false, 10000, frames);
+	runInstancing(video::EDT_NULL, true, 10000, frames);
+	runInstancing(video::EDT_BURNINGSVIDEO, false, 2500, frames);
+	runInstancing(video::EDT_BURNINGSVIDEO, true, 2500, frames);
+}
@@ -0,0 +1,126 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Many small lights over a field of cubes, with the closest lights to the
+// camera for the whole scene, with a light manager testing all lights for
+// each node and with light culling and selection per node.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+enum E_LIGHT_MODE
+{
+	ELM_CLOSEST,
+	ELM_ALL_LIGHTS,
+	ELM_CULLING
+};
+
+//! Turns on the 8 lights closest to each node, testing all lights
+class CAllLightsManager : public ILightManager
+{
+public:
+
+	CAllLightsManager(video::IVideoDriver* driver) : Driver(driver), LightList(0) {}
+
+	virtual void OnPreRender(array<ISceneNode*>& lightList) { LightList = &lightList; }
+	virtual void OnPostRender() {}
+	virtual void OnRenderPassPreRender(E_SCENE_NODE_RENDER_PASS renderPass) {}
+	virtual void OnRenderPassPostRender(E_SCENE_NODE_RENDER_PASS renderPass)
+	{
+		if (renderPass == ESNRP_LIGHT)
+			for (u32 i=0; i<LightList->size(); ++i)
+				Driver->turnLightOn((s32)i, false);
+	}
+
+	virtual void OnNodePreRender(ISceneNode* node)
+	{
+		const vector3df pos = node->getAbsolutePosition();
+		Closest.set_used(0);
+		for (u32 i=0; i<LightList->size(); ++i)
+		{
+			SLightDistance light;
+			light.Distance = (*LightList)[i]->getAbsolutePosition().getDistanceFromSQ(pos);
+			light.Index = i;
+			Closest.push_back(light);
+		}
+		Closest.sort();
+
+		for (u32 i=0; i<Closest.size(); ++i)
+			Driver->turnLightOn((s32)Closest[i].Index, i < 8);
+	}
+
+	virtual void OnNodePostRender(ISceneNode* node) {}
+
+private:
+
+	struct SLightDistance
+	{
+		f32 Distance;
+		u32 Index;
+
+		bool operator < (const SLightDistance& other) const { return Distance < other.Distance; }
+	};
+
+	video::IVideoDriver* Driver;
+	array<ISceneNode*>* LightList;
+	array<SLightDistance> Closest;
+};
+
+
+static void runLights(video::E_DRIVER_TYPE driverType, E_LIGHT_MODE mode, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(driverType, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	// 50x50 cubes and a light above each 5th of them
+	for (u32 i=0; i<2500; ++i)
+	{
+		const vector3df position((f32)(i % 50) * 8.f - 200.f, 0, (f32)(i / 50) * 8.f);
+		smgr->addCubeSceneNode(4.f, 0, -1, position);
+		if ((i % 5) == 0)
+			smgr->addLightSceneNode(0, position + vector3df(0, 6.f, 0),
+				video::SColorf((i % 3) * 0.5f, 1.f, 1.f), 12.f);
+	}
+	smgr->addCameraSceneNode(0, vector3df(0, 150.f, -100.f), vector3df(0, 0, 150.f));
+	smgr->setUseLightCulling(mode == ELM_CULLING);
+	if (mode == ELM_ALL_LIGHTS)
+	{
+		ILightManager* manager = new CAllLightsManager(driver);
+		smgr->setLightManager(manager);
+		manager->drop();
+	}
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant(driverType == video::EDT_NULL ? "null, " : "burning, ");
+	variant += mode == ELM_CULLING ? "light culling" : mode == ELM_ALL_LIGHTS ? "scan all lights" : "closest lights";
+	printResult("lights", variant.c_str(), frames, time, driver->getPrimitiveCountDrawn());
+
+	device->drop();
+}
+
+
+void benchmarkLights(u32 frames)
+{
+	runLights(video::EDT_NULL, ELM_CLOSEST, frames);
+	runLights(video::EDT_NULL, ELM_ALL_LIGHTS, frames);
+	runLights(video::EDT_NULL, ELM_CULLING, frames);
+	runLights(video::EDT_BURNINGSVIDEO, ELM_CLOSEST, frames);
+	runLights(video::EDT_BURNINGSVIDEO, ELM_ALL_LIGHTS, frames);
+	runLights(video::EDT_BURNINGSVIDEO, ELM_CULLING, frames);
+}
@@ -0,0 +1,77 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// A dense field of detailed meshes seen from close to the ground, drawn with
+// mesh scene nodes and with LOD scene nodes.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runLOD(video::E_DRIVER_TYPE driverType, bool lod, u32 count, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(driverType, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	const IGeometryCreator* geometry = smgr->getGeometryCreator();
+
+	IMesh* meshes[4];
+	meshes[0] = geometry->createSphereMesh(1.f, 48, 48);
+	meshes[1] = geometry->createSphereMesh(1.f, 16, 16);
+	meshes[2] = geometry->createSphereMesh(1.f, 8, 8);
+	meshes[3] = geometry->createSphereMesh(1.f, 4, 4);
+	const f32 screenSizes[4] = { 0.2f, 0.05f, 0.015f, 0.f };
+
+	// a square of spheres, the camera looks over it from one side
+	const f32 side = floorf(sqrtf((f32)count));
+	for (u32 i=0; i<count; ++i)
+	{
+		const vector3df position((f32)(i % (u32)side) * 6.f - side * 3.f, 0, (f32)(i / (u32)side) * 6.f);
+		ISceneNode* node;
+		if (lod)
+		{
+			ILODSceneNode* lodNode = smgr->addLODSceneNode(0, -1, position);
+			for (u32 l=0; l<4; ++l)
+				lodNode->addLevel(meshes[l], screenSizes[l]);
+			node = lodNode;
+		}
+		else
+			node = smgr->addMeshSceneNode(meshes[0], 0, -1, position);
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+	}
+	for (u32 l=0; l<4; ++l)
+		meshes[l]->drop();
+
+	smgr->addCameraSceneNode(0, vector3df(0, 4.f, -10.f), vector3df(0, 0, side * 3.f));
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant(driverType == video::EDT_NULL ? "null, " : "burning, ");
+	variant += lod ? "lod nodes" : "mesh nodes";
+	printResult("lod", variant.c_str(), frames, time, driver->getPrimitiveCountDrawn());
+
+	device->drop();
+}
+
+
+void benchmarkLOD(u32 frames)
+{
+	runLOD(video::EDT_NULL, false, 10000, frames);
+	runLOD(video::EDT_NULL, true, 10000, frames);
+	runLOD(video::EDT_BURNINGSVIDEO, false, 2500, frames);
+	runLOD(video::EDT_BURNINGSVIDEO, true, 2500, frames);
+}
+
@@ -0,0 +1,112 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Finding scene nodes by id, name and type in a large scene, with the index
+// of the scene manager and by walking the scene graph.
+
+#include "benchmark.h"
+#include <stdio.h>
+#include <string.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static ISceneNode* walkForId(s32 id, ISceneNode* start)
+{
+	if (start->getID() == id)
+		return start;
+
+	ISceneNodeList::ConstIterator it = start->getChildren().begin();
+	for (; it != start->getChildren().end(); ++it)
+	{
+		ISceneNode* node = walkForId(id, *it);
+		if (node)
+			return node;
+	}
+	return 0;
+}
+
+
+static ISceneNode* walkForName(const c8* name, ISceneNode* start)
+{
+	if (!strcmp(start->getName(), name))
+		return start;
+
+	ISceneNodeList::ConstIterator it = start->getChildren().begin();
+	for (; it != start->getChildren().end(); ++it)
+	{
+		ISceneNode* node = walkForName(name, *it);
+		if (node)
+			return node;
+	}
+	return 0;
+}
+
+
+void benchmarkLookup(u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+
+	// 100 groups of 100 nodes with their own ids and names, one light at the end
+	const u32 nodeCount = 10000;
+	array<stringc> names;
+	for (u32 g=0; g<100; ++g)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode();
+		for (u32 i=0; i<100; ++i)
+		{
+			const s32 id = (s32)(g * 100 + i);
+			ISceneNode* node = smgr->addEmptySceneNode(group, id);
+			names.push_back(stringc("node") + stringc(id));
+			node->setName(names.getLast());
+		}
+	}
+	smgr->addLightSceneNode();
+
+	// each frame looks up 100 nodes by id and by name and the light by type
+	const u32 lookups = 100;
+
+	u32 found = 0;
+	u32 start = timer->getRealTime();
+	for (u32 f=0; f<frames; ++f)
+	{
+		for (u32 i=0; i<lookups; ++i)
+		{
+			const u32 n = (f * lookups + i) * 7919 % nodeCount;
+			found += walkForId((s32)n, smgr->getRootSceneNode()) != 0;
+			found += walkForName(names[n].c_str(), smgr->getRootSceneNode()) != 0;
+		}
+		array<ISceneNode*> lights;
+		smgr->getSceneNodesFromType(ESNT_ANY, lights);
+		for (u32 i=0; i<lights.size(); ++i)
+			found += lights[i]->getType() == ESNT_LIGHT;
+	}
+	u32 time = timer->getRealTime() - start;
+	printResult("lookup", "walk", frames, time);
+
+	found = 0;
+	start = timer->getRealTime();
+	for (u32 f=0; f<frames; ++f)
+	{
+		for (u32 i=0; i<lookups; ++i)
+		{
+			const u32 n = (f * lookups + i) * 7919 % nodeCount;
+			found += smgr->getSceneNodeFromId((s32)n) != 0;
+			found += smgr->getSceneNodeFromName(names[n].c_str()) != 0;
+		}
+		found += smgr->getSceneNodeFromType(ESNT_LIGHT) != 0;
+	}
+	time = timer->getRealTime() - start;
+	printResult("lookup", "index", frames, time);
+	if (found != frames * (2 * lookups + 1))
+		printf("Not all nodes were found\n");
+
+	device->drop();
+}
+
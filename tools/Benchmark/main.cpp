@@ -0,0 +1,97 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Benchmarks for the engine internals.
+// Usage: Benchmark [frames] [case ...]
+// Without a case name all benchmarks are run.
+
+#include "benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace irr;
+
+#ifdef _MSC_VER
+#pragma comment(lib, "Irrlicht.lib")
+#endif
+
+struct SBenchmarkCase
+{
+	const char* Name;
+	void (*Run)(u32 frames);
+};
+
+static const SBenchmarkCase Cases[] =
+{
+	{ "culling", benchmarkCulling },
+	{ "animation", benchmarkAnimation },
+	{ "transform", benchmarkTransform },
+	{ "sort", benchmarkSort },
+	{ "batching", benchmarkBatching },
+	{ "instancing", benchmarkInstancing },
+	{ "lights", benchmarkLights },
+	{ "pool", benchmarkPool },
+	{ "lookup", benchmarkLookup },
+	{ "lod", benchmarkLOD },
+	{ "simplify", benchmarkSimplify },
+	{ "occlusion", benchmarkOcclusion },
+	{ "bsp", benchmarkBSP },
+	{ "sceneload", benchmarkSceneLoad },
+	{ "views", benchmarkViews },
+	{ "timestep", benchmarkTimeStep },
+	{ "raster", benchmarkRaster },
+	{ "vertex", benchmarkVertex },
+	{ "spans", benchmarkSpans },
+	{ "depthtiles", benchmarkDepthTiles },
+	{ "textures", benchmarkTextures },
+	{ "mipmaps", benchmarkMipMaps },
+	{ "commandlist", benchmarkCommandList }
+};
+
+static const u32 CaseCount = sizeof(Cases) / sizeof(Cases[0]);
+
+
+IrrlichtDevice* createBenchmarkDevice(video::E_DRIVER_TYPE driverType, const core::dimension2du& size)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = driverType;
+	params.WindowSize = size;
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		printf("Could not create device\n");
+	return device;
+}
+
+
+void printResult(const char* name, const char* variant, u32 frames, u32 time, u32 primitives)
+{
+	printf("%-16s %-24s %8.3f ms/frame %10u primitives\n", name, variant,
+		frames ? (f64)time / frames : 0.0, primitives);
+}
+
+
+int main(int argc, char* argv[])
+{
+	u32 frames = 200;
+	int first = 1;
+	if (argc > 1 && atoi(argv[1]) > 0)
+	{
+		frames = atoi(argv[1]);
+		first = 2;
+	}
+
+	for (u32 i=0; i<CaseCount; ++i)
+	{
+		bool run = (first >= argc);
+		for (int a=first; a<argc; ++a)
+			run |= !strcmp(argv[a], Cases[i].Name);
+		if (run)
+			Cases[i].Run(frames);
+	}
+
+	return 0;
+}
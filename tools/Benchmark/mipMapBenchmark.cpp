@@ -0,0 +1,129 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Mip map chains of a 512x512 image, one chain per frame. The box filter of
+// IImage::createMipMaps in each supported format, with and without worker
+// threads, the Kaiser filter, and for comparison the same levels scaled from
+// the full image with copyToScalingBoxFilter as Burning's Video did before. The
+// last variant creates Burning's Video textures with mip maps.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+
+static IrrlichtDevice* createMipMapDevice(video::E_DRIVER_TYPE driverType, u32 workers)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = driverType;
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	params.JobThreads = workers;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		printf("Could not create device\n");
+	return device;
+}
+
+static video::IImage* createMipMapSource(video::IVideoDriver* driver, video::ECOLOR_FORMAT format)
+{
+	video::IImage* image = driver->createImage(format, dimension2du(512, 512));
+	for (u32 y=0; y<512; ++y)
+		for (u32 x=0; x<512; ++x)
+			image->setPixel(x, y, video::SColor(255, x & 255, y & 255, (x ^ y) & 255));
+	return image;
+}
+
+static void runMipMaps(video::ECOLOR_FORMAT format, video::E_MIP_MAP_FILTER filter, u32 workers, u32 frames)
+{
+	IrrlichtDevice* device = createMipMapDevice(video::EDT_NULL, workers);
+	if (!device)
+		return;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	video::IImage* image = createMipMapSource(driver, format);
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+		image->createMipMaps(filter, device->getJobSystem());
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	sprintf(variant, "%s %s %u threads", filter == video::EMMF_BOX ? "box" : "kaiser",
+		video::ColorFormatNames[format], workers);
+	printResult("mipmaps", variant, frames, time);
+
+	image->drop();
+	device->drop();
+}
+
+static void runScaledMipMaps(u32 frames)
+{
+	IrrlichtDevice* device = createMipMapDevice(video::EDT_NULL, 0);
+	if (!device)
+		return;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	video::IImage* image = createMipMapSource(driver, video::ECF_A8R8G8B8);
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		for (u32 size=256; size; size >>= 1)
+		{
+			video::IImage* level = driver->createImage(video::ECF_A8R8G8B8, dimension2du(size, size));
+			image->copyToScalingBoxFilter(level);
+			level->drop();
+		}
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	printResult("mipmaps", "scaled box A8R8G8B8", frames, time);
+
+	image->drop();
+	device->drop();
+}
+
+static void runBurningTextures(u32 workers, u32 frames)
+{
+	IrrlichtDevice* device = createMipMapDevice(video::EDT_BURNINGSVIDEO, workers);
+	if (!device)
+		return;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, true);
+	video::IImage* image = createMipMapSource(driver, video::ECF_A8R8G8B8);
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		video::ITexture* texture = driver->addTexture("mipmapped", image);
+		driver->removeTexture(texture);
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	sprintf(variant, "burning texture %u threads", workers);
+	printResult("mipmaps", variant, frames, time);
+
+	image->drop();
+	device->drop();
+}
+
+
+void benchmarkMipMaps(u32 frames)
+{
+	runScaledMipMaps(frames);
+	runMipMaps(video::ECF_A8R8G8B8, video::EMMF_BOX, 0, frames);
+	runMipMaps(video::ECF_A8R8G8B8, video::EMMF_BOX, 2, frames);
+	runMipMaps(video::ECF_R8G8B8, video::EMMF_BOX, 0, frames);
+	runMipMaps(video::ECF_A1R5G5B5, video::EMMF_BOX, 0, frames);
+	runMipMaps(video::ECF_R5G6B5, video::EMMF_BOX, 0, frames);
+	runMipMaps(video::ECF_A8R8G8B8, video::EMMF_KAISER, 0, frames);
+	runBurningTextures(0, frames);
+	runBurningTextures(2, frames);
+}
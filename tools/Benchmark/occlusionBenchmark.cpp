@@ -0,0 +1,84 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// A town of blocks with detailed objects in the streets, seen from street
+// level. Drawn with frustum culling only and with software occlusion culling,
+// the blocks are the occluders.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runOcclusion(video::E_DRIVER_TYPE driverType, bool occlusion, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(driverType, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	const IGeometryCreator* geometry = smgr->getGeometryCreator();
+
+	const u32 blocks = 24;
+	const f32 spacing = 30.f;
+	IMesh* blockMesh = geometry->createCubeMesh(vector3df(20.f, 30.f, 20.f));
+	IMesh* objectMesh = geometry->createSphereMesh(1.f, 16, 16);
+
+	for (u32 z=0; z<blocks; ++z)
+	{
+		for (u32 x=0; x<blocks; ++x)
+		{
+			const vector3df corner(x * spacing, 0, z * spacing);
+			ISceneNode* block = smgr->addMeshSceneNode(blockMesh, 0, -1, corner + vector3df(0, 15.f, 0));
+			block->setMaterialFlag(video::EMF_LIGHTING, false);
+			block->setAutomaticCulling(occlusion ? EAC_FRUSTUM_BOX | EAC_OCC_SOFTWARE : EAC_FRUSTUM_BOX);
+			if (occlusion)
+				smgr->setOccluder(block, blockMesh);
+
+			// objects along the streets around the block
+			for (u32 i=0; i<4; ++i)
+			{
+				const vector3df offsets[4] = { vector3df(15.f, 1.f, -5.f), vector3df(15.f, 1.f, 5.f),
+					vector3df(-5.f, 1.f, 15.f), vector3df(5.f, 1.f, 15.f) };
+				ISceneNode* object = smgr->addMeshSceneNode(objectMesh, 0, -1, corner + offsets[i]);
+				object->setMaterialFlag(video::EMF_LIGHTING, false);
+				object->setAutomaticCulling(occlusion ? EAC_FRUSTUM_BOX | EAC_OCC_SOFTWARE : EAC_FRUSTUM_BOX);
+			}
+		}
+	}
+	blockMesh->drop();
+	objectMesh->drop();
+
+	// in a street, looking diagonally over the town
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(-15.f, 2.f, -15.f),
+		vector3df(blocks * spacing, 2.f, blocks * spacing * 0.6f));
+	camera->setFarValue(blocks * spacing * 2.f);
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant(driverType == video::EDT_NULL ? "null, " : "burning, ");
+	variant += occlusion ? "occlusion" : "frustum";
+	printResult("occlusion", variant.c_str(), frames, time, driver->getPrimitiveCountDrawn());
+
+	device->drop();
+}
+
+
+void benchmarkOcclusion(u32 frames)
+{
+	runOcclusion(video::EDT_NULL, false, frames);
+	runOcclusion(video::EDT_NULL, true, frames);
+	runOcclusion(video::EDT_BURNINGSVIDEO, false, frames);
+	runOcclusion(video::EDT_BURNINGSVIDEO, true, frames);
+}
+
@@ -0,0 +1,156 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// A large scene built between other allocations, like a loader does, with
+// scene nodes and animators allocated from the heap and from pools. Times
+// the animation pass over all nodes, creating and removing short lived
+// nodes in each frame and loading a .irr scene of 10000 nodes from memory.
+
+#include "benchmark.h"
+#include <stdlib.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+//! Size of the memory file for the scene
+static const s32 SceneFileSize = 64 * 1024 * 1024;
+
+//! Writes a scene of 100 groups of 100 nodes of different types into memory, returns the size
+static s32 createSceneFile(void* memory)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return 0;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	// half of the nodes are animated
+	for (u32 g=0; g<100; ++g)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode();
+		group->setPosition(vector3df((f32)(g % 10) * 100.f - 500.f, 0, (f32)(g / 10) * 100.f));
+		for (u32 i=0; i<100; ++i)
+		{
+			const vector3df position((f32)(i % 10) * 10.f - 50.f, 0, (f32)(i / 10) * 10.f - 50.f);
+			ISceneNode* node = 0;
+			switch (i % 4)
+			{
+			case 0:
+				node = smgr->addCubeSceneNode(4.f, group, -1, position);
+				break;
+			case 1:
+				node = smgr->addSphereSceneNode(2.f, 8, group, -1, position);
+				break;
+			case 2:
+				node = smgr->addBillboardSceneNode(group, dimension2df(4.f, 4.f), position);
+				break;
+			default:
+				node = smgr->addEmptySceneNode(group);
+				node->setPosition(position);
+				break;
+			}
+			if (i & 1)
+			{
+				ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0, 1.f, 0));
+				node->addAnimator(anim);
+				anim->drop();
+			}
+		}
+	}
+
+	io::IWriteFile* file = device->getFileSystem()->createMemoryWriteFile(memory, SceneFileSize, "pool.irr");
+	smgr->saveScene(file);
+	const s32 size = (s32)file->getPos();
+	file->drop();
+
+	device->drop();
+	return size;
+}
+
+
+static void runPool(bool pools, const void* sceneFile, s32 sceneFileSize, u32 frames)
+{
+	setUseObjectPools(pools);
+
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+
+	// 1000 groups of 100 nodes, each node between other allocations of
+	// which every second one is freed again
+	srand(1);
+	array<void*> other;
+	for (u32 g=0; g<1000; ++g)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode();
+		group->setPosition(vector3df((f32)(g % 40) * 10.f, 0, (f32)(g / 40) * 10.f));
+		for (u32 i=0; i<100; ++i)
+		{
+			other.push_back(malloc(16 + rand() % 600));
+			ISceneNode* node = smgr->addEmptySceneNode(group);
+			node->setPosition(vector3df((f32)(i % 10), 0, (f32)(i / 10)));
+		}
+	}
+	for (u32 i=0; i<other.size(); i+=2)
+		free(other[i]);
+
+	u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+		smgr->getRootSceneNode()->OnAnimate(i);
+	const u32 animateTime = timer->getRealTime() - start;
+
+	start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		ISceneNode* nodes[500];
+		for (u32 n=0; n<500; ++n)
+		{
+			nodes[n] = smgr->addEmptySceneNode();
+			ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0, 1.f, 0));
+			nodes[n]->addAnimator(anim);
+			anim->drop();
+		}
+		for (u32 n=0; n<500; ++n)
+			nodes[n]->remove();
+	}
+	const u32 churnTime = timer->getRealTime() - start;
+
+	// load the scene several times, each time without the previous one
+	const u32 loads = 5;
+	u32 loadTime = 0;
+	for (u32 i=0; i<loads; ++i)
+	{
+		smgr->clear();
+		io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(sceneFile, sceneFileSize, "pool.irr");
+		start = timer->getRealTime();
+		smgr->loadScene(file);
+		loadTime += timer->getRealTime() - start;
+		file->drop();
+	}
+
+	printResult("pool", pools ? "pools, animate 100000 nodes" : "heap, animate 100000 nodes", frames, animateTime);
+	printResult("pool", pools ? "pools, create and remove 500" : "heap, create and remove 500", frames, churnTime);
+	printResult("pool", pools ? "pools, load 10000 nodes" : "heap, load 10000 nodes", loads, loadTime);
+
+	device->drop();
+	for (u32 i=1; i<other.size(); i+=2)
+		free(other[i]);
+	setUseObjectPools(false);
+}
+
+
+void benchmarkPool(u32 frames)
+{
+	void* sceneFile = malloc(SceneFileSize);
+	const s32 size = createSceneFile(sceneFile);
+	if (size)
+	{
+		runPool(false, sceneFile, size, frames);
+		runPool(true, sceneFile, size, frames);
+	}
+	free(sceneFile);
+}
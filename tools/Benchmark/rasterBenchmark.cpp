@@ -0,0 +1,89 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Fill rate of Burning's Video at 1024x768 for different numbers of worker
+// threads, which rasterize bands of rows of the screen. Large textured,
+// transparent and lightmapped triangles, so the time is mostly spent in the
+// scanlines.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runRaster(u32 workers, u32 frames)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2du(1024, 768);
+	params.DeviceType = EIDT_CONSOLE;
+	params.LoggingLevel = ELL_WARNING;
+	params.JobThreads = workers;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	video::ITexture* wall = driver->getTexture("../../media/wall.bmp");
+	video::ITexture* fire = driver->getTexture("../../media/fire.bmp");
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(10.f));
+	IMesh* lightmapped = smgr->getMeshManipulator()->createMeshWith2TCoords(cube);
+
+	// 5 layers of 4 cubes, each layer covers most of the screen
+	for (u32 i=0; i<20; ++i)
+	{
+		const vector3df position(((f32)(i % 4) - 1.5f) * 9.f, ((f32)(i % 2) - 0.5f) * 6.f, 20.f + (f32)(i / 4) * 5.f);
+		ISceneNode* node = smgr->addMeshSceneNode((i % 3) ? cube : lightmapped, 0, -1, position);
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setMaterialTexture(0, wall);
+		node->setMaterialTexture(1, fire);
+		if (i % 3 == 0)
+			node->setMaterialType(video::EMT_LIGHTMAP);
+		else if (i % 5 == 0)
+			node->setMaterialType(video::EMT_TRANSPARENT_ADD_COLOR);
+
+		ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0.3f, 0.2f * (i % 4), 0));
+		node->addAnimator(anim);
+		anim->drop();
+	}
+	lightmapped->drop();
+	cube->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	ITimer* timer = device->getTimer();
+	u32 primitives = 0;
+	timer->stop();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		timer->setTime(i * 20);
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+		primitives = driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	if (workers)
+		sprintf(variant, "%u workers", workers);
+	else
+		sprintf(variant, "serial");
+	printResult("raster", variant, frames, time, primitives);
+
+	device->drop();
+}
+
+
+void benchmarkRaster(u32 frames)
+{
+	runRaster(0, frames);
+	runRaster(1, frames);
+	runRaster(3, frames);
+	runRaster(7, frames);
+}
@@ -0,0 +1,108 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Loading a scene of 2000 nodes with materials and animators from an .irr
+// file, from an .irrb file and from an .irrb file in memory. Each scene is
+// loaded 10 times, the number of frames is not used. The time includes
+// creating the nodes, the last column is the number of nodes.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void createScene(ISceneManager* smgr)
+{
+	for (u32 g=0; g<50; ++g)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode(0, (s32)g);
+		group->setName(stringc("group") + stringc(g));
+
+		for (u32 i=0; i<39; ++i)
+		{
+			ISceneNode* node;
+			if (i % 3 == 0)
+				node = smgr->addSphereSceneNode(1.f, 8, group);
+			else
+				node = smgr->addCubeSceneNode(1.f, group);
+			node->setPosition(vector3df((f32)i, 0, (f32)g));
+			node->setMaterialFlag(video::EMF_LIGHTING, false);
+
+			if (i % 13 == 0)
+			{
+				ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0, 1.f, 0));
+				node->addAnimator(anim);
+				anim->drop();
+			}
+		}
+	}
+}
+
+
+static void runLoad(IrrlichtDevice* device, const io::path& filename, bool memory, u32 nodes)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	io::IFileSystem* fs = device->getFileSystem();
+	ITimer* timer = device->getTimer();
+
+	array<u8> data;
+	if (memory)
+	{
+		io::IReadFile* file = fs->createAndOpenFile(filename);
+		if (!file)
+			return;
+		data.set_used(file->getSize());
+		file->read(data.pointer(), data.size());
+		file->drop();
+	}
+
+	const u32 loads = 10;
+	u32 time = 0;
+	for (u32 i=0; i<loads; ++i)
+	{
+		smgr->clear();
+
+		const u32 start = timer->getRealTime();
+		if (memory)
+		{
+			io::IReadFile* file = fs->createMemoryReadFile(data.pointer(), data.size(), filename);
+			smgr->loadScene(file);
+			file->drop();
+		}
+		else
+			smgr->loadScene(filename);
+		time += timer->getRealTime() - start;
+	}
+
+	stringc variant(filename);
+	if (memory)
+		variant += " in memory";
+	printResult("sceneload", variant.c_str(), loads, time, nodes);
+}
+
+
+void benchmarkSceneLoad(u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	createScene(smgr);
+	const u32 nodes = 50 * 40;
+
+	if (smgr->saveScene("sceneLoadBenchmark.irr") && smgr->saveScene("sceneLoadBenchmark.irrb"))
+	{
+		runLoad(device, "sceneLoadBenchmark.irr", false, nodes);
+		runLoad(device, "sceneLoadBenchmark.irrb", false, nodes);
+		runLoad(device, "sceneLoadBenchmark.irrb", true, nodes);
+	}
+
+	remove("sceneLoadBenchmark.irr");
+	remove("sceneLoadBenchmark.irrb");
+
+	device->drop();
+}
+
@@ -0,0 +1,85 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Simplification of a terrain of a million triangles to a half and to a
+// tenth of its triangles. Each mesh is simplified once, the number of frames
+// is not used.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+//! A hilly grid of quads with 32 bit indices
+static IMesh* createTerrain(u32 size)
+{
+	CDynamicMeshBuffer* mb = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+	IVertexBuffer& vertices = mb->getVertexBuffer();
+	IIndexBuffer& indices = mb->getIndexBuffer();
+	vertices.reallocate((size + 1) * (size + 1));
+	indices.reallocate(size * size * 6);
+
+	for (u32 z=0; z<=size; ++z)
+	{
+		for (u32 x=0; x<=size; ++x)
+		{
+			const f32 height = sinf(x * 0.05f) * cosf(z * 0.03f) * 8.f + sinf((x + z) * 0.2f);
+			vertices.push_back(video::S3DVertex((f32)x, height, (f32)z, 0, 1, 0,
+				video::SColor(255, 255, 255, 255), (f32)x / size, (f32)z / size));
+		}
+	}
+
+	for (u32 z=0; z<size; ++z)
+	{
+		for (u32 x=0; x<size; ++x)
+		{
+			const u32 v = z * (size + 1) + x;
+			indices.push_back(v);
+			indices.push_back(v + size + 1);
+			indices.push_back(v + size + 2);
+			indices.push_back(v);
+			indices.push_back(v + size + 2);
+			indices.push_back(v + 1);
+		}
+	}
+	mb->recalculateBoundingBox();
+
+	SMesh* mesh = new SMesh();
+	mesh->addMeshBuffer(mb);
+	mesh->recalculateBoundingBox();
+	mb->drop();
+	return mesh;
+}
+
+
+static void runSimplify(IMeshManipulator* manipulator, IMesh* mesh, f32 ratio, ITimer* timer)
+{
+	const u32 start = timer->getRealTime();
+	IMesh* simplified = manipulator->createMeshSimplified(mesh, ratio);
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant("ratio ");
+	variant += ratio;
+	printResult("simplify", variant.c_str(), 1, time, simplified->getMeshBuffer(0)->getIndexCount() / 3);
+
+	simplified->drop();
+}
+
+
+void benchmarkSimplify(u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	IMeshManipulator* manipulator = device->getSceneManager()->getMeshManipulator();
+	IMesh* terrain = createTerrain(708);
+
+	runSimplify(manipulator, terrain, 0.5f, device->getTimer());
+	runSimplify(manipulator, terrain, 0.1f, device->getTimer());
+
+	terrain->drop();
+	device->drop();
+}
+
@@ -0,0 +1,134 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Time to register, sort and draw many visible solid and transparent nodes
+// and the number of material and texture changes caused by the draw order
+// of the solid nodes. The nodes don't draw anything themselves.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Counts how often the material type or a texture changes between drawn nodes
+struct SStateCounter
+{
+	SStateCounter() : Last(0), Changes(0) {}
+
+	void draw(const video::SMaterial& material)
+	{
+		if (!Last || Last->MaterialType != material.MaterialType ||
+			Last->getTexture(0) != material.getTexture(0) ||
+			Last->getTexture(1) != material.getTexture(1))
+			++Changes;
+		Last = &material;
+	}
+
+	const video::SMaterial* Last;
+	u32 Changes;
+};
+
+SStateCounter Counter;
+
+class CSortBenchmarkNode : public ISceneNode
+{
+public:
+	CSortBenchmarkNode(ISceneManager* mgr, E_SCENE_NODE_RENDER_PASS pass)
+		: ISceneNode(mgr->getRootSceneNode(), mgr, -1), Pass(pass)
+	{
+		Box.reset(vector3df(-1.f));
+		Box.addInternalPoint(vector3df(1.f));
+		setAutomaticCulling(EAC_OFF);
+	}
+
+	virtual void OnRegisterSceneNode()
+	{
+		if (IsVisible)
+			SceneManager->registerNodeForRendering(this, Pass);
+		ISceneNode::OnRegisterSceneNode();
+	}
+
+	virtual void render()
+	{
+		if (Pass == ESNRP_SOLID)
+			Counter.draw(Material);
+	}
+
+	virtual const aabbox3d<f32>& getBoundingBox() const { return Box; }
+	virtual u32 getMaterialCount() const { return 1; }
+	virtual video::SMaterial& getMaterial(u32 i) { return Material; }
+
+	video::SMaterial Material;
+
+private:
+	E_SCENE_NODE_RENDER_PASS Pass;
+	aabbox3df Box;
+};
+
+}
+
+
+void benchmarkSort(u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	array<video::ITexture*> textures;
+	for (u32 i=0; i<32; ++i)
+	{
+		video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, dimension2du(2, 2));
+		char name[32];
+		sprintf(name, "sort%u", i);
+		textures.push_back(driver->addTexture(name, image));
+		image->drop();
+	}
+
+	const video::E_MATERIAL_TYPE solidTypes[4] =
+		{ video::EMT_SOLID, video::EMT_LIGHTMAP, video::EMT_DETAIL_MAP, video::EMT_REFLECTION_2_LAYER };
+	const video::E_MATERIAL_TYPE transparentTypes[2] =
+		{ video::EMT_TRANSPARENT_ALPHA_CHANNEL, video::EMT_TRANSPARENT_ADD_COLOR };
+
+	const u32 count = 8000;
+	IRandomizer* random = device->getRandomizer();
+	for (u32 i=0; i<count; ++i)
+	{
+		const bool transparent = (i % 4) == 0;
+		CSortBenchmarkNode* node = new CSortBenchmarkNode(smgr, transparent ? ESNRP_TRANSPARENT : ESNRP_SOLID);
+		node->setPosition(vector3df(random->frand() * 1000.f, random->frand() * 100.f, random->frand() * 1000.f));
+		if (transparent)
+			node->Material.MaterialType = transparentTypes[random->rand() % 2];
+		else
+			node->Material.MaterialType = solidTypes[random->rand() % 4];
+		node->Material.setTexture(0, textures[random->rand() % textures.size()]);
+		node->Material.setTexture(1, textures[random->rand() % 4]);
+		node->drop();
+	}
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(500.f, 50.f, -100.f), vector3df(500.f, 0, 500.f));
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		// moving camera, so the transparent order changes every frame
+		camera->setPosition(vector3df((f32)(i % 100) * 10.f, 50.f, -100.f));
+		Counter = SStateCounter();
+		smgr->drawAll();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	printResult("sort", "8000 nodes", frames, time);
+	printf("%-16s %-24s %8u state changes per frame\n", "sort", "solid nodes", Counter.Changes);
+
+	device->drop();
+}
+
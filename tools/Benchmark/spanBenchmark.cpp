@@ -0,0 +1,82 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Fill rate of the scanlines of Burning's Video for each renderer with
+// vectorized spans, at several resolutions. 8 screen covering layers drawn
+// back to front, so every pixel passes the depth test 8 times.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runSpans(video::E_MATERIAL_TYPE type, const char* name, const dimension2du& size, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(video::EDT_BURNINGSVIDEO, size);
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	video::ITexture* wall = driver->getTexture("../../media/wall.bmp");
+	video::ITexture* fire = driver->getTexture("../../media/fire.bmp");
+
+	IMesh* plane = smgr->getGeometryCreator()->createPlaneMesh(dimension2df(25.f, 25.f),
+		dimension2du(4, 4), 0, dimension2df(4.f, 4.f));
+	IMesh* mesh = (type == video::EMT_LIGHTMAP_M4) ? smgr->getMeshManipulator()->createMeshWith2TCoords(plane) : plane;
+	if (mesh != plane)
+		plane->drop();
+
+	for (u32 i=0; i<8; ++i)
+	{
+		ISceneNode* node = smgr->addMeshSceneNode(mesh, 0, -1,
+			vector3df(0, 0, 40.f - i * 3.f), vector3df(-90.f, 0, i * 10.f));
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setMaterialFlag(video::EMF_BACK_FACE_CULLING, false);
+		node->setMaterialTexture(0, wall);
+		node->setMaterialTexture(1, fire);
+		video::SMaterial& material = node->getMaterial(0);
+		material.MaterialType = type;
+		if (type == video::EMT_ONETEXTURE_BLEND)
+			material.MaterialTypeParam = video::pack_textureBlendFunc(video::EBF_DST_COLOR, video::EBF_ZERO);
+	}
+	mesh->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	ITimer* timer = device->getTimer();
+	u32 primitives = 0;
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+		primitives = driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	sprintf(variant, "%s %ux%u", name, size.Width, size.Height);
+	printResult("spans", variant, frames, time, primitives);
+
+	device->drop();
+}
+
+
+void benchmarkSpans(u32 frames)
+{
+	static const dimension2du sizes[] =
+	{
+		dimension2du(320, 240), dimension2du(640, 480), dimension2du(1024, 768)
+	};
+
+	for (u32 i=0; i<3; ++i)
+	{
+		runSpans(video::EMT_SOLID, "gouraud", sizes[i], frames);
+		runSpans(video::EMT_LIGHTMAP_M4, "lightmap m4", sizes[i], frames);
+		runSpans(video::EMT_ONETEXTURE_BLEND, "blend", sizes[i], frames);
+	}
+}
@@ -0,0 +1,77 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Texel fetches of Burning's Video on rotated geometry. 8 screen filling
+// planes at the same depth, so every layer passes the depth test, with a large
+// texture. They are turned around the view axis so the scanlines walk along
+// the rows, the diagonal or the columns of the texture. The texture is
+// repeated once or 8 times, with and without mip maps.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runTextures(f32 angle, f32 repeat, bool mipMaps, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(video::EDT_BURNINGSVIDEO, dimension2du(640, 480));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, mipMaps);
+
+	video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, dimension2du(1024, 1024));
+	for (u32 y=0; y<1024; ++y)
+		for (u32 x=0; x<1024; ++x)
+			image->setPixel(x, y, video::SColor(255, x & 255, y & 255, (x ^ y) & 255));
+	video::ITexture* texture = driver->addTexture("texels", image);
+	image->drop();
+
+	IMesh* plane = smgr->getGeometryCreator()->createPlaneMesh(dimension2df(10.f, 10.f),
+		dimension2du(4, 4), 0, dimension2df(repeat, repeat));
+	for (u32 i=0; i<8; ++i)
+	{
+		ISceneNode* node = smgr->addMeshSceneNode(plane, 0, -1, vector3df(0, 0, 12.f), vector3df(-90.f, 0, angle));
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setMaterialFlag(video::EMF_BACK_FACE_CULLING, false);
+		node->setMaterialTexture(0, texture);
+	}
+	plane->drop();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	ITimer* timer = device->getTimer();
+	u32 primitives = 0;
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+		primitives = driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	sprintf(variant, "repeat %.0f %s %.0f deg", repeat, mipMaps ? "mip" : "no mip", angle);
+	printResult("textures", variant, frames, time, primitives);
+
+	device->drop();
+}
+
+
+void benchmarkTextures(u32 frames)
+{
+	static const f32 angles[] = { 0.f, 45.f, 90.f };
+
+	for (u32 i=0; i<3; ++i)
+	{
+		runTextures(angles[i], 1.f, true, frames);
+		runTextures(angles[i], 8.f, true, frames);
+		runTextures(angles[i], 8.f, false, frames);
+	}
+}
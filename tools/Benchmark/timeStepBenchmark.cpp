@@ -0,0 +1,77 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Drawing at 144 frames per second with the scene animated in each drawAll
+// and with the animation in 30 Hz steps and interpolated transformations.
+// The time passed to the scene advances by 1/144 s per frame. The scene has
+// skinned meshes walking in circles, which are expensive to animate.
+
+#include "benchmark.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runTimeStep(u32 stepMs, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	smgr->setAnimationTimeStep(stepMs);
+
+	IAnimatedMesh* mesh = smgr->getMesh("../../media/ninja.b3d");
+	if (!mesh)
+	{
+		device->drop();
+		return;
+	}
+
+	// 100 walking ninjas
+	for (u32 i=0; i<100; ++i)
+	{
+		IAnimatedMeshSceneNode* node = smgr->addAnimatedMeshSceneNode(mesh);
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setFrameLoop(0, 13);
+		node->setAnimationSpeed(15.f);
+		node->setCurrentFrame((f32)(i % 13));
+		ISceneNodeAnimator* anim = smgr->createFlyCircleAnimator(vector3df((f32)(i % 10) * 12.f, 0, (f32)(i / 10) * 12.f), 3.f);
+		node->addAnimator(anim);
+		anim->drop();
+	}
+	smgr->addCameraSceneNode(0, vector3df(60.f, 80.f, -60.f), vector3df(60.f, 0, 60.f));
+
+	ITimer* timer = device->getTimer();
+	timer->stop();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		timer->setTime(i * 1000 / 144);
+		smgr->updateAnimation(timer->getTime());
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	char variant[64];
+	if (stepMs)
+		sprintf(variant, "%u Hz steps, interpolated", 1000 / stepMs);
+	else
+		sprintf(variant, "animated in drawAll");
+	printResult("timestep", variant, frames, time, driver->getPrimitiveCountDrawn());
+
+	device->drop();
+}
+
+
+void benchmarkTimeStep(u32 frames)
+{
+	runTimeStep(0, frames);
+	runTimeStep(33, frames);
+}
+
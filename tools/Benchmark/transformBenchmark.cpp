@@ -0,0 +1,63 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Time of the animation pass for a static scene, where no absolute
+// transformation has to be recalculated, and for a scene where all
+// top level nodes move.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runTransform(bool moving, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice();
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	// 2000 groups with 4 children and 4 grandchildren each
+	array<ISceneNode*> groups;
+	for (u32 i=0; i<2000; ++i)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode();
+		group->setPosition(vector3df((f32)(i % 50) * 10.f, 0, (f32)(i / 50) * 10.f));
+		group->setRotation(vector3df(0, (f32)i, 0));
+		groups.push_back(group);
+
+		for (u32 j=0; j<4; ++j)
+		{
+			ISceneNode* child = smgr->addEmptySceneNode(group);
+			child->setPosition(vector3df((f32)j, 1.f, 0));
+			child->setRotation(vector3df((f32)j * 10.f, 0, 0));
+			smgr->addEmptySceneNode(child)->setScale(vector3df(0.5f));
+		}
+	}
+
+	ITimer* timer = device->getTimer();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		if (moving)
+		{
+			for (u32 g=0; g<groups.size(); ++g)
+				groups[g]->setRotation(vector3df(0, (f32)(g + i), 0));
+		}
+		smgr->getRootSceneNode()->OnAnimate(i);
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	printResult("transform", moving ? "moving, 18000 nodes" : "static, 18000 nodes", frames, time);
+
+	device->drop();
+}
+
+
+void benchmarkTransform(u32 frames)
+{
+	runTransform(false, frames);
+	runTransform(true, frames);
+}
@@ -0,0 +1,71 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Vertex stage of Burning's Video: 64 finely tessellated spheres which
+// cover only a few pixels each, so the time goes into transforming,
+// lighting and clip testing the vertices. Without lights and with two
+// point lights and a directional light.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runVertex(bool lighting, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(video::EDT_BURNINGSVIDEO, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	IMesh* mesh = smgr->getGeometryCreator()->createSphereMesh(1.f, 64, 64);
+
+	for (u32 i=0; i<64; ++i)
+	{
+		ISceneNode* node = smgr->addMeshSceneNode(mesh, 0, -1,
+			vector3df(((f32)(i % 8) - 3.5f) * 6.f, ((f32)(i / 8) - 3.5f) * 4.5f, 60.f));
+		node->setMaterialFlag(video::EMF_LIGHTING, lighting);
+		ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0, 0.1f * (i % 5 + 1), 0));
+		node->addAnimator(anim);
+		anim->drop();
+	}
+	mesh->drop();
+
+	if (lighting)
+	{
+		smgr->addLightSceneNode(0, vector3df(-20.f, 20.f, 40.f), video::SColorf(1.f, 0.8f, 0.6f), 100.f);
+		smgr->addLightSceneNode(0, vector3df(20.f, -10.f, 50.f), video::SColorf(0.4f, 0.6f, 1.f), 60.f);
+		ILightSceneNode* sun = smgr->addLightSceneNode(0, vector3df(0, 0, 0), video::SColorf(0.3f, 0.3f, 0.3f));
+		sun->setLightType(video::ELT_DIRECTIONAL);
+		sun->setRotation(vector3df(45.f, 30.f, 0));
+	}
+	smgr->addCameraSceneNode(0, vector3df(0, 0, 0), vector3df(0, 0, 100.f));
+
+	ITimer* timer = device->getTimer();
+	u32 primitives = 0;
+	timer->stop();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		timer->setTime(i * 20);
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		smgr->drawAll();
+		driver->endScene();
+		primitives = driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	printResult("vertex", lighting ? "3 lights" : "unlit", frames, time, primitives);
+
+	device->drop();
+}
+
+
+void benchmarkVertex(u32 frames)
+{
+	runVertex(false, frames);
+	runVertex(true, frames);
+}
@@ -0,0 +1,93 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// A field of animated nodes seen from 4 cameras in split screen. Drawn with
+// drawAll for each camera and with a single drawAll for all views, which
+// animates and registers the nodes only once.
+
+#include "benchmark.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+static void runViews(video::E_DRIVER_TYPE driverType, bool together, u32 frames)
+{
+	IrrlichtDevice* device = createBenchmarkDevice(driverType, dimension2du(320, 240));
+	if (!device)
+		return;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	IMesh* mesh = smgr->getGeometryCreator()->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+
+	// 100 groups of 50 nodes, all with animators
+	for (u32 g=0; g<100; ++g)
+	{
+		ISceneNode* group = smgr->addEmptySceneNode();
+		group->setPosition(vector3df((f32)(g % 10) * 12.f, 0, (f32)(g / 10) * 12.f));
+		for (u32 i=0; i<50; ++i)
+		{
+			ISceneNode* node = smgr->addMeshSceneNode(mesh, group, -1, vector3df((f32)(i % 7), (f32)(i / 7), 0));
+			node->setMaterialFlag(video::EMF_LIGHTING, false);
+			ISceneNodeAnimator* anim = smgr->createRotationAnimator(vector3df(0, 0.1f * (i % 5), 0));
+			node->addAnimator(anim);
+			anim->drop();
+		}
+	}
+	mesh->drop();
+
+	// 4 cameras in the center of the field, each looking at a corner
+	array<SSceneView> views;
+	const vector3df center(60.f, 20.f, 60.f);
+	for (u32 i=0; i<4; ++i)
+	{
+		const vector3df corner((i & 1) ? 120.f : 0, 0, (i & 2) ? 120.f : 0);
+		ICameraSceneNode* camera = smgr->addCameraSceneNode(0, center, corner);
+		camera->setAspectRatio(4.f / 3.f);
+		camera->setFarValue(100.f);
+		views.push_back(SSceneView(camera, rect<s32>((i & 1) * 160, (i / 2) * 120, (i & 1) * 160 + 160, (i / 2) * 120 + 120)));
+	}
+
+	ITimer* timer = device->getTimer();
+	u32 primitives = 0;
+	// the animation advances by a fixed step so both variants draw the same
+	timer->stop();
+	const u32 start = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		device->run();
+		timer->setTime(i * 20);
+		driver->beginScene(true, true, video::SColor(255, 0, 0, 0));
+		if (together)
+			smgr->drawAll(views);
+		else
+		{
+			for (u32 v=0; v<views.size(); ++v)
+			{
+				driver->setViewPort(views[v].Viewport);
+				smgr->setActiveCamera(views[v].Camera);
+				smgr->drawAll();
+			}
+		}
+		driver->endScene();
+		primitives = driver->getPrimitiveCountDrawn();
+	}
+	const u32 time = timer->getRealTime() - start;
+
+	stringc variant(driverType == video::EDT_NULL ? "null, " : "burning, ");
+	variant += together ? "views together" : "drawAll per view";
+	printResult("views", variant.c_str(), frames, time, primitives);
+
+	device->drop();
+}
+
+
+void benchmarkViews(u32 frames)
+{
+	runViews(video::EDT_NULL, false, frames);
+	runViews(video::EDT_NULL, true, frames);
+	runViews(video::EDT_BURNINGSVIDEO, false, frames);
+	runViews(video::EDT_BURNINGSVIDEO, true, frames);
+}
+